@@ -44,6 +44,7 @@
 
 namespace OpenMS
 {
+  class ProteinSuffixArray;
 
 /**
   @brief Refreshes the protein references for all peptide hits in a vector of PeptideIdentifications and adds target/decoy information.
@@ -99,6 +100,14 @@ namespace OpenMS
   which is usually cleaved off in vivo. For example, the two peptides AAAR and MAAAR would both match a protein starting with MAAAR.
   You can relax the requirements further by choosing <tt>semi-tryptic</tt> (only one of two "internal" termini must match requirements)
   or <tt>none</tt> (essentially allowing all hits, no matter their context).
+
+  Persistent protein index:
+  When the same database is used for many runs, set @p index_cache_dir to an existing directory.
+  On first use, a suffix array over the protein sequences (see ProteinSuffixArray) is written to this directory,
+  named after a checksum of the (I/L-converted, if requested) database. Subsequent runs only memory-map this file
+  and look up each peptide directly, instead of building an Aho-Corasick automaton and scanning all proteins.
+  The results of the exact search are identical; tolerant search (if required) is not affected.
+  If the index cannot be written or read, the regular Aho-Corasick search is used instead.
 */
 
  class OPENMS_DLLAPI PeptideIndexing :
@@ -133,6 +142,13 @@ protected:
 
     void writeDebug_(const String& text, const Size min_level) const;
 
+    /**
+      @brief Loads the cached protein index for @p sequences from @p index_cache_dir_ (building it if necessary)
+
+      @return false if the index could not be built or loaded
+    */
+    bool loadProteinIndex_(const std::vector<String>& sequences, ProteinSuffixArray& index) const;
+
     /// Output stream for log/debug info
     String log_file_;
     mutable std::ofstream log_;
@@ -156,6 +172,9 @@ protected:
     UInt mismatches_max_;
     bool filter_aaa_proteins_;
 
+    /// directory of the persistent protein index (empty if disabled)
+    String index_cache_dir_;
+
   };
 }
 
@@ -0,0 +1,180 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_ANALYSIS_ID_PROTEINSUFFIXARRAY_H
+#define OPENMS_ANALYSIS_ID_PROTEINSUFFIXARRAY_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
+namespace OpenMS
+{
+
+  /**
+    @brief Persistent, memory-mapped suffix array over a protein database
+
+    Used by PeptideIndexing to avoid re-indexing the same FASTA database for
+    every run. The index is built once via build() and stored in a single
+    binary file; subsequent runs only map the file into memory (see load()),
+    which takes constant time independent of the database size.
+
+    All protein sequences are concatenated (each followed by a '$'
+    separator, which can never be part of a peptide) and the suffix array
+    over this text is stored alongside. Exact lookups (findAll()) are then
+    answered by binary search in O(m log n) for a peptide of length m.
+
+    The sequences are indexed as given, i.e. any normalization (such as
+    replacing 'L' by 'I' for I/L-equivalent searches) has to be applied by
+    the caller before building the index and before querying it. Since the
+    checksum (see computeChecksum()) is computed over the indexed sequences,
+    different normalizations of the same database are stored in different
+    files when using getCacheFilename().
+
+    The file is written in the native byte order; a file written on a machine
+    with a different byte order is rejected by load().
+
+    @ingroup Analysis_ID
+  */
+  class OPENMS_DLLAPI ProteinSuffixArray
+  {
+public:
+
+    /// Occurrence of a peptide in the protein database
+    struct Hit
+    {
+      /// index of the protein (as passed to build())
+      Size protein_index;
+      /// zero-based position of the peptide in the protein
+      Size position;
+    };
+
+    /// Default constructor (no index loaded)
+    ProteinSuffixArray();
+
+    /// Copy constructor (shares the memory mapping)
+    ProteinSuffixArray(const ProteinSuffixArray& rhs);
+
+    /// Assignment operator (shares the memory mapping)
+    ProteinSuffixArray& operator=(const ProteinSuffixArray& rhs);
+
+    /// Destructor
+    ~ProteinSuffixArray();
+
+    /**
+      @brief Builds the index for @p sequences and writes it to @p filename
+
+      The file is first written to a temporary file which is then renamed,
+      so that concurrent processes never observe a partially written index.
+
+      @exception Exception::InvalidSize if the total sequence length exceeds 2^32 - 1
+      @exception Exception::UnableToCreateFile if the file cannot be written
+    */
+    static void build(const std::vector<String>& sequences, const String& filename);
+
+    /**
+      @brief Maps the index stored in @p filename into memory
+
+      The structure of the index (protein boundaries and suffix array
+      entries) is validated in O(n), a truncated or corrupt file is rejected.
+
+      @exception Exception::FileNotFound if the file does not exist
+      @exception Exception::ParseError if the file is not a valid index
+    */
+    void load(const String& filename);
+
+    /**
+      @brief Returns true if the loaded index was built from exactly @p sequences
+
+      Compares the stored text with the given sequences, i.e. does not rely
+      on the checksum alone (which may collide).
+    */
+    bool matches(const std::vector<String>& sequences) const;
+
+    /// Returns true if an index is loaded
+    bool isLoaded() const;
+
+    /// Returns the checksum of the loaded index
+    UInt64 getChecksum() const;
+
+    /// Returns the number of proteins in the loaded index
+    Size getNumberOfProteins() const;
+
+    /**
+      @brief Finds all occurrences of @p peptide (exact match)
+
+      Hits are appended to @p hits, in no particular order. An empty peptide
+      never matches.
+    */
+    void findAll(const String& peptide, std::vector<Hit>& hits) const;
+
+    /// Checksum over the given sequences (and their order), as stored in the index file
+    static UInt64 computeChecksum(const std::vector<String>& sequences);
+
+    /// Returns the index file name for the given checksum in directory @p directory
+    static String getCacheFilename(const String& directory, UInt64 checksum);
+
+protected:
+
+    /// Computes the suffix array of @p text (prefix doubling with radix sort)
+    static void computeSuffixArray_(const String& text, std::vector<UInt32>& sa);
+
+    /// Compares the suffix at @p pos with @p pattern (returns 0 if @p pattern is a prefix of the suffix)
+    int compareSuffix_(UInt32 pos, const char* pattern, Size length) const;
+
+    boost::shared_ptr<boost::interprocess::mapped_region> region_;
+
+    UInt64 checksum_;
+    Size protein_count_;
+    Size text_length_;
+    /// protein start offsets in text_ (protein_count_ + 1 entries)
+    const UInt64* starts_;
+    const UInt32* sa_;
+    const char* text_;
+  };
+
+}
+
+#endif // OPENMS_ANALYSIS_ID_PROTEINSUFFIXARRAY_H
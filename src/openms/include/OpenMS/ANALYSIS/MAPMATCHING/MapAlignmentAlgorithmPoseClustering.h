@@ -79,6 +79,14 @@ public:
     /// Destructor
     virtual ~MapAlignmentAlgorithmPoseClustering();
 
+    /**
+      @brief Aligns @p map to the reference map (see setReference())
+
+      The reference is only read, so several maps can be aligned against the
+      same reference concurrently (e.g. from within an OpenMP parallel
+      region), as long as setReference() and setParameters() are not called
+      at the same time.
+    */
     void align(const FeatureMap& map, TransformationDescription& trafo);
     void align(const MSExperiment<>& map, TransformationDescription& trafo);
     void align(const ConsensusMap& map, TransformationDescription& trafo);
@@ -87,20 +95,26 @@ public:
     template <typename MapType>
     void setReference(const MapType& map)
     {
-      MapType map2 = map; // todo: avoid copy (MSExperiment version of convert() demands non-const version)
-      MapConversion::convert(0, map2, reference_, max_num_peaks_considered_);
+      MapConversion::convert(0, map, reference_, max_num_peaks_considered_);
+      updateReferencePeaks_();
     }
 
 protected:
 
     virtual void updateMembers_();
 
+    /// Converts the reference map once into the representation used by the superimposer
+    void updateReferencePeaks_();
+
     PoseClusteringAffineSuperimposer superimposer_;
 
     StablePairFinder pairfinder_;
 
     ConsensusMap reference_;
 
+    /// Reference as input for the superimposer (shared read-only by all align() calls)
+    std::vector<Peak2D> reference_peaks_;
+
     Int max_num_peaks_considered_;
 
 private:
@@ -45,6 +45,7 @@
 #include <boost/unordered_map.hpp>
 
 #include <list>
+#include <queue>
 #include <vector>
 #include <set>
 #include <utility> // for pair<>
@@ -92,7 +93,10 @@ namespace OpenMS
    This algorithm includes a number of optimizations to reduce run-time:
    @li two-dimensional hashing of features,
    @li a look-up table for feature distances,
-   @li a variant of QT clustering that requires only one round of clustering.
+   @li a variant of QT clustering that requires only one round of clustering,
+   @li parallel construction of the initial clusters (using OpenMP),
+   @li a priority queue for finding the best cluster, in which outdated
+       entries are skipped lazily instead of being removed on every update.
 
    @see FeatureGroupingAlgorithmQT
 
@@ -117,6 +121,23 @@ private:
 
     typedef HashGrid<OpenMS::GridFeature*> Grid;
 
+    /// Entry in the queue of clusters (quality at the time of insertion)
+    struct ClusterQueueEntry_
+    {
+      double quality;
+      Size index;
+
+      /// Higher quality first; on ties, the cluster that was created first
+      bool operator<(const ClusterQueueEntry_& rhs) const
+      {
+        if (quality != rhs.quality) return quality < rhs.quality;
+        return index > rhs.index;
+      }
+    };
+
+    /// Queue of clusters, best cluster on top
+    typedef std::priority_queue<ClusterQueueEntry_> ClusterQueue;
+
     /// Number of input maps
     Size num_maps_;
 
@@ -138,22 +159,23 @@ private:
     /// Set of features already used
     std::set<OpenMS::GridFeature*> already_used_;
 
-    /**
-       @brief Calculates the distance between two grid features.
-    */
-    double getDistance_(const OpenMS::GridFeature* left, const
-        OpenMS::GridFeature* right);
-
     /// Sets algorithm parameters
     void setParameters_(double max_intensity, double max_mz);
 
-    /// Generates a consensus feature from the best cluster and updates the clustering
-    void makeConsensusFeature_(std::list<QTCluster>& clustering,
+    /**
+       @brief Generates a consensus feature from the best cluster and updates the clustering
+
+       Clusters whose composition changes are re-inserted into @p queue with their new quality.
+
+       @return False if no valid cluster is left (@p feature is not set then)
+    */
+    bool makeConsensusFeature_(std::vector<QTCluster>& clustering,
+                               ClusterQueue& queue,
                                ConsensusFeature& feature,
                                ElementMapping& element_mapping, Grid&);
 
     /// Computes an initial QT clustering of the points in the hash grid
-    void computeClustering_(Grid& grid, std::list<QTCluster>& clustering);
+    void computeClustering_(Grid& grid, std::vector<QTCluster>& clustering);
 
     /// Runs the algorithm on feature maps or consensus maps
     template <typename MapType>
@@ -164,9 +186,14 @@ private:
     void run_internal_(const std::vector<MapType>& input_maps,
                        ConsensusMap& result_map, bool do_progress);
 
-    /// Adds elements to the cluster based on the elements hashed in the grid
+    /**
+       @brief Adds elements to the cluster based on the elements hashed in the grid
+
+       @p feature_distance is passed explicitly, since the functor is not
+       thread-safe (each thread needs its own copy).
+    */
     void addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-      const OpenMS::GridFeature* center_feature);
+      const OpenMS::GridFeature* center_feature, FeatureDistance& feature_distance);
 
 protected:
 
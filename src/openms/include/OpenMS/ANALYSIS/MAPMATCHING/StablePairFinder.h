@@ -144,6 +144,17 @@ public:
     void run(const std::vector<ConsensusMap>& input_maps,
              ConsensusMap& result_map);
 
+    /**
+      @brief Run the algorithm on two maps
+
+      Same as the vector version, but avoids copying the input maps into a
+      vector (e.g. when aligning many maps against one reference map).
+
+      @exception Exception::IllegalArgument is thrown if the file ids of the maps are not unique.
+    */
+    void run(const ConsensusMap& map0, const ConsensusMap& map1,
+             ConsensusMap& result_map);
+
 protected:
 
     ///@name Internal helper classes and enums
@@ -97,6 +97,12 @@ public:
      * @param ppm Whether mz_extraction_window is in ppm or in Th
      * @param filter Which function to apply in m/z space (currently "tophat" only)
      *
+     * @note If OpenMP is enabled, the spectra are split into contiguous blocks
+     * which are processed by different threads, all reading from @p input
+     * (which thus needs to support concurrent access). When called from an
+     * enclosing parallel region, this only happens if nested parallelism is
+     * enabled. The result is independent of the number of threads.
+     *
     */
     void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, 
         std::vector< OpenSwath::ChromatogramPtr >& output, 
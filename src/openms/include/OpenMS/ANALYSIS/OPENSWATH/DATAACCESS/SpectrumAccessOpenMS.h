@@ -48,6 +48,9 @@ namespace OpenMS
   /**
     @brief An implementation of the OpenSWATH Spectrum Access interface using OpenMS
 
+    All access to the underlying MSExperiment is read-only, therefore a single
+    instance can be used concurrently from multiple threads.
+
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMS :
     public OpenSwath::ISpectrumAccess
@@ -41,6 +41,8 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <fstream>
 
 namespace OpenMS
@@ -53,10 +55,13 @@ namespace OpenMS
     (ISpectrumAccess) using the CachedmzML class which is able to read and
     write a cached mzML file.
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    @note This implementation keeps internally a single file access pointer
+    which it moves when accessing a specific data item. Access to the file
+    stream is serialized by a lock held by each instance, so a single object
+    can be shared by multiple threads, but concurrent reads will not overlap.
+    Use lightClone() to obtain an object with its own file stream or see
+    SpectrumAccessOpenMSCachedMapped for a memory-mapped implementation
+    which supports lock-free concurrent access.
 
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMSCached :
@@ -109,12 +114,18 @@ public:
 
 private:
 
+    /// Lock protecting the file stream (defined in the implementation)
+    struct StreamLock_;
+
     /// Meta data
     MSExperimentType meta_ms_experiment_;
 
     /// Internal filestream 
     std::ifstream ifs_;
 
+    /// Lock protecting ifs_ (each instance has its own stream and lock)
+    boost::shared_ptr<StreamLock_> ifs_lock_;
+
     /// Name of the mzML file
     String filename_;
 
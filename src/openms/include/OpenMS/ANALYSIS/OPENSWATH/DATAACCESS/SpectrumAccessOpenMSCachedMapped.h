@@ -0,0 +1,139 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_ANALYSIS_OPENSWATH_DATAACCESS_SPECTRUMACCESSOPENMSCACHEDMAPPED_H
+#define OPENMS_ANALYSIS_OPENSWATH_DATAACCESS_SPECTRUMACCESSOPENMSCACHEDMAPPED_H
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/CachedMzMLMapped.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+
+namespace OpenMS
+{
+
+  /**
+    @brief An implementation of the Spectrum Access interface using a memory-mapped cached file
+
+    This class implements the OpenSWATH Spectrum Access interface
+    (ISpectrumAccess) on top of CachedmzMLMapped which maps a cached mzML
+    file into memory. In contrast to SpectrumAccessOpenMSCached no file
+    stream is kept and the data can be accessed without copying through
+    getSpectrumViewById and getChromatogramViewById.
+
+    All data access functions only read immutable, shared data. The object
+    (and its light clones, which share mapping and meta data) can thus be
+    used concurrently from multiple threads.
+
+  */
+  class OPENMS_DLLAPI SpectrumAccessOpenMSCachedMapped :
+    public OpenSwath::ISpectrumAccess
+  {
+
+public:
+    typedef OpenMS::MSExperiment<Peak1D> MSExperimentType;
+    typedef OpenMS::MSSpectrum<Peak1D> MSSpectrumType;
+    typedef CachedmzMLMapped::DataArrayView DataArrayView;
+
+    /**
+      @brief Constructor, maps the cached file into memory
+
+      @param filename The filename of the .mzML file (it is assumed a second
+      file .mzML.cached exists).
+
+      @throws Exception::FileNotFound is thrown if the file is not found
+      @throws Exception::ParseError is thrown if the file cannot be parsed
+    */
+    explicit SpectrumAccessOpenMSCachedMapped(String filename);
+
+    /**
+      @brief Destructor
+    */
+    ~SpectrumAccessOpenMSCachedMapped();
+
+    /// Copy constructor (shares mapping and meta data)
+    SpectrumAccessOpenMSCachedMapped(const SpectrumAccessOpenMSCachedMapped & rhs);
+
+    /// Light clone operator (actual data will not get copied)
+    boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const;
+
+    OpenSwath::SpectrumPtr getSpectrumById(int id);
+
+    /**
+      @brief Zero-copy access to the m/z and intensity array of a spectrum
+
+      The views are valid as long as this object (or one of its clones) exists.
+    */
+    void getSpectrumViewById(int id, DataArrayView& mz, DataArrayView& intensity) const;
+
+    OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const;
+
+    std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const;
+
+    size_t getNrSpectra() const;
+
+    SpectrumSettings getSpectraMetaInfo(int id) const;
+
+    OpenSwath::ChromatogramPtr getChromatogramById(int id);
+
+    /**
+      @brief Zero-copy access to the time and intensity array of a chromatogram
+
+      The views are valid as long as this object (or one of its clones) exists.
+    */
+    void getChromatogramViewById(int id, DataArrayView& rt, DataArrayView& intensity) const;
+
+    size_t getNrChromatograms() const;
+
+    ChromatogramSettings getChromatogramMetaInfo(int id) const;
+
+    std::string getChromatogramNativeID(int id) const;
+
+private:
+
+    /// Meta data (shared between clones)
+    boost::shared_ptr<MSExperimentType> meta_ms_experiment_;
+
+    /// Mapped cached file (shared between clones)
+    boost::shared_ptr<const CachedmzMLMapped> cache_;
+
+    /// Name of the mzML file
+    String filename_;
+  };
+
+} //end namespace
+
+#endif
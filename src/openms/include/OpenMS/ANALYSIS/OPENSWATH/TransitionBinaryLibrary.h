@@ -0,0 +1,238 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_ANALYSIS_OPENSWATH_TRANSITIONBINARYLIBRARY_H
+#define OPENMS_ANALYSIS_OPENSWATH_TRANSITIONBINARYLIBRARY_H
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
+namespace OpenMS
+{
+
+  /**
+    @brief Compact binary, memory-mapped transition library for OpenSWATH
+
+    Parsing large TSV or TraML assay libraries can dominate the start-up
+    time of an OpenSWATH run. This class stores a
+    OpenSwath::LightTargetedExperiment in a single binary file (usually with
+    the extension ".oswlib") which is written once via store() and
+    afterwards only mapped into memory (see load()), which takes constant
+    time independent of the library size.
+
+    The file consists of flat arrays: precursor m/z, product m/z, library
+    intensity and flags of all transitions, retention time and charge of all
+    compounds and so on. All strings (transition names, compound and
+    protein identifiers, sequences, ...) are stored once in a string table
+    and referenced by their offset. In addition, the transitions are indexed
+    by precursor m/z so that the transitions of a single SWATH window can be
+    selected without touching the rest of the library (see
+    selectTransitions()).
+
+    Individual entries can be accessed directly in the mapped file; the
+    OpenSwath::LightTargetedExperiment structures are only created on
+    request, either for the whole library (see getLightTargetedExperiment())
+    or for a precursor m/z range.
+
+    The file is written in the native byte order; a file written on a machine
+    with a different byte order is rejected by load().
+  */
+  class OPENMS_DLLAPI TransitionBinaryLibrary
+  {
+public:
+
+    /// Default constructor (no library loaded)
+    TransitionBinaryLibrary();
+
+    /// Copy constructor (shares the memory mapping)
+    TransitionBinaryLibrary(const TransitionBinaryLibrary& rhs);
+
+    /// Assignment operator (shares the memory mapping)
+    TransitionBinaryLibrary& operator=(const TransitionBinaryLibrary& rhs);
+
+    /// Destructor
+    ~TransitionBinaryLibrary();
+
+    /**
+      @brief Writes the library @p exp to @p filename
+
+      The file is first written to a temporary file which is then renamed,
+      so that concurrent processes never observe a partially written library.
+
+      @exception Exception::InvalidSize if the library has more than 2^32 - 1 transitions
+      @exception Exception::UnableToCreateFile if the file cannot be written
+    */
+    static void store(const String& filename, const OpenSwath::LightTargetedExperiment& exp);
+
+    /**
+      @brief Maps the library stored in @p filename into memory
+
+      The header, the file size and all string offsets and indices stored
+      in the file are validated (in linear time), so the accessors below are
+      safe for any successfully loaded library. On error, the previously
+      loaded library (if any) is kept.
+
+      @exception Exception::FileNotFound if the file does not exist
+      @exception Exception::ParseError if the file is not a valid library
+    */
+    void load(const String& filename);
+
+    /// Returns true if a library is loaded
+    bool isLoaded() const;
+
+    /// Returns the number of transitions in the loaded library
+    Size getNumberOfTransitions() const;
+
+    /// Returns the number of compounds (peptides or metabolites) in the loaded library
+    Size getNumberOfCompounds() const;
+
+    /// Returns the number of proteins in the loaded library
+    Size getNumberOfProteins() const;
+
+    /**
+      @name Direct access to the mapped library
+
+      These accessors read the mapped file without creating any objects.
+      Indices are not checked.
+    */
+    //@{
+    /// Returns the precursor m/z of transition @p index
+    double getPrecursorMZ(Size index) const;
+
+    /// Returns the product m/z of transition @p index
+    double getProductMZ(Size index) const;
+
+    /// Returns the library intensity of transition @p index
+    double getLibraryIntensity(Size index) const;
+
+    /// Returns true if transition @p index is a decoy
+    bool isDecoy(Size index) const;
+
+    /// Returns the name of transition @p index
+    const char* getTransitionName(Size index) const;
+
+    /// Returns the compound reference of transition @p index
+    const char* getPeptideRef(Size index) const;
+
+    /// Returns the identifier of compound @p index
+    const char* getCompoundID(Size index) const;
+
+    /// Returns the retention time of compound @p index
+    double getCompoundRT(Size index) const;
+    //@}
+
+    /// Creates transition @p index
+    void getTransition(Size index, OpenSwath::LightTransition& transition) const;
+
+    /// Creates compound @p index
+    void getCompound(Size index, OpenSwath::LightCompound& compound) const;
+
+    /// Creates protein @p index
+    void getProtein(Size index, OpenSwath::LightProtein& protein) const;
+
+    /// Creates the whole library (any previous content of @p exp is replaced)
+    void getLightTargetedExperiment(OpenSwath::LightTargetedExperiment& exp) const;
+
+    /**
+      @brief Creates the part of the library that belongs to one SWATH window
+
+      Selects all transitions with @p lower < precursor m/z < @p upper that
+      are at least @p min_upper_edge_dist away from the upper edge, together
+      with their compounds and the proteins of these compounds. The result is
+      identical to OpenSwathHelper::selectSwathTransitions() applied to the
+      whole library, but only the selected entries are created. Selected
+      entries are appended to @p exp.
+    */
+    void selectTransitions(double lower, double upper, double min_upper_edge_dist,
+                           OpenSwath::LightTargetedExperiment& exp) const;
+
+protected:
+
+    /// Returns the string at @p offset of the string table
+    const char* getString_(UInt64 offset) const;
+
+    boost::shared_ptr<boost::interprocess::mapped_region> region_;
+
+    Size transition_count_;
+    Size compound_count_;
+    Size protein_count_;
+
+    /// transition columns
+    const double* precursor_mz_;
+    const double* product_mz_;
+    const double* library_intensity_;
+    /// transition name and peptide reference (2 per transition)
+    const UInt64* transition_strings_;
+    const Int32* fragment_charge_;
+    /// transition indices sorted by precursor m/z
+    const UInt32* precursor_order_;
+    const unsigned char* transition_flags_;
+
+    /// compound columns
+    const double* compound_rt_;
+    const Int32* compound_charge_;
+    /// id, sequence, peptide group label, sum formula and compound name (5 per compound)
+    const UInt64* compound_strings_;
+    /// start of the protein references of each compound (compound_count_ + 1 entries)
+    const UInt64* protein_ref_starts_;
+    const UInt64* protein_refs_;
+    /// start of the modifications of each compound (compound_count_ + 1 entries)
+    const UInt64* modification_starts_;
+    const Int32* modification_location_;
+    const UInt64* modification_unimod_id_;
+
+    /// id and sequence (2 per protein)
+    const UInt64* protein_strings_;
+
+    const char* strings_;
+    Size string_bytes_;
+  };
+
+}
+
+#endif // OPENMS_ANALYSIS_OPENSWATH_TRANSITIONBINARYLIBRARY_H
@@ -165,14 +165,96 @@ private:
     */
     void getTSVHeader_(const std::string& line, char& delimiter, std::vector<std::string> header, std::map<std::string, int>& header_dict);
 
+    /**
+      @brief Column indices of a transition list, resolved once from its header
+
+      Optional columns that are not present have the index -1.
+    */
+    struct TSVColumns
+    {
+      /// number of fields every line needs to have
+      Size nr_fields;
+      int precursor;
+      int product;
+      int library_intensity;
+      int transition_name;
+      int group_id;
+      /// RetentionTime or Tr_recalibrated
+      int rt;
+      int spectrast_rt;
+      int spectrast_full_peptide_name;
+      int spectrast_annotation;
+      int compound_name;
+      int sum_formula;
+      int smiles;
+      int annotation;
+      /// CE or CollisionEnergy
+      int CE;
+      int decoy;
+      int detecting_transition;
+      int identifying_transition;
+      int quantifying_transition;
+      int protein_name;
+      int peptide_sequence;
+      /// FullUniModPeptideName or FullPeptideName
+      int full_peptide_name;
+      /// PrecursorCharge or Charge
+      int precursor_charge;
+      int peptide_group_label;
+      int label_type;
+      int uniprot_id;
+      int fragment_type;
+      int fragment_charge;
+      int fragment_nr;
+      int fragment_mzdelta;
+      int fragment_modification;
+    };
+
+    /// State of a (chunk-wise) conversion of transitions to a LightTargetedExperiment
+    struct LightConversionState
+    {
+      std::map<String, int> compound_map;
+      std::map<String, int> protein_map;
+      /// sequence of the first peptide of each peptide label group
+      std::map<String, String> label_sequences;
+      /// group of the last converted transition
+      String last_group_id;
+    };
+
+    /// Resolves the column indices for the fields of @p header_dict
+    void resolveTSVColumns_(const std::map<std::string, int>& header_dict, TSVColumns& columns);
+
+    /** @brief Parses a single line of a transition list
+     *
+     * @param tmp_line The fields of the line (only the first @p nr_fields are used)
+     * @param nr_fields The number of fields of the line
+     * @param columns The column indices
+     * @param mrm Whether the line is from a SpectraST (mrm) file
+     * @param cnt The line number (used for error messages and mrm transition names)
+     * @param mytransition The parsed transition
+     * @param spectrast_legacy Set to true if the retention time is not normalized (SpectraST legacy mode)
+     *
+    */
+    void parseTSVLine_(const std::vector<String>& tmp_line, Size nr_fields, const TSVColumns& columns, bool mrm,
+                       Size cnt, TSVTransition& mytransition, bool& spectrast_legacy);
+
     /** @brief Read tab or comma separated input with columns defined by their column headers only
+     *
+     * The file is memory-mapped and parsed in chunks of lines; the lines of
+     * each chunk are parsed in parallel (except for mrm files).
      *
      * @param filename The input file
      * @param filetype The type of file ("mrm" or "tsv")
      * @param transition_list The output list of transitions
+     * @param light_exp If given, the transitions are converted to @p light_exp
+     *        chunk by chunk instead of being collected in @p transition_list
      *
+     * @exception Exception::FileNotFound if the file does not exist
+     * @exception Exception::FileNotReadable if the file cannot be read
+     * @exception Exception::IllegalArgument if the header or a line is invalid
     */
-    void readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype, std::vector<TSVTransition>& transition_list);
+    void readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype, std::vector<TSVTransition>& transition_list,
+                                   OpenSwath::LightTargetedExperiment* light_exp = 0);
 
     /** @brief Cleanup of the read fields (removing quotes etc.)
     */
@@ -193,8 +275,12 @@ private:
      * LightTargetedExperiment with proper hierarchical structure from
      * Transition to Peptide to Protein.
      *
+     * The list may be a chunk of the file: consecutive chunks are appended to
+     * @p exp, @p state keeps track of the compounds, proteins and peptide
+     * label groups seen so far (see resolveMixedSequenceGroups_).
+     *
     */
-    void TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp);
+    void TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, LightConversionState& state, OpenSwath::LightTargetedExperiment& exp);
 
     /** @name  Conversion functions from TSVTransition objects to TraML datastructures
      *
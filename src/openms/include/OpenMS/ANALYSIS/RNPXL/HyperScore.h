@@ -60,6 +60,15 @@ struct OPENMS_DLLAPI HyperScore
    */
   static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const RichPeakSpectrum& theo_spectrum);
 
+  /* @brief compute the (ln transformed) X!Tandem HyperScore from already accumulated match statistics
+   *
+   * Allows to compute the score for search strategies which do not compare pairs of spectra directly (e.g. fragment ion indices).
+   * @param dot_product sum of the products of matching experimental and theoretical peak intensities
+   * @param b_ion_count number of matching b-ions
+   * @param y_ion_count number of matching y-ions
+   */
+  static double compute(double dot_product, UInt b_ion_count, UInt y_ion_count);
+
   private:
     // helper to compute the log factorial
     static double logfactorial_(UInt x);
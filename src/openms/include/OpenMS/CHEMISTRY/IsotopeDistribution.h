@@ -249,6 +249,12 @@ protected:
     /// convolves the distribution @p input @p factor times and stores the result in @p result
     void convolvePow_(ContainerType & result, const ContainerType & input, Size factor) const;
 
+    /// returns true if the @p n-th convolution power of a (gap-free) distribution with @p input_size entries is cheaper to compute by FFT
+    bool useFFTConvolvePow_(Size input_size, Size n) const;
+
+    /// convolves the (gap-free) distribution @p input @p n times using the FFT and stores the result in @p result
+    void convolvePowFFT_(ContainerType & result, const ContainerType & input, Size n) const;
+
     /// convolves the distribution @p input with itself and stores the result in @p result
     void convolveSquare_(ContainerType & result, const ContainerType & input) const;
 
@@ -0,0 +1,149 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_CHEMISTRY_ISOTOPEPATTERNCACHE_H
+#define OPENMS_CHEMISTRY_ISOTOPEPATTERNCACHE_H
+
+#include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  class Element;
+  class EmpiricalFormula;
+
+  /**
+    @brief Process-wide, thread-safe cache of exact isotope distributions
+
+    Feature finders score millions of isotope pattern hypotheses against
+    theoretical (mostly averagine) isotope distributions, and computing
+    such a distribution requires several convolutions. Since averagine
+    estimates are rounded to integer element counts, the same formulas (and
+    thus distributions) recur over and over again.
+
+    EmpiricalFormula::getIsotopeDistribution() therefore stores every
+    distribution it computes in this cache, keyed by the exact element
+    composition (elements with zero count and the charge are ignored) and
+    the maximal isotope. All IsotopeDistribution::estimateFrom...()
+    functions go through EmpiricalFormula and thus share the cache.
+
+    All member functions may be called concurrently. To avoid any locking
+    on the hot path, every thread has its own cache: lookups and inserts
+    only touch the cache of the calling thread. clear() and setMaxSize()
+    affect the caches of all threads, which are emptied the next time the
+    respective thread accesses its cache.
+
+    The number of cached distributions per thread is bounded (see
+    setMaxSize()); when the bound is reached the cache of that thread is
+    emptied and refilled on demand.
+
+    @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI IsotopePatternCache
+  {
+public:
+
+    /// returns the singleton instance
+    static IsotopePatternCache* getInstance();
+
+    /**
+      @brief Looks up the distribution of @p formula up to @p max_depth
+
+      @return true and the distribution in @p result if it is cached, false otherwise (leaving @p result untouched)
+    */
+    bool lookup(const EmpiricalFormula& formula, UInt max_depth, IsotopeDistribution& result) const;
+
+    /// stores the distribution @p distribution of @p formula up to @p max_depth
+    void insert(const EmpiricalFormula& formula, UInt max_depth, const IsotopeDistribution& distribution);
+
+    /// returns the number of distributions cached for the calling thread
+    Size size() const;
+
+    /// removes all cached distributions (of all threads)
+    void clear();
+
+    /**
+      @brief Sets the maximal number of cached distributions per thread (0 disables caching)
+
+      Removes all cached distributions.
+    */
+    void setMaxSize(Size max_size);
+
+    /// returns the maximal number of cached distributions per thread
+    Size getMaxSize() const;
+
+protected:
+
+    /// (maximal isotope, element composition)
+    typedef std::pair<UInt, std::vector<std::pair<const Element*, SignedSize> > > Key_;
+
+    /// The cache of a single thread
+    struct LocalCache_
+    {
+      /// value of generation_ the cache content belongs to
+      UInt generation;
+      /// key buffer reused for lookups (avoids allocations)
+      Key_ key;
+      boost::unordered_map<Key_, IsotopeDistribution::ContainerType> distributions;
+    };
+
+    IsotopePatternCache();
+
+    ~IsotopePatternCache();
+
+    /// not implemented
+    IsotopePatternCache(const IsotopePatternCache&);
+
+    /// not implemented
+    IsotopePatternCache& operator=(const IsotopePatternCache&);
+
+    /// builds the cache key of @p formula
+    static void makeKey_(const EmpiricalFormula& formula, UInt max_depth, Key_& key);
+
+    /// returns the (up to date) cache of the calling thread
+    LocalCache_& getLocalCache_() const;
+
+    /// incremented whenever all caches have to be emptied
+    volatile UInt generation_;
+
+    volatile Size max_size_;
+  };
+
+}
+
+#endif // OPENMS_CHEMISTRY_ISOTOPEPATTERNCACHE_H
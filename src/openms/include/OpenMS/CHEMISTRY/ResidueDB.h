@@ -57,6 +57,12 @@ namespace OpenMS
       By default no modified residues are stored in an instance. However, if one
       queries the instance with getModifiedResidue, a new modified residue is
       added.
+
+      Since the database is modified by these queries, it must not be used by
+      several threads at the same time, unless it was frozen before (see
+      freeze()): a frozen database contains all modified residues up front and
+      is never modified by queries, so all const member functions and
+      getModifiedResidue() can be called concurrently without locking.
   */
   class OPENMS_DLLAPI ResidueDB
   {
@@ -120,6 +126,26 @@ public:
     */
     const Residue* getModifiedResidue(const Residue* residue, const String& name);
 
+    /**
+       @brief Creates all modified residues and stops getModifiedResidue() from modifying the database
+
+       Modified residues are created for all side chain modifications
+       (ResidueModification::ANYWHERE) of ModificationsDB and all unmodified
+       residues they apply to, and their common names are indexed in a hash table.
+       Afterwards getModifiedResidue() only performs lookups and is thus safe
+       to call from several threads concurrently. Requesting a modified
+       residue which does not exist (e.g. for a residue added later via
+       addResidue()) then throws Exception::IllegalArgument.
+
+       This function itself is not thread-safe; call it before starting
+       threads. It may be called again to include residues added in the
+       meantime. setResidues() unfreezes the database.
+    */
+    void freeze();
+
+    /// returns true if the database is frozen (see freeze())
+    bool isFrozen() const;
+
     /**
        @brief returns a set of all residues stored in this residue db
 
@@ -210,8 +236,20 @@ protected:
 
     void addResidue_(Residue* residue);
 
+    /// returns the modified residue for base residue @p res_name and modification id @p mod_id, or 0 if not created yet (read-only)
+    const Residue* findModifiedResidue_(const String& res_name, const String& mod_id) const;
+
+    /// returns the modified residue for @p residue and @p mod, creating it if necessary (from the unmodified residue with the one letter code of @p residue)
+    const Residue* createModifiedResidue_(const Residue* residue, const ResidueModification& mod);
+
     boost::unordered_map<String, Residue*> residue_names_;
 
+    /// lookup table of a frozen database (base residue name -> modification name -> modified residue)
+    boost::unordered_map<String, boost::unordered_map<String, const Residue*> > frozen_mod_names_;
+
+    /// true if the database is frozen (see freeze())
+    bool frozen_;
+
     // fast lookup table for residues
     Residue* residue_by_one_letter_code_[256];
 
@@ -77,6 +77,40 @@ namespace OpenMS
     /// returns a spectrum with b and y peaks
     virtual void getSpectrum(RichPeakSpectrum & spec, const AASequence & peptide, Int charge = 1) const;
 
+    /**
+      @brief Fast path: computes the sorted m/z values of the fragment ions of @p peptide
+
+      Computes the prefix/suffix residue masses of the peptide once and writes
+      the m/z values of the enabled a-, b-, c-, x-, y- and z-ions of charges 1
+      to @p charge (and, if "add_losses" is set, of their water and ammonia
+      loss ions) in ascending order to @p mzs. Unlike getSpectrum(), no peaks,
+      meta values or intensities are created. Isotope peaks, precursor peaks,
+      immonium ions and residue specific losses other than water and ammonia
+      are not supported.
+
+      The contents of @p mzs are replaced, but its capacity is kept, so that
+      re-using the same vector for many peptides does not allocate memory.
+      Peptides with less than two residues have no fragment ions.
+    */
+    void getFragmentMZs(std::vector<double> & mzs, const AASequence & peptide, Int charge = 1) const;
+
+    /**
+      @brief Fast path: as above, but also stores the ion type of each fragment
+
+      @p ion_types receives the ion letter ('a', 'b', 'c', 'x', 'y' or 'z') of
+      each entry of @p mzs, also for loss ions.
+    */
+    void getFragmentMZs(std::vector<double> & mzs, std::vector<char> & ion_types, const AASequence & peptide, Int charge = 1) const;
+
+    /**
+      @brief Returns the intensity getSpectrum() uses for ions of type @p ion_letter ('a', 'b', 'c', 'x', 'y' or 'z')
+
+      Loss ions and isotope peaks are scaled further by getSpectrum().
+
+      @exception Exception::InvalidValue is thrown for other ion letters
+    */
+    double getIonIntensity(char ion_letter) const;
+
     /// adds peaks to a spectrum of the given ion-type, peptide, charge, and intensity
     virtual void addPeaks(RichPeakSpectrum & spectrum, const AASequence & peptide, Residue::ResidueType res_type, Int charge = 1) const;
 
@@ -101,6 +135,9 @@ namespace OpenMS
       /// helper for mapping residue type to letter
       char residueTypeToIonLetter_(Residue::ResidueType res_type) const;
 
+      /// implementation of getFragmentMZs() (@p ion_types may be 0)
+      void getFragmentMZs_(std::vector<double> & mzs, std::vector<char> * ion_types, const AASequence & peptide, Int charge) const;
+
       /// helper to add full neutral loss ladders
       void addLosses_(RichPeakSpectrum & spectrum, const AASequence & ion, double intensity, Residue::ResidueType res_type, int charge) const;
 
@@ -12,6 +12,7 @@ EnzymaticDigestion.h
 Enzyme.h
 EnzymesDB.h
 IsotopeDistribution.h
+IsotopePatternCache.h
 ModificationDefinition.h
 ModificationDefinitionsSet.h
 ModificationsDB.h
@@ -38,6 +38,7 @@
 #include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
 
 #include <vector>
 
@@ -100,6 +101,24 @@ public:
     /// registers all derived products
     static void registerChildren();
 
+protected:
+
+    /**
+        @brief Lance-Williams update rule of a linkage method
+
+        Returns the distance between the merger of clusters i and j (containing @p size_i and @p size_j elements) and another cluster k, given the distances @p d_ik and @p d_jk.
+    */
+    typedef float (*LinkageUpdate)(float d_ik, float d_jk, Size size_i, Size size_j);
+
+    /**
+        @brief clustering by the nearest-neighbor chain algorithm
+
+        Produces the same hierarchy as the naive algorithm (merging the closest pair of clusters and updating the distances with @p update in each step) in O(n^2) time instead of O(n^3) and without additional memory, provided the linkage is reducible (which holds for single, complete and average linkage).
+        The steps are reported in order of increasing distance. Steps at or above @p threshold are replaced by dummy steps (distance -1) as described in operator().
+        Only the distances to the remaining clusters are kept up-to-date in @p original_distance.
+    */
+    static void nearestNeighborChain_(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold, LinkageUpdate update, const ProgressLogger & progress_logger);
+
   };
 
 }
@@ -68,6 +68,56 @@ private:
     /// the threshold given to the ClusterFunctor
     double threshold_;
 
+    /**
+        @brief Fills the lower triangle of @p distance with 1 - similarity of all pairs in @p data
+
+        Rows are computed in parallel if OpenMP is enabled. Exceptions must not leave the
+        parallel region: rows that failed are computed again serially afterwards, so the
+        original exception of the first failing row is propagated to the caller.
+    */
+    template <typename Data, typename SimilarityComparator>
+    static void fillDistances_(std::vector<Data> & data, const SimilarityComparator & comparator, DistanceMatrix<float> & distance)
+    {
+      std::vector<char> failed(data.size(), false);
+      // rows are independent, but row i holds i elements: schedule dynamically
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)data.size(); i++)
+      {
+        try
+        {
+          fillDistanceRow_(data, comparator, distance, i);
+        }
+        catch (...)
+        {
+          failed[i] = true;
+        }
+      }
+      for (Size i = 0; i < data.size(); ++i)
+      {
+        if (failed[i])
+        {
+          fillDistanceRow_(data, comparator, distance, i);
+        }
+      }
+      if (!data.empty())
+      {
+        distance.updateMinElement();
+      }
+    }
+
+    /// Fills row @p i of the lower triangle of @p distance
+    template <typename Data, typename SimilarityComparator>
+    static void fillDistanceRow_(std::vector<Data> & data, const SimilarityComparator & comparator, DistanceMatrix<float> & distance, SignedSize i)
+    {
+      for (SignedSize j = 0; j < i; j++)
+      {
+        //distance value is 1-similarity value, since similarity is in range of [0,1]
+        distance.setValueQuick(i, j, 1 - comparator(data[i], data[j]));
+      }
+    }
+
 public:
     /// default constructor
     ClusterHierarchical() :
@@ -96,6 +146,8 @@ public:
         for @ref PeakSpectrum with a @ref PeakSpectrumCompareFunctor.
         The similarity functor must provide the similarity calculation with the ()-operator and
         yield normalized values in range of [0,1] for the type of < Data >.
+        If OpenMP is enabled, the pairwise similarities are computed in parallel,
+        so the ()-operator of the functor must be safe to call concurrently.
 
         @param data vector of objects to be clustered
         @param comparator similarity functor fitting for types in data
@@ -112,14 +164,7 @@ public:
         //create distancematrix for data with comparator
         original_distance.clear();
         original_distance.resize(data.size(), 1);
-        for (Size i = 0; i < data.size(); i++)
-        {
-          for (Size j = 0; j < i; j++)
-          {
-            //distance value is 1-similarity value, since similarity is in range of [0,1]
-            original_distance.setValueQuick(i, j, 1 - comparator(data[i], data[j]));
-          }
-        }
+        fillDistances_(data, comparator, original_distance);
       }
 
       //~ std::cout << "done" << std::endl; //maybe progress handler?
@@ -146,28 +191,38 @@ public:
     void cluster(std::vector<PeakSpectrum> & data, const BinnedSpectrumCompareFunctor & comparator, double sz, UInt sp, const ClusterFunctor & clusterer, std::vector<BinaryTreeNode> & cluster_tree, DistanceMatrix<float> & original_distance)
     {
 
-      std::vector<BinnedSpectrum> binned_data;
-      binned_data.reserve(data.size());
+      std::vector<BinnedSpectrum> binned_data(data.size());
 
       //transform each PeakSpectrum to a corresponding BinnedSpectrum with given settings of size and spread
-      for (Size i = 0; i < data.size(); i++)
+      // (exceptions must not leave the parallel region: failed spectra are binned again serially below,
+      // which rethrows the original exception, e.g. NoSpectrumIntegrated for an empty spectrum)
+      std::vector<char> failed(data.size(), false);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (SignedSize i = 0; i < (SignedSize)data.size(); i++)
+      {
+        try
+        {
+          binned_data[i] = BinnedSpectrum(sz, sp, data[i]);
+        }
+        catch (...)
+        {
+          failed[i] = true;
+        }
+      }
+      for (Size i = 0; i < data.size(); ++i)
       {
-        //double sz(2), UInt sp(1);
-        binned_data.push_back(BinnedSpectrum(sz, sp, data[i]));
+        if (failed[i])
+        {
+          binned_data[i] = BinnedSpectrum(sz, sp, data[i]);
+        }
       }
 
       //create distancematrix for data with comparator
       original_distance.clear();
       original_distance.resize(data.size(), 1);
-
-      for (Size i = 0; i < binned_data.size(); i++)
-      {
-        for (Size j = 0; j < i; j++)
-        {
-          //distance value is 1-similarity value, since similarity is in range of [0,1]
-          original_distance.setValue(i, j, 1 - comparator(binned_data[i], binned_data[j]));
-        }
-      }
+      fillDistances_(binned_data, comparator, original_distance);
 
       // create Clustering with ClusterMethod, DistanceMatrix and Data
       clusterer(original_distance, cluster_tree, threshold_);
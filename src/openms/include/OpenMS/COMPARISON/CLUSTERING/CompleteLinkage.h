@@ -80,6 +80,7 @@ public:
     @param threshold float value, the minimal distance from which on cluster merging is considered unrealistic. By default set to 1, i.e. complete clustering until only one cluster remains
     @throw ClusterFunctor::InsufficientInput thrown if input is <2
         The clustering method is complete linkage, where the updated distances after merging two clusters are each the maximal distance between the elements of their clusters. After @p threshold is exceeded, @p cluster_tree is filled with dummy clusteringsteps (children: (0,1), distance:-1) to the root.
+        The hierarchy is computed with the nearest-neighbor chain algorithm in O(n^2) time; steps of equal distance may be reported in a different order than by merging the closest pair of clusters in each step.
     @see ClusterFunctor , BinaryTreeNode
     */
     void operator()(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const;
@@ -90,6 +91,11 @@ public:
     /// get the identifier for this object
     static const String getProductName();
 
+protected:
+
+    /// Lance-Williams update rule of this linkage method
+    static float updateDistance_(float d_ik, float d_jk, Size size_i, Size size_j);
+
   };
 
 }
@@ -89,6 +89,11 @@ public:
 
     /// get the identifier for this object
     static const String getProductName();
+
+protected:
+
+    /// representative (smallest element) of the cluster containing @p i, @p parent holds the union-find forest
+    static Size findRepresentative_(std::vector<Size> & parent, Size i);
   };
 
 
@@ -41,6 +41,7 @@
 #include <OpenMS/CONCEPT/Exception.h>
 
 #include <cmath>
+#include <vector>
 
 namespace OpenMS
 {
@@ -59,6 +60,15 @@ namespace OpenMS
     If the binspread is 1, the peak at 100 Th will be added to bin no. 199, 200 and 201.
     If the binspread is 2, the peak at 100 @p Th will also be added to bin no. 198 and 202, and so on.
 
+    Besides the SparseVector returned by getBins(), the filled bins are kept in
+    a flat array sorted by bin index, and additionally as a dense array of all
+    bins if at least a quarter of the bins is filled. The similarity functors
+    compare spectra on these arrays via computeBinStatistics(), which avoids
+    the per-bin lookups in the SparseVector. Modifying the bins through the
+    mutable accessors (getBins(), begin(), end()) invalidates the flat arrays
+    until updateFlatBins() is called; comparisons stay correct meanwhile, but
+    are slower.
+
     @ingroup SpectraComparison
   */
 
@@ -73,6 +83,20 @@ private:
     SparseVector<float> bins_;
     /// The original raw spectrum
     PeakSpectrum raw_spec_;
+    /// Indices of the filled (i.e. non-zero) bins in ascending order
+    std::vector<UInt> filled_bins_;
+    /// Intensities of the filled bins (corresponding to filled_bins_)
+    std::vector<float> filled_intensities_;
+    /// Intensities of all bins, empty if less than a quarter of the bins is filled
+    std::vector<float> dense_bins_;
+    /// False if bins_ may have been modified via a mutable accessor since the flat arrays were built
+    bool flat_bins_valid_;
+
+    /// Builds the flat arrays from bins_
+    void buildFlatBins_();
+
+    /// Provides the flat arrays of @p spec (copied from bins_ into @p indices and @p intensities if outdated)
+    static void getFlatBins_(const BinnedSpectrum& spec, std::vector<UInt>& indices, std::vector<float>& intensities, const UInt*& index_begin, const float*& intensity_begin, Size& size);
 
 public:
 
@@ -92,6 +116,38 @@ public:
     typedef SparseVector<float>::const_iterator const_bin_iterator;
     typedef SparseVector<float>::iterator bin_iterator;
 
+    /**
+      @brief Statistics over the bins of two spectra, as needed by the binned similarity functors
+
+      Only bins that exist in both spectra (i.e. below the smaller bin number) are considered.
+    */
+    struct OPENMS_DLLAPI BinStatistics
+    {
+      /// sum of the intensities of the first spectrum
+      double sum1;
+      /// sum of the intensities of the second spectrum
+      double sum2;
+      /// sum of the squared intensities of the first spectrum
+      double squared_sum1;
+      /// sum of the squared intensities of the second spectrum
+      double squared_sum2;
+      /// sum of the intensity products of both spectra
+      double dot_product;
+      /// sum of the products of the squared intensities of both spectra
+      double squared_dot_product;
+      /// as dot_product, but only over bins with positive intensity in both spectra
+      double positive_dot_product;
+      /// as squared_dot_product, but only over bins with positive intensity in both spectra
+      double positive_squared_dot_product;
+      /// sum of max(0, (a + b) / 2 - |a - b|) for the intensities a and b of both spectra
+      double agreeing_sum;
+      /// number of bins with positive intensity in both spectra
+      UInt shared_bins;
+
+      /// default constructor (all zero)
+      BinStatistics();
+    };
+
     /// default constructor
     BinnedSpectrum();
 
@@ -109,10 +165,14 @@ public:
     {
       if (&source != this)
       {
-        setBinSize(source.getBinSize());
-        setBinSpread(source.getBinSpread());
-        bins_ = source.getBins();
+        bin_spread_ = source.bin_spread_;
+        bin_size_ = source.bin_size_;
+        bins_ = source.bins_;
         raw_spec_ = source.raw_spec_;
+        filled_bins_ = source.filled_bins_;
+        filled_intensities_ = source.filled_intensities_;
+        dense_bins_ = source.dense_bins_;
+        flat_bins_valid_ = source.flat_bins_valid_;
       }
       return *this;
     }
@@ -179,6 +239,10 @@ public:
     /// get the FilledBinNumber, number of filled Bins
     inline UInt getFilledBinNumber() const
     {
+      if (flat_bins_valid_)
+      {
+        return (UInt) this->filled_bins_.size();
+      }
       return (UInt) this->bins_.nonzero_size();
     }
 
@@ -197,10 +261,13 @@ public:
 
     /** mutable access to the Bincontainer
 
+            Invalidates the flat bin arrays (see updateFlatBins()).
+
             @throw NoSpectrumIntegrated is thrown if no spectrum was integrated
     */
     inline SparseVector<float>& getBins()
     {
+      flat_bins_valid_ = false;
       if (bins_.empty())
       {
         try
@@ -227,15 +294,17 @@ public:
       return bins_.end();
     }
 
-    /// returns the begin iterator of the container
+    /// returns the begin iterator of the container (invalidates the flat bin arrays, see updateFlatBins())
     inline bin_iterator begin()
     {
+      flat_bins_valid_ = false;
       return bins_.begin();
     }
 
-    /// returns the end iterator of the container
+    /// returns the end iterator of the container (invalidates the flat bin arrays, see updateFlatBins())
     inline bin_iterator end()
     {
+      flat_bins_valid_ = false;
       return bins_.end();
     }
 
@@ -292,6 +361,17 @@ public:
 
     /// Gives access to the underlying raw spectrum
     const PeakSpectrum& getRawSpectrum() const;
+
+    /// Rebuilds the flat bin arrays after the bins were modified via getBins() or the mutable iterators
+    void updateFlatBins();
+
+    /**
+      @brief Computes the statistics over the bins of @p spec1 and @p spec2 in one pass
+
+      Uses the dense bin arrays if both spectra have one and merges the sorted filled bins otherwise.
+      The spectra are expected to be compliant (see checkCompliance()).
+    */
+    static BinStatistics computeBinStatistics(const BinnedSpectrum& spec1, const BinnedSpectrum& spec2);
   };
 
 }
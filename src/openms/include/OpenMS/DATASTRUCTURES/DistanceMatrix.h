@@ -41,6 +41,7 @@
 #include <OpenMS/config.h>
 
 #include <algorithm>
+#include <new>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -84,7 +85,7 @@ public:
 
     */
     DistanceMatrix() :
-      matrix_(0), init_size_(0), dimensionsize_(0), min_element_(0, 0)
+      matrix_(0), dimensionsize_(0), min_element_(0, 0)
     {
     }
 
@@ -96,38 +97,11 @@ public:
       @throw Exception::OutOfMemory if requested dimensionsize is to big to fit into memory
     */
     DistanceMatrix(SizeType dimensionsize, Value value = Value()) :
-      matrix_(new ValueType*[dimensionsize]), init_size_(dimensionsize), dimensionsize_(dimensionsize), min_element_(0, 0)
+      matrix_(0), dimensionsize_(0), min_element_(0, 0)
     {
-      matrix_[0] = NULL;
-      SizeType i = 1;
-      for (i = 1; i < dimensionsize; ++i)
-      {
-        matrix_[i] = new ValueType[i];
-        if (matrix_[i] == NULL)
-        {
-          SizeType j = i;
-          for (i = 1; i < j; i++)
-          {
-            delete[] matrix_[i];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          throw Exception::OutOfMemory(__FILE__, __LINE__, __PRETTY_FUNCTION__, (UInt)((((dimensionsize - 2) * (dimensionsize - 1)) / 2) * sizeof(ValueType)));
-        }
-      }
-      if (matrix_ != NULL)
-      {
-        for (i = 1; i < dimensionsize; ++i)
-        {
-          for (SizeType j = 0; j < i; ++j)
-          {
-            matrix_[i][j] = value;
-          }
-        }
-        min_element_ = std::make_pair(1, 0);
-      }
+      allocate_(dimensionsize);
+      std::fill(matrix_, matrix_ + elementCount_(dimensionsize_), value);
+      min_element_ = std::make_pair(1, 0);
     }
 
     /**
@@ -137,47 +111,16 @@ public:
       @throw Exception::OutOfMemory if requested dimensionsize is to big to fit into memory
     */
     DistanceMatrix(const DistanceMatrix& source) :
-      matrix_(new ValueType*[source.dimensionsize_]),
-      init_size_(source.dimensionsize_),
-      dimensionsize_(source.dimensionsize_),
-      min_element_(source.min_element_)
+      matrix_(0), dimensionsize_(0), min_element_(0, 0)
     {
-      matrix_[0] = NULL;
-      SizeType i = 1;
-      for (i = 1; i < dimensionsize_; ++i)
-      {
-        matrix_[i] = new ValueType[i];
-        if (matrix_[i] == NULL)
-        {
-          SizeType j = i;
-          for (i = 1; i < j; i++)
-          {
-            delete[] matrix_[i];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          min_element_ = std::make_pair(0, 0);
-          throw Exception::OutOfMemory(__FILE__, __LINE__, __PRETTY_FUNCTION__, (UInt)((((dimensionsize_ - 2) * (dimensionsize_ - 1)) / 2) * sizeof(ValueType)));
-        }
-      }
-      if (matrix_ != NULL)
-      {
-        for (i = 1; i < dimensionsize_; ++i)
-        {
-          std::copy(source.matrix_[i], source.matrix_[i] + i, matrix_[i]);
-        }
-      }
+      allocate_(source.dimensionsize_);
+      std::copy(source.matrix_, source.matrix_ + elementCount_(dimensionsize_), matrix_);
+      min_element_ = source.min_element_;
     }
 
     /// destructor
     ~DistanceMatrix()
     {
-      for (SizeType i = 1; i < init_size_; i++)
-      {
-        delete[] matrix_[i];
-      }
       delete[] matrix_;
     }
 
@@ -225,7 +168,7 @@ public:
       {
         std::swap(i, j);
       }
-      return (const ValueType)(matrix_[i][j]);
+      return (const ValueType)(element_(i, j));
     }
 
     /**
@@ -250,7 +193,7 @@ public:
       {
         std::swap(i, j);
       }
-      return matrix_[i][j];
+      return element_(i, j);
     }
 
     /**
@@ -276,21 +219,21 @@ public:
         }
         if (i != min_element_.first && j != min_element_.second)
         {
-          matrix_[i][j] = value;
-          if (value < matrix_[min_element_.first][min_element_.second]) // keep min_element_ up-to-date
+          element_(i, j) = value;
+          if (value < element_(min_element_.first, min_element_.second)) // keep min_element_ up-to-date
           {
             min_element_ = std::make_pair(i, j);
           }
         }
         else
         {
-          if (value <= matrix_[min_element_.first][min_element_.second])
+          if (value <= element_(min_element_.first, min_element_.second))
           {
-            matrix_[i][j] = value;
+            element_(i, j) = value;
           }
           else
           {
-            matrix_[i][j] = value;
+            element_(i, j) = value;
             updateMinElement();
           }
         }
@@ -306,6 +249,9 @@ public:
       @throw Exception::OutOfRange if given coordinates are out of range
 
       possible invalidation of min_element_ - make sure to update before further usage of matrix
+
+      Different threads may set different elements concurrently (e.g. when
+      filling the matrix in parallel), since no other state is touched.
     */
     void setValueQuick(SizeType i, SizeType j, ValueType value)
     {
@@ -320,22 +266,17 @@ public:
         {
           std::swap(i, j);
         }
-        matrix_[i][j] = value;
+        element_(i, j) = value;
       }
     }
 
     /// reset all
     void clear()
     {
-      for (SizeType i = 1; i < init_size_; i++)
-      {
-        delete[] matrix_[i];
-      }
       delete[] matrix_;
       matrix_ = NULL;
       min_element_ = std::make_pair(0, 0);
       dimensionsize_ = 0;
-      init_size_ = 0;
     }
 
     /**
@@ -349,42 +290,10 @@ public:
     */
     void resize(SizeType dimensionsize, Value value = Value())
     {
-      for (SizeType j = 1; j < init_size_; j++)
-      {
-        delete[] matrix_[j];
-      }
-      delete[] matrix_;
-      dimensionsize_ = dimensionsize;
-      init_size_ = dimensionsize;
-      min_element_ = std::make_pair(0, 0);
-      matrix_ = new ValueType*[dimensionsize_];
-      for (SizeType j = 1; j < dimensionsize_; ++j)
-      {
-        matrix_[j] = new ValueType[j];
-        if (matrix_[j] == NULL)
-        {
-          for (SizeType k = 1; k < j; ++k)
-          {
-            delete[] matrix_[k];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          throw Exception::OutOfMemory(__FILE__, __LINE__, __PRETTY_FUNCTION__, (UInt)((((dimensionsize_ - 2) * (dimensionsize_ - 1)) / 2) * sizeof(Value)));
-        }
-      }
-      if (matrix_ != NULL)
-      {
-        for (SizeType j = 0; j < dimensionsize; ++j)
-        {
-          for (SizeType k = 0; k < j; ++k)
-          {
-            matrix_[j][k] = value;
-          }
-        }
-        min_element_ = std::make_pair(1, 0);
-      }
+      clear();
+      allocate_(dimensionsize);
+      std::fill(matrix_, matrix_ + elementCount_(dimensionsize_), value);
+      min_element_ = std::make_pair(1, 0);
     }
 
     /**
@@ -401,17 +310,15 @@ public:
       {
         throw Exception::OutOfRange(__FILE__, __LINE__, __PRETTY_FUNCTION__);
       }
-      //delete row j and therefor overwrite with row j+1 and iterate like this to last row
-      SizeType i = j + 1;
-      while (i < dimensionsize_ && matrix_[i] != NULL)
+      // rows before j are unaffected; every following row moves up by one
+      // and loses its jth element. Since the rows are stored consecutively
+      // the target of each copy never lies behind its source.
+      for (SizeType i = j + 1; i < dimensionsize_; ++i)
       {
-        //left out in the copy is each rows jth element, pointer working here as iterators just fine
-        std::copy(matrix_[i] + j + 1, matrix_[i] + i, std::copy(matrix_[i], matrix_[i] + j, matrix_[i - 1]));
-        ++i;
+        ValueType* row = matrix_ + elementCount_(i);
+        std::copy(row + j + 1, row + i, std::copy(row, row + j, matrix_ + elementCount_(i - 1)));
       }
-      //last row is freed and the pointer set to NULL (outer array's size is not changed)
-      delete[] matrix_[i - 1];
-      matrix_[i - 1] = NULL;
+      // the storage is not shrunk
       --dimensionsize_;
     }
 
@@ -437,12 +344,13 @@ public:
       if (dimensionsize_ != 1) //else matrix has one element: (1,0)
       {
         ValueType* row_min_;
-        for (SizeType r = 2; r < dimensionsize_ && matrix_[r] != NULL; ++r)
+        for (SizeType r = 2; r < dimensionsize_; ++r)
         {
-          row_min_ = std::min_element(matrix_[r], matrix_[r] + r);
-          if (*row_min_ < matrix_[min_element_.first][min_element_.second])
+          ValueType* row = matrix_ + elementCount_(r);
+          row_min_ = std::min_element(row, row + r);
+          if (*row_min_ < element_(min_element_.first, min_element_.second))
           {
-            min_element_ = std::make_pair(r, row_min_ - matrix_[r]);
+            min_element_ = std::make_pair(r, row_min_ - row);
           }
         }
       }
@@ -456,17 +364,7 @@ public:
     bool operator==(DistanceMatrix<ValueType> const& rhs) const
     {
       OPENMS_PRECONDITION(dimensionsize_ == rhs.dimensionsize_, "DistanceMatrices have different sizes.");
-      for (Size i = 1; i < rhs.dimensionsize(); ++i)
-      {
-        for (Size j = 0; j < i; ++j)
-        {
-          if (matrix_[i][j] != rhs.matrix_[i][j])
-          {
-            return false;
-          }
-        }
-      }
-      return true;
+      return std::equal(matrix_, matrix_ + elementCount_(rhs.dimensionsize()), rhs.matrix_);
     }
 
     /**
@@ -484,21 +382,53 @@ public:
     }
 
 protected:
-    /// sparse element not to be included in base container
-    ValueType** matrix_;
-    /// number of actually stored rows
-    SizeType init_size_; // actual size of outer array
+    /// elements below the main diagonal, stored row by row (row i has i elements)
+    ValueType* matrix_;
     /// number of accessibly stored rows (i.e. number of columns)
     SizeType dimensionsize_; //number of virtual elements: ((dimensionsize-1)*(dimensionsize))/2
     /// index of minimal element(i.e. number in underlying SparseVector)
     std::pair<SizeType, SizeType> min_element_;
 
+    /// number of stored elements of a matrix with @p dimensionsize rows (equals the offset of row @p dimensionsize)
+    static SizeType elementCount_(SizeType dimensionsize)
+    {
+      return dimensionsize < 2 ? 0 : (dimensionsize * (dimensionsize - 1)) / 2;
+    }
+
+    /// element at row @p i and col @p j (with @p j < @p i)
+    ValueType& element_(SizeType i, SizeType j)
+    {
+      return matrix_[elementCount_(i) + j];
+    }
+
+    /// element at row @p i and col @p j (with @p j < @p i)
+    const ValueType& element_(SizeType i, SizeType j) const
+    {
+      return matrix_[elementCount_(i) + j];
+    }
+
+    /// allocates the (uninitialized) storage for @p dimensionsize rows, expects matrix_ to be empty
+    void allocate_(SizeType dimensionsize)
+    {
+      try
+      {
+        matrix_ = new ValueType[elementCount_(dimensionsize)];
+      }
+      catch (std::bad_alloc&)
+      {
+        matrix_ = NULL;
+        dimensionsize_ = 0;
+        min_element_ = std::make_pair(0, 0);
+        throw Exception::OutOfMemory(__FILE__, __LINE__, __PRETTY_FUNCTION__, (UInt)(elementCount_(dimensionsize) * sizeof(ValueType)));
+      }
+      dimensionsize_ = dimensionsize;
+    }
+
 private:
     /// assignment operator (unsafe)
     DistanceMatrix& operator=(const DistanceMatrix& rhs)
     {
       matrix_ = rhs.matrix_;
-      init_size_ = rhs.init_size_;
       dimensionsize_ = rhs.dimensionsize_;
       min_element_ = rhs.min_element_;
 
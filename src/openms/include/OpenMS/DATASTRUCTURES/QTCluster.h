@@ -43,7 +43,6 @@
 
 #include <boost/unordered_map.hpp>
 
-#include <map> // for multimap<>
 #include <vector> // for vector<>
 #include <set> // for set<>
 #include <utility> // for pair<>
@@ -113,9 +112,21 @@ namespace OpenMS
   {
 private:
 
-    // need to store more than one
-    typedef std::multimap<double, GridFeature*> NeighborListType;
-    typedef OpenMSBoost::unordered_map<Size, NeighborListType> NeighborMapMulti;
+    /// Potential cluster element (with its input map and distance to the center)
+    struct Neighbor_
+    {
+      Size map_index;
+      double distance;
+      GridFeature* feature;
+
+      /// Order by input map, then by distance
+      bool operator<(const Neighbor_& rhs) const
+      {
+        if (map_index != rhs.map_index) return map_index < rhs.map_index;
+        return distance < rhs.distance;
+      }
+    };
+    typedef std::vector<Neighbor_> NeighborListType;
 
     typedef std::pair<double, GridFeature*> NeighborPairType;
     typedef OpenMSBoost::unordered_map<Size, NeighborPairType> NeighborMap;
@@ -130,13 +141,14 @@ private:
     NeighborMap neighbors_;
 
     /**
-     * @brief Temporary map tracking *all* neighbors
+     * @brief Temporary list tracking *all* neighbors
      *
-     * For each input run, a multimap which contains pointers to all
-     * neighboring elements and the respective distance.
+     * Flat list of all neighboring elements of all input runs (in order of
+     * insertion), with the respective distances. Only filled if annotations
+     * need to be collected; cleared when the cluster is finalized.
      *
      */
-    NeighborMapMulti* tmp_neighbors_;
+    NeighborListType tmp_neighbors_;
 
     /// Maximum distance of a point that can still belong to the cluster
     double max_distance_;
@@ -203,7 +215,7 @@ private:
      * the one producing the best cluster.
      *
      * This function needs access to all possible neighbors for this cluster
-     * and thus can only be run when tmp_neighbors_ is filled (which is during
+     * and thus can only be run while tmp_neighbors_ is filled (which is during
      * the filling of a cluster). The function thus cannot be called after
      * finalizing the cluster.
      *
@@ -40,6 +40,8 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <boost/dynamic_bitset.hpp>
+
 namespace OpenMS
 {
 
@@ -65,6 +67,17 @@ namespace OpenMS
     length as well as having the minimal sample rate criterion fulfilled) get
     added to the result.
 
+    Besides the batch mode (run()), spectra can also be processed one at a
+    time (see startStreaming(), consumeSpectrum() and finishStreaming()) so
+    that the whole map never needs to be held in memory. In this mode, only
+    the spectra of a sliding RT window are kept: apices are processed in
+    consecutive chunks of @em chunk:rt_window seconds while mass traces may
+    extend @em chunk:rt_overlap seconds beyond the chunk on either side (the
+    overlap should therefore be larger than the longest expected trace).
+    Since apices are sorted by intensity within each chunk rather than
+    globally, traces close to chunk boundaries may differ slightly from the
+    batch mode.
+
     @htmlinclude OpenMS_MassTraceDetection.parameters
 
     @ingroup Quantitation
@@ -95,6 +108,40 @@ public:
     /// Invokes the run method (see above) on merely a subregion of a @ref MSExperiment map.
     void run(MSExperiment<Peak1D>::ConstAreaIterator & begin, MSExperiment<Peak1D>::ConstAreaIterator & end, std::vector<MassTrace> & found_masstraces);
 
+    /** @name Streaming mode
+    */
+    //@{
+    /// Resets the internal state for a new run in streaming mode
+    void startStreaming();
+
+    /**
+      @brief Adds the next spectrum (in order of increasing RT) in streaming mode
+
+      Spectra with MS level other than 1 are ignored. Mass traces which are
+      completed by this spectrum (if any) are appended to @p completed_masstraces.
+
+      @exception Exception::Precondition if the spectrum has a lower RT than the previous one
+    */
+    void consumeSpectrum(const MSSpectrum<Peak1D>& spectrum, std::vector<MassTrace>& completed_masstraces);
+
+    /**
+      @brief Processes the remaining spectra in streaming mode
+
+      Appends all remaining mass traces to @p completed_masstraces.
+
+      @exception Exception::InvalidValue if less than 3 MS1 spectra were consumed in total
+    */
+    void finishStreaming(std::vector<MassTrace>& completed_masstraces);
+
+    /**
+      @brief RT before which no further mass trace can start (streaming mode)
+
+      All mass traces returned by later calls to consumeSpectrum() or
+      finishStreaming() consist of peaks with RT greater or equal to this value.
+    */
+    double getStreamingBoundary() const;
+    //@}
+
     /** @name Private methods and members 
     */
 protected:
@@ -109,7 +156,13 @@ private:
               const Size peak_count, 
               const MSExperiment<Peak1D> & work_exp,
               const std::vector<Size>& spec_offsets,
-              std::vector<MassTrace> & found_masstraces);
+              std::vector<MassTrace> & found_masstraces,
+              boost::dynamic_bitset<> & peak_visited,
+              Size & trace_number,
+              bool report_progress);
+
+    /// Processes all apices of the streaming window in the RT range [@p rt_begin, @p rt_end) and removes spectra which are no longer needed
+    void processStreamingChunk_(double rt_begin, double rt_end, std::vector<MassTrace>& completed_masstraces);
 
     // parameter stuff
     double mass_error_ppm_;
@@ -124,6 +177,23 @@ private:
     double max_trace_length_;
 
     bool reestimate_mt_sd_;
+
+    double chunk_rt_window_;
+    double chunk_rt_overlap_;
+
+    /// @name Streaming state
+    //@{
+    /// noise-filtered MS1 spectra of the current window
+    MSExperiment<Peak1D> stream_exp_;
+    /// peaks of stream_exp_ already assigned to a mass trace
+    boost::dynamic_bitset<> stream_peak_visited_;
+    /// apices with RT below this value have been processed
+    double stream_chunk_begin_;
+    /// number of MS1 spectra consumed so far
+    Size stream_spectra_count_;
+    /// number of the next mass trace (used for its label)
+    Size stream_trace_number_;
+    //@}
   };
 }
 
@@ -50,9 +50,15 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
+  class MSDataAveragingConsumer;
+
   /**
   @brief Merges blocks of MS or MS2 spectra
 
@@ -287,41 +293,17 @@ public:
     /**
      * @brief average over neighbouring spectra
      *
+     * See MSDataAveragingConsumer for a streaming variant, which holds only
+     * the spectra within the averaging range in memory.
+     *
      * @param exp   experimental data to be averaged
      * @param average_type    averaging type to be used ("gaussian" or "tophat")
      */
     template <typename MapType>
     void average(MapType& exp, String average_type)
     {
-      // MS level to be averaged
-      int ms_level = param_.getValue("average_gaussian:ms_level");
-      if (average_type == "tophat")
-      {
-        ms_level = param_.getValue("average_tophat:ms_level");
-      }
-      
-      // spectrum type (profile, centroid or automatic)
-      String spectrum_type = param_.getValue("average_gaussian:spectrum_type");
-      if (average_type == "tophat")
-      {
-        spectrum_type = param_.getValue("average_tophat:spectrum_type");
-      }
-
-      // parameters for Gaussian averaging
-      double fwhm(param_.getValue("average_gaussian:rt_FWHM"));
-      double factor = -4 * log(2.0) / (fwhm * fwhm); // numerical factor within Gaussian
-      double cutoff(param_.getValue("average_gaussian:cutoff"));
-
-      // parameters for Top-Hat averaging
-      bool unit(param_.getValue("average_tophat:rt_unit") == "scans"); // true if RT unit is 'scans', false if RT unit is 'seconds'
-      double range(param_.getValue("average_tophat:rt_range")); // range of spectra to be averaged over
-      double range_seconds = range / 2; // max. +/- <range_seconds> seconds from master spectrum
-      int range_scans = range;
-      if ((range_scans % 2) == 0)
-      {
-        ++range_scans;
-      }
-      range_scans = (range_scans - 1) / 2; // max. +/- <range_scans> scans from master spectrum
+      AveragingSettings_ settings = getAveragingSettings_(average_type);
+      int ms_level = settings.ms_level; // MS level to be averaged
 
       AverageBlocks spectra_to_average_over;
 
@@ -345,30 +327,11 @@ public:
           {
             if (Int(it_rt_2->getMSLevel()) == ms_level)
             {
-              double weight = 1;
-              if (average_type == "gaussian")
-              {
-                weight = std::exp(factor * pow(it_rt_2->getRT() - it_rt->getRT(), 2));
-              }
-              std::pair<Size, double> p(m, weight);
+              std::pair<Size, double> p(m, averagingWeight_(settings, it_rt->getRT(), it_rt_2->getRT()));
               spectra_to_average_over[n].push_back(p);
               ++steps;
             }
-            if (average_type == "gaussian")
-            {
-              // Gaussian
-              terminate_now = std::exp(factor * pow(it_rt_2->getRT() - it_rt->getRT(), 2)) < cutoff;
-            }
-            else if (unit)
-            {
-              // Top-Hat with RT unit = scans
-              terminate_now = (steps > range_scans);
-            }
-            else
-            {
-              // Top-Hat with RT unit = seconds
-              terminate_now = (std::abs(it_rt_2->getRT() - it_rt->getRT()) > range_seconds);
-            }
+            terminate_now = averagingTerminates_(settings, it_rt->getRT(), it_rt_2->getRT(), steps);
             ++m;
             ++it_rt_2;
           }
@@ -382,30 +345,11 @@ public:
           {
             if (Int(it_rt_2->getMSLevel()) == ms_level)
             {
-              double weight = 1;
-              if (average_type == "gaussian")
-              {
-                weight = std::exp(factor * pow(it_rt_2->getRT() - it_rt->getRT(), 2));
-              }
-              std::pair<Size, double> p(m, weight);
+              std::pair<Size, double> p(m, averagingWeight_(settings, it_rt->getRT(), it_rt_2->getRT()));
               spectra_to_average_over[n].push_back(p);
               ++steps;
             }
-            if (average_type == "gaussian")
-            {
-              // Gaussian
-              terminate_now = std::exp(factor * pow(it_rt_2->getRT() - it_rt->getRT(), 2)) < cutoff;
-            }
-            else if (unit)
-            {
-              // Top-Hat with RT unit = scans
-              terminate_now = (steps > range_scans);
-            }
-            else
-            {
-              // Top-Hat with RT unit = seconds
-              terminate_now = (std::abs(it_rt_2->getRT() - it_rt->getRT()) > range_seconds);
-            }
+            terminate_now = averagingTerminates_(settings, it_rt->getRT(), it_rt_2->getRT(), steps);
             --m;
             --it_rt_2;
           }
@@ -417,37 +361,12 @@ public:
       // normalize weights
       for (AverageBlocks::Iterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
       {
-        double sum(0.0);
-        for (std::vector<std::pair<Size, double> >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
-        {
-          sum += it2->second;
-        }
-
-        for (std::vector<std::pair<Size, double> >::iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
-        {
-          (*it2).second /= sum;
-        }
+        normalizeAveragingWeights_(it->second);
       }
 
       // determine type of spectral data (profile or centroided)
-      SpectrumSettings::SpectrumType type;
-      if (spectrum_type == "automatic")
-      {
-        Size idx = spectra_to_average_over.begin()->first; // index of first spectrum to be averaged
-        type = exp[idx].getType();
-        if (type == SpectrumSettings::UNKNOWN)
-        {
-          type = PeakTypeEstimator().estimateType(exp[idx].begin(), exp[idx].end());
-        }
-      }
-      else if (spectrum_type == "profile")
-      {
-        type = SpectrumSettings::RAWDATA;
-      }
-      else if (spectrum_type == "centroid")
-      {
-        type = SpectrumSettings::PEAKS;
-      }
+      Size idx = spectra_to_average_over.begin()->first; // index of first spectrum to be averaged
+      SpectrumSettings::SpectrumType type = averagingSpectrumType_(settings, exp[idx]);
 
       // generate new spectra
       if (type == SpectrumSettings::PEAKS)
@@ -468,6 +387,65 @@ public:
 
 protected:
 
+    friend class MSDataAveragingConsumer;
+
+    /// settings of the RT averaging, shared by average() and MSDataAveragingConsumer
+    struct AveragingSettings_
+    {
+      /// MS level to be averaged
+      int ms_level;
+      /// spectrum type (profile, centroid or automatic)
+      String spectrum_type;
+      /// Gaussian (true) or Top-Hat (false) averaging
+      bool gaussian;
+      /// numerical factor within Gaussian
+      double factor;
+      /// cutoff of the Gaussian
+      double cutoff;
+      /// true if the Top-Hat RT unit is 'scans', false if it is 'seconds'
+      bool unit;
+      /// max. +/- <range_seconds> seconds from master spectrum
+      double range_seconds;
+      /// max. +/- <range_scans> scans from master spectrum
+      int range_scans;
+    };
+
+    /// extracts the averaging settings of @p average_type ("gaussian" or "tophat") from the parameters
+    AveragingSettings_ getAveragingSettings_(const String& average_type) const;
+
+    /// weight of a spectrum at @p rt in the average of the master spectrum at @p rt_master
+    static double averagingWeight_(const AveragingSettings_& settings, double rt_master, double rt);
+
+    /// true if the search for spectra to average over stops at @p rt (after @p steps spectra of the MS level)
+    static bool averagingTerminates_(const AveragingSettings_& settings, double rt_master, double rt, int steps);
+
+    /// normalizes the weights of a block to a sum of one
+    static void normalizeAveragingWeights_(std::vector<std::pair<Size, double> >& block);
+
+    /// determines the type (profile or centroided) of the spectral data to be averaged, using @p spec for "automatic"
+    template <typename SpectrumType>
+    static SpectrumSettings::SpectrumType averagingSpectrumType_(const AveragingSettings_& settings, const SpectrumType& spec)
+    {
+      SpectrumSettings::SpectrumType type = SpectrumSettings::UNKNOWN;
+      if (settings.spectrum_type == "automatic")
+      {
+        type = spec.getType();
+        if (type == SpectrumSettings::UNKNOWN)
+        {
+          type = PeakTypeEstimator().estimateType(spec.begin(), spec.end());
+        }
+      }
+      else if (settings.spectrum_type == "profile")
+      {
+        type = SpectrumSettings::RAWDATA;
+      }
+      else if (settings.spectrum_type == "centroid")
+      {
+        type = SpectrumSettings::PEAKS;
+      }
+      return type;
+    }
+
     /**
         @brief merges blocks of spectra of a certain level
 
@@ -477,6 +455,9 @@ protected:
         All spectra with other MS levels remain untouched.
         The resulting map is NOT sorted!
 
+        Blocks are merged in parallel (if OpenMP is enabled); the consensus
+        spectra are added in block order, i.e. the result does not depend on
+        the number of threads.
     */
     template <typename MapType>
     void mergeSpectra_(MapType& exp, const MergeBlocks& spectra_to_merge, const UInt ms_level)
@@ -484,9 +465,6 @@ protected:
       double mz_binning_width(param_.getValue("mz_binning_width"));
       String mz_binning_unit(param_.getValue("mz_binning_width_unit"));
 
-      // merge spectra
-      MapType merged_spectra;
-
       Map<Size, Size> cluster_sizes;
       std::set<Size> merged_indices;
 
@@ -498,24 +476,39 @@ protected:
       // TODO : SpectrumAlignment does not implement is_relative_tolerance
       p.setValue("is_relative_tolerance", mz_binning_unit == "Da" ? "false" : "true");
       sas.setParameters(p);
-      std::vector<std::pair<Size, Size> > alignment;
 
+      // blocks are independent of each other - collect them for indexed (parallel) access
+      std::vector<MergeBlocks::ConstIterator> blocks;
+      for (MergeBlocks::ConstIterator it = spectra_to_merge.begin(); it != spectra_to_merge.end(); ++it)
+      {
+        blocks.push_back(it);
+        ++cluster_sizes[it->second.size() + 1]; // for stats
+        merged_indices.insert(it->first);
+        merged_indices.insert(it->second.begin(), it->second.end());
+      }
+
+      std::vector<typename MapType::SpectrumType> consensus_spectra(blocks.size());
       Size count_peaks_aligned(0);
       Size count_peaks_overall(0);
+      String error;
 
       // each BLOCK
-      for (Map<Size, std::vector<Size> >::ConstIterator it = spectra_to_merge.begin(); it != spectra_to_merge.end(); ++it)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+: count_peaks_aligned, count_peaks_overall)
+#endif
+      for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
       {
+        const Size master_index = blocks[b]->first;
+        const std::vector<Size>& block = blocks[b]->second;
+        typename MapType::SpectrumType& consensus_spec = consensus_spectra[b];
+        std::vector<std::pair<Size, Size> > alignment;
 
-        ++cluster_sizes[it->second.size() + 1]; // for stats
-
-        typename MapType::SpectrumType consensus_spec = exp[it->first];
+        consensus_spec = exp[master_index];
         consensus_spec.setMSLevel(ms_level);
 
-        //consensus_spec.unify(exp[it->first]); // append meta info
-        merged_indices.insert(it->first);
+        //consensus_spec.unify(exp[master_index]); // append meta info
 
-        //typename MapType::SpectrumType all_peaks = exp[it->first];
+        //typename MapType::SpectrumType all_peaks = exp[master_index];
         double rt_average = consensus_spec.getRT();
         double precursor_mz_average = 0.0;
         Size precursor_count(0);
@@ -527,50 +520,60 @@ protected:
 
         count_peaks_overall += consensus_spec.size();
 
-        // block elements
-        for (std::vector<Size>::const_iterator sit = it->second.begin(); sit != it->second.end(); ++sit)
+        try
         {
-          consensus_spec.unify(exp[*sit]); // append meta info
-          merged_indices.insert(*sit);
-
-          rt_average += exp[*sit].getRT();
-          if (ms_level >= 2 && exp[*sit].getPrecursors().size() > 0)
+          // block elements
+          for (std::vector<Size>::const_iterator sit = block.begin(); sit != block.end(); ++sit)
           {
-            precursor_mz_average += exp[*sit].getPrecursors()[0].getMZ();
-            ++precursor_count;
-          }
+            consensus_spec.unify(exp[*sit]); // append meta info
 
-          // merge data points
-          sas.getSpectrumAlignment(alignment, consensus_spec, exp[*sit]);
-          //std::cerr << "alignment of " << it->first << " with " << *sit << " yielded " << alignment.size() << " common peaks!\n";
-          count_peaks_aligned += alignment.size();
-          count_peaks_overall += exp[*sit].size();
-
-          Size align_index(0);
-          Size spec_b_index(0);
-
-          // sanity check for number of peaks
-          Size spec_a = consensus_spec.size(), spec_b = exp[*sit].size(), align_size = alignment.size();
-          for (typename MapType::SpectrumType::ConstIterator pit = exp[*sit].begin(); pit != exp[*sit].end(); ++pit)
-          {
-            // either add aligned peak height to existing peak
-            if (alignment.size() > 0 && alignment[align_index].second == spec_b_index)
+            rt_average += exp[*sit].getRT();
+            if (ms_level >= 2 && exp[*sit].getPrecursors().size() > 0)
             {
-              consensus_spec[alignment[align_index].first].setIntensity(consensus_spec[alignment[align_index].first].getIntensity() +
-                                                                        pit->getIntensity());
-              ++align_index; // this aligned peak was explained, wait for next aligned peak ...
-              if (align_index == alignment.size()) alignment.clear();  // end reached -> avoid going into this block again
+              precursor_mz_average += exp[*sit].getPrecursors()[0].getMZ();
+              ++precursor_count;
             }
-            else // ... or add unaligned peak
+
+            // merge data points
+            sas.getSpectrumAlignment(alignment, consensus_spec, exp[*sit]);
+            //std::cerr << "alignment of " << master_index << " with " << *sit << " yielded " << alignment.size() << " common peaks!\n";
+            count_peaks_aligned += alignment.size();
+            count_peaks_overall += exp[*sit].size();
+
+            Size align_index(0);
+            Size spec_b_index(0);
+
+            // sanity check for number of peaks
+            Size spec_a = consensus_spec.size(), spec_b = exp[*sit].size(), align_size = alignment.size();
+            for (typename MapType::SpectrumType::ConstIterator pit = exp[*sit].begin(); pit != exp[*sit].end(); ++pit)
             {
-              consensus_spec.push_back(*pit);
+              // either add aligned peak height to existing peak
+              if (alignment.size() > 0 && alignment[align_index].second == spec_b_index)
+              {
+                consensus_spec[alignment[align_index].first].setIntensity(consensus_spec[alignment[align_index].first].getIntensity() +
+                                                                          pit->getIntensity());
+                ++align_index; // this aligned peak was explained, wait for next aligned peak ...
+                if (align_index == alignment.size()) alignment.clear();  // end reached -> avoid going into this block again
+              }
+              else // ... or add unaligned peak
+              {
+                consensus_spec.push_back(*pit);
+              }
+              ++spec_b_index;
             }
-            ++spec_b_index;
+            consensus_spec.sortByPosition(); // sort, otherwise next alignment will fail
+            if (spec_a + spec_b - align_size != consensus_spec.size()) std::cerr << "\n\n ERRROR \n\n";
           }
-          consensus_spec.sortByPosition(); // sort, otherwise next alignment will fail
-          if (spec_a + spec_b - align_size != consensus_spec.size()) std::cerr << "\n\n ERRROR \n\n";
         }
-        rt_average /= it->second.size() + 1;
+        catch (Exception::BaseException& e)
+        {
+          // exceptions must not leave the parallel region - rethrown below
+#ifdef _OPENMP
+#pragma omp critical (OPENMS_SpectraMerger_error)
+#endif
+          if (error.empty()) error = e.what();
+        }
+        rt_average /= block.size() + 1;
         consensus_spec.setRT(rt_average);
 
         if (ms_level >= 2)
@@ -582,11 +585,22 @@ protected:
           pcs[0].setMZ(precursor_mz_average);
           consensus_spec.setPrecursors(pcs);
         }
+      }
 
-        if (consensus_spec.empty()) continue;
-        else merged_spectra.addSpectrum(consensus_spec);
+      if (!error.empty())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__, error);
       }
 
+      // merge spectra
+      MapType merged_spectra;
+      for (Size b = 0; b < consensus_spectra.size(); ++b)
+      {
+        if (consensus_spectra[b].empty()) continue;
+        else merged_spectra.addSpectrum(consensus_spectra[b]);
+      }
+      consensus_spectra.clear();
+
       LOG_INFO << "Cluster sizes:\n";
       for (Map<Size, Size>::const_iterator it = cluster_sizes.begin(); it != cluster_sizes.end(); ++it)
       {
@@ -638,6 +652,9 @@ protected:
      * original spectra. The exact m/z position is not crucial, since not the
      * original intensities but the spline-interpolated intensities are used.
      *
+     * Blocks are averaged in parallel (if OpenMP is enabled), always from the
+     * original spectra.
+     *
      * @param exp   experimental data to be averaged
      * @param spectra_to_average_over    mapping of spectral index to set of spectra to average over with corresponding weights
      * @param ms_level    MS level of spectra to be averaged
@@ -645,99 +662,136 @@ protected:
     template <typename MapType>
     void averageProfileSpectra_(MapType& exp, const AverageBlocks& spectra_to_average_over, const UInt ms_level)
     {
-      MapType exp_tmp; // temporary experiment for averaged spectra
-
       double mz_binning_width(param_.getValue("mz_binning_width"));
       String mz_binning_unit(param_.getValue("mz_binning_width_unit"));
 
-      unsigned progress = 0;
+      std::vector<AverageBlocks::ConstIterator> blocks;
+      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+      {
+        blocks.push_back(it);
+      }
+      std::vector<typename MapType::SpectrumType> average_spectra(blocks.size()); // averaged spectra (in block order)
+      String error;
+
+      Size progress = 0;
       std::stringstream progress_message;
       progress_message << "averaging profile spectra of MS level " << ms_level;
       startProgress(0, spectra_to_average_over.size(), progress_message.str());
 
       // loop over blocks
-      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
       {
-        setProgress(++progress);
+        IF_MASTERTHREAD setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
 
-        // loop over spectra in blocks
-        std::vector<double> mz_positions_all; // m/z positions from all spectra
-        for (std::vector<std::pair<Size, double> >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+        try
         {
-          // loop over m/z positions
-          for (typename MapType::SpectrumType::ConstIterator it_mz = exp[it2->first].begin(); it_mz < exp[it2->first].end(); ++it_mz)
-          {
-            mz_positions_all.push_back(it_mz->getMZ());
-          }
+          average_spectra[b] = exp[blocks[b]->first];
+          averageProfileBlock_(exp, blocks[b]->second, mz_binning_width, mz_binning_unit, average_spectra[b]);
+        }
+        catch (Exception::BaseException& e)
+        {
+          // exceptions must not leave the parallel region - rethrown below
+#ifdef _OPENMP
+#pragma omp critical (OPENMS_SpectraMerger_error)
+#endif
+          if (error.empty()) error = e.what();
         }
+      }
+
+      endProgress();
 
-        sort(mz_positions_all.begin(), mz_positions_all.end());
+      if (!error.empty())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__, error);
+      }
 
-        std::vector<double> mz_positions; // positions at which the averaged spectrum should be evaluated
-        std::vector<double> intensities;
-        double last_mz = std::numeric_limits<double>::min(); // last m/z position pushed through from mz_position to mz_position_2
-        double delta_mz(mz_binning_width); // for m/z unit Da
-        for (std::vector<double>::iterator it_mz = mz_positions_all.begin(); it_mz < mz_positions_all.end(); ++it_mz)
-        {
-          if (mz_binning_unit == "ppm")
-          {
-            delta_mz = mz_binning_width * (*it_mz) / 1000000;
-          }
+      // loop over blocks
+      for (Size b = 0; b < blocks.size(); ++b)
+      {
+        exp[blocks[b]->first] = average_spectra[b];
+      }
 
-          if (((*it_mz) - last_mz) > delta_mz)
-          {
-            mz_positions.push_back(*it_mz);
-            intensities.push_back(0.0);
-            last_mz = *it_mz;
-          }
+    }
+
+    /**
+     * @brief averages one block of profile spectra (see averageProfileSpectra_())
+     *
+     * @param spectra   spectra to be averaged (indexed by the block)
+     * @param block    indices of the spectra to average over with corresponding weights
+     * @param mz_binning_width    minimum m/z distance of two data points
+     * @param mz_binning_unit    unit of @p mz_binning_width ("Da" or "ppm")
+     * @param average_spec    master spectrum of the block, replaced by its average (meta data is kept)
+     */
+    template <typename SpectraType, typename SpectrumType>
+    static void averageProfileBlock_(SpectraType& spectra, const std::vector<std::pair<Size, double> >& block, double mz_binning_width, const String& mz_binning_unit, SpectrumType& average_spec)
+    {
+      // loop over spectra in blocks
+      std::vector<double> mz_positions_all; // m/z positions from all spectra
+      for (std::vector<std::pair<Size, double> >::const_iterator it2 = block.begin(); it2 != block.end(); ++it2)
+      {
+        // loop over m/z positions
+        for (typename SpectrumType::ConstIterator it_mz = spectra[it2->first].begin(); it_mz < spectra[it2->first].end(); ++it_mz)
+        {
+          mz_positions_all.push_back(it_mz->getMZ());
         }
+      }
+
+      sort(mz_positions_all.begin(), mz_positions_all.end());
 
-        // loop over spectra in blocks
-        for (std::vector<std::pair<Size, double> >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+      std::vector<double> mz_positions; // positions at which the averaged spectrum should be evaluated
+      std::vector<double> intensities;
+      double last_mz = std::numeric_limits<double>::min(); // last m/z position pushed through from mz_position to mz_position_2
+      double delta_mz(mz_binning_width); // for m/z unit Da
+      for (std::vector<double>::iterator it_mz = mz_positions_all.begin(); it_mz < mz_positions_all.end(); ++it_mz)
+      {
+        if (mz_binning_unit == "ppm")
         {
-          SplineSpectrum spline(exp[it2->first]);
-          SplineSpectrum::Navigator nav = spline.getNavigator();
+          delta_mz = mz_binning_width * (*it_mz) / 1000000;
+        }
 
-          // loop over m/z positions
-          for (Size i = 0; i < mz_positions.size(); ++i)
-          {
-            if ((spline.getMzMin() < mz_positions[i]) && (mz_positions[i] < spline.getMzMax()))
-            {
-              intensities[i] += nav.eval(mz_positions[i]) * (it2->second); // spline-interpolated intensity * weight
-            }
-          }
+        if (((*it_mz) - last_mz) > delta_mz)
+        {
+          mz_positions.push_back(*it_mz);
+          intensities.push_back(0.0);
+          last_mz = *it_mz;
         }
+      }
 
-        // update spectrum
-        typename MapType::SpectrumType average_spec = exp[it->first];
-        average_spec.clear(false); // Precursors are part of the meta data, which are not deleted.
-        //average_spec.setMSLevel(ms_level);
+      // loop over spectra in blocks
+      for (std::vector<std::pair<Size, double> >::const_iterator it2 = block.begin(); it2 != block.end(); ++it2)
+      {
+        SplineSpectrum spline(spectra[it2->first]);
+        SplineSpectrum::Navigator nav = spline.getNavigator();
 
-        // refill spectrum
+        // loop over m/z positions
         for (Size i = 0; i < mz_positions.size(); ++i)
         {
-          typename MapType::PeakType peak;
-          peak.setMZ(mz_positions[i]);
-          peak.setIntensity(intensities[i]);
-          average_spec.push_back(peak);
+          if ((spline.getMzMin() < mz_positions[i]) && (mz_positions[i] < spline.getMzMax()))
+          {
+            intensities[i] += nav.eval(mz_positions[i]) * (it2->second); // spline-interpolated intensity * weight
+          }
         }
-
-        // store spectrum temporarily
-        exp_tmp.addSpectrum(average_spec);
       }
 
-      endProgress();
+      // update spectrum
+      average_spec.clear(false); // Precursors are part of the meta data, which are not deleted.
+      //average_spec.setMSLevel(ms_level);
 
-      // loop over blocks
-      int n(0);
-      //typename MapType::SpectrumType empty_spec;
-      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+      // refill spectrum
+      for (Size i = 0; i < mz_positions.size(); ++i)
       {
-        exp[it->first] = exp_tmp[n];
-        //exp_tmp[n] = empty_spec;
-        ++n;
+        typename SpectrumType::PeakType peak;
+        peak.setMZ(mz_positions[i]);
+        peak.setIntensity(intensities[i]);
+        average_spec.push_back(peak);
       }
-
     }
 
     /**
@@ -751,6 +805,9 @@ protected:
      * (2) m/z positions closer than mz_binning_width are combined to a single
      *     peak. The m/z are averaged and the corresponding intensities summed.
      *
+     * Blocks are averaged in parallel (if OpenMP is enabled), always from the
+     * original spectra.
+     *
      * @param exp   experimental data to be averaged
      * @param spectra_to_average_over    mapping of spectral index to set of spectra to average over with corresponding weights
      * @param ms_level    MS level of spectra to be averaged
@@ -758,103 +815,124 @@ protected:
     template <typename MapType>
     void averageCentroidSpectra_(MapType& exp, const AverageBlocks& spectra_to_average_over, const UInt ms_level)
     {
-      MapType exp_tmp; // temporary experiment for averaged spectra
-
       double mz_binning_width(param_.getValue("mz_binning_width"));
       String mz_binning_unit(param_.getValue("mz_binning_width_unit"));
 
-      unsigned progress = 0;
+      std::vector<AverageBlocks::ConstIterator> blocks;
+      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+      {
+        blocks.push_back(it);
+      }
+      std::vector<typename MapType::SpectrumType> average_spectra(blocks.size()); // averaged spectra (in block order)
+
+      Size progress = 0;
       ProgressLogger logger;
       std::stringstream progress_message;
       progress_message << "averaging centroid spectra of MS level " << ms_level;
       logger.startProgress(0, spectra_to_average_over.size(), progress_message.str());
 
       // loop over blocks
-      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
       {
-        logger.setProgress(++progress);
-
-        // collect peaks from all spectra
-        // loop over spectra in blocks
-        std::vector<std::pair<double, double> > mz_intensity_all; // m/z positions and peak intensities from all spectra
-        for (std::vector<std::pair<Size, double> >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
-        {
-          // loop over m/z positions
-          for (typename MapType::SpectrumType::ConstIterator it_mz = exp[it2->first].begin(); it_mz < exp[it2->first].end(); ++it_mz)
-          {
-            std::pair<double, double> mz_intensity(it_mz->getMZ(), (it_mz->getIntensity() * it2->second)); // m/z, intensity * weight
-            mz_intensity_all.push_back(mz_intensity);
-          }
-        }
+        IF_MASTERTHREAD logger.setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
+
+        average_spectra[b] = exp[blocks[b]->first];
+        averageCentroidBlock_(exp, blocks[b]->second, mz_binning_width, mz_binning_unit, average_spectra[b]);
+      }
 
-        sort(mz_intensity_all.begin(), mz_intensity_all.end(), SpectraMerger::compareByFirst);
-
-        // generate new spectrum
-        std::vector<double> mz_new;
-        std::vector<double> intensity_new;
-        double last_mz = std::numeric_limits<double>::min();
-        double delta_mz = mz_binning_width;
-        double sum_mz(0);
-        double sum_intensity(0);
-        Size count(0);
-        for (std::vector<std::pair<double, double> >::const_iterator it_mz = mz_intensity_all.begin(); it_mz != mz_intensity_all.end(); ++it_mz)
-        {
-          if (mz_binning_unit == "ppm")
-          {
-            delta_mz = mz_binning_width * (it_mz->first) / 1000000;
-          }
+      logger.endProgress();
 
-          if (((it_mz->first - last_mz) > delta_mz) && (count > 0))
-          {
-            mz_new.push_back(sum_mz / count);
-            intensity_new.push_back(sum_intensity); // intensities already weighted
+      // loop over blocks
+      for (Size b = 0; b < blocks.size(); ++b)
+      {
+        exp[blocks[b]->first] = average_spectra[b];
+      }
 
-            sum_mz = 0;
-            sum_intensity = 0;
+    }
 
-            last_mz = it_mz->first;
-            count = 0;
-          }
+    /**
+     * @brief averages one block of centroided spectra (see averageCentroidSpectra_())
+     *
+     * @param spectra   spectra to be averaged (indexed by the block)
+     * @param block    indices of the spectra to average over with corresponding weights
+     * @param mz_binning_width    minimum m/z distance of two peaks
+     * @param mz_binning_unit    unit of @p mz_binning_width ("Da" or "ppm")
+     * @param average_spec    master spectrum of the block, replaced by its average (meta data is kept)
+     */
+    template <typename SpectraType, typename SpectrumType>
+    static void averageCentroidBlock_(SpectraType& spectra, const std::vector<std::pair<Size, double> >& block, double mz_binning_width, const String& mz_binning_unit, SpectrumType& average_spec)
+    {
+      // collect peaks from all spectra
+      // loop over spectra in blocks
+      std::vector<std::pair<double, double> > mz_intensity_all; // m/z positions and peak intensities from all spectra
+      for (std::vector<std::pair<Size, double> >::const_iterator it2 = block.begin(); it2 != block.end(); ++it2)
+      {
+        // loop over m/z positions
+        for (typename SpectrumType::ConstIterator it_mz = spectra[it2->first].begin(); it_mz < spectra[it2->first].end(); ++it_mz)
+        {
+          std::pair<double, double> mz_intensity(it_mz->getMZ(), (it_mz->getIntensity() * it2->second)); // m/z, intensity * weight
+          mz_intensity_all.push_back(mz_intensity);
+        }
+      }
 
-          sum_mz += it_mz->first;
-          sum_intensity += it_mz->second;
-          ++count;
+      sort(mz_intensity_all.begin(), mz_intensity_all.end(), SpectraMerger::compareByFirst);
+
+      // generate new spectrum
+      std::vector<double> mz_new;
+      std::vector<double> intensity_new;
+      double last_mz = std::numeric_limits<double>::min();
+      double delta_mz = mz_binning_width;
+      double sum_mz(0);
+      double sum_intensity(0);
+      Size count(0);
+      for (std::vector<std::pair<double, double> >::const_iterator it_mz = mz_intensity_all.begin(); it_mz != mz_intensity_all.end(); ++it_mz)
+      {
+        if (mz_binning_unit == "ppm")
+        {
+          delta_mz = mz_binning_width * (it_mz->first) / 1000000;
         }
-        if (count > 0)
+
+        if (((it_mz->first - last_mz) > delta_mz) && (count > 0))
         {
           mz_new.push_back(sum_mz / count);
           intensity_new.push_back(sum_intensity); // intensities already weighted
-        }
 
-        // update spectrum
-        typename MapType::SpectrumType average_spec = exp[it->first];
-        average_spec.clear(false); // Precursors are part of the meta data, which are not deleted.
-        //average_spec.setMSLevel(ms_level);
+          sum_mz = 0;
+          sum_intensity = 0;
 
-        // refill spectrum
-        for (Size i = 0; i < mz_new.size(); ++i)
-        {
-          typename MapType::PeakType peak;
-          peak.setMZ(mz_new[i]);
-          peak.setIntensity(intensity_new[i]);
-          average_spec.push_back(peak);
+          last_mz = it_mz->first;
+          count = 0;
         }
 
-        // store spectrum temporarily
-        exp_tmp.addSpectrum(average_spec);
-
+        sum_mz += it_mz->first;
+        sum_intensity += it_mz->second;
+        ++count;
+      }
+      if (count > 0)
+      {
+        mz_new.push_back(sum_mz / count);
+        intensity_new.push_back(sum_intensity); // intensities already weighted
       }
 
-      logger.endProgress();
+      // update spectrum
+      average_spec.clear(false); // Precursors are part of the meta data, which are not deleted.
+      //average_spec.setMSLevel(ms_level);
 
-      // loop over blocks
-      int n(0);
-      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+      // refill spectrum
+      for (Size i = 0; i < mz_new.size(); ++i)
       {
-        exp[it->first] = exp_tmp[n];
-        ++n;
+        typename SpectrumType::PeakType peak;
+        peak.setMZ(mz_new[i]);
+        peak.setIntensity(intensity_new[i]);
+        average_spec.push_back(peak);
       }
-
     }
 
     /**
@@ -49,6 +49,7 @@
 #include <algorithm>
 #include <iterator>
 #include <cmath>
+#include <cstring>
 #include <vector>
 
 #include <QByteArray>
@@ -151,22 +152,34 @@ public:
 
 private:
 
-    ///Internal class needed for type-punning
-    union Reinterpreter64_
-    {
-      double f;
-      UInt64 i;
-    };
-
-    ///Internal class needed for type-punning
-    union Reinterpreter32_
-    {
-      float f;
-      UInt32 i;
-    };
-
     static const char encoder_[];
     static const char decoder_[];
+
+    /**
+      @brief Encodes @p in_size bytes into Base64 characters
+
+      Writes exactly ceil(in_size / 3) * 4 characters (including '=' padding)
+      to @p out. Uses SSSE3 or AVX2 kernels if supported by the CPU.
+    */
+    static void encodeBytes_(const Byte * in, Size in_size, Byte * out);
+
+    /**
+      @brief Decodes @p in_size Base64 characters into bytes
+
+      @p in_size has to be a multiple of 4, of which the last @p padding
+      characters are '=' and decoded as zero. Writes exactly in_size / 4 * 3
+      bytes to @p out. Uses SSSE3 or AVX2 kernels if supported by the CPU.
+    */
+    static void decodeBytes_(const Byte * in, Size in_size, Size padding, Byte * out);
+
+    /**
+      @brief Reverses the byte order of @p count consecutive elements of @p element_size bytes each
+
+      Works on the raw bytes, so the buffer may hold any type and does not
+      need to be aligned.
+    */
+    static void swapByteOrder_(Byte * data, Size count, Size element_size);
+
     /// Decodes a Base64 string to a vector of floating point numbers
     template <typename ToType>
     void decodeUncompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out);
@@ -222,26 +235,7 @@ private:
     //Change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      if (element_size == 4)
-      {
-        for (Size i = 0; i < in.size(); ++i)
-        {
-          Reinterpreter32_ tmp;
-          tmp.f = in[i];
-          tmp.i = endianize32(tmp.i);
-          in[i] = tmp.f;
-        }
-      }
-      else
-      {
-        for (Size i = 0; i < in.size(); ++i)
-        {
-          Reinterpreter64_ tmp;
-          tmp.f = in[i];
-          tmp.i = endianize64(tmp.i);
-          in[i] = tmp.f;
-        }
-      }
+      swapByteOrder_(reinterpret_cast<Byte *>(&in[0]), in.size(), element_size);
     }
 
     //encode with compression
@@ -290,47 +284,7 @@ private:
       end = it + input_bytes;
     }
 
-    Byte * to = reinterpret_cast<Byte *>(&out[0]);
-
-
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
-    }
-
-    out.resize(written);         //no more space is needed
+    encodeBytes_(it, end - it, reinterpret_cast<Byte *>(&out[0]));
   }
 
   template <typename ToType>
@@ -375,10 +329,9 @@ private:
 
     std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
 
-    void* byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
+    Byte * byte_buffer = reinterpret_cast<Byte *>(&decompressed[0]);
     Size buffer_size = decompressed.size();
 
-    const ToType * float_buffer = reinterpret_cast<const ToType *>(byte_buffer);
     if (buffer_size % element_size != 0)
     {
       throw Exception::ConversionError(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Bad BufferCount?");
@@ -389,20 +342,15 @@ private:
     // change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      if (element_size == 4) // 32 bit
-      {
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-      }
-      else // 64 bit
-      {
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-      }
+      swapByteOrder_(byte_buffer, float_count, element_size);
     }
 
-    // copy values
-    out.assign(float_buffer, float_buffer + float_count);
+    // copy values (the buffer is not necessarily aligned for ToType)
+    out.resize(float_count);
+    if (float_count > 0)
+    {
+      std::memcpy(&out[0], byte_buffer, float_count * element_size);
+    }
   }
 
   template <typename ToType>
@@ -421,103 +369,29 @@ private:
       throw Exception::ConversionError(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Malformed base64 input, length is not a multiple of 4.");
     }
 
-    Size src_size = in.size();
+    const Size src_size = in.size();
     // last one or two '=' are skipped if contained
-    int padding = 0;
+    Size padding = 0;
     if (in[src_size - 1] == '=') padding++;
     if (in[src_size - 2] == '=') padding++;
 
-    src_size -= padding;
-
-    register UInt a;
-    register UInt b;
-
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
     const Size element_size = sizeof(ToType);
-
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
-
-    // Parse little endian data in big endian OpenMS (or other way round)
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || 
-       (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
+    const Size byte_count = (src_size / 4) * 3;
+
+    // decode directly into the memory of the output vector (the last
+    // element may only be partially covered by the data and is removed)
+    out.resize((byte_count + element_size - 1) / element_size);
+    decodeBytes_(reinterpret_cast<const Byte *>(in.c_str()), src_size, padding, reinterpret_cast<Byte *>(&out[0]));
+    out.resize(byte_count / element_size);
+    if (out.empty())
     {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
-    }
-    else
-    {
-      offset = 0;
-      inc = 1;
+      return;
     }
 
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
-
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
+    // change endianness if necessary
+    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
-      {
-        b = 0;
-      }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
-      {
-        a = 0;
-      }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
-      {
-        b = 0;
-      }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
+      swapByteOrder_(reinterpret_cast<Byte *>(&out[0]), out.size(), element_size);
     }
   }
 
@@ -585,47 +459,7 @@ private:
       end = it + input_bytes;
     }
 
-    Byte * to = reinterpret_cast<Byte *>(&out[0]);
-
-
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
-    }
-
-    out.resize(written);         //no more space is needed
+    encodeBytes_(it, end - it, reinterpret_cast<Byte *>(&out[0]));
   }
 
   template <typename ToType>
@@ -648,8 +482,6 @@ private:
     if (in == "")
       return;
 
-    void * byte_buffer;
-    Size buffer_size;
     const Size element_size = sizeof(ToType);
 
     String decompressed;
@@ -672,85 +504,39 @@ private:
 
     std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
 
-    byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    buffer_size = decompressed.size();
+    Byte * byte_buffer = reinterpret_cast<Byte *>(&decompressed[0]);
+    Size buffer_size = decompressed.size();
+
+    if (buffer_size % element_size != 0)
+    {
+      throw Exception::ConversionError(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Bad BufferCount?");
+    }
+    Size float_count = buffer_size / element_size;
 
     //change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      if (element_size == 4)
-      {
-        const Int32 * float_buffer = reinterpret_cast<const Int32 *>(byte_buffer);
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Bad BufferCount?");
-        Size float_count = buffer_size / element_size;
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
-      else
-      {
-        const Int64 * float_buffer = reinterpret_cast<const Int64 *>(byte_buffer);
-
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Bad BufferCount?");
-
-        Size float_count = buffer_size / element_size;
-
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
+      swapByteOrder_(byte_buffer, float_count, element_size);
     }
-    else
+
+    // copy values element-wise (the buffer is not necessarily aligned)
+    out.resize(float_count);
+    // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
+    for (Size i = 0; i < float_count; ++i)
     {
       if (element_size == 4)
       {
-        const Int * float_buffer = reinterpret_cast<const Int *>(byte_buffer);
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Bad BufferCount while decoding?");
-
-        Size float_count = buffer_size / element_size;
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
+        Int32 value;
+        std::memcpy(&value, byte_buffer + i * element_size, sizeof(Int32));
+        out[i] = (ToType) value;
       }
       else
       {
-        const Int64 * float_buffer = reinterpret_cast<const Int64 *>(byte_buffer);
-
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Bad BufferCount while decoding?");
-
-        Size float_count = buffer_size / element_size;
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
+        Int64 value;
+        std::memcpy(&value, byte_buffer + i * element_size, sizeof(Int64));
+        out[i] = (ToType) value;
       }
     }
-
   }
 
   template <typename ToType>
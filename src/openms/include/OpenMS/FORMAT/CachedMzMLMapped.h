@@ -0,0 +1,281 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_CACHEDMZMLMAPPED_H
+#define OPENMS_FORMAT_CACHEDMZMLMAPPED_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
+namespace OpenMS
+{
+
+  /**
+    @brief Read-only, memory-mapped access to a cached mzML file
+
+    This class provides random access to the spectra and chromatograms
+    stored in a file written by CachedmzML::writeMemdump (or
+    MSDataCachedConsumer). Instead of seeking in a file stream and copying
+    the data into newly allocated arrays (as CachedmzML::readSpectrumFast
+    does), the whole file is mapped into the address space of the process
+    and views (pointer and length) into the mapping are handed out.
+
+    After construction the object is immutable, thus all access functions
+    are const and can be called concurrently from multiple threads without
+    any locking. Copies of the object share the same mapping.
+
+    @note The views returned by this class are only valid as long as at
+    least one CachedmzMLMapped object referring to the mapping exists.
+  */
+  class OPENMS_DLLAPI CachedmzMLMapped
+  {
+public:
+
+    /**
+      @brief A non-owning view on a binary data array inside the mapping
+
+      The cached format does not align the data arrays in the file, elements
+      are therefore accessed through memcpy which compiles to a single
+      (unaligned) load.
+    */
+    struct DataArrayView
+    {
+      /// Bidirectional iterator over the (possibly unaligned) elements of a view
+      class ConstIterator
+      {
+public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef double value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const double* pointer;
+        typedef double reference;
+
+        explicit ConstIterator(const char* pos = 0) :
+          pos_(pos)
+        {
+        }
+
+        inline double operator*() const
+        {
+          double result;
+          std::memcpy(&result, pos_, sizeof(double));
+          return result;
+        }
+
+        inline ConstIterator& operator++()
+        {
+          pos_ += sizeof(double);
+          return *this;
+        }
+
+        inline ConstIterator operator++(int)
+        {
+          ConstIterator tmp(*this);
+          pos_ += sizeof(double);
+          return tmp;
+        }
+
+        inline ConstIterator& operator--()
+        {
+          pos_ -= sizeof(double);
+          return *this;
+        }
+
+        inline ConstIterator operator--(int)
+        {
+          ConstIterator tmp(*this);
+          pos_ -= sizeof(double);
+          return tmp;
+        }
+
+        inline bool operator==(const ConstIterator& rhs) const
+        {
+          return pos_ == rhs.pos_;
+        }
+
+        inline bool operator!=(const ConstIterator& rhs) const
+        {
+          return pos_ != rhs.pos_;
+        }
+
+private:
+        const char* pos_;
+      };
+
+      typedef ConstIterator const_iterator;
+
+      /// Start of the (contiguous) array of doubles inside the mapping
+      const char* data;
+
+      /// Number of elements in the array
+      Size size;
+
+      DataArrayView() :
+        data(0),
+        size(0)
+      {
+      }
+
+      /// Access to the i-th element of the array
+      inline double operator[](Size i) const
+      {
+        double result;
+        std::memcpy(&result, data + i * sizeof(double), sizeof(double));
+        return result;
+      }
+
+      /// Iterator to the first element
+      inline const_iterator begin() const
+      {
+        return const_iterator(data);
+      }
+
+      /// Iterator past the last element
+      inline const_iterator end() const
+      {
+        return const_iterator(data + size * sizeof(double));
+      }
+
+      /// Copy the data into the provided vector (overwriting its content)
+      inline void copyTo(std::vector<double>& v) const
+      {
+        v.resize(size);
+        if (size > 0)
+        {
+          std::memcpy(&v[0], data, size * sizeof(double));
+        }
+      }
+    };
+
+    /** @name Constructors and Destructor
+    */
+    //@{
+    /**
+      @brief Maps the given cached file into memory and builds the index
+
+      @param filename The cached file (usually ending in .mzML.cached)
+
+      @throws Exception::FileNotFound is thrown if the file cannot be opened
+      @throws Exception::ParseError is thrown if the file is not a valid cached mzML file
+    */
+    explicit CachedmzMLMapped(const String& filename);
+
+    /// Copy constructor (shares the mapping)
+    CachedmzMLMapped(const CachedmzMLMapped& rhs);
+
+    /// Assignment operator (shares the mapping)
+    CachedmzMLMapped& operator=(const CachedmzMLMapped& rhs);
+
+    /// Destructor
+    ~CachedmzMLMapped();
+    //@}
+
+    /// Returns the number of spectra in the file
+    Size getNrSpectra() const;
+
+    /// Returns the number of chromatograms in the file
+    Size getNrChromatograms() const;
+
+    /// Returns the name of the mapped file
+    const String& getFilename() const;
+
+    /**
+      @brief Retrieves views on the m/z and intensity array of a spectrum
+
+      No data is copied, the views point directly into the mapping.
+    */
+    void getSpectrumView(Size id, DataArrayView& mz, DataArrayView& intensity, int& ms_level, double& rt) const;
+
+    /**
+      @brief Retrieves views on the time and intensity array of a chromatogram
+
+      No data is copied, the views point directly into the mapping.
+    */
+    void getChromatogramView(Size id, DataArrayView& rt, DataArrayView& intensity) const;
+
+protected:
+
+    /// Walks through the mapped file and records the offset of all spectra and chromatograms
+    void createIndex_();
+
+    /// Reads a value of type T at the given offset of the mapping
+    template <typename T>
+    inline T readValue_(Size offset) const
+    {
+      T result;
+      std::memcpy(&result, begin_ + offset, sizeof(T));
+      return result;
+    }
+
+    /// Name of the mapped file
+    String filename_;
+
+    /// The mapping (shared between copies)
+    boost::shared_ptr<boost::interprocess::mapped_region> region_;
+
+    /// Start of the mapping
+    const char* begin_;
+
+    /// Size of the mapping in bytes
+    Size length_;
+
+    /// Byte offsets of all spectra inside the mapping
+    std::vector<Size> spectra_index_;
+
+    /// Byte offsets of all chromatograms inside the mapping
+    std::vector<Size> chrom_index_;
+
+private:
+
+    /// Not implemented
+    CachedmzMLMapped();
+  };
+}
+
+#endif // OPENMS_FORMAT_CACHEDMZMLMAPPED_H
@@ -0,0 +1,140 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_DATAACCESS_MSDATAAVERAGINGCONSUMER_H
+#define OPENMS_FORMAT_DATAACCESS_MSDATAAVERAGINGCONSUMER_H
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
+
+#include <deque>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Consumer class that averages spectra over RT on the fly (streaming variant of SpectraMerger::average())
+
+    Spectra of the MS level to be averaged are replaced by the weighted average
+    over their neighbours (Gaussian or Top-Hat, see SpectraMerger), all other
+    spectra and all chromatograms are passed on unchanged. The results are
+    passed on to the next consumer in the order in which the spectra were
+    consumed and are identical to those of SpectraMerger::average() on the
+    full experiment.
+
+    Only a sliding window of spectra is kept in memory: a spectrum is passed
+    on as soon as all spectra within its averaging range have been consumed,
+    and spectra are removed from the window once they are out of range for
+    all spectra still to be averaged. The spectra therefore need to be
+    consumed sorted by RT.
+
+    @note flush() has to be called after the last spectrum has been consumed,
+    otherwise the spectra at the end of the run are not passed on.
+
+    @note This does not transfer ownership of the next consumer - it is the
+    callers responsibility to delete it afterwards.
+  */
+  class OPENMS_DLLAPI MSDataAveragingConsumer :
+    public Interfaces::IMSDataConsumer<>
+  {
+
+  public:
+    typedef MSExperiment<> MapType;
+    typedef MapType::SpectrumType SpectrumType;
+    typedef MapType::ChromatogramType ChromatogramType;
+
+    /**
+      @brief Constructor
+
+      @param next_consumer Consumer to pass the (averaged) spectra and chromatograms on to
+      @param param Parameters of SpectraMerger (missing values are set to their defaults)
+      @param average_type Averaging type to be used ("gaussian" or "tophat")
+    */
+    MSDataAveragingConsumer(Interfaces::IMSDataConsumer<>* next_consumer, const Param& param, const String& average_type);
+
+    /// Destructor
+    virtual ~MSDataAveragingConsumer();
+
+    /// Passes the expected size on to the next consumer
+    virtual void setExpectedSize(Size expectedSpectra, Size expectedChromatograms);
+
+    /// Passes the experimental settings on to the next consumer
+    virtual void setExperimentalSettings(const ExperimentalSettings& exp);
+
+    /**
+      @brief Consumes a spectrum and passes on all spectra whose averaging range is complete
+
+      @exception Exception::IllegalArgument if the spectra are not consumed sorted by RT
+    */
+    virtual void consumeSpectrum(SpectrumType& s);
+
+    /// Passes the chromatogram on to the next consumer
+    virtual void consumeChromatogram(ChromatogramType& c);
+
+    /// Averages and passes on all remaining spectra (to be called after the last spectrum)
+    void flush();
+
+    /// Returns the number of spectra currently held in memory
+    Size getWindowSize() const;
+
+  protected:
+
+    /// Passes on all spectra whose averaging range is complete (all remaining ones if @p end_of_run is true)
+    void passOnSpectra_(bool end_of_run);
+
+    Interfaces::IMSDataConsumer<>* next_consumer_;
+
+    /// averaging settings and m/z binning parameters
+    SpectraMerger::AveragingSettings_ settings_;
+    double mz_binning_width_;
+    String mz_binning_unit_;
+
+    /// type of the spectral data (determined from the first averaged spectrum)
+    SpectrumSettings::SpectrumType type_;
+    bool type_determined_;
+
+    /// original spectra within the averaging range (spectra of other MS levels are reduced to RT and MS level)
+    std::deque<SpectrumType> window_;
+    /// number of spectra consumed before the first one in window_
+    Size window_start_;
+    /// index (in the run) of the next spectrum to be passed on
+    Size next_spectrum_;
+
+    bool rt_initialized_;
+    double last_rt_;
+  };
+
+} //end namespace OpenMS
+
+#endif // OPENMS_FORMAT_DATAACCESS_MSDATAAVERAGINGCONSUMER_H
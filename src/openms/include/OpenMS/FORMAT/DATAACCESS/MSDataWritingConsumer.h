@@ -40,7 +40,9 @@
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/HANDLERS/MzMLHandler.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/CONCEPT/LogStream.h>
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <fstream>
@@ -85,6 +87,13 @@ namespace OpenMS
       inconsistent mzML if the count attribute of spectrumList or
       chromatogramList is incorrect.
 
+      Consumed spectra and chromatograms are processed right away but written
+      in batches (see setWriteBatchSize()): the binary data arrays of a batch
+      are encoded in parallel (if OpenMP is available) and the resulting XML
+      is written in the order of consumption, while the offsets for the
+      indexedmzML index are computed on the fly. All remaining data is
+      written when the consumer is destroyed.
+
     */
     class OPENMS_DLLAPI MSDataWritingConsumer : 
       public Internal::MzMLHandler< MSExperiment<> >,
@@ -110,7 +119,8 @@ namespace OpenMS
         chromatograms_written_(0),
         spectra_expected_(0),
         chromatograms_expected_(0),
-        add_dataprocessing_(false)
+        add_dataprocessing_(false),
+        write_batch_size_(100)
       {
         validator_ = new Internal::MzMLValidator(this->mapping_, this->cv_);
 
@@ -171,8 +181,9 @@ namespace OpenMS
               "Cannot write spectra after writing chromatograms.");
         }
 
-        // Process the spectrum 
-        SpectrumType scpy = s;
+        // Process a copy of the spectrum (buffered until the batch is written)
+        spectra_batch_.push_back(s);
+        SpectrumType& scpy = spectra_batch_.back();
         processSpectrum_(scpy);
 
         // Add dataprocessing if required
@@ -202,11 +213,13 @@ namespace OpenMS
           ofs_ << "\t\t<spectrumList count=\"" << spectra_expected_ << "\" defaultDataProcessingRef=\"dp_sp_0\">\n";
           writing_spectra_ = true;
         }
-        bool renew_native_ids = false;
         // TODO writeSpectrum assumes that dps_ has at least one value -> assert
         // this here ...
-        Internal::MzMLHandler<MapType>::writeSpectrum_(ofs_, scpy,
-                spectra_written_++, *validator_, renew_native_ids, dps_);
+        ++spectra_written_;
+        if (spectra_batch_.size() >= write_batch_size_)
+        {
+          writeSpectrumBatch_();
+        }
       }
 
       /**
@@ -222,11 +235,13 @@ namespace OpenMS
         // make sure to close an open List tag
         if (writing_spectra_)
         {
+          writeSpectrumBatch_();
           ofs_ << "\t\t</spectrumList>\n";
         }
 
-        // Create copy and add dataprocessing if required
-        ChromatogramType ccpy = c;
+        // Create copy (buffered until the batch is written) and add dataprocessing if required
+        chromatograms_batch_.push_back(c);
+        ChromatogramType& ccpy = chromatograms_batch_.back();
         processChromatogram_(ccpy);
 
         if (add_dataprocessing_)
@@ -255,8 +270,11 @@ namespace OpenMS
           writing_chromatograms_ = true;
           writing_spectra_ = false;
         }
-        Internal::MzMLHandler<MapType>::writeChromatogram_(ofs_, ccpy,
-                chromatograms_written_++, *validator_);
+        ++chromatograms_written_;
+        if (chromatograms_batch_.size() >= write_batch_size_)
+        {
+          writeChromatogramBatch_();
+        }
       }
       //@}
 
@@ -276,13 +294,35 @@ namespace OpenMS
 
       /**
         @brief Return the number of spectra written.
+
+        Includes the spectra which are consumed but not yet written to disk.
       */
       virtual Size getNrSpectraWritten() {return spectra_written_;}
       /**
         @brief Return the number of chromatograms written.
+
+        Includes the chromatograms which are consumed but not yet written to disk.
       */
       virtual Size getNrChromatogramsWritten() {return chromatograms_written_;}
 
+      /**
+        @brief Set the number of spectra (or chromatograms) which are encoded together
+
+        Larger batches use more threads at the cost of memory for the
+        buffered data. A batch size of 1 writes each spectrum and chromatogram
+        as soon as it is consumed. The default is 100.
+      */
+      void setWriteBatchSize(Size batch_size)
+      {
+        write_batch_size_ = std::max(batch_size, Size(1));
+      }
+
+      /// Return the number of spectra (or chromatograms) which are encoded together
+      Size getWriteBatchSize() const
+      {
+        return write_batch_size_;
+      }
+
     private:
 
       /// @name Data Processing using the template method pattern
@@ -312,6 +352,29 @@ namespace OpenMS
         //--------------------------------------------------------------------------------------------
         //cleanup
         //--------------------------------------------------------------------------------------------
+        // write remaining data (the destructor must not throw)
+        try
+        {
+          writeSpectrumBatch_();
+          writeChromatogramBatch_();
+        }
+        catch (std::exception& e)
+        {
+          LOG_ERROR << "Error while writing mzML data: " << e.what() << std::endl;
+        }
+        catch (...)
+        {
+          LOG_ERROR << "Error while writing mzML data: unknown error" << std::endl;
+        }
+        // the batches are only cleared once written
+        if (!spectra_batch_.empty() || !chromatograms_batch_.empty())
+        {
+          LOG_ERROR << "Error: " << spectra_batch_.size() << " spectra and " << chromatograms_batch_.size()
+                    << " chromatograms were consumed but not written. The file is incomplete: the spectrumList and"
+                    << " chromatogramList counts and the numbers of spectra and chromatograms written ("
+                    << spectra_written_ << ", " << chromatograms_written_ << ") include them." << std::endl;
+        }
+
         // make sure to close an open List tag
         if (writing_spectra_)
         {
@@ -332,6 +395,23 @@ namespace OpenMS
 
     protected:
 
+      /// Encodes the buffered spectra in parallel and writes them (in order)
+      void writeSpectrumBatch_();
+
+      /// Encodes the buffered chromatograms in parallel and writes them (in order)
+      void writeChromatogramBatch_();
+
+      /**
+        @brief Encodes the first @p size buffered spectra (or chromatograms) to XML
+
+        Uses OpenMP tasks if called from within a parallel region (e.g. from a
+        pipelined parser, see MzMLFile::transform), a parallel loop otherwise.
+      */
+      void encodeBatch_(bool spectra, Size size, std::vector<std::string>& fragments);
+
+      /// Encodes buffered spectrum (or chromatogram) @p i to XML
+      void encodeElement_(bool spectrum, Size i, std::string& fragment);
+
       /// File stream (to write mzML)
       std::ofstream ofs_;
 
@@ -361,6 +441,13 @@ namespace OpenMS
       std::vector<std::vector< ConstDataProcessingPtr > > dps_;
       /// The dataprocessing to be added to each spectrum/chromatogram
       DataProcessingPtr additional_dataprocessing_;
+
+      /// Number of spectra (or chromatograms) encoded together
+      Size write_batch_size_;
+      /// Spectra consumed but not yet written
+      std::vector<SpectrumType> spectra_batch_;
+      /// Chromatograms consumed but not yet written
+      std::vector<ChromatogramType> chromatograms_batch_;
     };
 
     /**
@@ -7,6 +7,7 @@ MSDataWritingConsumer.h
 MSDataTransformingConsumer.h
 MSDataCachedConsumer.h
 MSDataChainingConsumer.h
+MSDataAveragingConsumer.h
 NoopMSDataConsumer.h
 SwathFileConsumer.h
 )
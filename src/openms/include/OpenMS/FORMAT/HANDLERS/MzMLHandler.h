@@ -65,6 +65,10 @@
 
 #include <QRegExp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //MISSING:
 // - more than one selected ion per precursor (warning if more than one)
 // - scanWindowList for each acquisition separately (currently for the whole spectrum only)
@@ -125,6 +129,7 @@ public:
         data_(),
         default_array_length_(0),
         in_spectrum_list_(false),
+        pending_errors_(0),
         decoder_(),
         logger_(logger),
         consumer_(NULL),
@@ -162,6 +167,7 @@ public:
         data_(),
         default_array_length_(0),
         in_spectrum_list_(false),
+        pending_errors_(0),
         decoder_(),
         logger_(logger),
         consumer_(NULL),
@@ -262,12 +268,61 @@ protected:
 
       typedef MzMLHandlerHelper::BinaryData BinaryData;
 
+      /**
+          @brief Data necessary to generate a single spectrum
+
+          Small struct holds all data necessary to populate a spectrum at a
+          later timepoint (since reading of the base64 data and generation of
+          spectra can be done at distinct timepoints).
+      */
+      struct SpectrumData
+      {
+        std::vector<BinaryData> data;
+        Size default_array_length;
+        SpectrumType spectrum;
+        bool skip_data;
+      };
+
+      /**
+          @brief Data necessary to generate a single chromatogram
+
+          Small struct holds all data necessary to populate a chromatogram at a
+          later timepoint (since reading of the base64 data and generation of
+          chromatogram can be done at distinct timepoints).
+      */
+      struct ChromatogramData
+      {
+        std::vector<BinaryData> data;
+        Size default_array_length;
+        ChromatogramType chromatogram;
+      };
+
+      /// Writes a spectrum element and records its offset (relative to the start of @p os) for the index
       void writeSpectrum_(std::ostream& os, const SpectrumType& spec, Size s,
                           Internal::MzMLValidator& validator, bool renew_native_ids,
                           std::vector<std::vector< ConstDataProcessingPtr > >& dps);
 
+      /**
+        @brief Writes a spectrum element with id @p native_id (without recording its offset)
+
+        Only reads member data, i.e. several spectra can be written to
+        different streams concurrently.
+      */
+      void writeSpectrumElement_(std::ostream& os, const SpectrumType& spec, Size s, const String& native_id,
+                                 Internal::MzMLValidator& validator,
+                                 std::vector<std::vector< ConstDataProcessingPtr > >& dps);
+
+      /// Writes a chromatogram element and records its offset (relative to the start of @p os) for the index
       void writeChromatogram_(std::ostream& os, const ChromatogramType& chromatogram, Size c, Internal::MzMLValidator& validator);
 
+      /**
+        @brief Writes a chromatogram element (without recording its offset)
+
+        Only reads member data, i.e. several chromatograms can be written to
+        different streams concurrently.
+      */
+      void writeChromatogramElement_(std::ostream& os, const ChromatogramType& chromatogram, Size c, Internal::MzMLValidator& validator);
+
       template <typename ContainerT>
       void writeContainerData(std::ostream& os, const PeakFileOptions& pf_options_, const ContainerT& container, String array_type)
       {
@@ -320,9 +375,47 @@ protected:
 
           Will populate all spectra on the current work stack with data (using
           multiple threads if available) and append them to the result.
+
+          If pipelined decoding is enabled (see
+          PeakFileOptions::setPipelinedDecoding), the spectra are handed to
+          background tasks and the function returns immediately, so that the
+          parser can continue with the next batch. The spectra are appended
+          in order once the next batch is dispatched or
+          finishPendingData_() is called.
       */
       void populateSpectraWithData()
       {
+        if (usePipelinedDecoding_())
+        {
+          // deliver the batch that is currently decoded in the background
+          // and hand the current batch to the worker threads
+          finishPendingData_();
+          spectrum_data_pending_.swap(spectrum_data_);
+          if (options_.getFillData())
+          {
+            for (Size i = 0; i < spectrum_data_pending_.size(); i++)
+            {
+              SpectrumData* sd = &spectrum_data_pending_[i];
+#ifdef _OPENMP
+#pragma omp task firstprivate(sd)
+#endif
+              {
+                try
+                {
+                  populateSpectrum_(*sd);
+                }
+                catch (...)
+                {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                  ++pending_errors_;
+                }
+              }
+            }
+          }
+          return;
+        }
 
         // Whether spectrum should be populated with data
         if (options_.getFillData())
@@ -338,13 +431,7 @@ protected:
             {
               try
               {
-                populateSpectraWithData_(spectrum_data_[i].data,
-                                         spectrum_data_[i].default_array_length, options_,
-                                         spectrum_data_[i].spectrum);
-                if (options_.getSortSpectraByMZ() && !spectrum_data_[i].spectrum.isSorted())
-                {
-                  spectrum_data_[i].spectrum.sortByPosition();
-                }
+                populateSpectrum_(spectrum_data_[i]);
               }
               catch (...)
               {
@@ -360,24 +447,7 @@ protected:
         }
 
         // Append all spectra to experiment / consumer
-        for (Size i = 0; i < spectrum_data_.size(); i++)
-        {
-          if (consumer_ != NULL)
-          {
-            consumer_->consumeSpectrum(spectrum_data_[i].spectrum);
-            if (options_.getAlwaysAppendData())
-            {
-              exp_->addSpectrum(spectrum_data_[i].spectrum);
-            }
-          }
-          else
-          {
-            exp_->addSpectrum(spectrum_data_[i].spectrum);
-          }
-        }
-
-        // Delete batch
-        spectrum_data_.clear();
+        appendSpectra_(spectrum_data_);
       }
 
       /**
@@ -385,9 +455,41 @@ protected:
 
           Will populate all chromatograms on the current work stack with data (using
           multiple threads if available) and append them to the result.
+
+          See populateSpectraWithData() for the pipelined mode.
       */
       void populateChromatogramsWithData()
       {
+        if (usePipelinedDecoding_())
+        {
+          finishPendingData_();
+          chromatogram_data_pending_.swap(chromatogram_data_);
+          if (options_.getFillData())
+          {
+            for (Size i = 0; i < chromatogram_data_pending_.size(); i++)
+            {
+              ChromatogramData* cd = &chromatogram_data_pending_[i];
+#ifdef _OPENMP
+#pragma omp task firstprivate(cd)
+#endif
+              {
+                try
+                {
+                  populateChromatogram_(*cd);
+                }
+                catch (...)
+                {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                  ++pending_errors_;
+                }
+              }
+            }
+          }
+          return;
+        }
+
         // Whether chromatogram should be populated with data
         if (options_.getFillData())
         {
@@ -400,13 +502,7 @@ protected:
             // parallel exception catching and re-throwing business
             try
             {
-              populateChromatogramsWithData_(chromatogram_data_[i].data,
-                                             chromatogram_data_[i].default_array_length, options_,
-                                             chromatogram_data_[i].chromatogram);
-              if (options_.getSortChromatogramsByRT() && !chromatogram_data_[i].chromatogram.isSorted())
-              {
-                chromatogram_data_[i].chromatogram.sortByPosition();
-              }
+              populateChromatogram_(chromatogram_data_[i]);
             }
             catch (...)
             {++errCount; }
@@ -419,24 +515,123 @@ protected:
         }
 
         // Append all chromatograms to experiment / consumer
-        for (Size i = 0; i < chromatogram_data_.size(); i++)
+        appendChromatograms_(chromatogram_data_);
+      }
+
+      /**
+          @brief Whether the binary data should be decoded by background tasks
+
+          Pipelined decoding is only used if it is enabled in the options and
+          the parser runs inside a parallel region with more than one thread
+          (see MzMLFile) since otherwise the tasks would not run concurrently
+          to the parser.
+      */
+      bool usePipelinedDecoding_() const
+      {
+#ifdef _OPENMP
+        return options_.getPipelinedDecoding() && omp_get_num_threads() > 1;
+#else
+        return false;
+#endif
+      }
+
+      /**
+          @brief Waits for the background decoding tasks and appends their result
+
+          Only has an effect in pipelined mode. Spectra and chromatograms are
+          appended to the experiment / consumer in the order in which they
+          were read.
+      */
+      void finishPendingData_()
+      {
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+        if (pending_errors_ != 0)
+        {
+          pending_errors_ = 0;
+          spectrum_data_pending_.clear();
+          chromatogram_data_pending_.clear();
+          throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, file_, "Error during parsing of binary data.");
+        }
+        appendSpectra_(spectrum_data_pending_);
+        appendChromatograms_(chromatogram_data_pending_);
+      }
+
+      /**
+          @brief Decodes the binary data of a single spectrum
+
+          @note Do not modify any internal state variables of the class since
+          this function will be executed in parallel.
+      */
+      void populateSpectrum_(SpectrumData& sd)
+      {
+        populateSpectraWithData_(sd.data, sd.default_array_length, options_, sd.spectrum);
+        if (options_.getSortSpectraByMZ() && !sd.spectrum.isSorted())
+        {
+          sd.spectrum.sortByPosition();
+        }
+      }
+
+      /**
+          @brief Decodes the binary data of a single chromatogram
+
+          @note Do not modify any internal state variables of the class since
+          this function will be executed in parallel.
+      */
+      void populateChromatogram_(ChromatogramData& cd)
+      {
+        populateChromatogramsWithData_(cd.data, cd.default_array_length, options_, cd.chromatogram);
+        if (options_.getSortChromatogramsByRT() && !cd.chromatogram.isSorted())
+        {
+          cd.chromatogram.sortByPosition();
+        }
+      }
+
+      /// Append all (decoded) spectra to the experiment / consumer and clear the batch
+      void appendSpectra_(std::vector<SpectrumData>& spectrum_data)
+      {
+        for (Size i = 0; i < spectrum_data.size(); i++)
+        {
+          if (consumer_ != NULL)
+          {
+            consumer_->consumeSpectrum(spectrum_data[i].spectrum);
+            if (options_.getAlwaysAppendData())
+            {
+              exp_->addSpectrum(spectrum_data[i].spectrum);
+            }
+          }
+          else
+          {
+            exp_->addSpectrum(spectrum_data[i].spectrum);
+          }
+        }
+
+        // Delete batch
+        spectrum_data.clear();
+      }
+
+      /// Append all (decoded) chromatograms to the experiment / consumer and clear the batch
+      void appendChromatograms_(std::vector<ChromatogramData>& chromatogram_data)
+      {
+        for (Size i = 0; i < chromatogram_data.size(); i++)
         {
           if (consumer_ != NULL)
           {
-            consumer_->consumeChromatogram(chromatogram_data_[i].chromatogram);
+            consumer_->consumeChromatogram(chromatogram_data[i].chromatogram);
             if (options_.getAlwaysAppendData())
             {
-              exp_->addChromatogram(chromatogram_data_[i].chromatogram);
+              exp_->addChromatogram(chromatogram_data[i].chromatogram);
             }
           }
           else
           {
-            exp_->addChromatogram(chromatogram_data_[i].chromatogram);
+            exp_->addChromatogram(chromatogram_data[i].chromatogram);
           }
         }
 
         // Delete batch
-        chromatogram_data_.clear();
+        chromatogram_data.clear();
       }
 
       template <typename SpectrumType>
@@ -932,41 +1127,21 @@ protected:
       /// id of the default data processing (used when no processing is defined)
       String default_processing_;
 
-      /**
-          @brief Data necessary to generate a single spectrum
-
-          Small struct holds all data necessary to populate a spectrum at a
-          later timepoint (since reading of the base64 data and generation of
-          spectra can be done at distinct timepoints).
-      */
-      struct SpectrumData
-      {
-        std::vector<BinaryData> data;
-        Size default_array_length;
-        SpectrumType spectrum;
-        bool skip_data;
-      };
-
       /// Vector of spectrum data stored for later parallel processing
       std::vector<SpectrumData> spectrum_data_;
 
-      /**
-          @brief Data necessary to generate a single chromatogram
-
-          Small struct holds all data necessary to populate a chromatogram at a
-          later timepoint (since reading of the base64 data and generation of
-          chromatogram can be done at distinct timepoints).
-      */
-      struct ChromatogramData
-      {
-        std::vector<BinaryData> data;
-        Size default_array_length;
-        ChromatogramType chromatogram;
-      };
-
       /// Vector of chromatogram data stored for later parallel processing
       std::vector<ChromatogramData> chromatogram_data_;
 
+      /// Spectra currently decoded by background tasks (pipelined mode only)
+      std::vector<SpectrumData> spectrum_data_pending_;
+
+      /// Chromatograms currently decoded by background tasks (pipelined mode only)
+      std::vector<ChromatogramData> chromatogram_data_pending_;
+
+      /// Number of errors encountered by the background tasks
+      Size pending_errors_;
+
       //@}
       /**@name temporary data structures to hold written data */
       //@{
@@ -1637,6 +1812,7 @@ protected:
         // Flush the remaining data
         populateSpectraWithData();
         populateChromatogramsWithData();
+        finishPendingData_();
       }
 
       sm_.clear();
@@ -4992,7 +5168,16 @@ protected:
       long offset = os.tellp();
       spectra_offsets.push_back(make_pair(native_id, offset + 3));
 
-      // IMPORTANT make sure the offset (above) corresponds to the start of the <spectrum tag
+      writeSpectrumElement_(os, spec, s, native_id, validator, dps);
+    }
+
+    template <typename MapType>
+    void MzMLHandler<MapType>::writeSpectrumElement_(std::ostream& os,
+                                                     const SpectrumType& spec, Size s, const String& native_id,
+                                                     Internal::MzMLValidator& validator,
+                                                     std::vector<std::vector< ConstDataProcessingPtr > >& dps)
+    {
+      // IMPORTANT make sure the offset (see writeSpectrum_) corresponds to the start of the <spectrum tag
       os << "\t\t\t<spectrum id=\"" << writeXMLEscape(native_id) << "\" index=\"" << s << "\" defaultArrayLength=\"" << spec.size() << "\"";
       if (spec.getSourceFile() != SourceFile())
       {
@@ -5316,8 +5501,15 @@ protected:
       long offset = os.tellp();
       chromatograms_offsets.push_back(make_pair(chromatogram.getNativeID(), offset + 6));
 
+      writeChromatogramElement_(os, chromatogram, c, validator);
+    }
+
+    template <typename MapType>
+    void MzMLHandler<MapType>::writeChromatogramElement_(std::ostream& os,
+                                                         const ChromatogramType& chromatogram, Size c, Internal::MzMLValidator& validator)
+    {
       // TODO native id with chromatogram=?? prefix?
-      // IMPORTANT make sure the offset (above) corresponds to the start of the <chromatogram tag
+      // IMPORTANT make sure the offset (see writeChromatogram_) corresponds to the start of the <chromatogram tag
       os << "      <chromatogram id=\"" << writeXMLEscape(chromatogram.getNativeID()) << "\" index=\"" << c << "\" defaultArrayLength=\"" << chromatogram.size() << "\">" << "\n";
 
       // write cvParams (chromatogram type)
@@ -90,7 +90,7 @@ public:
 
       Internal::MzMLHandler<MapType> handler(map, filename, getVersion(), *this);
       handler.setOptions(options_);
-      safeParse_(filename, &handler);
+      safeParse_(filename, &handler, options_.getPipelinedDecoding());
     }
 
     /**
@@ -127,6 +127,10 @@ public:
       does not require a full first pass through the file to compute the
       correct number of spectra and chromatograms in the input file.
 
+      @note Decoding is only overlapped with parsing if the consumer is
+      prepared to be called from within a parallel region (see
+      PeakFileOptions::setPipelinedTransform).
+
       @param filename_in Filename of input mzML file to transform
       @param consumer Consumer class to operate on the input filename (implementing a transformation)
       @param skip_full_count Whether to skip computing the correct number of spectra and chromatograms in the input file
@@ -139,11 +143,13 @@ public:
 
       // Second pass through the data, now read the spectra!
       {
+        PeakFileOptions tmp_options(options_);
+        tmp_options.setPipelinedDecoding(options_.getPipelinedTransform());
         MapType dummy;
         Internal::MzMLHandler<MapType> handler(dummy, filename_in, getVersion(), *this);
-        handler.setOptions(options_);
+        handler.setOptions(tmp_options);
         handler.setMSDataConsumer(consumer);
-        safeParse_(filename_in, &handler);
+        safeParse_(filename_in, &handler, tmp_options.getPipelinedDecoding());
       }
     }
 
@@ -172,10 +178,11 @@ public:
         PeakFileOptions tmp_options(options_);
         Internal::MzMLHandler<MapType> handler(map, filename_in, getVersion(), *this);
         tmp_options.setAlwaysAppendData(true);
+        tmp_options.setPipelinedDecoding(options_.getPipelinedTransform());
         handler.setOptions(tmp_options);
         handler.setMSDataConsumer(consumer);
 
-        safeParse_(filename_in, &handler);
+        safeParse_(filename_in, &handler, tmp_options.getPipelinedDecoding());
       }
     }
 
@@ -223,8 +230,20 @@ protected:
       consumer->setExperimentalSettings(experimental_settings);
     }
 
-    /// Safe parse that catches exceptions and handles them accordingly
-    void safeParse_(const String & filename, Internal::XMLHandler * handler);
+    /**
+      @brief Safe parse that catches exceptions and handles them accordingly
+
+      @param filename The file to parse
+      @param handler The handler to use
+      @param pipelined Run the parser in a parallel region so that the
+      handler can decode the binary data in the worker threads while the XML
+      is parsed (see PeakFileOptions::setPipelinedDecoding). Errors raised
+      in the parallel region are re-thrown with their original type (for
+      exceptions not derived from Exception::BaseException this requires
+      that boost can transport them, which is the case for the standard
+      library exceptions).
+    */
+    void safeParse_(const String & filename, Internal::XMLHandler * handler, bool pipelined = false);
 
 private:
 
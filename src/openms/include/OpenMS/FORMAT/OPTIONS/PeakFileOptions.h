@@ -207,6 +207,32 @@ public:
     Size getMaxDataPoolSize() const;
     /// Set maximal size of the data pool
     void setMaxDataPoolSize(Size size);
+    /**
+      @brief Sets whether decoding of a data pool is overlapped with parsing
+
+      If enabled (default), the XML of the next data pool is parsed by one
+      thread while the worker threads decode the binary data (base64, zlib,
+      numpress) of the previous pool. The data is still handed to the map in
+      the order of the file.
+
+      This option applies to loading into a map, for transforming with a
+      consumer see setPipelinedTransform().
+    */
+    void setPipelinedDecoding(bool pipelined);
+    /// Returns whether decoding of a data pool is overlapped with parsing
+    bool getPipelinedDecoding() const;
+    /**
+      @brief Sets whether decoding is overlapped with parsing when transforming with a consumer
+
+      Same as setPipelinedDecoding() but for MzMLFile::transform(). Disabled
+      by default, since the consumer is then called from within an OpenMP
+      parallel region: parallel regions inside the consumer only use a
+      single thread unless nested parallelism is enabled, and the consumer
+      must not rely on being called outside of a parallel region.
+    */
+    void setPipelinedTransform(bool pipelined);
+    /// Returns whether decoding is overlapped with parsing when transforming with a consumer
+    bool getPipelinedTransform() const;
     //@}
 
 private:
@@ -232,6 +258,8 @@ private:
     MSNumpressCoder::NumpressConfig np_config_mz_;
     MSNumpressCoder::NumpressConfig np_config_int_;
     Size maximal_data_pool_size_;
+    bool pipelined_decoding_;
+    bool pipelined_transform_;
   };
 
 } // namespace OpenMS
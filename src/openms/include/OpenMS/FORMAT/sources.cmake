@@ -26,6 +26,7 @@ Base64.h
 Bzip2Ifstream.h
 Bzip2InputStream.h
 CachedMzML.h
+CachedMzMLMapped.h
 CompressedInputSource.h
 CVMappingFile.h
 ConsensusXMLFile.h
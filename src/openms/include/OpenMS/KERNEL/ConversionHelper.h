@@ -60,7 +60,7 @@ public:
       @param n The maximum number of elements to be copied.
     */
     static void convert(UInt64 const input_map_index,
-                        MSExperiment<>& input_map,
+                        MSExperiment<> const& input_map,
                         ConsensusMap& output_map,
                         Size n = -1);
 
@@ -0,0 +1,450 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_KERNEL_MSSPECTRUMARRAYS_H
+#define OPENMS_KERNEL_MSSPECTRUMARRAYS_H
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/Peak1D.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Peak data of a 1D spectrum stored as separate m/z and intensity arrays.
+
+    MSSpectrum stores its peaks as an array of structures (e.g. interleaved
+    m/z and intensity of Peak1D). Kernels that mostly scan m/z (binary
+    searches, extraction windows, peak picking) then load the intensities
+    along with the m/z values. This class stores the m/z values and the
+    intensities in two separate contiguous arrays instead ("structure of
+    arrays"); the m/z values can be stored as @p float (@p MZType) to halve
+    their memory footprint where the precision is sufficient.
+
+    Only the peak data, the retention time and the MS level are stored. Use
+    the constructor / assign() to convert from MSSpectrum and toSpectrum() to
+    convert back.
+
+    Algorithms can consume this class without copying:
+    - operator[] returns a lightweight read-only peak reference providing
+      getMZ() and getIntensity(), so code templated on the spectrum type that
+      only uses size(), operator[], getMZ() and getIntensity() (e.g.
+      PeakPickerHiRes::pick(), ChromatogramExtractor::extract_value_tophat())
+      works on both layouts.
+    - getMZArray() and getIntensityArray() give direct access to the arrays,
+      e.g. for the iterator based ChromatogramExtractorAlgorithm functions
+      (with @p MZType = double).
+
+    @ingroup Kernel
+  */
+  template <typename MZType = double>
+  class MSSpectrumArrays
+  {
+public:
+
+    /// Peak type used for conversions (see push_back())
+    typedef Peak1D PeakType;
+    /// Intensity type
+    typedef PeakType::IntensityType IntensityType;
+    /// m/z array type
+    typedef std::vector<MZType> MZArray;
+    /// Intensity array type
+    typedef std::vector<IntensityType> IntensityArray;
+
+    /// Read-only reference to a single peak (see operator[])
+    class ConstPeakReference
+    {
+public:
+      ConstPeakReference(const MZType* mz, const IntensityType* intensity) :
+        mz_(mz),
+        intensity_(intensity)
+      {
+      }
+
+      /// Returns the m/z of the peak
+      inline double getMZ() const
+      {
+        return *mz_;
+      }
+
+      /// Returns the intensity of the peak
+      inline IntensityType getIntensity() const
+      {
+        return *intensity_;
+      }
+
+protected:
+      const MZType* mz_;
+      const IntensityType* intensity_;
+    };
+
+    /// Default constructor
+    MSSpectrumArrays() :
+      rt_(-1.0),
+      ms_level_(1)
+    {
+    }
+
+    /// Conversion from MSSpectrum (peaks, retention time and MS level)
+    template <typename PeakT>
+    explicit MSSpectrumArrays(const MSSpectrum<PeakT>& spectrum) :
+      rt_(-1.0),
+      ms_level_(1)
+    {
+      assign(spectrum);
+    }
+
+    /// Equality operator (compares peaks, retention time and MS level)
+    bool operator==(const MSSpectrumArrays& rhs) const
+    {
+      return rt_ == rhs.rt_ &&
+             ms_level_ == rhs.ms_level_ &&
+             mz_ == rhs.mz_ &&
+             intensity_ == rhs.intensity_;
+    }
+
+    /// Inequality operator
+    bool operator!=(const MSSpectrumArrays& rhs) const
+    {
+      return !(operator==(rhs));
+    }
+
+    /// Replaces the content by the peaks, retention time and MS level of @p spectrum
+    template <typename PeakT>
+    void assign(const MSSpectrum<PeakT>& spectrum)
+    {
+      rt_ = spectrum.getRT();
+      ms_level_ = spectrum.getMSLevel();
+      mz_.resize(spectrum.size());
+      intensity_.resize(spectrum.size());
+      for (Size i = 0; i < spectrum.size(); ++i)
+      {
+        mz_[i] = spectrum[i].getMZ();
+        intensity_[i] = spectrum[i].getIntensity();
+      }
+    }
+
+    /**
+      @brief Writes the peaks, retention time and MS level to @p spectrum
+
+      All other meta data of @p spectrum is kept, except for its data arrays
+      (which would no longer match the peaks).
+    */
+    template <typename PeakT>
+    void toSpectrum(MSSpectrum<PeakT>& spectrum) const
+    {
+      spectrum.clear(false);
+      spectrum.getFloatDataArrays().clear();
+      spectrum.getStringDataArrays().clear();
+      spectrum.getIntegerDataArrays().clear();
+      spectrum.setRT(rt_);
+      spectrum.setMSLevel(ms_level_);
+      spectrum.reserve(mz_.size());
+      PeakT p;
+      for (Size i = 0; i < mz_.size(); ++i)
+      {
+        p.setMZ(mz_[i]);
+        p.setIntensity(intensity_[i]);
+        spectrum.push_back(p);
+      }
+    }
+
+    /// Returns the retention time
+    inline double getRT() const
+    {
+      return rt_;
+    }
+
+    /// Sets the retention time
+    inline void setRT(double rt)
+    {
+      rt_ = rt;
+    }
+
+    /// Returns the MS level
+    inline UInt getMSLevel() const
+    {
+      return ms_level_;
+    }
+
+    /// Sets the MS level
+    inline void setMSLevel(UInt ms_level)
+    {
+      ms_level_ = ms_level;
+    }
+
+    ///@name Peak access
+    ///@{
+    /// Returns the number of peaks
+    inline Size size() const
+    {
+      return mz_.size();
+    }
+
+    /// Returns true if there are no peaks
+    inline bool empty() const
+    {
+      return mz_.empty();
+    }
+
+    /// Removes all peaks (the retention time and MS level are kept)
+    void clear()
+    {
+      mz_.clear();
+      intensity_.clear();
+    }
+
+    /// Reserves space for @p n peaks
+    void reserve(Size n)
+    {
+      mz_.reserve(n);
+      intensity_.reserve(n);
+    }
+
+    /// Appends a peak
+    inline void push_back(MZType mz, IntensityType intensity)
+    {
+      mz_.push_back(mz);
+      intensity_.push_back(intensity);
+    }
+
+    /// Appends a peak
+    inline void push_back(const PeakType& peak)
+    {
+      mz_.push_back(peak.getMZ());
+      intensity_.push_back(peak.getIntensity());
+    }
+
+    /// Returns a read-only reference to the peak at index @p i
+    inline ConstPeakReference operator[](Size i) const
+    {
+      return ConstPeakReference(&mz_[i], &intensity_[i]);
+    }
+
+    /// Returns the m/z of the peak at index @p i
+    inline MZType getMZ(Size i) const
+    {
+      return mz_[i];
+    }
+
+    /// Returns the intensity of the peak at index @p i
+    inline IntensityType getIntensity(Size i) const
+    {
+      return intensity_[i];
+    }
+
+    /// Returns the m/z array
+    inline const MZArray& getMZArray() const
+    {
+      return mz_;
+    }
+
+    /**
+      @brief Returns the mutable m/z array (e.g. to swap in existing data)
+
+      @note The m/z and the intensity array must have the same size before
+      any other member is used.
+    */
+    inline MZArray& getMZArray()
+    {
+      return mz_;
+    }
+
+    /// Returns the intensity array
+    inline const IntensityArray& getIntensityArray() const
+    {
+      return intensity_;
+    }
+
+    /**
+      @brief Returns the mutable intensity array (e.g. to swap in existing data)
+
+      @note The m/z and the intensity array must have the same size before
+      any other member is used.
+    */
+    inline IntensityArray& getIntensityArray()
+    {
+      return intensity_;
+    }
+    ///@}
+
+    ///@name Sorting and searching
+    ///@{
+    /// Sorts the peaks by ascending m/z (stable, i.e. peaks with equal m/z keep their order)
+    void sortByPosition()
+    {
+      if (isSorted()) return;
+
+      std::vector<Size> indices(mz_.size());
+      for (Size i = 0; i < indices.size(); ++i)
+      {
+        indices[i] = i;
+      }
+      std::stable_sort(indices.begin(), indices.end(), IndexMZLess_(mz_));
+
+      MZArray mz(mz_.size());
+      IntensityArray intensity(intensity_.size());
+      for (Size i = 0; i < indices.size(); ++i)
+      {
+        mz[i] = mz_[indices[i]];
+        intensity[i] = intensity_[indices[i]];
+      }
+      mz_.swap(mz);
+      intensity_.swap(intensity);
+    }
+
+    /// Checks if all peaks are sorted with respect to ascending m/z
+    bool isSorted() const
+    {
+      for (Size i = 1; i < mz_.size(); ++i)
+      {
+        if (mz_[i - 1] > mz_[i]) return false;
+      }
+      return true;
+    }
+
+    /**
+      @brief Binary search for the index of the first peak with m/z >= @p mz (size() if there is none)
+
+      @note Make sure the spectrum is sorted with respect to m/z! Otherwise the result is undefined.
+    */
+    Size MZBegin(double mz) const
+    {
+      return std::lower_bound(mz_.begin(), mz_.end(), mz, MZValueLess_()) - mz_.begin();
+    }
+
+    /**
+      @brief Binary search for the index of the first peak with m/z > @p mz (size() if there is none)
+
+      @note Make sure the spectrum is sorted with respect to m/z! Otherwise the result is undefined.
+    */
+    Size MZEnd(double mz) const
+    {
+      return std::upper_bound(mz_.begin(), mz_.end(), mz, ValueMZLess_()) - mz_.begin();
+    }
+
+    /**
+      @brief Binary search for the peak nearest to a specific m/z
+
+      @return Returns the index of the peak.
+
+      @note Make sure the spectrum is sorted with respect to m/z! Otherwise the result is undefined.
+
+      @exception Exception::Precondition is thrown if the spectrum is empty
+    */
+    Size findNearest(double mz) const
+    {
+      if (mz_.empty()) throw Exception::Precondition(__FILE__, __LINE__, __PRETTY_FUNCTION__, "There must be at least one peak to determine the nearest peak!");
+
+      Size i = MZBegin(mz);
+      if (i == 0) return 0;
+      if (i == mz_.size()) return mz_.size() - 1;
+      // the peak before or the current peak are closest
+      if (std::fabs(mz_[i] - mz) < std::fabs(mz_[i - 1] - mz))
+      {
+        return i;
+      }
+      return i - 1;
+    }
+
+    /**
+      @brief Binary search for the peak nearest to a specific m/z given a +/- tolerance window in Th
+
+      @return Returns the index of the peak or -1 if no peak is present in the tolerance window or if the spectrum is empty
+
+      @note Make sure the spectrum is sorted with respect to m/z! Otherwise the result is undefined.
+      @note Peaks exactly on borders are considered in tolerance window.
+    */
+    Int findNearest(double mz, double tolerance) const
+    {
+      if (mz_.empty()) return -1;
+      Size i = findNearest(mz);
+      const double found_mz = mz_[i];
+      if (found_mz >= mz - tolerance && found_mz <= mz + tolerance)
+      {
+        return static_cast<Int>(i);
+      }
+      return -1;
+    }
+    ///@}
+
+protected:
+
+    /// Compares m/z values with a search value (for std::lower_bound)
+    struct MZValueLess_
+    {
+      inline bool operator()(MZType mz, double value) const
+      {
+        return mz < value;
+      }
+    };
+
+    /// Compares a search value with m/z values (for std::upper_bound)
+    struct ValueMZLess_
+    {
+      inline bool operator()(double value, MZType mz) const
+      {
+        return value < mz;
+      }
+    };
+
+    /// Compares peak indices by m/z (for sorting)
+    struct IndexMZLess_
+    {
+      explicit IndexMZLess_(const MZArray& mz) :
+        mz_(mz)
+      {
+      }
+
+      inline bool operator()(Size a, Size b) const
+      {
+        return mz_[a] < mz_[b];
+      }
+
+      const MZArray& mz_;
+    };
+
+    double rt_;
+    UInt ms_level_;
+    MZArray mz_;
+    IntensityArray intensity_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_KERNEL_MSSPECTRUMARRAYS_H
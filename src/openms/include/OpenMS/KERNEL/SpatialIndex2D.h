@@ -0,0 +1,186 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_KERNEL_SPATIALINDEX2D_H
+#define OPENMS_KERNEL_SPATIALINDEX2D_H
+
+#include <OpenMS/DATASTRUCTURES/DBoundingBox.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/PeakIndex.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  class FeatureMap;
+  class ConsensusMap;
+
+  /**
+    @brief Grid index for rectangular and nearest neighbor queries in the RT/m/z plane
+
+    Each item (a peak, feature or consensus feature) is represented by a
+    bounding box with RT as first and m/z as second dimension (a point
+    for peaks and feature centroids). The area covered by all items is
+    divided into a uniform grid of tiles, and each item is registered
+    in all tiles its box overlaps. Queries then only look at the tiles
+    overlapping the query area (see findInArea()) or at the tiles around
+    the query position (see findNearest()) instead of all items.
+
+    The index does not keep a reference to the data it was built from,
+    i.e. it has to be rebuilt when the data changes. Items are identified
+    by their index in the data (see getPeakIndex() for peak maps).
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI SpatialIndex2D
+  {
+public:
+    /// Bounding box type (dimension 0: RT, dimension 1: m/z)
+    typedef DBoundingBox<2> BoxType;
+
+    /// Default constructor (empty index)
+    SpatialIndex2D();
+
+    /**
+      @brief Builds the index for the given boxes
+
+      Item @em i is the box @p boxes[i]. Empty boxes (minimum larger than
+      maximum, e.g. default-constructed ones) are never reported.
+
+      @param boxes Item boxes
+      @param items_per_tile Average number of items per tile the grid size is chosen for
+
+      @exception Exception::InvalidSize if there are more than 2^32 - 1 items
+    */
+    void build(const std::vector<BoxType>& boxes, Size items_per_tile = 4);
+
+    /**
+      @brief Builds the index for the features of @p map
+
+      @param map The features
+      @param use_convex_hulls Use the bounding box of the convex hull(s) instead of the centroid
+
+      @exception Exception::InvalidSize if there are more than 2^32 - 1 features
+    */
+    void build(const FeatureMap& map, bool use_convex_hulls = false);
+
+    /**
+      @brief Builds the index for the consensus features of @p map
+
+      @param map The consensus features
+      @param use_subelements Use the bounding box of the sub-element positions instead of the centroid
+
+      @exception Exception::InvalidSize if there are more than 2^32 - 1 consensus features
+    */
+    void build(const ConsensusMap& map, bool use_subelements = false);
+
+    /**
+      @brief Builds the index for the peaks of all spectra of MS level @p ms_level in @p map
+
+      Items are numbered consecutively over all spectra (see getPeakIndex()).
+
+      @exception Exception::InvalidSize if there are more than 2^32 - 1 peaks
+    */
+    void build(const MSExperiment<>& map, UInt ms_level = 1);
+
+    /// Removes all items
+    void clear();
+
+    /// Returns the number of items
+    Size size() const;
+
+    /// Returns true if the index contains no items
+    bool empty() const;
+
+    /// Returns the box of item @p item
+    const BoxType& getBox(Size item) const;
+
+    /**
+      @brief Returns the peak/feature index of item @p item
+
+      For an index over a peak map, this is the spectrum and peak index;
+      otherwise only the peak index (i.e. the feature index) is set.
+    */
+    PeakIndex getPeakIndex(Size item) const;
+
+    /**
+      @brief Finds all items whose box intersects the given area (borders included)
+
+      @p items is cleared and filled with the items in ascending order.
+    */
+    void findInArea(double rt_min, double rt_max, double mz_min, double mz_max, std::vector<Size>& items) const;
+
+    /**
+      @brief Finds the @p k items closest to the given position
+
+      The distance of an item is the distance of the position to the
+      nearest point of its box, with RT differences divided by
+      @p rt_scale and m/z differences divided by @p mz_scale (i.e. they
+      define which RT and m/z differences count as equally far).
+
+      @p items is cleared and filled with (at most) @p k items, sorted by
+      distance (ties by item).
+
+      @exception Exception::InvalidValue if @p rt_scale or @p mz_scale is not positive
+    */
+    void findNearest(double rt, double mz, Size k, std::vector<Size>& items, double rt_scale = 1.0, double mz_scale = 1.0) const;
+
+protected:
+
+    /// Tile coordinate of @p value in the given dimension (clamped to the grid)
+    Size tileOf_(double value, UInt dim) const;
+
+    /// Sets up the grid and the tiles for boxes_
+    void buildTiles_(Size items_per_tile);
+
+    /// boxes of all items
+    std::vector<BoxType> boxes_;
+    /// start of each spectrum in the item numbering (peak maps only, one entry more than spectra)
+    std::vector<Size> spectrum_offsets_;
+    /// area covered by the grid
+    BoxType grid_area_;
+    /// number of tiles per dimension
+    Size tile_count_[2];
+    /// size of a tile per dimension
+    double tile_size_[2];
+    /// start of each tile in tile_items_ (row-wise in RT, one entry more than tiles)
+    std::vector<Size> tile_offsets_;
+    /// items of all tiles
+    std::vector<UInt32> tile_items_;
+  };
+
+}
+
+#endif // OPENMS_KERNEL_SPATIALINDEX2D_H
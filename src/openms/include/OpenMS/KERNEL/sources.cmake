@@ -23,6 +23,7 @@ MRMTransitionGroup.h
 MSChromatogram.h
 MSExperiment.h
 MSSpectrum.h
+MSSpectrumArrays.h
 OnDiscMSExperiment.h
 Peak1D.h
 Peak2D.h
@@ -31,6 +32,7 @@ RangeManager.h
 RangeUtils.h
 RichPeak1D.h
 RichPeak2D.h
+SpatialIndex2D.h
 StandardTypes.h
 )
 
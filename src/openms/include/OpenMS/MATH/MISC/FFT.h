@@ -0,0 +1,85 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_MATH_MISC_FFT_H
+#define OPENMS_MATH_MISC_FFT_H
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <complex>
+#include <vector>
+
+namespace OpenMS
+{
+  namespace Math
+  {
+    /**
+      @brief Minimal fast Fourier transform (radix-2) and FFT-based convolution
+
+      Intended for the moderately sized, one-dimensional problems occurring
+      in OpenMS (e.g. convolution powers of isotope distributions), where
+      pulling in an external FFT library is not worth it. Transforms are
+      computed in place by the iterative Cooley-Tukey algorithm and thus
+      require a power of two as input size (see nextPowerOfTwo()).
+
+      @ingroup Math
+    */
+    class OPENMS_DLLAPI FFT
+    {
+public:
+      /// Returns the smallest power of two which is greater than or equal to @p n (1 for @p n = 0)
+      static Size nextPowerOfTwo(Size n);
+
+      /**
+        @brief Computes the discrete Fourier transform of @p data in place
+
+        The inverse transform is scaled by 1 / @p data.size(), so that
+        transforming forth and back yields the original data.
+
+        @exception Exception::InvalidSize if the size of @p data is not a power of two
+      */
+      static void transform(std::vector<std::complex<double> >& data, bool inverse = false);
+
+      /**
+        @brief Computes the linear convolution of @p a and @p b
+
+        @p result has a.size() + b.size() - 1 entries (none if one of the inputs is empty).
+      */
+      static void convolve(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& result);
+    };
+
+  }
+}
+
+#endif // OPENMS_MATH_MISC_FFT_H
@@ -36,11 +36,15 @@
 #define OPENMS_METADATA_METAINFO_H
 
 #include <vector>
+#include <utility>
 
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 #include <OpenMS/DATASTRUCTURES/DataValue.h>
 
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+
 namespace OpenMS
 {
   class String;
@@ -62,6 +66,11 @@ namespace OpenMS
       member. MetaInfoInterface implements a full interface to a MetaInfo
       member and is more memory efficient if no meta info gets added.
 
+      The values are stored in a vector sorted by index. The first few values
+      are stored inside the object itself, so small MetaInfo objects need no
+      further allocation; larger ones use a single contiguous block. Lookups
+      are done by binary search.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI MetaInfo
@@ -120,10 +129,35 @@ public:
     void clear();
 
 private:
+    /// Index and value of a meta value
+    typedef std::pair<UInt, DataValue> Entry_;
+
+    /// Number of entries stored inside the object
+    enum { INLINE_CAPACITY = 4 };
+
+    /// Returns the first entry with an index not less than @p index
+    Entry_* lowerBound_(UInt index) const;
+
+    /// Returns the entry with @p index or 0 if there is none
+    Entry_* find_(UInt index) const;
+
+    /// Makes room for at least @p capacity entries (keeps existing entries)
+    void reserve_(Size capacity);
+
+    /// Destroys all entries and releases heap memory
+    void destroy_();
+
     /// Static MetaInfoRegistry
     static MetaInfoRegistry registry_;
-    /// The actual mapping of indexes to values
-    std::map<UInt, DataValue> index_to_value_;
+
+    /// Inline storage for the first entries
+    boost::aligned_storage<INLINE_CAPACITY * sizeof(Entry_), boost::alignment_of<Entry_>::value>::type inline_storage_;
+    /// Entries sorted by index (points to inline_storage_ or to heap memory)
+    Entry_* entries_;
+    /// Number of entries
+    UInt size_;
+    /// Number of entries that fit into entries_
+    UInt capacity_;
 
   };
 
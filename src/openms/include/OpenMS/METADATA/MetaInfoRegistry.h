@@ -37,6 +37,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/CONCEPT/Types.h>
@@ -69,6 +70,20 @@ namespace OpenMS
       12 - low_quality<BR>
       13 - charge<BR>
 
+      All methods may be called concurrently from several threads (except for
+      assigning to a registry which is in use). Names are looked up without
+      any locking (see getIndex() and getName()): registered names are never
+      changed or removed, so readers only need to find a published entry.
+      Registering new names and accessing descriptions and units is
+      serialized by an OpenMP critical section.
+
+      Internally, entries are stored in fixed-size blocks addressed by their
+      index, and an open-addressing hash table maps names to indices. New
+      entries (and grown hash tables) are only published after they have
+      been fully initialized (flush before the pointer is written, flush
+      after it is read); replaced hash tables are kept until the registry is
+      destroyed since readers may still be using them.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI MetaInfoRegistry
@@ -160,16 +175,61 @@ public:
     String getUnit(const String& name) const;
 
 private:
+    /// A registered name with its description and unit
+    struct Entry_
+    {
+      String name;
+      String description;
+      String unit;
+    };
+
+    /// Pointer to an entry (null if the index is not registered)
+    typedef Entry_* volatile EntryPtr_;
+
+    /// Hash table from name to index (open addressing, 0 marks an empty slot)
+    struct NameTable_
+    {
+      UInt mask;
+      volatile UInt* slots;
+    };
+
+    enum
+    {
+      BLOCK_SIZE = 4096, ///< number of entries per block
+      MAX_BLOCKS = 1024 ///< maximum number of blocks (limits the highest index)
+    };
+
+    /// Sets up an empty registry (without the reserved names)
+    void init_();
+
+    /// Frees all memory
+    void clear_();
+
+    /// Adds a new entry for @p name at @p index (< MAX_BLOCKS * BLOCK_SIZE) and publishes it (requires the lock)
+    void insert_(UInt index, const String& name, const String& description, const String& unit);
+
+    /// Adds @p index at the position of @p name to @p table (requires the lock)
+    void insertIntoTable_(NameTable_* table, const String& name, UInt index);
+
+    /// Returns the entry for @p index or 0 if unregistered (lock-free)
+    const Entry_* findEntry_(UInt index) const;
+
+    /// Returns the index of @p name or UInt(-1) if unregistered (lock-free)
+    UInt findIndex_(const String& name) const;
+
+    /// Hash function for names
+    static UInt hash_(const String& name);
+
     /// internal counter, that stores the next index to assign
     UInt next_index_;
-    /// map from name to index
-    std::map<String, UInt> name_to_index_;
-    /// map from index to name
-    std::map<UInt, String> index_to_name_;
-    /// map from index to description
-    std::map<UInt, String> index_to_description_;
-    /// map from index to unit
-    std::map<UInt, String> index_to_unit_;
+    /// number of registered names
+    UInt name_count_;
+    /// entries by index (blocks_[index / BLOCK_SIZE][index % BLOCK_SIZE])
+    EntryPtr_* volatile blocks_[MAX_BLOCKS];
+    /// current hash table from name to index
+    NameTable_* volatile name_table_;
+    /// hash tables replaced by name_table_
+    std::vector<NameTable_*> retired_name_tables_;
 
   };
 
@@ -36,6 +36,7 @@
 #define OPENMS_TRANSFORMATIONS_RAW2PEAK_PEAKPICKERHIRES_H
 
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/MSSpectrumArrays.h>
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
@@ -136,20 +137,303 @@ public:
       // don't pick a spectrum with less than 5 data points
       if (input.size() < 5) return;
 
-      // if both spacing constraints are disabled, don't check spacings at all:
-      if ((spacing_difference_ == std::numeric_limits<double>::infinity()) &&
-          (spacing_difference_gap_ == std::numeric_limits<double>::infinity()))
+      // signal-to-noise estimation
+      std::vector<double> snt_values;
+      if (signal_to_noise_ > 0.0)
       {
-        check_spacings = false;
+        computeSignalToNoise_(input, snt_values);
       }
 
-      // signal-to-noise estimation
+      pick_(input, snt_values, output, report_FWHM_ ? &output.getFloatDataArrays()[0] : 0, boundaries, check_spacings);
+    }
+
+    /**
+     * @brief Applies the peak-picking algorithm to a single spectrum stored
+     * as separate m/z and intensity arrays (MSSpectrumArrays). The resulting
+     * picked peaks are written to the output spectrum. Peak boundaries are
+     * written to a separate structure.
+     *
+     * With @p MZType = double, the picked peaks are the same as for the
+     * corresponding MSSpectrum. Since MSSpectrumArrays has no data arrays,
+     * the FWHM of the peaks are not reported (see parameter report_FWHM). If
+     * signal-to-noise filtering is enabled, a temporary MSSpectrum is created
+     * for the noise estimation.
+     *
+     * @param input  input spectrum in profile mode
+     * @param output  output spectrum with picked peaks
+     * @param boundaries  boundaries of the picked peaks
+     */
+    template <typename MZType>
+    void pick(const MSSpectrumArrays<MZType>& input, MSSpectrumArrays<MZType>& output, std::vector<PeakBoundary>& boundaries) const
+    {
+      output.clear();
+      output.setRT(input.getRT());
+      output.setMSLevel(input.getMSLevel());
+
+      // don't pick a spectrum with less than 5 data points
+      if (input.size() < 5) return;
+
+      // signal-to-noise estimation (the estimator works on MSSpectrum only)
+      std::vector<double> snt_values;
+      if (signal_to_noise_ > 0.0)
+      {
+        MSSpectrum<Peak1D> spectrum;
+        input.toSpectrum(spectrum);
+        computeSignalToNoise_(spectrum, snt_values);
+      }
+
+      pick_(input, snt_values, output, 0, boundaries, true);
+    }
+
+    /**
+     * @brief Applies the peak-picking algorithm to a single spectrum stored
+     * as separate m/z and intensity arrays (MSSpectrumArrays). The resulting
+     * picked peaks are written to the output spectrum.
+     *
+     * @param input  input spectrum in profile mode
+     * @param output  output spectrum with picked peaks
+     */
+    template <typename MZType>
+    void pick(const MSSpectrumArrays<MZType>& input, MSSpectrumArrays<MZType>& output) const
+    {
+      std::vector<PeakBoundary> boundaries;
+      pick(input, output, boundaries);
+    }
+
+     /**
+     * @brief Applies the peak-picking algorithm to a single chromatogram
+     * (MSChromatogram). The resulting picked peaks are written to the output chromatogram.
+     *
+     * @param input  input chromatogram in profile mode
+     * @param output  output chromatogram with picked peaks
+     */
+    template <typename PeakType>
+    void pick(const MSChromatogram<PeakType>& input, MSChromatogram<PeakType>& output) const
+    {
+      std::vector<PeakBoundary> boundaries;
+      pick(input, output, boundaries);
+    }
+
+    /**
+     * @brief Applies the peak-picking algorithm to a single chromatogram
+     * (MSChromatogram). The resulting picked peaks are written to the output chromatogram.
+     *
+     * @param input  input chromatogram in profile mode
+     * @param output  output chromatogram with picked peaks
+     * @param boundaries  boundaries of the picked peaks
+     */
+    template <typename PeakType>
+    void pick(const MSChromatogram<PeakType>& input, MSChromatogram<PeakType>& output, std::vector<PeakBoundary>& boundaries) const
+    {
+      // copy meta data of the input chromatogram
+      output.clear(true);
+      output.ChromatogramSettings::operator=(input);
+      output.MetaInfoInterface::operator=(input);
+      output.setName(input.getName());
+
+      MSSpectrum<PeakType> input_spectrum;
+      MSSpectrum<PeakType> output_spectrum;
+      for (typename MSChromatogram<PeakType>::const_iterator it = input.begin(); it != input.end(); ++it)
+      {
+        input_spectrum.push_back(*it);
+      }
+      pick(input_spectrum, output_spectrum, boundaries, false); // no spacing checks!
+      output.insert(output.begin(), output_spectrum.begin(), output_spectrum.end());
+      // copy float data arrays (for FWHM)
+      output.getFloatDataArrays().resize(output_spectrum.getFloatDataArrays().size());
+      for (Size i = 0; i < output_spectrum.getFloatDataArrays().size(); ++i)
+      {
+        output.getFloatDataArrays()[i].insert(output.getFloatDataArrays()[i].begin(), output_spectrum.getFloatDataArrays()[i].begin(), output_spectrum.getFloatDataArrays()[i].end());
+        output.getFloatDataArrays()[i].setName(output_spectrum.getFloatDataArrays()[i].getName());
+      }
+    }
+
+    /**
+     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
+     * method picks peaks for each scan in the map consecutively. The resulting
+     * picked peaks are written to the output map.
+     *
+     * @param input  input map in profile mode
+     * @param output  output map with picked peaks
+     * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
+     */
+    template <typename PeakType, typename ChromatogramPeakT>
+    void pickExperiment(const MSExperiment<PeakType, ChromatogramPeakT>& input, MSExperiment<PeakType, ChromatogramPeakT>& output, const bool check_spectrum_type = true) const
+    {
+        std::vector<std::vector<PeakBoundary> > boundaries_spec;
+        std::vector<std::vector<PeakBoundary> > boundaries_chrom;
+        pickExperiment(input, output, boundaries_spec, boundaries_chrom, check_spectrum_type);
+    }
+
+    /**
+     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
+     * method picks peaks for each scan in the map consecutively. The resulting
+     * picked peaks are written to the output map.
+     *
+     * @param input  input map in profile mode
+     * @param output  output map with picked peaks
+     * @param boundaries_spec  boundaries of the picked peaks in spectra
+     * @param boundaries_chrom  boundaries of the picked peaks in chromatograms
+     * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
+     */
+    template <typename PeakType, typename ChromatogramPeakT>
+    void pickExperiment(const MSExperiment<PeakType, ChromatogramPeakT>& input, MSExperiment<PeakType, ChromatogramPeakT>& output, std::vector<std::vector<PeakBoundary> >& boundaries_spec, std::vector<std::vector<PeakBoundary> >& boundaries_chrom, const bool check_spectrum_type = true) const
+    {
+      // make sure that output is clear
+      output.clear(true);
+
+      // copy experimental settings
+      static_cast<ExperimentalSettings &>(output) = input;
+
+      // resize output with respect to input
+      output.resize(input.size());
+
+      Size progress = 0;
+      startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
+
+      if (input.getNrSpectra() > 0)
+      {
+        for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+        {
+          if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
+          {
+            output[scan_idx] = input[scan_idx];
+          }
+          else
+          {
+            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
+
+            // determine type of spectral data (profile or centroided)
+            SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType();
+
+            if (spectrum_type == SpectrumSettings::PEAKS && check_spectrum_type)
+            {
+              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            }
+
+            pick(input[scan_idx], output[scan_idx], boundaries_s);
+            boundaries_spec.push_back(boundaries_s);
+          }
+          setProgress(++progress);
+        }
+      }
+
+
+      for (Size i = 0; i < input.getChromatograms().size(); ++i)
+      {
+        MSChromatogram<ChromatogramPeakT> chromatogram;
+        std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
+        pick(input.getChromatograms()[i], chromatogram, boundaries_c);
+        output.addChromatogram(chromatogram);
+        boundaries_chrom.push_back(boundaries_c);
+        setProgress(++progress);
+      }
+      endProgress();
+
+      return;
+    }
+
+    /**
+      @brief Applies the peak-picking algorithm to a map (MSExperiment). This
+      method picks peaks for each scan in the map consecutively. The resulting
+      picked peaks are written to the output map.
+
+      Currently we have to give up const-correctness but we know that everything on disc is constant
+    */
+    template <typename PeakType, typename ChromatogramPeakT>
+    void pickExperiment(/* const */ OnDiscMSExperiment<PeakType, ChromatogramPeakT>& input, MSExperiment<PeakType, ChromatogramPeakT>& output, const bool check_spectrum_type = true) const
+    {
+      // make sure that output is clear
+      output.clear(true);
+
+      // copy experimental settings
+      static_cast<ExperimentalSettings &>(output) = *input.getExperimentalSettings();
+
+      Size progress = 0;
+      startProgress(0, input.size() + input.getNrChromatograms(), "picking peaks");
+
+      if (input.getNrSpectra() > 0)
+      {
+
+        // resize output with respect to input
+        output.resize(input.size());
+
+        for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+        {
+          if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
+          {
+            output[scan_idx] = input[scan_idx];
+          }
+          else
+          {
+            MSSpectrum<PeakType> s = input[scan_idx];
+            s.sortByPosition();
+
+            // determine type of spectral data (profile or centroided)
+            SpectrumSettings::SpectrumType spectrum_type = s.getType();
+
+            if (spectrum_type == SpectrumSettings::PEAKS && check_spectrum_type)
+            {
+              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            }
+
+            pick(s, output[scan_idx]);
+          }
+          setProgress(++progress);
+        }
+      }
+
+      for (Size i = 0; i < input.getNrChromatograms(); ++i)
+      {
+        MSChromatogram<ChromatogramPeakT> chromatogram;
+        pick(input.getChromatogram(i), chromatogram);
+        output.addChromatogram(chromatogram);
+        setProgress(++progress);
+      }
+      endProgress();
+
+      return;
+    }
+
+protected:
+    /// Computes the signal-to-noise ratio of every data point of @p input
+    template <typename PeakType>
+    void computeSignalToNoise_(const MSSpectrum<PeakType>& input, std::vector<double>& snt_values) const
+    {
       SignalToNoiseEstimatorMedian<MSSpectrum<PeakType> > snt;
       snt.setParameters(param_.copy("SignalToNoise:", true));
+      snt.init(input);
 
-      if (signal_to_noise_ > 0.0)
+      snt_values.resize(input.size());
+      for (Size i = 0; i < input.size(); ++i)
       {
-        snt.init(input);
+        snt_values[i] = snt.getSignalToNoise(input[i]);
+      }
+    }
+
+    /**
+     * @brief Core of the peak picking, independent of the spectrum layout
+     *
+     * @p InputT has to provide size() and operator[] with getMZ() and
+     * getIntensity() (e.g. MSSpectrum or MSSpectrumArrays), @p OutputT
+     * push_back() of a @p OutputT::PeakType.
+     *
+     * @param input  input spectrum in profile mode (at least 5 data points)
+     * @param snt_values  signal-to-noise ratio of every input data point (only used if signal_to_noise > 0)
+     * @param output  picked peaks are appended here
+     * @param fwhm  FWHM of the picked peaks are appended here (if not null)
+     * @param boundaries  boundaries of the picked peaks
+     * @param check_spacings  check spacing constraints? (yes for spectra, no for chromatograms)
+     */
+    template <typename InputT, typename OutputT>
+    void pick_(const InputT& input, const std::vector<double>& snt_values, OutputT& output, std::vector<float>* fwhm,
+               std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+    {
+      // if both spacing constraints are disabled, don't check spacings at all:
+      if ((spacing_difference_ == std::numeric_limits<double>::infinity()) &&
+          (spacing_difference_gap_ == std::numeric_limits<double>::infinity()))
+      {
+        check_spacings = false;
       }
 
       // find local maxima in raw data
@@ -175,9 +459,9 @@ public:
         double act_snt = 0.0, act_snt_l1 = 0.0, act_snt_r1 = 0.0;
         if (signal_to_noise_ > 0.0)
         {
-          act_snt = snt.getSignalToNoise(input[i]);
-          act_snt_l1 = snt.getSignalToNoise(input[i - 1]);
-          act_snt_r1 = snt.getSignalToNoise(input[i + 1]);
+          act_snt = snt_values[i];
+          act_snt_l1 = snt_values[i - 1];
+          act_snt_r1 = snt_values[i + 1];
         }
 
         // look for peak cores meeting MZ and intensity/SNT criteria
@@ -198,8 +482,8 @@ public:
 
           if (signal_to_noise_ > 0.0)
           {
-            act_snt_l2 = snt.getSignalToNoise(input[i - 2]);
-            act_snt_r2 = snt.getSignalToNoise(input[i + 2]);
+            act_snt_l2 = snt_values[i - 2];
+            act_snt_r2 = snt_values[i + 2];
           }
 
           // checking signal-to-noise?
@@ -243,7 +527,7 @@ public:
 
             if (signal_to_noise_ > 0.0)
             {
-              act_snt_lk = snt.getSignalToNoise(input[i - k]);
+              act_snt_lk = snt_values[i - k];
             }
 
             if ((act_snt_lk >= signal_to_noise_) && 
@@ -284,7 +568,7 @@ public:
 
             if (signal_to_noise_ > 0.0)
             {
-              act_snt_rk = snt.getSignalToNoise(input[i + k]);
+              act_snt_rk = snt_values[i + k];
             }
 
             if ((act_snt_rk >= signal_to_noise_) && 
@@ -354,7 +638,7 @@ public:
           //
           // compute FWHM
           //
-          if (report_FWHM_)
+          if (fwhm != 0)
           {
             double fwhm_int = max_peak_int / 2.0;
             threshold = 0.01 * fwhm_int;
@@ -408,11 +692,11 @@ public:
             }
             const double fwhm_right_mz = mz_mid;
             const double fwhm_absolute = fwhm_right_mz - fwhm_left_mz;
-            output.getFloatDataArrays()[0].push_back( report_FWHM_as_ppm_ ? fwhm_absolute / max_peak_mz  * 1e6 : fwhm_absolute);
+            fwhm->push_back( report_FWHM_as_ppm_ ? fwhm_absolute / max_peak_mz  * 1e6 : fwhm_absolute);
           } // FWHM
 
           // save picked peak into output spectrum
-          PeakType peak;
+          typename OutputT::PeakType peak;
           PeakBoundary peak_boundary;
           peak.setMZ(max_peak_mz);
           peak.setIntensity(max_peak_int);
@@ -426,206 +710,8 @@ public:
           i = i + k - 1;
         }
       }
-
-      return;
     }
 
-     /**
-     * @brief Applies the peak-picking algorithm to a single chromatogram
-     * (MSChromatogram). The resulting picked peaks are written to the output chromatogram.
-     *
-     * @param input  input chromatogram in profile mode
-     * @param output  output chromatogram with picked peaks
-     */
-    template <typename PeakType>
-    void pick(const MSChromatogram<PeakType>& input, MSChromatogram<PeakType>& output) const
-    {
-      std::vector<PeakBoundary> boundaries;
-      pick(input, output, boundaries);
-    }
-
-    /**
-     * @brief Applies the peak-picking algorithm to a single chromatogram
-     * (MSChromatogram). The resulting picked peaks are written to the output chromatogram.
-     *
-     * @param input  input chromatogram in profile mode
-     * @param output  output chromatogram with picked peaks
-     * @param boundaries  boundaries of the picked peaks
-     */
-    template <typename PeakType>
-    void pick(const MSChromatogram<PeakType>& input, MSChromatogram<PeakType>& output, std::vector<PeakBoundary>& boundaries) const
-    {
-      // copy meta data of the input chromatogram
-      output.clear(true);
-      output.ChromatogramSettings::operator=(input);
-      output.MetaInfoInterface::operator=(input);
-      output.setName(input.getName());
-
-      MSSpectrum<PeakType> input_spectrum;
-      MSSpectrum<PeakType> output_spectrum;
-      for (typename MSChromatogram<PeakType>::const_iterator it = input.begin(); it != input.end(); ++it)
-      {
-        input_spectrum.push_back(*it);
-      }
-      pick(input_spectrum, output_spectrum, boundaries, false); // no spacing checks!
-      output.insert(output.begin(), output_spectrum.begin(), output_spectrum.end());
-      // copy float data arrays (for FWHM)
-      output.getFloatDataArrays().resize(output_spectrum.getFloatDataArrays().size());
-      for (Size i = 0; i < output_spectrum.getFloatDataArrays().size(); ++i)
-      {
-        output.getFloatDataArrays()[i].insert(output.getFloatDataArrays()[i].begin(), output_spectrum.getFloatDataArrays()[i].begin(), output_spectrum.getFloatDataArrays()[i].end());
-        output.getFloatDataArrays()[i].setName(output_spectrum.getFloatDataArrays()[i].getName());
-      }
-    }
-
-    /**
-     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
-     *
-     * @param input  input map in profile mode
-     * @param output  output map with picked peaks
-     * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
-     */
-    template <typename PeakType, typename ChromatogramPeakT>
-    void pickExperiment(const MSExperiment<PeakType, ChromatogramPeakT>& input, MSExperiment<PeakType, ChromatogramPeakT>& output, const bool check_spectrum_type = true) const
-    {
-        std::vector<std::vector<PeakBoundary> > boundaries_spec;
-        std::vector<std::vector<PeakBoundary> > boundaries_chrom;
-        pickExperiment(input, output, boundaries_spec, boundaries_chrom, check_spectrum_type);
-    }
-
-    /**
-     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
-     *
-     * @param input  input map in profile mode
-     * @param output  output map with picked peaks
-     * @param boundaries_spec  boundaries of the picked peaks in spectra
-     * @param boundaries_chrom  boundaries of the picked peaks in chromatograms
-     * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
-     */
-    template <typename PeakType, typename ChromatogramPeakT>
-    void pickExperiment(const MSExperiment<PeakType, ChromatogramPeakT>& input, MSExperiment<PeakType, ChromatogramPeakT>& output, std::vector<std::vector<PeakBoundary> >& boundaries_spec, std::vector<std::vector<PeakBoundary> >& boundaries_chrom, const bool check_spectrum_type = true) const
-    {
-      // make sure that output is clear
-      output.clear(true);
-
-      // copy experimental settings
-      static_cast<ExperimentalSettings &>(output) = input;
-
-      // resize output with respect to input
-      output.resize(input.size());
-
-      Size progress = 0;
-      startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
-
-      if (input.getNrSpectra() > 0)
-      {
-        for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
-        {
-          if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-
-            // determine type of spectral data (profile or centroided)
-            SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType();
-
-            if (spectrum_type == SpectrumSettings::PEAKS && check_spectrum_type)
-            {
-              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-            }
-
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            boundaries_spec.push_back(boundaries_s);
-          }
-          setProgress(++progress);
-        }
-      }
-
-
-      for (Size i = 0; i < input.getChromatograms().size(); ++i)
-      {
-        MSChromatogram<ChromatogramPeakT> chromatogram;
-        std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-        pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-        output.addChromatogram(chromatogram);
-        boundaries_chrom.push_back(boundaries_c);
-        setProgress(++progress);
-      }
-      endProgress();
-
-      return;
-    }
-
-    /**
-      @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-      method picks peaks for each scan in the map consecutively. The resulting
-      picked peaks are written to the output map.
-
-      Currently we have to give up const-correctness but we know that everything on disc is constant
-    */
-    template <typename PeakType, typename ChromatogramPeakT>
-    void pickExperiment(/* const */ OnDiscMSExperiment<PeakType, ChromatogramPeakT>& input, MSExperiment<PeakType, ChromatogramPeakT>& output, const bool check_spectrum_type = true) const
-    {
-      // make sure that output is clear
-      output.clear(true);
-
-      // copy experimental settings
-      static_cast<ExperimentalSettings &>(output) = *input.getExperimentalSettings();
-
-      Size progress = 0;
-      startProgress(0, input.size() + input.getNrChromatograms(), "picking peaks");
-
-      if (input.getNrSpectra() > 0)
-      {
-
-        // resize output with respect to input
-        output.resize(input.size());
-
-        for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
-        {
-          if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            MSSpectrum<PeakType> s = input[scan_idx];
-            s.sortByPosition();
-
-            // determine type of spectral data (profile or centroided)
-            SpectrumSettings::SpectrumType spectrum_type = s.getType();
-
-            if (spectrum_type == SpectrumSettings::PEAKS && check_spectrum_type)
-            {
-              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-            }
-
-            pick(s, output[scan_idx]);
-          }
-          setProgress(++progress);
-        }
-      }
-
-      for (Size i = 0; i < input.getNrChromatograms(); ++i)
-      {
-        MSChromatogram<ChromatogramPeakT> chromatogram;
-        pick(input.getChromatogram(i), chromatogram);
-        output.addChromatogram(chromatogram);
-        setProgress(++progress);
-      }
-      endProgress();
-
-      return;
-    }
-
-protected:
     // signal-to-noise parameter
     double signal_to_noise_;
 
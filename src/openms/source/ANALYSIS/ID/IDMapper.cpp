@@ -35,6 +35,7 @@
 #include <OpenMS/ANALYSIS/ID/IDMapper.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
+#include <OpenMS/KERNEL/SpatialIndex2D.h>
 
 using namespace std;
 
@@ -115,6 +116,12 @@ namespace OpenMS
     double rt_pep;
     IntList charges;
 
+    // index the consensus feature (or sub-element) positions, so only
+    // features within the tolerances of a peptide have to be checked
+    SpatialIndex2D position_index;
+    position_index.build(map, measure_from_subelements);
+    std::vector<Size> candidates, in_window;
+
     //iterate over the peptide IDs
     for (Size i = 0; i < ids.size(); ++i)
     {
@@ -123,9 +130,24 @@ namespace OpenMS
 
       getIDDetails_(ids[i], rt_pep, mz_values, charges);
 
-      //iterate over the features
-      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+      // collect candidates for all m/z values; the windows are enlarged
+      // slightly, so rounding cannot lose matches (isMatch_() decides)
+      candidates.clear();
+      const double rt_window = rt_tolerance_ * (1.0 + 1e-6) + 1e-6;
+      for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
+      {
+        const double mz_window = getAbsoluteMZTolerance_(mz_values[i_mz]) * (1.0 + 1e-6) + 1e-6;
+        position_index.findInArea(rt_pep - rt_window, rt_pep + rt_window, mz_values[i_mz] - mz_window, mz_values[i_mz] + mz_window, in_window);
+        candidates.insert(candidates.end(), in_window.begin(), in_window.end());
+      }
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+      //iterate over the candidate features
+      for (std::vector<Size>::const_iterator cand_it = candidates.begin(); cand_it != candidates.end(); ++cand_it)
       {
+        const Size cm_index = *cand_it;
+
         // if set to TRUE, we leave the i_mz-loop as we added the whole ID with all hits
         bool was_added = false; // was current pep-m/z matched?!
 
@@ -294,29 +316,13 @@ namespace OpenMS
       max_rt = std::max(max_rt, box.maxPosition().getX());
     }
     
-    // hash bounding boxes of features by RT:
-    // RT range is partitioned into slices (bins) of 1 second; every feature
-    // that overlaps a certain slice is hashed into the corresponding bin
-    std::vector<std::vector<SignedSize> > hash_table;
-    // make sure the RT hash table has indices >= 0 and doesn't waste space
-    // in the beginning:
-    SignedSize offset(0);
+    // index the bounding boxes in RT and m/z, so only features whose box
+    // encloses a peptide position have to be looked at
+    SpatialIndex2D box_index;
     
     if (map.size() > 0)
     {
-      // std::cout << "Setting up hash table..." << std::endl;
-      offset = SignedSize(floor(min_rt));
-      // this only works if features were found
-      hash_table.resize(SignedSize(floor(max_rt)) - offset + 1);
-      for (Size index = 0; index < boxes.size(); ++index)
-      {
-        const DBoundingBox<2> & box = boxes[index];
-        for (SignedSize i = SignedSize(floor(box.minPosition().getX()));
-             i <= SignedSize(floor(box.maxPosition().getX())); ++i)
-        {
-          hash_table[i - offset].push_back(index);
-        }
-      }
+      box_index.build(boxes);
     }
     else
     {
@@ -347,14 +353,23 @@ namespace OpenMS
         continue;
       }
       
+      // candidate features (box encloses the position for at least one m/z):
+      std::vector<Size> candidates, enclosing;
+      for (DoubleList::iterator mz_it = mz_values.begin();
+           mz_it != mz_values.end(); ++mz_it)
+      {
+        box_index.findInArea(rt_value, rt_value, *mz_it, *mz_it, enclosing);
+        candidates.insert(candidates.end(), enclosing.begin(), enclosing.end());
+      }
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+      
       // iterate over candidate features:
-      Size index = SignedSize(floor(rt_value)) - offset;
       Size matching_features = 0;
-      for (std::vector<SignedSize>::iterator hash_it =
-           hash_table[index].begin(); hash_it != hash_table[index].end();
-           ++hash_it)
+      for (std::vector<Size>::iterator cand_it = candidates.begin();
+           cand_it != candidates.end(); ++cand_it)
       {
-        Feature & feat = map[*hash_it];
+        Feature & feat = map[*cand_it];
         
         // need to check the charge state?
         bool check_charge = !ignore_charge_;
@@ -375,7 +390,7 @@ namespace OpenMS
           }
           
           DPosition<2> id_pos(rt_value, *mz_it);
-          if (boxes[*hash_it].encloses(id_pos))                 // potential match
+          if (boxes[*cand_it].encloses(id_pos))                 // potential match
           {
             if (use_centroid_mz)
             {
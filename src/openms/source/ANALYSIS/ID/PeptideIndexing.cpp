@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArray.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
 #include <OpenMS/DATASTRUCTURES/SeqanIncludeWrapper.h>
@@ -41,6 +42,7 @@
 #include <OpenMS/METADATA/PeptideEvidence.h>
 #include <OpenMS/CHEMISTRY/EnzymesDB.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/SYSTEM/File.h>
 
 #include <algorithm>
 
@@ -416,6 +418,8 @@ DefaultParamHandler("PeptideIndexing")
     defaults_.setValue("filter_aaa_proteins", "false", "In the tolerant search for matches to proteins with ambiguous amino acids (AAAs), rebuild the search database to only consider proteins with AAAs. This may save time if most proteins don't contain AAAs and if there is a significant number of peptides that enter the tolerant search.");
     defaults_.setValidStrings("filter_aaa_proteins", ListUtils::create<String>("true,false"));
 
+    defaults_.setValue("index_cache_dir", "", "Existing directory to store a persistent index of the protein database in. The index is built on first use (identified by a checksum of the database) and memory-mapped by subsequent runs using the same database, which avoids re-indexing for exact matching. Leave empty to disable.");
+
     defaults_.setValue("log", "", "Name of log file (created only when specified)");
     defaults_.setValue("debug", 0, "Sets the debug level");
 
@@ -444,6 +448,48 @@ DefaultParamHandler("PeptideIndexing")
     }
   }
 
+  bool PeptideIndexing::loadProteinIndex_(const vector<String>& sequences, ProteinSuffixArray& index) const
+  {
+    const UInt64 checksum = ProteinSuffixArray::computeChecksum(sequences);
+    const String filename = ProteinSuffixArray::getCacheFilename(index_cache_dir_, checksum);
+
+    if (File::exists(filename))
+    {
+      try
+      {
+        index.load(filename);
+        if (index.getChecksum() == checksum && index.matches(sequences))
+        {
+          writeLog_("Using cached protein index '" + filename + "'.");
+          return true;
+        }
+      }
+      catch (Exception::BaseException& /* e */)
+      {
+      }
+      LOG_WARN << "Warning: Cached protein index '" << filename << "' is invalid or does not match the database. Rebuilding it..." << endl;
+      index = ProteinSuffixArray(); // release the mapping before replacing the file
+      File::remove(filename);
+    }
+
+    try
+    {
+      StopWatch sw;
+      sw.start();
+      ProteinSuffixArray::build(sequences, filename);
+      index.load(filename);
+      sw.stop();
+      writeLog_(String("Built protein index '") + filename + "' (time: " + sw.getClockTime() + " s (wall), " + sw.getCPUTime() + " s (CPU)).");
+    }
+    catch (Exception::BaseException& e)
+    {
+      LOG_WARN << "Warning: Could not build protein index '" << filename << "' (" << e.what() << "). Using Aho-Corasick instead." << endl;
+      index = ProteinSuffixArray();
+      return false;
+    }
+    return true;
+  }
+
   void PeptideIndexing::updateMembers_()
   {
     decoy_string_ = static_cast<String>(param_.getValue("decoy_string"));
@@ -462,6 +508,7 @@ DefaultParamHandler("PeptideIndexing")
     aaa_max_ = static_cast<Size>(param_.getValue("aaa_max"));
     mismatches_max_ = static_cast<Size>(param_.getValue("mismatches_max"));
     filter_aaa_proteins_ = param_.getValue("filter_aaa_proteins").toBool();
+    index_cache_dir_ = param_.getValue("index_cache_dir");
 
     log_file_ = param_.getValue("log");
     debug_ = static_cast<Size>(param_.getValue("debug")) > 0;
@@ -520,6 +567,7 @@ DefaultParamHandler("PeptideIndexing")
       seqan::StringSet<seqan::Peptide> prot_DB;
 
       vector<String> duplicate_accessions;
+      vector<String> index_sequences; // sequences for the persistent protein index (if enabled)
 
       for (Size i = 0; i != proteins.size(); ++i)
       {
@@ -553,6 +601,10 @@ DefaultParamHandler("PeptideIndexing")
           // extend protein DB
           seqan::appendValue(prot_DB, seq.c_str());
           acc_to_prot[acc] = i;
+          if (!index_cache_dir_.empty())
+          {
+            index_sequences.push_back(seq);
+          }
         }
 
       }
@@ -605,31 +657,61 @@ DefaultParamHandler("PeptideIndexing")
       {
         StopWatch sw;
         sw.start();
+
+        // with a persistent protein index, we look up each peptide directly
+        // instead of building the automaton and scanning all proteins
+        ProteinSuffixArray prot_index;
+        const bool use_prot_index = !index_cache_dir_.empty() && loadProteinIndex_(index_sequences, prot_index);
+        vector<String>().swap(index_sequences); // not needed anymore
+
         SignedSize protDB_length = (SignedSize) length(prot_DB);
+        SignedSize pepDB_length = (SignedSize) length(pep_DB);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
-          seqan::Pattern<seqan::StringSet<seqan::Peptide>, seqan::AhoCorasick> pattern(pep_DB);
           seqan::FoundProteinFunctor func_threads(enzyme);
           writeDebug_("Finding peptide/protein matches ...", 1);
 
+          if (use_prot_index)
+          {
+            vector<ProteinSuffixArray::Hit> hits;
 #pragma omp for
-          // search all peptides in each protein
-          for (SignedSize i = 0; i < protDB_length; ++i)
+            // look up each peptide in the index
+            for (SignedSize i = 0; i < pepDB_length; ++i)
+            {
+              const seqan::Peptide& tmp_pep = pep_DB[i];
+              const String seq_pep(begin(tmp_pep), end(tmp_pep));
+              hits.clear();
+              prot_index.findAll(seq_pep, hits);
+              for (vector<ProteinSuffixArray::Hit>::const_iterator it = hits.begin(); it != hits.end(); ++it)
+              {
+                const seqan::Peptide& tmp_prot = prot_DB[it->protein_index];
+                func_threads.addHit(i, it->protein_index, seq_pep, String(begin(tmp_prot), end(tmp_prot)), it->position);
+              }
+            }
+          }
+          else
           {
-            seqan::Finder<seqan::Peptide> finder(prot_DB[i]);
-            while (find(finder, pattern))
+            seqan::Pattern<seqan::StringSet<seqan::Peptide>, seqan::AhoCorasick> pattern(pep_DB);
+
+#pragma omp for
+            // search all peptides in each protein
+            for (SignedSize i = 0; i < protDB_length; ++i)
             {
-              //seqan::appendValue(pat_hits, seqan::Pair<Size, Size>(position(pattern), position(finder)));
+              seqan::Finder<seqan::Peptide> finder(prot_DB[i]);
+              while (find(finder, pattern))
+              {
+                //seqan::appendValue(pat_hits, seqan::Pair<Size, Size>(position(pattern), position(finder)));
 
-              //func_threads.pep_to_prot[position(pattern)].insert(i);
-              // String(seqan::String<char, seqan::CStyle>(prot_DB[i])), position(finder))
-              // target.assign(begin(source, Standard()), end(source, Standard()));
-              const seqan::Peptide& tmp_pep = pep_DB[position(pattern)];
-              const seqan::Peptide& tmp_prot = prot_DB[i];
+                //func_threads.pep_to_prot[position(pattern)].insert(i);
+                // String(seqan::String<char, seqan::CStyle>(prot_DB[i])), position(finder))
+                // target.assign(begin(source, Standard()), end(source, Standard()));
+                const seqan::Peptide& tmp_pep = pep_DB[position(pattern)];
+                const seqan::Peptide& tmp_prot = prot_DB[i];
 
-              func_threads.addHit(position(pattern), i, String(begin(tmp_pep), end(tmp_pep)), String(begin(tmp_prot), end(tmp_prot)), position(finder));
+                func_threads.addHit(position(pattern), i, String(begin(tmp_pep), end(tmp_pep)), String(begin(tmp_prot), end(tmp_prot)), position(finder));
+              }
             }
           }
 
@@ -650,7 +732,7 @@ DefaultParamHandler("PeptideIndexing")
 
         sw.stop();
 
-        writeLog_(String("\nAho-Corasick done:\n  found ") + func.filter_passed + " hits for " + func.pep_to_prot.size() + " of " + length(pep_DB) + " peptides (time: " + sw.getClockTime() + " s (wall), " + sw.getCPUTime() + " s (CPU)).");
+        writeLog_(String(use_prot_index ? "\nProtein index lookup done:\n  found " : "\nAho-Corasick done:\n  found ") + func.filter_passed + " hits for " + func.pep_to_prot.size() + " of " + length(pep_DB) + " peptides (time: " + sw.getClockTime() + " s (wall), " + sw.getCPUTime() + " s (CPU)).");
       } // end of Aho Corasick
 
       /// now, search using a suffix array -- allows approximate matching:
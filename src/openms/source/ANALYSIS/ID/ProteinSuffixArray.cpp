@@ -0,0 +1,416 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArray.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /// file header of the index (followed by the protein starts, the suffix array and the text)
+    struct IndexHeader
+    {
+      char magic[8];
+      UInt64 byte_order;
+      UInt64 checksum;
+      UInt64 protein_count;
+      UInt64 text_length;
+    };
+
+    const char INDEX_MAGIC[8] = {'O', 'M', 'S', 'P', 'S', 'A', '0', '1'};
+
+    /// written in native byte order; reads back differently on a machine with another endianness
+    const UInt64 BYTE_ORDER_MARK = (UInt64(0x01020304) << 32) | UInt64(0x05060708);
+
+    const char PROTEIN_SEPARATOR = '$';
+
+    /// checks (without overflow) whether a file of @p size bytes holds exactly the given number of proteins and text length
+    bool hasFileSize(Size size, UInt64 protein_count, UInt64 text_length)
+    {
+      if (size < sizeof(IndexHeader)) return false;
+      // the text length is limited to 32 bit by build(), each protein occupies at least its separator
+      if (text_length >= UInt64(std::numeric_limits<UInt32>::max()) || protein_count > text_length) return false;
+      const UInt64 payload = UInt64(size - sizeof(IndexHeader));
+      return payload == (protein_count + 1) * sizeof(UInt64) + text_length * (sizeof(UInt32) + 1);
+    }
+  }
+
+  ProteinSuffixArray::ProteinSuffixArray() :
+    region_(),
+    checksum_(0),
+    protein_count_(0),
+    text_length_(0),
+    starts_(0),
+    sa_(0),
+    text_(0)
+  {
+  }
+
+  ProteinSuffixArray::ProteinSuffixArray(const ProteinSuffixArray& rhs) :
+    region_(rhs.region_),
+    checksum_(rhs.checksum_),
+    protein_count_(rhs.protein_count_),
+    text_length_(rhs.text_length_),
+    starts_(rhs.starts_),
+    sa_(rhs.sa_),
+    text_(rhs.text_)
+  {
+  }
+
+  ProteinSuffixArray& ProteinSuffixArray::operator=(const ProteinSuffixArray& rhs)
+  {
+    if (&rhs == this) return *this;
+
+    region_ = rhs.region_;
+    checksum_ = rhs.checksum_;
+    protein_count_ = rhs.protein_count_;
+    text_length_ = rhs.text_length_;
+    starts_ = rhs.starts_;
+    sa_ = rhs.sa_;
+    text_ = rhs.text_;
+    return *this;
+  }
+
+  ProteinSuffixArray::~ProteinSuffixArray()
+  {
+  }
+
+  UInt64 ProteinSuffixArray::computeChecksum(const std::vector<String>& sequences)
+  {
+    // 64 bit FNV-1a over all sequences (including separators, so that the
+    // partitioning into proteins is part of the checksum)
+    const UInt64 prime = (UInt64(0x100) << 32) | UInt64(0x000001b3);
+    UInt64 hash = (UInt64(0xcbf29ce4) << 32) | UInt64(0x84222325);
+    for (std::vector<String>::const_iterator it = sequences.begin(); it != sequences.end(); ++it)
+    {
+      for (String::const_iterator c = it->begin(); c != it->end(); ++c)
+      {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * prime;
+      }
+      hash = (hash ^ static_cast<unsigned char>(PROTEIN_SEPARATOR)) * prime;
+    }
+    return hash;
+  }
+
+  String ProteinSuffixArray::getCacheFilename(const String& directory, UInt64 checksum)
+  {
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << checksum;
+    return directory + "/" + String(ss.str()) + ".psa";
+  }
+
+  void ProteinSuffixArray::computeSuffixArray_(const String& text, std::vector<UInt32>& sa)
+  {
+    const Size n = text.size();
+    sa.resize(n);
+    if (n == 0) return;
+
+    std::vector<UInt32> rank(n), tmp(n);
+    std::vector<Size> count(std::max(n, Size(256)) + 1, 0);
+
+    // initial ranks are the characters themselves
+    for (Size i = 0; i < n; ++i)
+    {
+      rank[i] = static_cast<unsigned char>(text[i]);
+      ++count[rank[i] + 1];
+    }
+    for (Size c = 1; c < count.size(); ++c) count[c] += count[c - 1];
+    for (Size i = 0; i < n; ++i) sa[count[rank[i]]++] = (UInt32)i;
+
+    // prefix doubling: sort by (rank[i], rank[i + k]) using the order of the
+    // previous round for the second key and a stable counting sort for the first
+    Size classes = 256;
+    for (Size k = 1; k < n; k <<= 1)
+    {
+      // second key: suffixes without a second half come first
+      Size p = 0;
+      for (Size i = n - k; i < n; ++i) tmp[p++] = (UInt32)i;
+      for (Size j = 0; j < n; ++j)
+      {
+        if (sa[j] >= k) tmp[p++] = (UInt32)(sa[j] - k);
+      }
+
+      std::fill(count.begin(), count.begin() + classes + 1, 0);
+      for (Size i = 0; i < n; ++i) ++count[rank[i] + 1];
+      for (Size c = 1; c <= classes; ++c) count[c] += count[c - 1];
+      for (Size j = 0; j < n; ++j) sa[count[rank[tmp[j]]]++] = tmp[j];
+
+      // assign new ranks
+      tmp[sa[0]] = 0;
+      for (Size j = 1; j < n; ++j)
+      {
+        const Size a = sa[j - 1], b = sa[j];
+        const bool same = rank[a] == rank[b] && (a + k < n) == (b + k < n) && (a + k >= n || rank[a + k] == rank[b + k]);
+        tmp[b] = tmp[a] + (same ? 0 : 1);
+      }
+      rank.swap(tmp);
+
+      classes = rank[sa[n - 1]] + 1;
+      if (classes == n) break; // all suffixes are distinguished
+    }
+  }
+
+  void ProteinSuffixArray::build(const std::vector<String>& sequences, const String& filename)
+  {
+    Size text_length = 0;
+    for (std::vector<String>::const_iterator it = sequences.begin(); it != sequences.end(); ++it)
+    {
+      text_length += it->size() + 1;
+    }
+    if (text_length >= Size(std::numeric_limits<UInt32>::max()))
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, __PRETTY_FUNCTION__, text_length);
+    }
+
+    std::vector<UInt64> starts;
+    starts.reserve(sequences.size() + 1);
+    String text;
+    text.reserve(text_length);
+    for (std::vector<String>::const_iterator it = sequences.begin(); it != sequences.end(); ++it)
+    {
+      starts.push_back(text.size());
+      text += *it;
+      text += PROTEIN_SEPARATOR;
+    }
+    starts.push_back(text.size());
+
+    std::vector<UInt32> sa;
+    computeSuffixArray_(text, sa);
+
+    IndexHeader header;
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.checksum = computeChecksum(sequences);
+    header.protein_count = sequences.size();
+    header.text_length = text.size();
+
+    // write to a temporary file first and rename it afterwards, so other
+    // processes looking for the index never see a partially written file
+    String tmp_filename = filename + "." + File::getUniqueName() + ".tmp";
+    {
+      std::ofstream ofs(tmp_filename.c_str(), std::ios::binary);
+      if (!ofs)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, tmp_filename);
+      }
+      ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      ofs.write(reinterpret_cast<const char*>(&starts[0]), starts.size() * sizeof(UInt64));
+      if (!sa.empty())
+      {
+        ofs.write(reinterpret_cast<const char*>(&sa[0]), sa.size() * sizeof(UInt32));
+      }
+      ofs.write(text.c_str(), text.size());
+      if (!ofs)
+      {
+        ofs.close();
+        File::remove(tmp_filename);
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+      }
+    }
+
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    {
+      File::remove(tmp_filename);
+      // another process may have created the very same index in the meantime (rename fails on Windows then)
+      if (!File::exists(filename))
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+      }
+    }
+  }
+
+  void ProteinSuffixArray::load(const String& filename)
+  {
+    boost::shared_ptr<boost::interprocess::mapped_region> region;
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+      region = boost::shared_ptr<boost::interprocess::mapped_region>(
+        new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception& /* e */)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+    }
+
+    const char* begin = static_cast<const char*>(region->get_address());
+    const Size size = region->get_size();
+
+    if (size < sizeof(IndexHeader))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "File is too small to contain a protein index.");
+    }
+    IndexHeader header;
+    std::memcpy(&header, begin, sizeof(header));
+    if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "File is not a protein index.");
+    }
+    if (header.byte_order != BYTE_ORDER_MARK)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "Protein index was written on a machine with different byte order.");
+    }
+    if (!hasFileSize(size, header.protein_count, header.text_length))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "Protein index is truncated or corrupt.");
+    }
+
+    // validate the structure once, so that lookups never read outside of the mapping
+    const Size protein_count = header.protein_count;
+    const Size text_length = header.text_length;
+    const UInt64* starts = reinterpret_cast<const UInt64*>(begin + sizeof(IndexHeader));
+    const UInt32* sa = reinterpret_cast<const UInt32*>(starts + protein_count + 1);
+    const char* text = reinterpret_cast<const char*>(sa + text_length);
+    bool valid = starts[0] == 0 && starts[protein_count] == text_length;
+    for (Size i = 0; valid && i < protein_count; ++i)
+    {
+      // proteins are stored consecutively, each followed by a separator
+      valid = starts[i] < starts[i + 1] && text[starts[i + 1] - 1] == PROTEIN_SEPARATOR;
+    }
+    for (Size i = 0; valid && i < text_length; ++i)
+    {
+      valid = sa[i] < text_length;
+    }
+    if (!valid)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "Protein index is corrupt.");
+    }
+
+    // we expect random access to the suffix array and text
+    region->advise(boost::interprocess::mapped_region::advice_random);
+
+    region_ = region;
+    checksum_ = header.checksum;
+    protein_count_ = header.protein_count;
+    text_length_ = header.text_length;
+    starts_ = reinterpret_cast<const UInt64*>(begin + sizeof(IndexHeader));
+    sa_ = reinterpret_cast<const UInt32*>(starts_ + protein_count_ + 1);
+    text_ = reinterpret_cast<const char*>(sa_ + text_length_);
+  }
+
+  bool ProteinSuffixArray::matches(const std::vector<String>& sequences) const
+  {
+    if (!isLoaded() || sequences.size() != protein_count_) return false;
+
+    for (Size i = 0; i < protein_count_; ++i)
+    {
+      // stored length excludes the separator
+      const Size length = starts_[i + 1] - starts_[i] - 1;
+      if (sequences[i].size() != length || std::memcmp(text_ + starts_[i], sequences[i].c_str(), length) != 0)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool ProteinSuffixArray::isLoaded() const
+  {
+    return region_.get() != 0;
+  }
+
+  UInt64 ProteinSuffixArray::getChecksum() const
+  {
+    return checksum_;
+  }
+
+  Size ProteinSuffixArray::getNumberOfProteins() const
+  {
+    return protein_count_;
+  }
+
+  int ProteinSuffixArray::compareSuffix_(UInt32 pos, const char* pattern, Size length) const
+  {
+    const Size len = std::min(text_length_ - pos, length);
+    const int cmp = std::memcmp(text_ + pos, pattern, len);
+    if (cmp != 0) return cmp;
+    return (len < length) ? -1 : 0;
+  }
+
+  void ProteinSuffixArray::findAll(const String& peptide, std::vector<Hit>& hits) const
+  {
+    if (peptide.empty() || !isLoaded()) return;
+
+    const char* pattern = peptide.c_str();
+    const Size length = peptide.size();
+
+    // first suffix not smaller than the peptide
+    Size lo = 0, hi = text_length_;
+    while (lo < hi)
+    {
+      const Size mid = lo + (hi - lo) / 2;
+      if (compareSuffix_(sa_[mid], pattern, length) < 0) lo = mid + 1;
+      else hi = mid;
+    }
+    const Size first = lo;
+
+    // first suffix which does not start with the peptide
+    hi = text_length_;
+    while (lo < hi)
+    {
+      const Size mid = lo + (hi - lo) / 2;
+      if (compareSuffix_(sa_[mid], pattern, length) <= 0) lo = mid + 1;
+      else hi = mid;
+    }
+
+    hits.reserve(hits.size() + (lo - first));
+    for (Size i = first; i < lo; ++i)
+    {
+      const UInt64 pos = sa_[i];
+      const Size protein = std::upper_bound(starts_, starts_ + protein_count_ + 1, pos) - starts_ - 1;
+      Hit hit;
+      hit.protein_index = protein;
+      hit.position = pos - starts_[protein];
+      hits.push_back(hit);
+    }
+  }
+
+}
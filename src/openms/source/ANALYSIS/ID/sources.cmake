@@ -23,6 +23,7 @@ MetaboliteSpectralMatching.cpp
 PeptideProteinResolution.cpp
 ProtonDistributionModel.cpp
 PeptideIndexing.cpp
+ProteinSuffixArray.cpp
 )
 
 ### add path to the filenames
@@ -80,6 +80,17 @@ namespace OpenMS
     defaultsToParam_();
   }
 
+  FeatureDistance::FeatureDistance(const FeatureDistance & other) :
+    DefaultParamHandler(other),
+    params_rt_(other.params_rt_), params_mz_(other.params_mz_),
+    params_intensity_(other.params_intensity_),
+    total_weight_reciprocal_(other.total_weight_reciprocal_),
+    max_intensity_(other.max_intensity_),
+    ignore_charge_(other.ignore_charge_),
+    force_constraints_(other.force_constraints_)
+  {
+  }
+
   FeatureDistance::~FeatureDistance()
   {
   }
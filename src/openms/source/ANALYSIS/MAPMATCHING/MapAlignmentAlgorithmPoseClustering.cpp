@@ -39,6 +39,10 @@
 
 #include <iostream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -71,6 +75,20 @@ namespace OpenMS
   {
   }
 
+  void MapAlignmentAlgorithmPoseClustering::updateReferencePeaks_()
+  {
+    reference_peaks_.clear();
+    reference_peaks_.reserve(reference_.size());
+    for (ConsensusMap::ConstIterator it = reference_.begin(); it != reference_.end(); ++it)
+    {
+      Peak2D c;
+      c.setIntensity(it->getIntensity());
+      c.setRT(it->getRT());
+      c.setMZ(it->getMZ());
+      reference_peaks_.push_back(c);
+    }
+  }
+
   void MapAlignmentAlgorithmPoseClustering::align(const FeatureMap& map, TransformationDescription& trafo)
   {
     ConsensusMap map_scene;
@@ -81,21 +99,36 @@ namespace OpenMS
   void MapAlignmentAlgorithmPoseClustering::align(const MSExperiment<>& map, TransformationDescription& trafo)
   {
     ConsensusMap map_scene;
-    MSExperiment<> map2(map);
-    MapConversion::convert(1, map2, map_scene, max_num_peaks_considered_); // copy MSExperiment here, since it is sorted internally by intensity
+    MapConversion::convert(1, map, map_scene, max_num_peaks_considered_);
     align(map_scene, trafo);
   }
 
   void MapAlignmentAlgorithmPoseClustering::align(const ConsensusMap& map, TransformationDescription& trafo)
   {
-    // TODO: move this to updateMembers_? (if ConsensusMap prevails)
-    // TODO: why does superimposer work on consensus map???
-    const ConsensusMap & map_model = reference_;
     ConsensusMap map_scene = map;
+    std::vector<Peak2D> scene_peaks;
+    scene_peaks.reserve(map_scene.size());
+    for (ConsensusMap::ConstIterator it = map_scene.begin(); it != map_scene.end(); ++it)
+    {
+      Peak2D c;
+      c.setIntensity(it->getIntensity());
+      c.setRT(it->getRT());
+      c.setMZ(it->getMZ());
+      scene_peaks.push_back(c);
+    }
 
-    // run superimposer to find the global transformation
+    // run superimposer to find the global transformation; the superimposer
+    // keeps progress state, so every call uses its own instance (this allows
+    // concurrent calls of align())
+    PoseClusteringAffineSuperimposer superimposer;
+    superimposer.setParameters(superimposer_.getParameters());
+#ifdef _OPENMP
+    superimposer.setLogType(omp_in_parallel() ? ProgressLogger::NONE : getLogType());
+#else
+    superimposer.setLogType(getLogType());
+#endif
     TransformationDescription si_trafo;
-    superimposer_.run(map_model, map_scene, si_trafo);
+    superimposer.run(reference_peaks_, scene_peaks, si_trafo);
 
     // apply transformation to consensus features and contained feature
     // handles
@@ -112,11 +145,7 @@ namespace OpenMS
 
     // run pairfinder to find pairs
     ConsensusMap result;
-    // TODO: add another 2-map interface to pairfinder?
-    std::vector<ConsensusMap> input(2);
-    input[0] = map_model;
-    input[1] = map_scene;
-    pairfinder_.run(input, result);
+    pairfinder_.run(reference_, map_scene, result);
 
     // calculate the local transformation
     si_trafo.invert(); // to undo the transformation applied above
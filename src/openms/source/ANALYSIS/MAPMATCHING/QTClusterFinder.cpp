@@ -246,15 +246,26 @@ namespace OpenMS
 
     // compute QT clustering:
     // std::cout << "Clustering..." << std::endl;
-    list<QTCluster> clustering;
+    vector<QTCluster> clustering;
     computeClustering_(grid, clustering);
     // number of clusters == number of data points:
     Size size = clustering.size();
 
+    // queue of clusters ordered by quality (clusters do not move in memory
+    // from here on, so we can refer to them by index and pointer)
+    ClusterQueue queue;
+    for (Size i = 0; i < clustering.size(); ++i)
+    {
+      ClusterQueueEntry_ entry;
+      entry.quality = clustering[i].getQuality();
+      entry.index = i;
+      queue.push(entry);
+    }
+
     // create a temp. map storing which grid features are next to which clusters
     typedef OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > NeighborList;
     ElementMapping element_mapping;
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       NeighborList neigh = it->getAllNeighbors();
@@ -271,7 +282,7 @@ namespace OpenMS
     }
 
     // ensure that all cluster centers are in the list
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       OpenMS::GridFeature* center_feature = it->getCenterPoint();
@@ -286,50 +297,47 @@ namespace OpenMS
       logger.startProgress(0, size, "linking features");
     }
 
-    while (!clustering.empty())
+    while (true)
     {
-      // std::cout << "Clusters: " << clustering.size() << std::endl;
+      // std::cout << "Clusters: " << queue.size() << std::endl;
       ConsensusFeature consensus_feature;
-      makeConsensusFeature_(clustering, consensus_feature, element_mapping, grid);
-      if (!clustering.empty())
+      if (!makeConsensusFeature_(clustering, queue, consensus_feature, element_mapping, grid))
       {
-        result_map.push_back(consensus_feature);
+        break;
       }
+      result_map.push_back(consensus_feature);
       if (do_progress) logger.setProgress(progress++);
     }
 
     if (do_progress) logger.endProgress();
   }
 
-  void QTClusterFinder::makeConsensusFeature_(list<QTCluster>& clustering,
+  bool QTClusterFinder::makeConsensusFeature_(vector<QTCluster>& clustering,
+                                              ClusterQueue& queue,
                                               ConsensusFeature& feature,
                                               ElementMapping& element_mapping,
                                               Grid& grid)
   {
-    // find the best cluster (a valid cluster with the highest score)
-    // -> this is equivalent to std::max_element but we can skip invalid clusters
-    list<QTCluster>::iterator best = clustering.begin();
-    while (best != clustering.end() && best->isInvalid()) // find start element
+    // find the best cluster (a valid cluster with the highest score):
+    // entries of invalid clusters and entries with an outdated quality (the
+    // cluster was re-inserted after an update) are skipped
+    QTCluster* best = 0;
+    while (!queue.empty())
     {
-      ++best;
-    }
-    for (list<QTCluster>::iterator it = best;
-         it != clustering.end(); ++it)
-    {
-      if (!it->isInvalid())
+      const ClusterQueueEntry_ top = queue.top();
+      queue.pop();
+      QTCluster& cluster = clustering[top.index];
+      if (!cluster.isInvalid() && cluster.getQuality() == top.quality)
       {
-        if (it->getQuality() > best->getQuality())
-        {
-          best = it;
-        }
+        best = &cluster;
+        break;
       }
     }
 
-    // no more clusters to process -> clear clustering and return
-    if (best == clustering.end())
+    // no more clusters to process
+    if (best == 0)
     {
-      clustering.clear();
-      return;
+      return false;
     }
 
     OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*> elements;
@@ -401,7 +409,13 @@ namespace OpenMS
             // add elements to the current cluster to replace the ones we just
             // removed
             const OpenMS::GridFeature* center_feature = (*cluster)->getCenterPoint();
-            addClusterElements_(x, y, grid, (**cluster), center_feature);
+            addClusterElements_(x, y, grid, (**cluster), center_feature, feature_distance_);
+
+            // re-insert with the new quality (the old entry becomes outdated)
+            ClusterQueueEntry_ entry;
+            entry.quality = (*cluster)->getQuality();
+            entry.index = *cluster - &clustering[0];
+            queue.push(entry);
 
             ////////////////////////////////////////
             // Step 2: update element_mapping as the best feature for each
@@ -433,10 +447,11 @@ namespace OpenMS
         }
       }
     }
+    return true;
   }
 
   void QTClusterFinder::addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-    const OpenMS::GridFeature* center_feature)
+    const OpenMS::GridFeature* center_feature, FeatureDistance& feature_distance)
   {
     cluster.initializeCluster();
 
@@ -479,7 +494,8 @@ namespace OpenMS
             if (center_feature != neighbor_feature)
             {
               // NOTE: this actually caches the distance -> memory problem
-              double dist = getDistance_(center_feature, neighbor_feature);
+              double dist = feature_distance(center_feature->getFeature(),
+                                             neighbor_feature->getFeature()).second;
 
               if (dist == FeatureDistance::infinity)
               {
@@ -532,7 +548,7 @@ namespace OpenMS
   }
 
   void QTClusterFinder::computeClustering_(Grid& grid,
-                                           list<QTCluster>& clustering)
+                                           vector<QTCluster>& clustering)
   {
     clustering.clear();
     already_used_.clear();
@@ -540,27 +556,37 @@ namespace OpenMS
     // FeatureDistance produces normalized distances (between 0 and 1):
     const double max_distance = 1.0;
 
-    // iterate over all grid cells:
+    // create one cluster per feature, iterating over all grid cells:
+    clustering.reserve(grid.size());
     for (Grid::iterator it = grid.begin(); it != grid.end(); ++it)
     {
       const Grid::CellIndex& act_coords = it.index();
       const Int x = act_coords[0], y = act_coords[1];
 
       OpenMS::GridFeature* center_feature = it->second;
-      QTCluster cluster(center_feature, num_maps_, max_distance, use_IDs_, x, y);
-
-      addClusterElements_(x, y, grid, cluster, center_feature);
+      clustering.push_back(QTCluster(center_feature, num_maps_, max_distance, use_IDs_, x, y));
+    }
 
-      clustering.push_back(cluster);
+    // collect the elements of all clusters (independent of each other, since
+    // no features have been used yet):
+    SignedSize nr_clusters = (SignedSize) clustering.size();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      FeatureDistance feature_distance(feature_distance_);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = 0; i < nr_clusters; ++i)
+      {
+        QTCluster& cluster = clustering[i];
+        addClusterElements_(cluster.getXCoord(), cluster.getYCoord(), grid,
+                            cluster, cluster.getCenterPoint(), feature_distance);
+      }
     }
   }
 
-  double QTClusterFinder::getDistance_(const OpenMS::GridFeature* left,
-                                       const OpenMS::GridFeature* right)
-  {
-    return feature_distance_(left->getFeature(), right->getFeature()).second;
-  }
-  
 
   QTClusterFinder::~QTClusterFinder()
   {
@@ -81,20 +81,34 @@ namespace OpenMS
   void StablePairFinder::run(const std::vector<ConsensusMap>& input_maps,
                              ConsensusMap& result_map)
   {
-    // empty output destination:
-    result_map.clear(false);
-
     // sanity checks:
     if (input_maps.size() != 2)
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
                                        "exactly two input maps required");
     }
-    checkIds_(input_maps);
+    run(input_maps[0], input_maps[1], result_map);
+  }
+
+  void StablePairFinder::run(const ConsensusMap& map0,
+                             const ConsensusMap& map1,
+                             ConsensusMap& result_map)
+  {
+    // empty output destination:
+    result_map.clear(false);
+
+    // sanity check (same as checkIds_(), without copying the maps into a vector):
+    for (ConsensusMap::FileDescriptions::const_iterator it = map0.getFileDescriptions().begin(); it != map0.getFileDescriptions().end(); ++it)
+    {
+      if (map1.getFileDescriptions().find(it->first) != map1.getFileDescriptions().end())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__, "file ids have to be unique");
+      }
+    }
 
     // set up the distance functor:
-    double max_intensity = max(input_maps[0].getMaxInt(),
-                               input_maps[1].getMaxInt());
+    double max_intensity = max(map0.getMaxInt(),
+                               map1.getMaxInt());
     Param distance_params = param_.copy("");
     distance_params.remove("use_identifications");
     distance_params.remove("second_nearest_gap");
@@ -103,8 +117,8 @@ namespace OpenMS
 
     // keep track of pairing:
     std::vector<bool> is_singleton[2];
-    is_singleton[0].resize(input_maps[0].size(), true);
-    is_singleton[1].resize(input_maps[1].size(), true);
+    is_singleton[0].resize(map0.size(), true);
+    is_singleton[1].resize(map1.size(), true);
 
     typedef pair<double, double> DoublePair;
     DoublePair init = make_pair(FeatureDistance::infinity,
@@ -112,27 +126,27 @@ namespace OpenMS
 
     // for every element in map 0:
     // - index of nearest neighbor in map 1:
-    vector<UInt> nn_index_0(input_maps[0].size(), UInt(-1));
+    vector<UInt> nn_index_0(map0.size(), UInt(-1));
     // - distances to nearest and second-nearest neighbors in map 1:
-    vector<DoublePair> nn_distance_0(input_maps[0].size(), init);
+    vector<DoublePair> nn_distance_0(map0.size(), init);
 
     // for every element in map 1:
     // - index of nearest neighbor in map 0:
-    vector<UInt> nn_index_1(input_maps[1].size(), UInt(-1));
+    vector<UInt> nn_index_1(map1.size(), UInt(-1));
     // - distances to nearest and second-nearest neighbors in map 0:
-    vector<DoublePair> nn_distance_1(input_maps[1].size(), init);
+    vector<DoublePair> nn_distance_1(map1.size(), init);
 
     // iterate over all feature pairs, find nearest neighbors:
     // TODO: iterate over SENSIBLE RT (and m/z) window -- sort the maps beforehand
     //       to save a lot of processing time...
     //       Once done, remove the warning in the description of the 'use_identifications' parameter
-    for (UInt fi0 = 0; fi0 < input_maps[0].size(); ++fi0)
+    for (UInt fi0 = 0; fi0 < map0.size(); ++fi0)
     {
-      const ConsensusFeature& feat0 = input_maps[0][fi0];
+      const ConsensusFeature& feat0 = map0[fi0];
 
-      for (UInt fi1 = 0; fi1 < input_maps[1].size(); ++fi1)
+      for (UInt fi1 = 0; fi1 < map1.size(); ++fi1)
       {
-        const ConsensusFeature& feat1 = input_maps[1][fi1];
+        const ConsensusFeature& feat1 = map1[fi1];
 
         if (use_IDs_ && !compatibleIDs_(feat0, feat1)) // check peptide IDs
         {
@@ -180,13 +194,13 @@ namespace OpenMS
 
     // if features from the two maps are nearest neighbors of each other, they
     // can become a pair:
-    for (UInt fi0 = 0; fi0 < input_maps[0].size(); ++fi0)
+    for (UInt fi0 = 0; fi0 < map0.size(); ++fi0)
     {
       UInt fi1 = nn_index_0[fi0]; // nearest neighbor of "fi0" in map 1
-      // cout << "index: " << fi0 << ", RT: " << input_maps[0][fi0].getRT()
-      //         << ", MZ: " << input_maps[0][fi0].getMZ() << endl
-      //         << "neighbor: " << fi1 << ", RT: " << input_maps[1][fi1].getRT()
-      //         << ", MZ: " << input_maps[1][fi1].getMZ() << endl
+      // cout << "index: " << fi0 << ", RT: " << map0[fi0].getRT()
+      //         << ", MZ: " << map0[fi0].getMZ() << endl
+      //         << "neighbor: " << fi1 << ", RT: " << map1[fi1].getRT()
+      //         << ", MZ: " << map1[fi1].getMZ() << endl
       //         << "d(i,j): " << nn_distance_0[fi0].first << endl
       //         << "d2(i): " << nn_distance_0[fi0].second << endl
       //         << "d2(j): " << nn_distance_1[fi1].second << endl;
@@ -204,15 +218,15 @@ namespace OpenMS
           result_map.push_back(ConsensusFeature());
           ConsensusFeature& f = result_map.back();
 
-          f.insert(input_maps[0][fi0]);
+          f.insert(map0[fi0]);
           f.getPeptideIdentifications().insert(f.getPeptideIdentifications().end(),
-                                               input_maps[0][fi0].getPeptideIdentifications().begin(),
-                                               input_maps[0][fi0].getPeptideIdentifications().end());
+                                               map0[fi0].getPeptideIdentifications().begin(),
+                                               map0[fi0].getPeptideIdentifications().end());
 
-          f.insert(input_maps[1][fi1]);
+          f.insert(map1[fi1]);
           f.getPeptideIdentifications().insert(f.getPeptideIdentifications().end(),
-                                               input_maps[1][fi1].getPeptideIdentifications().begin(),
-                                               input_maps[1][fi1].getPeptideIdentifications().end());
+                                               map1[fi1].getPeptideIdentifications().begin(),
+                                               map1[fi1].getPeptideIdentifications().end());
 
           f.computeConsensus();
           double quality = 1.0 - nn_distance_0[fi0].first;
@@ -221,12 +235,12 @@ namespace OpenMS
           quality = quality * quality0 * quality1; // TODO other formula?
 
           // incorporate existing quality values:
-          Size size0 = max(input_maps[0][fi0].size(), size_t(1));
-          Size size1 = max(input_maps[1][fi1].size(), size_t(1));
+          Size size0 = max(map0[fi0].size(), size_t(1));
+          Size size1 = max(map1[fi1].size(), size_t(1));
           // quality contribution from first map:
-          quality0 = input_maps[0][fi0].getQuality() * (size0 - 1);
+          quality0 = map0[fi0].getQuality() * (size0 - 1);
           // quality contribution from second map:
-          quality1 = input_maps[1][fi1].getQuality() * (size1 - 1);
+          quality1 = map1[fi1].getQuality() * (size1 - 1);
           f.setQuality((quality + quality0 + quality1) / (size0 + size1 - 1));
 
           is_singleton[0][fi0] = false;
@@ -238,11 +252,12 @@ namespace OpenMS
     // write out unmatched consensus features
     for (UInt input = 0; input <= 1; ++input)
     {
-      for (UInt index = 0; index < input_maps[input].size(); ++index)
+      const ConsensusMap& input_map = (input == 0) ? map0 : map1;
+      for (UInt index = 0; index < input_map.size(); ++index)
       {
         if (is_singleton[input][index])
         {
-          result_map.push_back(input_maps[input][index]);
+          result_map.push_back(input_map[index]);
           if (result_map.back().size() < 2) // singleton consensus feature
           {
             result_map.back().setQuality(0.0);
@@ -33,96 +33,184 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractorAlgorithm.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCachedMapped.h>
 
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
-  void ChromatogramExtractorAlgorithm::extract_value_tophat(
-      const std::vector<double>::const_iterator& mz_start, 
-            std::vector<double>::const_iterator& mz_it,
-      const std::vector<double>::const_iterator& mz_end,
-            std::vector<double>::const_iterator& int_it,
-      const double& mz, double& integrated_intensity, const double& mz_extraction_window, bool ppm)
+  namespace
   {
-    integrated_intensity = 0;
-    if (mz_start == mz_end)
+    /// Top-hat extraction on any bidirectional iterators (see ChromatogramExtractorAlgorithm::extract_value_tophat)
+    template <typename MzIterator, typename IntIterator>
+    void extractValueTophat(const MzIterator& mz_start, MzIterator& mz_it, const MzIterator& mz_end, IntIterator& int_it,
+                            const double& mz, double& integrated_intensity, const double& mz_extraction_window, bool ppm)
     {
-      return;
-    }
+      integrated_intensity = 0;
+      if (mz_start == mz_end)
+      {
+        return;
+      }
 
-    // calculate extraction window
-    double left, right;
-    if (ppm)
-    {
-      left  = mz - mz * mz_extraction_window / 2.0 * 1.0e-6;
-      right = mz + mz * mz_extraction_window / 2.0 * 1.0e-6;
-    }
-    else
-    {
-      left  = mz - mz_extraction_window / 2.0;
-      right = mz + mz_extraction_window / 2.0;
-    }
+      // calculate extraction window
+      double left, right;
+      if (ppm)
+      {
+        left  = mz - mz * mz_extraction_window / 2.0 * 1.0e-6;
+        right = mz + mz * mz_extraction_window / 2.0 * 1.0e-6;
+      }
+      else
+      {
+        left  = mz - mz_extraction_window / 2.0;
+        right = mz + mz_extraction_window / 2.0;
+      }
 
-    std::vector<double>::const_iterator mz_walker;
-    std::vector<double>::const_iterator int_walker;
+      MzIterator mz_walker;
+      IntIterator int_walker;
 
-    // advance the mz / int iterator until we hit the m/z value of the next transition
-    while (mz_it != mz_end && (*mz_it) < mz)
-    {
-      mz_it++; 
-      int_it++;
-    }
+      // advance the mz / int iterator until we hit the m/z value of the next transition
+      while (mz_it != mz_end && (*mz_it) < mz)
+      {
+        mz_it++; 
+        int_it++;
+      }
 
-    // walk right and left and add to our intensity
-    mz_walker  = mz_it;
-    int_walker = int_it;
+      // walk right and left and add to our intensity
+      mz_walker  = mz_it;
+      int_walker = int_it;
 
-    // if we moved past the end of the spectrum, we need to try the last peak of the spectrum (it could still be within the window)
-    if (mz_it == mz_end)
-    {
-      --mz_walker; 
-      --int_walker;
-    }
+      // if we moved past the end of the spectrum, we need to try the last peak of the spectrum (it could still be within the window)
+      if (mz_it == mz_end)
+      {
+        --mz_walker; 
+        --int_walker;
+      }
 
-    // add the current peak if it is between right and left
-    if ((*mz_walker) > left && (*mz_walker) < right)
-    {
-      integrated_intensity += (*int_walker);
-    }
+      // add the current peak if it is between right and left
+      if ((*mz_walker) > left && (*mz_walker) < right)
+      {
+        integrated_intensity += (*int_walker);
+      }
 
-    // walk to the left until we go outside the window, then start walking to the right until we are outside the window
-    mz_walker  = mz_it;
-    int_walker = int_it;
-    if (mz_it != mz_start)
-    {
-      --mz_walker;
-      --int_walker;
-    }
-    while (mz_walker != mz_start && (*mz_walker) > left && (*mz_walker) < right)
-    {
-      integrated_intensity += (*int_walker); 
-      --mz_walker; 
-      --int_walker;
+      // walk to the left until we go outside the window, then start walking to the right until we are outside the window
+      mz_walker  = mz_it;
+      int_walker = int_it;
+      if (mz_it != mz_start)
+      {
+        --mz_walker;
+        --int_walker;
+      }
+      while (mz_walker != mz_start && (*mz_walker) > left && (*mz_walker) < right)
+      {
+        integrated_intensity += (*int_walker); 
+        --mz_walker; 
+        --int_walker;
+      }
+      mz_walker  = mz_it;
+      int_walker = int_it;
+      if (mz_it != mz_end)
+      {
+        ++mz_walker;
+        ++int_walker;
+      }
+      while (mz_walker != mz_end && (*mz_walker) > left && (*mz_walker) < right)
+      {
+        integrated_intensity += (*int_walker); 
+        ++mz_walker; 
+        ++int_walker;
+      }
     }
-    mz_walker  = mz_it;
-    int_walker = int_it;
-    if (mz_it != mz_end)
+
+    /// Extracts the signal of all coordinates from a single spectrum (with @p rt) and appends it to @p rt_out and @p int_out
+    template <typename MzIterator, typename IntIterator>
+    void extractSpectrum(const MzIterator& mz_start, const MzIterator& mz_end, IntIterator int_it, double rt,
+                         const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& extraction_coordinates,
+                         double mz_extraction_window, bool ppm,
+                         std::vector<std::vector<double> >& rt_out, std::vector<std::vector<double> >& int_out)
     {
-      ++mz_walker;
-      ++int_walker;
+      if (mz_start == mz_end)
+        return;
+
+      // go through all transitions / chromatograms which are sorted by
+      // ProductMZ. We can use this to step through the spectrum and at the
+      // same time step through the transitions. We increase the peak counter
+      // until we hit the next transition and then extract the signal.
+      MzIterator mz_it = mz_start;
+      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+      {
+        double integrated_intensity = 0;
+        if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
+             (rt < extraction_coordinates[k].rt_start ||
+              rt > extraction_coordinates[k].rt_end) )
+        {
+          continue;
+        }
+
+        extractValueTophat(mz_start, mz_it, mz_end, int_it,
+                extraction_coordinates[k].mz, integrated_intensity, mz_extraction_window, ppm);
+
+        // Time is first, intensity is second
+        rt_out[k].push_back(rt);
+        int_out[k].push_back(integrated_intensity);
+      }
     }
-    while (mz_walker != mz_end && (*mz_walker) > left && (*mz_walker) < right)
+
+    /// Extracts the signal of the spectra [@p block_start, @p block_end) of @p input (reports progress if @p progress is given)
+    void extractBlock(const OpenSwath::SpectrumAccessPtr& input, const SpectrumAccessOpenMSCachedMapped* mapped_input,
+                      Size block_start, Size block_end,
+                      const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& extraction_coordinates,
+                      double mz_extraction_window, bool ppm,
+                      std::vector<std::vector<double> >& rt_out, std::vector<std::vector<double> >& int_out,
+                      const ProgressLogger* progress, int nr_blocks)
     {
-      integrated_intensity += (*int_walker); 
-      ++mz_walker; 
-      ++int_walker;
+      for (Size scan_idx = block_start; scan_idx < block_end; ++scan_idx)
+      {
+        if (progress != NULL)
+        {
+          // all blocks proceed at roughly the same speed
+          progress->setProgress((scan_idx - block_start) * nr_blocks);
+        }
+
+        OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
+        if (mapped_input != NULL)
+        {
+          // read directly from the memory-mapped file (no copy)
+          SpectrumAccessOpenMSCachedMapped::DataArrayView mz_arr, int_arr;
+          mapped_input->getSpectrumViewById(scan_idx, mz_arr, int_arr);
+          extractSpectrum(mz_arr.begin(), mz_arr.end(), int_arr.begin(), s_meta.RT,
+                          extraction_coordinates, mz_extraction_window, ppm, rt_out, int_out);
+        }
+        else
+        {
+          OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
+          const std::vector<double>& mz_arr = sptr->getMZArray()->data;
+          const std::vector<double>& int_arr = sptr->getIntensityArray()->data;
+          extractSpectrum(mz_arr.begin(), mz_arr.end(), int_arr.begin(), s_meta.RT,
+                          extraction_coordinates, mz_extraction_window, ppm, rt_out, int_out);
+        }
+      }
     }
   }
 
+  void ChromatogramExtractorAlgorithm::extract_value_tophat(
+      const std::vector<double>::const_iterator& mz_start, 
+            std::vector<double>::const_iterator& mz_it,
+      const std::vector<double>::const_iterator& mz_end,
+            std::vector<double>::const_iterator& int_it,
+      const double& mz, double& integrated_intensity, const double& mz_extraction_window, bool ppm)
+  {
+    extractValueTophat(mz_start, mz_it, mz_end, int_it, mz, integrated_intensity, mz_extraction_window, ppm);
+  }
+
   void ChromatogramExtractorAlgorithm::extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
       std::vector< OpenSwath::ChromatogramPtr >& output, 
       std::vector<ExtractionCoordinates> extraction_coordinates, double mz_extraction_window,
@@ -149,53 +237,82 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
-    //go through all spectra
-    startProgress(0, input_size, "Extracting chromatograms");
-    for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
+    if (used_filter == 2)
     {
-      setProgress(scan_idx);
-
-      OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
-      OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
+      throw Exception::NotImplemented(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
 
-      OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
-      OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
-      std::vector<double>::const_iterator mz_start = mz_arr->data.begin();
-      std::vector<double>::const_iterator mz_end = mz_arr->data.end();
-      std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
-      std::vector<double>::const_iterator int_it = int_arr->data.begin();
+    // The spectra are split into contiguous blocks, one per thread, which
+    // all read from the same (thread-safe) input. Each thread collects the
+    // data points of its block separately and the blocks are then appended
+    // to the output in order, so the result does not depend on the number
+    // of threads. When called from within a parallel region (e.g. one thread
+    // per SWATH map) this runs with a single thread unless nested
+    // parallelism is enabled.
+    int nr_threads = 1;
+#ifdef _OPENMP
+    nr_threads = std::max(1, std::min(omp_get_max_threads(), (int)input_size));
+    if (omp_in_parallel() && !omp_get_nested())
+    {
+      nr_threads = 1;
+    }
+#endif
+    std::vector<std::vector<std::vector<double> > > block_rt(nr_threads, std::vector<std::vector<double> >(extraction_coordinates.size()));
+    std::vector<std::vector<std::vector<double> > > block_int(nr_threads, std::vector<std::vector<double> >(extraction_coordinates.size()));
+    // exceptions must not leave the parallel region: failed blocks are
+    // extracted again serially below, which rethrows the original exception
+    std::vector<char> failed(nr_threads, false);
 
-      if (sptr->getMZArray()->data.size() == 0)
-        continue;
+    // memory-mapped cached data can be accessed without copying the spectra
+    const SpectrumAccessOpenMSCachedMapped* mapped_input =
+      dynamic_cast<const SpectrumAccessOpenMSCachedMapped*>(input.get());
 
-      // go through all transitions / chromatograms which are sorted by
-      // ProductMZ. We can use this to step through the spectrum and at the
-      // same time step through the transitions. We increase the peak counter
-      // until we hit the next transition and then extract the signal.
-      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+    //go through all spectra
+    startProgress(0, input_size, "Extracting chromatograms");
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+    {
+      int thread_idx = 0;
+#ifdef _OPENMP
+      thread_idx = omp_get_thread_num();
+#endif
+      try
       {
-        double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
-        if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 && 
-             (current_rt < extraction_coordinates[k].rt_start || 
-              current_rt > extraction_coordinates[k].rt_end) )
-        {
-          continue;
-        }
+        extractBlock(input, mapped_input,
+                     (input_size * thread_idx) / nr_threads, (input_size * (thread_idx + 1)) / nr_threads,
+                     extraction_coordinates, mz_extraction_window, ppm, block_rt[thread_idx], block_int[thread_idx],
+                     (thread_idx == 0) ? this : NULL, nr_threads);
+      }
+      catch (...)
+      {
+        failed[thread_idx] = true;
+      }
+    }
 
-        if (used_filter == 1)
-        {
-          extract_value_tophat( mz_start, mz_it, mz_end, int_it,
-                  extraction_coordinates[k].mz, integrated_intensity, mz_extraction_window, ppm);
-        }
-        else if (used_filter == 2)
-        {
-          throw Exception::NotImplemented(__FILE__, __LINE__, __PRETTY_FUNCTION__);
-        }
+    for (int thread_idx = 0; thread_idx < nr_threads; ++thread_idx)
+    {
+      if (failed[thread_idx])
+      {
+        // discard the partial data of the block
+        block_rt[thread_idx].assign(extraction_coordinates.size(), std::vector<double>());
+        block_int[thread_idx].assign(extraction_coordinates.size(), std::vector<double>());
+        extractBlock(input, mapped_input,
+                     (input_size * thread_idx) / nr_threads, (input_size * (thread_idx + 1)) / nr_threads,
+                     extraction_coordinates, mz_extraction_window, ppm, block_rt[thread_idx], block_int[thread_idx],
+                     NULL, nr_threads);
+      }
+    }
 
-        // Time is first, intensity is second
-        output[k]->binaryDataArrayPtrs[0]->data.push_back(current_rt);
-        output[k]->binaryDataArrayPtrs[1]->data.push_back(integrated_intensity);
+    // append the blocks in order of the spectra
+    for (Size k = 0; k < extraction_coordinates.size(); ++k)
+    {
+      std::vector<double>& rt_data = output[k]->binaryDataArrayPtrs[0]->data;
+      std::vector<double>& int_data = output[k]->binaryDataArrayPtrs[1]->data;
+      for (int thread_idx = 0; thread_idx < nr_threads; ++thread_idx)
+      {
+        rt_data.insert(rt_data.end(), block_rt[thread_idx][k].begin(), block_rt[thread_idx][k].end());
+        int_data.insert(int_data.end(), block_int[thread_idx][k].begin(), block_int[thread_idx][k].end());
       }
     }
     endProgress();
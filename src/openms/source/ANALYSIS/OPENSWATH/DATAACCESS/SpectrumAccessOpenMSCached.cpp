@@ -36,10 +36,45 @@
 
 #include <OpenMS/FORMAT/CachedMzML.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
-  SpectrumAccessOpenMSCached::SpectrumAccessOpenMSCached(String filename)
+  struct SpectrumAccessOpenMSCached::StreamLock_
+  {
+#ifdef _OPENMP
+    StreamLock_() { omp_init_lock(&lock); }
+    ~StreamLock_() { omp_destroy_lock(&lock); }
+    void set() { omp_set_lock(&lock); }
+    void unset() { omp_unset_lock(&lock); }
+    omp_lock_t lock;
+#else
+    void set() {}
+    void unset() {}
+#endif
+  };
+
+  namespace
+  {
+    /// Holds a lock for the lifetime of the object (also releases it if an exception is thrown)
+    template <typename LockT>
+    class ScopedLock
+    {
+public:
+      explicit ScopedLock(LockT& lock) : lock_(lock) { lock_.set(); }
+      ~ScopedLock() { lock_.unset(); }
+private:
+      ScopedLock(const ScopedLock&);
+      ScopedLock& operator=(const ScopedLock&);
+      LockT& lock_;
+    };
+  }
+
+  SpectrumAccessOpenMSCached::SpectrumAccessOpenMSCached(String filename) :
+    ifs_lock_(new StreamLock_)
   {
     filename_cached_ = filename + ".cached";
     filename_ = filename;
@@ -65,7 +100,9 @@ namespace OpenMS
   SpectrumAccessOpenMSCached::SpectrumAccessOpenMSCached(const SpectrumAccessOpenMSCached & rhs) :
     meta_ms_experiment_(rhs.meta_ms_experiment_),
     ifs_(rhs.filename_cached_.c_str(), std::ios::binary),
+    ifs_lock_(new StreamLock_),
     filename_(rhs.filename_),
+    filename_cached_(rhs.filename_cached_),
     spectra_index_(rhs.spectra_index_),
     chrom_index_(rhs.chrom_index_)
   {
@@ -86,6 +123,7 @@ namespace OpenMS
     int ms_level = -1;
     double rt = -1.0;
 
+    ScopedLock<StreamLock_> guard(*ifs_lock_);
     if ( !ifs_.seekg(spectra_index_[id]) )
     {
       std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
@@ -121,6 +159,7 @@ namespace OpenMS
     OpenSwath::BinaryDataArrayPtr rt_array(new OpenSwath::BinaryDataArray);
     OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
 
+    ScopedLock<StreamLock_> guard(*ifs_lock_);
     if ( !ifs_.seekg(chrom_index_[id]) )
     {
       std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
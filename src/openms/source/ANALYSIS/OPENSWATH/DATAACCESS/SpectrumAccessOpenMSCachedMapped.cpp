@@ -0,0 +1,186 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCachedMapped.h>
+
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+namespace OpenMS
+{
+
+  SpectrumAccessOpenMSCachedMapped::SpectrumAccessOpenMSCachedMapped(String filename) :
+    meta_ms_experiment_(new MSExperimentType),
+    cache_(new CachedmzMLMapped(filename + ".cached")),
+    filename_(filename)
+  {
+    // load the meta data from disk
+    MzMLFile().load(filename, *meta_ms_experiment_);
+  }
+
+  SpectrumAccessOpenMSCachedMapped::~SpectrumAccessOpenMSCachedMapped()
+  {
+  }
+
+  SpectrumAccessOpenMSCachedMapped::SpectrumAccessOpenMSCachedMapped(const SpectrumAccessOpenMSCachedMapped & rhs) :
+    meta_ms_experiment_(rhs.meta_ms_experiment_),
+    cache_(rhs.cache_),
+    filename_(rhs.filename_)
+  {
+  }
+
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessOpenMSCachedMapped::lightClone() const
+  {
+    return boost::shared_ptr<SpectrumAccessOpenMSCachedMapped>(new SpectrumAccessOpenMSCachedMapped(*this));
+  }
+
+  OpenSwath::SpectrumPtr SpectrumAccessOpenMSCachedMapped::getSpectrumById(int id)
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    DataArrayView mz, intensity;
+    getSpectrumViewById(id, mz, intensity);
+
+    OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
+    mz.copyTo(mz_array->data);
+    intensity.copyTo(intensity_array->data);
+
+    OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+    sptr->setMZArray(mz_array);
+    sptr->setIntensityArray(intensity_array);
+    return sptr;
+  }
+
+  void SpectrumAccessOpenMSCachedMapped::getSpectrumViewById(int id, DataArrayView& mz, DataArrayView& intensity) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    int ms_level = -1;
+    double rt = -1.0;
+    cache_->getSpectrumView(id, mz, intensity, ms_level, rt);
+  }
+
+  OpenSwath::SpectrumMeta SpectrumAccessOpenMSCachedMapped::getSpectrumMetaById(int id) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    OpenSwath::SpectrumMeta meta;
+    meta.RT = (*meta_ms_experiment_)[id].getRT();
+    meta.ms_level = (*meta_ms_experiment_)[id].getMSLevel();
+    return meta;
+  }
+
+  OpenSwath::ChromatogramPtr SpectrumAccessOpenMSCachedMapped::getChromatogramById(int id)
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+
+    DataArrayView rt, intensity;
+    getChromatogramViewById(id, rt, intensity);
+
+    OpenSwath::BinaryDataArrayPtr rt_array(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
+    rt.copyTo(rt_array->data);
+    intensity.copyTo(intensity_array->data);
+
+    OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+    cptr->setTimeArray(rt_array);
+    cptr->setIntensityArray(intensity_array);
+    return cptr;
+  }
+
+  void SpectrumAccessOpenMSCachedMapped::getChromatogramViewById(int id, DataArrayView& rt, DataArrayView& intensity) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+
+    cache_->getChromatogramView(id, rt, intensity);
+  }
+
+  std::vector<std::size_t> SpectrumAccessOpenMSCachedMapped::getSpectraByRT(double RT, double deltaRT) const
+  {
+    OPENMS_PRECONDITION(deltaRT >= 0, "Delta RT needs to be a positive number");
+
+    // we first perform a search for the spectrum that is past the
+    // beginning of the RT domain. Then we add this spectrum and try to add
+    // further spectra as long as they are below RT + deltaRT.
+    std::vector<std::size_t> result;
+    const MSExperimentType& meta = *meta_ms_experiment_;
+    MSExperimentType::ConstIterator spectrum = meta.RTBegin(RT - deltaRT);
+    if (spectrum == meta.end()) return result;
+
+    result.push_back(std::distance(meta.begin(), spectrum));
+    spectrum++;
+
+    while (spectrum != meta.end() && spectrum->getRT() < RT + deltaRT)
+    {
+      result.push_back(spectrum - meta.begin());
+      spectrum++;
+    }
+    return result;
+  }
+
+  size_t SpectrumAccessOpenMSCachedMapped::getNrSpectra() const
+  {
+    return meta_ms_experiment_->size();
+  }
+
+  SpectrumSettings SpectrumAccessOpenMSCachedMapped::getSpectraMetaInfo(int id) const
+  {
+    return (*meta_ms_experiment_)[id];
+  }
+
+  size_t SpectrumAccessOpenMSCachedMapped::getNrChromatograms() const
+  {
+    return meta_ms_experiment_->getChromatograms().size();
+  }
+
+  ChromatogramSettings SpectrumAccessOpenMSCachedMapped::getChromatogramMetaInfo(int id) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+    return meta_ms_experiment_->getChromatograms()[id];
+  }
+
+  std::string SpectrumAccessOpenMSCachedMapped::getChromatogramNativeID(int id) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+    return meta_ms_experiment_->getChromatograms()[id].getNativeID();
+  }
+
+} //end namespace OpenMS
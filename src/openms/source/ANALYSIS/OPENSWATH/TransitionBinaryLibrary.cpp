@@ -0,0 +1,727 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/TransitionBinaryLibrary.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <set>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /**
+      file header of the library, followed by the sections (in this order):
+
+      8 byte entries:
+        precursor m/z, product m/z, library intensity (double, per transition)
+        transition strings (UInt64, 2 per transition)
+        compound RT (double, per compound)
+        compound strings (UInt64, 5 per compound)
+        protein reference starts, modification starts (UInt64, compound_count + 1 each)
+        protein references (UInt64, protein_ref_count)
+        modification UniMod ids (UInt64, modification_count)
+        protein strings (UInt64, 2 per protein)
+      4 byte entries:
+        fragment charge (Int32), precursor order (UInt32) (per transition)
+        compound charge (Int32, per compound)
+        modification location (Int32, modification_count)
+      1 byte entries:
+        transition flags (unsigned char, per transition)
+        string table (zero-terminated strings, string_bytes)
+
+      Since the header size is a multiple of 8, all entries are aligned.
+    */
+    struct LibraryHeader
+    {
+      char magic[8];
+      UInt64 byte_order;
+      UInt64 transition_count;
+      UInt64 compound_count;
+      UInt64 protein_count;
+      UInt64 protein_ref_count;
+      UInt64 modification_count;
+      UInt64 string_bytes;
+    };
+
+    const char LIBRARY_MAGIC[8] = {'O', 'M', 'S', 'O', 'S', 'W', '0', '1'};
+
+    /// written in native byte order; reads back differently on a machine with another endianness
+    const UInt64 BYTE_ORDER_MARK = (UInt64(0x01020304) << 32) | UInt64(0x05060708);
+
+    const Size TRANSITION_STRINGS = 2;
+    const Size COMPOUND_STRINGS = 5;
+    const Size PROTEIN_STRINGS = 2;
+
+    /// bits of the transition flags
+    enum TransitionFlag
+    {
+      FLAG_DECOY = 1,
+      FLAG_DETECTING = 2,
+      FLAG_QUANTIFYING = 4,
+      FLAG_IDENTIFYING = 8
+    };
+
+    /// Removes @p count entries of @p entry_size bytes from @p remaining, returns false if they do not fit
+    bool takeEntries(UInt64& remaining, UInt64 count, UInt64 entry_size)
+    {
+      if (count > remaining / entry_size) return false;
+      remaining -= count * entry_size;
+      return true;
+    }
+
+    /// Checks that the file size @p size matches the counts of the header @p h (without overflows)
+    bool hasFileSize(Size size, const LibraryHeader& h)
+    {
+      if (size < sizeof(LibraryHeader)) return false;
+      UInt64 remaining = UInt64(size - sizeof(LibraryHeader));
+      // the starts arrays hold compound_count + 1 entries each
+      return takeEntries(remaining, 1, 2 * sizeof(UInt64))
+             && takeEntries(remaining, h.transition_count, 3 * sizeof(double) + TRANSITION_STRINGS * sizeof(UInt64)
+                                                           + sizeof(Int32) + sizeof(UInt32) + sizeof(unsigned char))
+             && takeEntries(remaining, h.compound_count, sizeof(double) + COMPOUND_STRINGS * sizeof(UInt64)
+                                                         + 2 * sizeof(UInt64) + sizeof(Int32))
+             && takeEntries(remaining, h.protein_ref_count, sizeof(UInt64))
+             && takeEntries(remaining, h.modification_count, sizeof(UInt64) + sizeof(Int32))
+             && takeEntries(remaining, h.protein_count, PROTEIN_STRINGS * sizeof(UInt64))
+             && remaining == h.string_bytes;
+    }
+
+    /// Checks that all @p count string offsets lie within the string table
+    bool validOffsets(const UInt64* offsets, Size count, UInt64 string_bytes)
+    {
+      for (Size i = 0; i < count; ++i)
+      {
+        if (offsets[i] >= string_bytes) return false;
+      }
+      return true;
+    }
+
+    /// Checks that @p starts (@p count + 1 entries) rises monotonically from 0 to @p total
+    bool validStarts(const UInt64* starts, Size count, UInt64 total)
+    {
+      if (starts[0] != 0 || starts[count] != total) return false;
+      for (Size i = 0; i < count; ++i)
+      {
+        if (starts[i] > starts[i + 1]) return false;
+      }
+      return true;
+    }
+
+    /// Collects strings for the string table (identical strings are stored once)
+    class StringTable
+    {
+public:
+      StringTable() :
+        data_(1, '\0') // offset 0 is the empty string
+      {
+      }
+
+      UInt64 add(const std::string& s)
+      {
+        if (s.empty()) return 0;
+        std::map<std::string, UInt64>::const_iterator it = offsets_.find(s);
+        if (it != offsets_.end()) return it->second;
+        const UInt64 offset = data_.size();
+        data_.insert(data_.end(), s.begin(), s.end());
+        data_.push_back('\0');
+        offsets_.insert(std::make_pair(s, offset));
+        return offset;
+      }
+
+      const std::vector<char>& data() const
+      {
+        return data_;
+      }
+
+private:
+      std::vector<char> data_;
+      std::map<std::string, UInt64> offsets_;
+    };
+
+    /// Compares transition indices by precursor m/z
+    struct PrecursorLess
+    {
+      explicit PrecursorLess(const std::vector<double>& mz) :
+        mz_(mz)
+      {
+      }
+
+      bool operator()(UInt32 a, UInt32 b) const
+      {
+        return mz_[a] < mz_[b];
+      }
+
+      const std::vector<double>& mz_;
+    };
+
+    /// Compares a transition index with an m/z value (for binary search in the precursor order)
+    struct PrecursorIndexLess
+    {
+      explicit PrecursorIndexLess(const double* mz) :
+        mz_(mz)
+      {
+      }
+
+      bool operator()(UInt32 a, double mz) const
+      {
+        return mz_[a] < mz;
+      }
+
+      bool operator()(double mz, UInt32 a) const
+      {
+        return mz < mz_[a];
+      }
+
+      const double* mz_;
+    };
+
+    template <typename T>
+    void writeArray(std::ofstream& ofs, const std::vector<T>& v)
+    {
+      if (!v.empty())
+      {
+        ofs.write(reinterpret_cast<const char*>(&v[0]), v.size() * sizeof(T));
+      }
+    }
+  }
+
+  TransitionBinaryLibrary::TransitionBinaryLibrary() :
+    region_(),
+    transition_count_(0),
+    compound_count_(0),
+    protein_count_(0),
+    precursor_mz_(0),
+    product_mz_(0),
+    library_intensity_(0),
+    transition_strings_(0),
+    fragment_charge_(0),
+    precursor_order_(0),
+    transition_flags_(0),
+    compound_rt_(0),
+    compound_charge_(0),
+    compound_strings_(0),
+    protein_ref_starts_(0),
+    protein_refs_(0),
+    modification_starts_(0),
+    modification_location_(0),
+    modification_unimod_id_(0),
+    protein_strings_(0),
+    strings_(0),
+    string_bytes_(0)
+  {
+  }
+
+  TransitionBinaryLibrary::TransitionBinaryLibrary(const TransitionBinaryLibrary& rhs) :
+    region_(rhs.region_),
+    transition_count_(rhs.transition_count_),
+    compound_count_(rhs.compound_count_),
+    protein_count_(rhs.protein_count_),
+    precursor_mz_(rhs.precursor_mz_),
+    product_mz_(rhs.product_mz_),
+    library_intensity_(rhs.library_intensity_),
+    transition_strings_(rhs.transition_strings_),
+    fragment_charge_(rhs.fragment_charge_),
+    precursor_order_(rhs.precursor_order_),
+    transition_flags_(rhs.transition_flags_),
+    compound_rt_(rhs.compound_rt_),
+    compound_charge_(rhs.compound_charge_),
+    compound_strings_(rhs.compound_strings_),
+    protein_ref_starts_(rhs.protein_ref_starts_),
+    protein_refs_(rhs.protein_refs_),
+    modification_starts_(rhs.modification_starts_),
+    modification_location_(rhs.modification_location_),
+    modification_unimod_id_(rhs.modification_unimod_id_),
+    protein_strings_(rhs.protein_strings_),
+    strings_(rhs.strings_),
+    string_bytes_(rhs.string_bytes_)
+  {
+  }
+
+  TransitionBinaryLibrary& TransitionBinaryLibrary::operator=(const TransitionBinaryLibrary& rhs)
+  {
+    if (&rhs == this) return *this;
+
+    region_ = rhs.region_;
+    transition_count_ = rhs.transition_count_;
+    compound_count_ = rhs.compound_count_;
+    protein_count_ = rhs.protein_count_;
+    precursor_mz_ = rhs.precursor_mz_;
+    product_mz_ = rhs.product_mz_;
+    library_intensity_ = rhs.library_intensity_;
+    transition_strings_ = rhs.transition_strings_;
+    fragment_charge_ = rhs.fragment_charge_;
+    precursor_order_ = rhs.precursor_order_;
+    transition_flags_ = rhs.transition_flags_;
+    compound_rt_ = rhs.compound_rt_;
+    compound_charge_ = rhs.compound_charge_;
+    compound_strings_ = rhs.compound_strings_;
+    protein_ref_starts_ = rhs.protein_ref_starts_;
+    protein_refs_ = rhs.protein_refs_;
+    modification_starts_ = rhs.modification_starts_;
+    modification_location_ = rhs.modification_location_;
+    modification_unimod_id_ = rhs.modification_unimod_id_;
+    protein_strings_ = rhs.protein_strings_;
+    strings_ = rhs.strings_;
+    string_bytes_ = rhs.string_bytes_;
+    return *this;
+  }
+
+  TransitionBinaryLibrary::~TransitionBinaryLibrary()
+  {
+  }
+
+  void TransitionBinaryLibrary::store(const String& filename, const OpenSwath::LightTargetedExperiment& exp)
+  {
+    const Size transition_count = exp.transitions.size();
+    const Size compound_count = exp.compounds.size();
+    const Size protein_count = exp.proteins.size();
+    if (transition_count >= Size(std::numeric_limits<UInt32>::max()))
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, __PRETTY_FUNCTION__, transition_count);
+    }
+
+    StringTable strings;
+
+    std::vector<double> precursor_mz(transition_count), product_mz(transition_count), library_intensity(transition_count);
+    std::vector<UInt64> transition_strings(transition_count * TRANSITION_STRINGS);
+    std::vector<Int32> fragment_charge(transition_count);
+    std::vector<UInt32> precursor_order(transition_count);
+    std::vector<unsigned char> transition_flags(transition_count);
+    for (Size i = 0; i < transition_count; ++i)
+    {
+      const OpenSwath::LightTransition& tr = exp.transitions[i];
+      precursor_mz[i] = tr.precursor_mz;
+      product_mz[i] = tr.product_mz;
+      library_intensity[i] = tr.library_intensity;
+      transition_strings[i * TRANSITION_STRINGS] = strings.add(tr.transition_name);
+      transition_strings[i * TRANSITION_STRINGS + 1] = strings.add(tr.peptide_ref);
+      fragment_charge[i] = tr.fragment_charge;
+      precursor_order[i] = (UInt32)i;
+      transition_flags[i] = (tr.decoy ? FLAG_DECOY : 0) |
+                            (tr.detecting_transition ? FLAG_DETECTING : 0) |
+                            (tr.quantifying_transition ? FLAG_QUANTIFYING : 0) |
+                            (tr.identifying_transition ? FLAG_IDENTIFYING : 0);
+    }
+    std::stable_sort(precursor_order.begin(), precursor_order.end(), PrecursorLess(precursor_mz));
+
+    std::vector<double> compound_rt(compound_count);
+    std::vector<Int32> compound_charge(compound_count);
+    std::vector<UInt64> compound_strings(compound_count * COMPOUND_STRINGS);
+    std::vector<UInt64> protein_ref_starts, protein_refs, modification_starts, modification_unimod_id;
+    std::vector<Int32> modification_location;
+    protein_ref_starts.reserve(compound_count + 1);
+    modification_starts.reserve(compound_count + 1);
+    for (Size i = 0; i < compound_count; ++i)
+    {
+      const OpenSwath::LightCompound& c = exp.compounds[i];
+      compound_rt[i] = c.rt;
+      compound_charge[i] = c.charge;
+      UInt64* cs = &compound_strings[i * COMPOUND_STRINGS];
+      cs[0] = strings.add(c.id);
+      cs[1] = strings.add(c.sequence);
+      cs[2] = strings.add(c.peptide_group_label);
+      cs[3] = strings.add(c.sum_formula);
+      cs[4] = strings.add(c.compound_name);
+
+      protein_ref_starts.push_back(protein_refs.size());
+      for (Size j = 0; j < c.protein_refs.size(); ++j)
+      {
+        protein_refs.push_back(strings.add(c.protein_refs[j]));
+      }
+      modification_starts.push_back(modification_location.size());
+      for (Size j = 0; j < c.modifications.size(); ++j)
+      {
+        modification_location.push_back(c.modifications[j].location);
+        modification_unimod_id.push_back(strings.add(c.modifications[j].unimod_id));
+      }
+    }
+    protein_ref_starts.push_back(protein_refs.size());
+    modification_starts.push_back(modification_location.size());
+
+    std::vector<UInt64> protein_strings(protein_count * PROTEIN_STRINGS);
+    for (Size i = 0; i < protein_count; ++i)
+    {
+      protein_strings[i * PROTEIN_STRINGS] = strings.add(exp.proteins[i].id);
+      protein_strings[i * PROTEIN_STRINGS + 1] = strings.add(exp.proteins[i].sequence);
+    }
+
+    LibraryHeader header;
+    std::memcpy(header.magic, LIBRARY_MAGIC, sizeof(LIBRARY_MAGIC));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.transition_count = transition_count;
+    header.compound_count = compound_count;
+    header.protein_count = protein_count;
+    header.protein_ref_count = protein_refs.size();
+    header.modification_count = modification_location.size();
+    header.string_bytes = strings.data().size();
+
+    // write to a temporary file first and rename it afterwards, so other
+    // processes never see a partially written library
+    String tmp_filename = filename + "." + File::getUniqueName() + ".tmp";
+    {
+      std::ofstream ofs(tmp_filename.c_str(), std::ios::binary);
+      if (!ofs)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, tmp_filename);
+      }
+      ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      writeArray(ofs, precursor_mz);
+      writeArray(ofs, product_mz);
+      writeArray(ofs, library_intensity);
+      writeArray(ofs, transition_strings);
+      writeArray(ofs, compound_rt);
+      writeArray(ofs, compound_strings);
+      writeArray(ofs, protein_ref_starts);
+      writeArray(ofs, modification_starts);
+      writeArray(ofs, protein_refs);
+      writeArray(ofs, modification_unimod_id);
+      writeArray(ofs, protein_strings);
+      writeArray(ofs, fragment_charge);
+      writeArray(ofs, precursor_order);
+      writeArray(ofs, compound_charge);
+      writeArray(ofs, modification_location);
+      writeArray(ofs, transition_flags);
+      writeArray(ofs, strings.data());
+      if (!ofs)
+      {
+        ofs.close();
+        File::remove(tmp_filename);
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+      }
+    }
+
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0 &&
+        // std::rename does not replace an existing file on Windows
+        !(File::exists(filename) && File::remove(filename) && std::rename(tmp_filename.c_str(), filename.c_str()) == 0))
+    {
+      File::remove(tmp_filename);
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+    }
+  }
+
+  void TransitionBinaryLibrary::load(const String& filename)
+  {
+    boost::shared_ptr<boost::interprocess::mapped_region> region;
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+      region = boost::shared_ptr<boost::interprocess::mapped_region>(
+        new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception& /* e */)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+    }
+
+    const char* begin = static_cast<const char*>(region->get_address());
+    const Size size = region->get_size();
+    if (size < sizeof(LibraryHeader))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "File is too small to contain a transition library.");
+    }
+    LibraryHeader header;
+    std::memcpy(&header, begin, sizeof(header));
+    if (std::memcmp(header.magic, LIBRARY_MAGIC, sizeof(LIBRARY_MAGIC)) != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "File is not a binary transition library.");
+    }
+    if (header.byte_order != BYTE_ORDER_MARK)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "Transition library was written on a machine with different byte order.");
+    }
+    // the string table starts with the empty string and ends with a terminated string
+    if (!hasFileSize(size, header) || header.string_bytes == 0 ||
+        begin[size - header.string_bytes] != '\0' || begin[size - 1] != '\0')
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "Transition library is truncated or corrupt.");
+    }
+
+    // all counts fit into the mapped file, hence into Size
+    const Size transition_count = header.transition_count;
+    const Size compound_count = header.compound_count;
+    const Size protein_count = header.protein_count;
+
+    TransitionBinaryLibrary lib;
+    lib.region_ = region;
+    lib.transition_count_ = transition_count;
+    lib.compound_count_ = compound_count;
+    lib.protein_count_ = protein_count;
+
+    lib.precursor_mz_ = reinterpret_cast<const double*>(begin + sizeof(LibraryHeader));
+    lib.product_mz_ = lib.precursor_mz_ + transition_count;
+    lib.library_intensity_ = lib.product_mz_ + transition_count;
+    lib.transition_strings_ = reinterpret_cast<const UInt64*>(lib.library_intensity_ + transition_count);
+    lib.compound_rt_ = reinterpret_cast<const double*>(lib.transition_strings_ + transition_count * TRANSITION_STRINGS);
+    lib.compound_strings_ = reinterpret_cast<const UInt64*>(lib.compound_rt_ + compound_count);
+    lib.protein_ref_starts_ = lib.compound_strings_ + compound_count * COMPOUND_STRINGS;
+    lib.modification_starts_ = lib.protein_ref_starts_ + compound_count + 1;
+    lib.protein_refs_ = lib.modification_starts_ + compound_count + 1;
+    lib.modification_unimod_id_ = lib.protein_refs_ + header.protein_ref_count;
+    lib.protein_strings_ = lib.modification_unimod_id_ + header.modification_count;
+    lib.fragment_charge_ = reinterpret_cast<const Int32*>(lib.protein_strings_ + protein_count * PROTEIN_STRINGS);
+    lib.precursor_order_ = reinterpret_cast<const UInt32*>(lib.fragment_charge_ + transition_count);
+    lib.compound_charge_ = reinterpret_cast<const Int32*>(lib.precursor_order_ + transition_count);
+    lib.modification_location_ = lib.compound_charge_ + compound_count;
+    lib.transition_flags_ = reinterpret_cast<const unsigned char*>(lib.modification_location_ + header.modification_count);
+    lib.strings_ = reinterpret_cast<const char*>(lib.transition_flags_ + transition_count);
+    lib.string_bytes_ = header.string_bytes;
+
+    // the accessors do not check offsets and indices, so validate them once here
+    bool valid = validOffsets(lib.transition_strings_, transition_count * TRANSITION_STRINGS, header.string_bytes)
+                 && validOffsets(lib.compound_strings_, compound_count * COMPOUND_STRINGS, header.string_bytes)
+                 && validOffsets(lib.protein_refs_, header.protein_ref_count, header.string_bytes)
+                 && validOffsets(lib.modification_unimod_id_, header.modification_count, header.string_bytes)
+                 && validOffsets(lib.protein_strings_, protein_count * PROTEIN_STRINGS, header.string_bytes)
+                 && validStarts(lib.protein_ref_starts_, compound_count, header.protein_ref_count)
+                 && validStarts(lib.modification_starts_, compound_count, header.modification_count);
+    // the precursor order is a permutation of the transitions, sorted by precursor m/z
+    std::vector<bool> seen(valid ? transition_count : 0, false);
+    for (Size i = 0; valid && i < transition_count; ++i)
+    {
+      const UInt32 t = lib.precursor_order_[i];
+      valid = t < transition_count && !seen[t] &&
+              (i == 0 || !(lib.precursor_mz_[t] < lib.precursor_mz_[lib.precursor_order_[i - 1]]));
+      if (valid) seen[t] = true;
+    }
+    if (!valid)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename, "Transition library is corrupt.");
+    }
+
+    *this = lib;
+  }
+
+  bool TransitionBinaryLibrary::isLoaded() const
+  {
+    return region_.get() != 0;
+  }
+
+  Size TransitionBinaryLibrary::getNumberOfTransitions() const
+  {
+    return transition_count_;
+  }
+
+  Size TransitionBinaryLibrary::getNumberOfCompounds() const
+  {
+    return compound_count_;
+  }
+
+  Size TransitionBinaryLibrary::getNumberOfProteins() const
+  {
+    return protein_count_;
+  }
+
+  const char* TransitionBinaryLibrary::getString_(UInt64 offset) const
+  {
+    return strings_ + offset;
+  }
+
+  double TransitionBinaryLibrary::getPrecursorMZ(Size index) const
+  {
+    return precursor_mz_[index];
+  }
+
+  double TransitionBinaryLibrary::getProductMZ(Size index) const
+  {
+    return product_mz_[index];
+  }
+
+  double TransitionBinaryLibrary::getLibraryIntensity(Size index) const
+  {
+    return library_intensity_[index];
+  }
+
+  bool TransitionBinaryLibrary::isDecoy(Size index) const
+  {
+    return (transition_flags_[index] & FLAG_DECOY) != 0;
+  }
+
+  const char* TransitionBinaryLibrary::getTransitionName(Size index) const
+  {
+    return getString_(transition_strings_[index * TRANSITION_STRINGS]);
+  }
+
+  const char* TransitionBinaryLibrary::getPeptideRef(Size index) const
+  {
+    return getString_(transition_strings_[index * TRANSITION_STRINGS + 1]);
+  }
+
+  const char* TransitionBinaryLibrary::getCompoundID(Size index) const
+  {
+    return getString_(compound_strings_[index * COMPOUND_STRINGS]);
+  }
+
+  double TransitionBinaryLibrary::getCompoundRT(Size index) const
+  {
+    return compound_rt_[index];
+  }
+
+  void TransitionBinaryLibrary::getTransition(Size index, OpenSwath::LightTransition& transition) const
+  {
+    transition.transition_name = getTransitionName(index);
+    transition.peptide_ref = getPeptideRef(index);
+    transition.library_intensity = library_intensity_[index];
+    transition.product_mz = product_mz_[index];
+    transition.precursor_mz = precursor_mz_[index];
+    transition.fragment_charge = fragment_charge_[index];
+    const unsigned char flags = transition_flags_[index];
+    transition.decoy = (flags & FLAG_DECOY) != 0;
+    transition.detecting_transition = (flags & FLAG_DETECTING) != 0;
+    transition.quantifying_transition = (flags & FLAG_QUANTIFYING) != 0;
+    transition.identifying_transition = (flags & FLAG_IDENTIFYING) != 0;
+  }
+
+  void TransitionBinaryLibrary::getCompound(Size index, OpenSwath::LightCompound& compound) const
+  {
+    const UInt64* cs = compound_strings_ + index * COMPOUND_STRINGS;
+    compound.rt = compound_rt_[index];
+    compound.charge = compound_charge_[index];
+    compound.id = getString_(cs[0]);
+    compound.sequence = getString_(cs[1]);
+    compound.peptide_group_label = getString_(cs[2]);
+    compound.sum_formula = getString_(cs[3]);
+    compound.compound_name = getString_(cs[4]);
+
+    compound.protein_refs.clear();
+    compound.protein_refs.reserve(protein_ref_starts_[index + 1] - protein_ref_starts_[index]);
+    for (UInt64 j = protein_ref_starts_[index]; j < protein_ref_starts_[index + 1]; ++j)
+    {
+      compound.protein_refs.push_back(getString_(protein_refs_[j]));
+    }
+
+    compound.modifications.resize(modification_starts_[index + 1] - modification_starts_[index]);
+    for (Size j = 0; j < compound.modifications.size(); ++j)
+    {
+      const UInt64 m = modification_starts_[index] + j;
+      compound.modifications[j].location = modification_location_[m];
+      compound.modifications[j].unimod_id = getString_(modification_unimod_id_[m]);
+    }
+  }
+
+  void TransitionBinaryLibrary::getProtein(Size index, OpenSwath::LightProtein& protein) const
+  {
+    protein.id = getString_(protein_strings_[index * PROTEIN_STRINGS]);
+    protein.sequence = getString_(protein_strings_[index * PROTEIN_STRINGS + 1]);
+  }
+
+  void TransitionBinaryLibrary::getLightTargetedExperiment(OpenSwath::LightTargetedExperiment& exp) const
+  {
+    exp = OpenSwath::LightTargetedExperiment();
+    exp.transitions.resize(transition_count_);
+    for (Size i = 0; i < transition_count_; ++i)
+    {
+      getTransition(i, exp.transitions[i]);
+    }
+    exp.compounds.resize(compound_count_);
+    for (Size i = 0; i < compound_count_; ++i)
+    {
+      getCompound(i, exp.compounds[i]);
+    }
+    exp.proteins.resize(protein_count_);
+    for (Size i = 0; i < protein_count_; ++i)
+    {
+      getProtein(i, exp.proteins[i]);
+    }
+  }
+
+  void TransitionBinaryLibrary::selectTransitions(double lower, double upper, double min_upper_edge_dist,
+                                                  OpenSwath::LightTargetedExperiment& exp) const
+  {
+    if (!isLoaded()) return;
+
+    // candidates from the precursor index, then restore the library order
+    const UInt32* first = std::upper_bound(precursor_order_, precursor_order_ + transition_count_,
+                                           lower, PrecursorIndexLess(precursor_mz_));
+    const UInt32* last = std::lower_bound(first, precursor_order_ + transition_count_,
+                                          upper, PrecursorIndexLess(precursor_mz_));
+    std::vector<UInt32> selected;
+    selected.reserve(last - first);
+    for (const UInt32* it = first; it != last; ++it)
+    {
+      if (std::fabs(upper - precursor_mz_[*it]) >= min_upper_edge_dist)
+      {
+        selected.push_back(*it);
+      }
+    }
+    std::sort(selected.begin(), selected.end());
+
+    // identical strings share their offset in the string table, thus
+    // references can be matched by offset
+    std::set<UInt64> matching_compounds;
+    Size tr_offset = exp.transitions.size();
+    exp.transitions.resize(tr_offset + selected.size());
+    for (Size i = 0; i < selected.size(); ++i)
+    {
+      getTransition(selected[i], exp.transitions[tr_offset + i]);
+      matching_compounds.insert(transition_strings_[selected[i] * TRANSITION_STRINGS + 1]);
+    }
+
+    std::set<UInt64> matching_proteins;
+    for (Size i = 0; i < compound_count_; ++i)
+    {
+      if (matching_compounds.find(compound_strings_[i * COMPOUND_STRINGS]) != matching_compounds.end())
+      {
+        exp.compounds.push_back(OpenSwath::LightCompound());
+        getCompound(i, exp.compounds.back());
+        matching_proteins.insert(protein_refs_ + protein_ref_starts_[i], protein_refs_ + protein_ref_starts_[i + 1]);
+      }
+    }
+
+    for (Size i = 0; i < protein_count_; ++i)
+    {
+      if (matching_proteins.find(protein_strings_[i * PROTEIN_STRINGS]) != matching_proteins.end())
+      {
+        exp.proteins.push_back(OpenSwath::LightProtein());
+        getProtein(i, exp.proteins.back());
+      }
+    }
+  }
+
+}
@@ -39,6 +39,14 @@
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
 
 namespace OpenMS
 {
@@ -170,341 +178,511 @@ namespace OpenMS
     }
   }
 
-  void TransitionTSVReader::readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype, std::vector<TSVTransition>& transition_list)
+  namespace
   {
-    std::ifstream data(filename);
-    std::string   line;
-    std::string   tmp;
-
-    // read header
-    std::vector<std::string>   tmp_line;
-    std::vector<std::string>   header;
-    std::map<std::string, int> header_dict;
-    char delimiter = ',';
-
-    if (FileTypes::typeToName(filetype) == "mrm")
+    /// Returns the end of the line [@p begin, @p end) without a trailing carriage return (Windows line endings)
+    const char* stripCarriageReturn(const char* begin, const char* end)
     {
-      delimiter = '\t';
-
-      header_dict["SpectraSTBestSample"] = 0;
-      header_dict["SpectraSTmaxNumUsed/totNumUsed"] = 1;
-      header_dict["SpectraSTpI"] = 2;
-      header_dict["PrecursorMz"] = 3;
-      header_dict["SpectraSTRetentionTime"] = 4;
-      header_dict["ProductMz"] = 5;
-      header_dict["LibraryIntensity"] = 6;
-      header_dict["SpectraSTAnnotation"] = 7;
-      header_dict["FragmentCharge"] = 8;
-      header_dict["SpectraSTFullPeptideName"] = 9;
-      header_dict["SpectraSTUnknown"] = 10;
-      header_dict["SpectraSTNumberOfProteinsMappedTo"] = 11;
-      header_dict["ProteinName"] = 12;
+      return (end != begin && *(end - 1) == '\r') ? end - 1 : end;
     }
-    else
-    {
-      std::getline(data, line);
 
-      getTSVHeader_(line, delimiter, header, header_dict);
-    }
+    /**
+      @brief Splits the line [@p begin, @p end) at @p delimiter into @p fields
 
-    bool spectrast_legacy = 0; // we will check below if SpectraST was run in legacy (<5.0) mode or if the RT normalization was forgotten.
-    int cnt = 0;
-    while (std::getline(data, line))
+      The strings in @p fields are re-used to avoid allocations; entries
+      beyond the returned number of fields are left untouched. An empty last
+      column is kept (e.g. "a,b," has three fields).
+    */
+    Size splitTSVLine(const char* begin, const char* end, char delimiter, std::vector<String>& fields)
     {
-      line.push_back(delimiter); // avoid losing last column if it is empty
-      std::stringstream lineStream(line);
-
-      while (std::getline(lineStream, tmp, delimiter))
+      Size nr_fields = 0;
+      while (true)
       {
-        tmp_line.push_back(tmp);
+        const char* field_end = std::find(begin, end, delimiter);
+        if (nr_fields == fields.size())
+        {
+          fields.push_back(String());
+        }
+        fields[nr_fields++].assign(begin, field_end);
+        if (field_end == end)
+        {
+          return nr_fields;
+        }
+        begin = field_end + 1;
       }
-      cnt++;
+    }
+  }
 
-#ifdef TRANSITIONTSVREADER_TESTING
-      for (int i = 0; i < tmp_line.size(); i++)
-      {
-        std::cout << "line " << i << " " << tmp_line[i] << std::endl;
-      }
+  void TransitionTSVReader::resolveTSVColumns_(const std::map<std::string, int>& header_dict, TSVColumns& columns)
+  {
+    struct Lookup
+    {
+      static int column(const std::map<std::string, int>& dict, const char* name)
+      {
+        std::map<std::string, int>::const_iterator it = dict.find(name);
+        return it == dict.end() ? -1 : it->second;
+      }
+
+      static int column(const std::map<std::string, int>& dict, const char* name, const char* fallback)
+      {
+        int col = column(dict, name);
+        return col == -1 ? column(dict, fallback) : col;
+      }
+    };
+
+    columns.nr_fields = header_dict.size();
+    columns.precursor = Lookup::column(header_dict, "PrecursorMz");
+    columns.product = Lookup::column(header_dict, "ProductMz");
+    columns.library_intensity = Lookup::column(header_dict, "LibraryIntensity");
+    columns.transition_name = Lookup::column(header_dict, "transition_name");
+    columns.group_id = Lookup::column(header_dict, "transition_group_id");
+    columns.rt = Lookup::column(header_dict, "RetentionTime", "Tr_recalibrated");
+    columns.spectrast_rt = Lookup::column(header_dict, "SpectraSTRetentionTime");
+    columns.spectrast_full_peptide_name = Lookup::column(header_dict, "SpectraSTFullPeptideName");
+    columns.spectrast_annotation = Lookup::column(header_dict, "SpectraSTAnnotation");
+    columns.compound_name = Lookup::column(header_dict, "CompoundName");
+    columns.sum_formula = Lookup::column(header_dict, "SumFormula");
+    columns.smiles = Lookup::column(header_dict, "SMILES");
+    columns.annotation = Lookup::column(header_dict, "Annotation");
+    columns.CE = Lookup::column(header_dict, "CE", "CollisionEnergy");
+    columns.decoy = Lookup::column(header_dict, "decoy");
+    columns.detecting_transition = Lookup::column(header_dict, "detecting_transition");
+    columns.identifying_transition = Lookup::column(header_dict, "identifying_transition");
+    columns.quantifying_transition = Lookup::column(header_dict, "quantifying_transition");
+    columns.protein_name = Lookup::column(header_dict, "ProteinName");
+    columns.peptide_sequence = Lookup::column(header_dict, "PeptideSequence");
+    // previously, only FullPeptideName was used and not FullUniModPeptideName
+    columns.full_peptide_name = Lookup::column(header_dict, "FullUniModPeptideName", "FullPeptideName");
+    // charge is assumed to be the charge of the precursor
+    columns.precursor_charge = Lookup::column(header_dict, "PrecursorCharge", "Charge");
+    columns.peptide_group_label = Lookup::column(header_dict, "PeptideGroupLabel");
+    columns.label_type = Lookup::column(header_dict, "LabelType");
+    columns.uniprot_id = Lookup::column(header_dict, "UniprotID");
+    columns.fragment_type = Lookup::column(header_dict, "FragmentType");
+    columns.fragment_charge = Lookup::column(header_dict, "FragmentCharge");
+    columns.fragment_nr = Lookup::column(header_dict, "FragmentSeriesNumber");
+    columns.fragment_mzdelta = Lookup::column(header_dict, "FragmentMzDelta");
+    columns.fragment_modification = Lookup::column(header_dict, "FragmentModification");
+  }
 
-      for (std::map<std::string, int>::iterator iter = header_dict.begin(); iter != header_dict.end(); ++iter)
-      {
-        std::cout << "header " << iter->first << " " << iter->second << std::endl;
-      }
+  void TransitionTSVReader::parseTSVLine_(const std::vector<String>& tmp_line, Size nr_fields, const TSVColumns& columns, bool mrm,
+                                          Size cnt, TSVTransition& mytransition, bool& spectrast_legacy)
+  {
+#ifdef TRANSITIONTSVREADER_TESTING
+    for (Size i = 0; i < nr_fields; i++)
+    {
+      std::cout << "line " << i << " " << tmp_line[i] << std::endl;
+    }
 #endif
 
-      if (tmp_line.size() != header_dict.size())
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
-                                         "Error reading the file on line " + String(cnt) + ": length of the header and length of the line" +
-                                         " do not match: " + String(tmp_line.size()) + " != " + String(header_dict.size()));
-      }
+    if (nr_fields != columns.nr_fields)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                                       "Error reading the file on line " + String(cnt) + ": length of the header and length of the line" +
+                                       " do not match: " + String(nr_fields) + " != " + String(columns.nr_fields));
+    }
 
-      TSVTransition mytransition;
+    // Required columns (they are guaranteed to be present, see getTSVHeader_)
+    mytransition.precursor                    = tmp_line[columns.precursor].toDouble();
+    mytransition.product                      = tmp_line[columns.product].toDouble();
+    mytransition.library_intensity            = tmp_line[columns.library_intensity].toDouble();
 
-      // Required columns (they are guaranteed to be present, see getTSVHeader_)
-      mytransition.precursor                    = String(tmp_line[header_dict["PrecursorMz"]]).toDouble();
-      mytransition.product                      = String(tmp_line[header_dict["ProductMz"]]).toDouble();
-      mytransition.library_intensity            = String(tmp_line[header_dict["LibraryIntensity"]]).toDouble();
+    if (mrm)
+    {
+      std::vector<String> substrings;
+      tmp_line[columns.spectrast_full_peptide_name].split("/", substrings);
+      AASequence peptide = AASequence::fromString(substrings[0]);
 
-      if (FileTypes::typeToName(filetype) == "mrm")
-      {
-        std::vector<String> substrings;
-        String(tmp_line[header_dict["SpectraSTFullPeptideName"]]).split("/", substrings);
-        AASequence peptide = AASequence::fromString(substrings[0]);
+      mytransition.FullPeptideName = peptide.toString();
+      mytransition.PeptideSequence = peptide.toUnmodifiedString();
+      mytransition.precursor_charge = substrings[1];
 
-        mytransition.FullPeptideName = peptide.toString();
-        mytransition.PeptideSequence = peptide.toUnmodifiedString();
-        mytransition.precursor_charge = substrings[1];
+      mytransition.transition_name = String(cnt) + ("_") + tmp_line[columns.protein_name] +
+                                     String("_") + mytransition.FullPeptideName + String("_") +
+                                     tmp_line[columns.precursor] + "_" + tmp_line[columns.product];
 
-        mytransition.transition_name = String(cnt) + ("_") + String(tmp_line[header_dict["ProteinName"]]) +
-                                       String("_") + mytransition.FullPeptideName + String("_") + 
-                                       String(tmp_line[header_dict["PrecursorMz"]]) + "_" + String(tmp_line[header_dict["ProductMz"]]);
+      mytransition.group_id = tmp_line[columns.protein_name] +
+                              String("_") + mytransition.FullPeptideName + String("_") + String(mytransition.precursor_charge);
+    }
+    else
+    {
+      mytransition.transition_name = tmp_line[columns.transition_name];
+      mytransition.group_id = tmp_line[columns.group_id];
+      mytransition.precursor_charge = "NA";
+    }
 
-        mytransition.group_id = String(tmp_line[header_dict["ProteinName"]]) + 
-                                String("_") + mytransition.FullPeptideName + String("_") + String(mytransition.precursor_charge);
+    if (columns.rt != -1)
+    {
+      mytransition.rt_calibrated = tmp_line[columns.rt].toDouble();
+    }
+    else if (columns.spectrast_rt != -1)
+    {
+      // If SpectraST was run in RT normalization mode, the retention time is annotated as following: "3887.50(57.30)"
+      // 3887.50 refers to the non-normalized RT of the individual or consensus run, and 57.30 refers to the normalized
+      // iRT.
+      const String& spectrast_rt = tmp_line[columns.spectrast_rt];
+      size_t start_position = spectrast_rt.find("(");
+      if (start_position != std::string::npos)
+      {
+        ++start_position;
+        size_t end_position = spectrast_rt.find(")");
+        if (end_position != std::string::npos)
+        {
+          mytransition.rt_calibrated = String(spectrast_rt.substr(start_position, end_position - start_position)).toDouble();
+        }
       }
       else
       {
-        mytransition.transition_name = tmp_line[header_dict["transition_name"]];
-        mytransition.group_id = tmp_line[header_dict["transition_group_id"]];
-        mytransition.precursor_charge = "NA";
+        // SpectraST was run without RT Normalization mode
+        spectrast_legacy = true;
+        mytransition.rt_calibrated = spectrast_rt.toDouble();
       }
+    }
+    else
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                                       "Expected a header named RetentionTime, Tr_recalibrated or SpectraSTRetentionTime but found none");
+    }
 
-      if (header_dict.find("RetentionTime") != header_dict.end())
-      {
-        mytransition.rt_calibrated = String(tmp_line[header_dict["RetentionTime"]]).toDouble();
-      }
-      else if (header_dict.find("Tr_recalibrated") != header_dict.end())
+    if (columns.compound_name != -1)
+    {
+      mytransition.CompoundName = tmp_line[columns.compound_name];
+    }
+    if (columns.sum_formula != -1)
+    {
+      mytransition.SumFormula = tmp_line[columns.sum_formula];
+    }
+    if (columns.smiles != -1)
+    {
+      mytransition.SMILES = tmp_line[columns.smiles];
+    }
+
+    if (columns.annotation != -1)
+    {
+      mytransition.Annotation = tmp_line[columns.annotation];
+    }
+    if (columns.CE != -1)
+    {
+      mytransition.CE = tmp_line[columns.CE].toDouble();
+    }
+
+    if (columns.decoy != -1)
+    {
+      mytransition.decoy                        =                      tmp_line[columns.decoy].toInt();
+    }
+    if (columns.detecting_transition != -1)
+    {
+      if  (tmp_line[columns.detecting_transition] == "1") { mytransition.detecting_transition = true; }
+      else if (tmp_line[columns.detecting_transition] == "0") { mytransition.detecting_transition = false; }
+    }
+    if (columns.identifying_transition != -1)
+    {
+      if  (tmp_line[columns.identifying_transition] == "1") { mytransition.identifying_transition = true; }
+      else if (tmp_line[columns.identifying_transition] == "0") { mytransition.identifying_transition = false; }
+    }
+    if (columns.quantifying_transition != -1)
+    {
+      if  (tmp_line[columns.quantifying_transition] == "1") { mytransition.quantifying_transition = true; }
+      else if (tmp_line[columns.quantifying_transition] == "0") { mytransition.quantifying_transition = false; }
+    }
+    if (columns.protein_name != -1)
+    {
+      mytransition.ProteinName = tmp_line[columns.protein_name];
+    }
+    if (columns.peptide_sequence != -1)
+    {
+      mytransition.PeptideSequence = tmp_line[columns.peptide_sequence];
+    }
+    if (columns.full_peptide_name != -1)
+    {
+      mytransition.FullPeptideName              =                             tmp_line[columns.full_peptide_name];
+    }
+    if (columns.precursor_charge != -1)
+    {
+      mytransition.precursor_charge = tmp_line[columns.precursor_charge];
+    }
+
+    if (columns.peptide_group_label != -1)
+    {
+      mytransition.peptide_group_label = tmp_line[columns.peptide_group_label];
+    }
+    if (columns.label_type != -1)
+    {
+      mytransition.label_type                   =                             tmp_line[columns.label_type];
+    }
+    if (columns.uniprot_id != -1)
+    {
+      if (tmp_line[columns.uniprot_id] != "NA")
       {
-        mytransition.rt_calibrated = String(tmp_line[header_dict["Tr_recalibrated"]]).toDouble();
+        mytransition.uniprot_id                   =                             tmp_line[columns.uniprot_id];
       }
-      else if (header_dict.find("SpectraSTRetentionTime") != header_dict.end())
-      {
-        // If SpectraST was run in RT normalization mode, the retention time is annotated as following: "3887.50(57.30)"
-        // 3887.50 refers to the non-normalized RT of the individual or consensus run, and 57.30 refers to the normalized
-        // iRT.
-        size_t start_position = tmp_line[header_dict["SpectraSTRetentionTime"]].find("(");
-        if (start_position != std::string::npos)
+    }
+    if (columns.fragment_type != -1)
+    {
+      mytransition.fragment_type                =                             tmp_line[columns.fragment_type];
+    }
+    if (columns.fragment_charge != -1)
+    {
+      mytransition.fragment_charge = tmp_line[columns.fragment_charge];
+    }
+    if (columns.fragment_nr != -1)
+    {
+      mytransition.fragment_nr                  =                      tmp_line[columns.fragment_nr].toInt();
+    }
+    if (columns.fragment_mzdelta != -1)
+    {
+      mytransition.fragment_mzdelta = tmp_line[columns.fragment_mzdelta].toInt();
+    }
+    if (columns.fragment_modification != -1)
+    {
+      mytransition.fragment_modification = tmp_line[columns.fragment_modification].toInt();
+    }
+    if (columns.spectrast_annotation != -1)
+    {
+      // Parses SpectraST fragment ion annotations
+      // Example: y13^2/0.000,b16-18^2/-0.013,y7-45/0.000
+      // Important: m2:8 are not yet supported! See SpectraSTPeakList::annotateInternalFragments for further information
+      mytransition.Annotation = tmp_line[columns.spectrast_annotation];
+
+      std::vector<String> all_fragment_annotations;
+      tmp_line[columns.spectrast_annotation].split(",", all_fragment_annotations);
+
+      if (all_fragment_annotations[0].find("[") == std::string::npos && // non-unique peak annotation
+          all_fragment_annotations[0].find("]") == std::string::npos && // non-unique peak annotation
+          all_fragment_annotations[0].find("I") == std::string::npos && // immonium ion
+          all_fragment_annotations[0].find("p") == std::string::npos && // precursor ion
+          all_fragment_annotations[0].find("i") == std::string::npos && // isotope ion
+          all_fragment_annotations[0].find("m") == std::string::npos &&
+          all_fragment_annotations[0].find("?") == std::string::npos
+          )
+      {
+        std::vector<String> best_fragment_annotation_with_deviation;
+        all_fragment_annotations[0].split("/", best_fragment_annotation_with_deviation);
+        String best_fragment_annotation = best_fragment_annotation_with_deviation[0];
+
+        if (best_fragment_annotation.find("^") != std::string::npos)
         {
-          ++start_position;
-          size_t end_position = tmp_line[header_dict["SpectraSTRetentionTime"]].find(")");
-          if (end_position != std::string::npos)
-          {
-            mytransition.rt_calibrated = String(tmp_line[header_dict["SpectraSTRetentionTime"]].substr(start_position, end_position - start_position)).toDouble();
-          }
+          std::vector<String> best_fragment_annotation_charge;
+          best_fragment_annotation.split("^", best_fragment_annotation_charge);
+          mytransition.fragment_charge = String(best_fragment_annotation_charge[1]);
+          best_fragment_annotation = best_fragment_annotation_charge[0];
         }
         else
         {
-          // SpectraST was run without RT Normalization mode
-          spectrast_legacy = 1;
-          mytransition.rt_calibrated = String(tmp_line[header_dict["SpectraSTRetentionTime"]]).toDouble();
+          mytransition.fragment_charge = 1; // assume 1 (most frequent charge state)
         }
-      }
-      else
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
-                                         "Expected a header named RetentionTime, Tr_recalibrated or SpectraSTRetentionTime but found none");
-      }
 
-      if (header_dict.find("CompoundName") != header_dict.end())
-      {
-        mytransition.CompoundName = tmp_line[header_dict["CompoundName"]];
-      }
-      if (header_dict.find("SumFormula") != header_dict.end())
-      {
-        mytransition.SumFormula = tmp_line[header_dict["SumFormula"]];
-      }
-      if (header_dict.find("SMILES") != header_dict.end())
-      {
-        mytransition.SMILES = tmp_line[header_dict["SMILES"]];
-      }
+        if (best_fragment_annotation.find("-") != std::string::npos)
+        {
+          std::vector<String> best_fragment_annotation_modification;
+          best_fragment_annotation.split("-", best_fragment_annotation_modification);
+          mytransition.fragment_type = best_fragment_annotation_modification[0].substr(0, 1);
+          mytransition.fragment_nr = String(best_fragment_annotation_modification[0].substr(1)).toInt();
+          mytransition.fragment_modification = -1 * String(best_fragment_annotation_modification[1]).toInt();
 
-      if (header_dict.find("Annotation") != header_dict.end())
-      {
-        mytransition.Annotation = tmp_line[header_dict["Annotation"]];
-      }
-      if (header_dict.find("CE") != header_dict.end())
-      {
-        mytransition.CE = String(tmp_line[header_dict["CE"]]).toDouble();
-      }
-      else if (header_dict.find("CollisionEnergy") != header_dict.end())
-      {
-        mytransition.CE = String(tmp_line[header_dict["CollisionEnergy"]]).toDouble();
-      }
+        }
+        else if (best_fragment_annotation.find("+") != std::string::npos)
+        {
+          std::vector<String> best_fragment_annotation_modification;
+          best_fragment_annotation.split("+", best_fragment_annotation_modification);
+          mytransition.fragment_type = best_fragment_annotation_modification[0].substr(0, 1);
+          mytransition.fragment_nr = String(best_fragment_annotation_modification[0].substr(1)).toInt();
+          mytransition.fragment_modification = String(best_fragment_annotation_modification[1]).toInt();
+        }
+        else
+        {
+          mytransition.fragment_type = best_fragment_annotation.substr(0, 1);
+          mytransition.fragment_nr = String(best_fragment_annotation.substr(1)).toInt();
+          mytransition.fragment_modification = 0;
+        }
 
-      if (header_dict.find("decoy") != header_dict.end())
-      {
-        mytransition.decoy                        =                      String(tmp_line[header_dict["decoy"]]).toInt();
-      }
-      if (header_dict.find("detecting_transition") != header_dict.end())
-      {
-        if  (String(tmp_line[header_dict["detecting_transition"]]) == "1") { mytransition.detecting_transition = true; }
-        else if (String(tmp_line[header_dict["detecting_transition"]]) == "0") { mytransition.detecting_transition = false; }
-      }
-      if (header_dict.find("identifying_transition") != header_dict.end())
-      {
-        if  (String(tmp_line[header_dict["identifying_transition"]]) == "1") { mytransition.identifying_transition = true; }
-        else if (String(tmp_line[header_dict["identifying_transition"]]) == "0") { mytransition.identifying_transition = false; }
-      }
-      if (header_dict.find("quantifying_transition") != header_dict.end())
-      {
-        if  (String(tmp_line[header_dict["quantifying_transition"]]) == "1") { mytransition.quantifying_transition = true; }
-        else if (String(tmp_line[header_dict["quantifying_transition"]]) == "0") { mytransition.quantifying_transition = false; }
-      }
-      if (header_dict.find("ProteinName") != header_dict.end())
-      {
-        mytransition.ProteinName = tmp_line[header_dict["ProteinName"]];
-      }
-      if (header_dict.find("PeptideSequence") != header_dict.end())
-      {
-        mytransition.PeptideSequence = tmp_line[header_dict["PeptideSequence"]];
-      }
-      if (header_dict.find("FullUniModPeptideName") != header_dict.end())
-      {
-        mytransition.FullPeptideName              =                             tmp_line[header_dict["FullUniModPeptideName"]];
-      }
-      else if (header_dict.find("FullPeptideName") != header_dict.end())
-      {
-        // previously, only FullPeptideName was used and not FullUniModPeptideName
-        mytransition.FullPeptideName              =                             tmp_line[header_dict["FullPeptideName"]];
-      }
-      if (header_dict.find("PrecursorCharge") != header_dict.end())
-      {
-        mytransition.precursor_charge = String(tmp_line[header_dict["PrecursorCharge"]]);
-      }
-      else if (header_dict.find("Charge") != header_dict.end())
-      {
-        // charge is assumed to be the charge of the precursor
-        mytransition.precursor_charge = String(tmp_line[header_dict["Charge"]]);
+        mytransition.fragment_mzdelta = String(best_fragment_annotation_with_deviation[1]).toDouble();
       }
+    }
+
+    cleanupTransitions_(mytransition);
+
+#ifdef TRANSITIONTSVREADER_TESTING
+    std::cout << mytransition.precursor << std::endl;
+    std::cout << mytransition.product << std::endl;
+    std::cout << mytransition.rt_calibrated << std::endl;
+    std::cout << mytransition.transition_name << std::endl;
+    std::cout << mytransition.CE << std::endl;
+    std::cout << mytransition.library_intensity << std::endl;
+    std::cout << mytransition.group_id << std::endl;
+    std::cout << mytransition.decoy << std::endl;
+    std::cout << mytransition.PeptideSequence << std::endl;
+    std::cout << mytransition.ProteinName << std::endl;
+    std::cout << mytransition.Annotation << std::endl;
+    std::cout << mytransition.FullPeptideName << std::endl;
+    std::cout << mytransition.precursor_charge << std::endl;
+    std::cout << mytransition.peptide_group_label << std::endl;
+    std::cout << mytransition.fragment_charge << std::endl;
+    std::cout << mytransition.fragment_nr << std::endl;
+    std::cout << mytransition.fragment_mzdelta << std::endl;
+    std::cout << mytransition.fragment_modification << std::endl;
+    std::cout << mytransition.fragment_type << std::endl;
+    std::cout << mytransition.uniprot_id << std::endl;
+#endif
+  }
 
-      if (header_dict.find("PeptideGroupLabel") != header_dict.end()) 
+  void TransitionTSVReader::readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype, std::vector<TSVTransition>& transition_list,
+                                                      OpenSwath::LightTargetedExperiment* light_exp)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+    }
+    if (!File::readable(filename))
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+    }
+
+    // map the whole file into memory (mapping an empty file is not possible)
+    boost::shared_ptr<boost::interprocess::mapped_region> region;
+    const char* data = 0;
+    Size size = 0;
+    if (!File::empty(filename))
+    {
+      try
       {
-        mytransition.peptide_group_label = tmp_line[header_dict["PeptideGroupLabel"]];
+        boost::interprocess::file_mapping mapping(filename, boost::interprocess::read_only);
+        region = boost::shared_ptr<boost::interprocess::mapped_region>(
+          new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
       }
-      if (header_dict.find("LabelType") != header_dict.end())
+      catch (boost::interprocess::interprocess_exception& /* e */)
       {
-        mytransition.label_type                   =                             tmp_line[header_dict["LabelType"]];
+        throw Exception::FileNotReadable(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
       }
-      if (header_dict.find("UniprotID") != header_dict.end())
+      region->advise(boost::interprocess::mapped_region::advice_sequential);
+      data = static_cast<const char*>(region->get_address());
+      size = region->get_size();
+    }
+    const char* const data_end = data + size;
+
+    // read header
+    std::vector<std::string>   header;
+    std::map<std::string, int> header_dict;
+    char delimiter = ',';
+    const bool mrm = FileTypes::typeToName(filetype) == "mrm";
+    const char* pos = data;
+
+    if (mrm)
+    {
+      delimiter = '\t';
+
+      header_dict["SpectraSTBestSample"] = 0;
+      header_dict["SpectraSTmaxNumUsed/totNumUsed"] = 1;
+      header_dict["SpectraSTpI"] = 2;
+      header_dict["PrecursorMz"] = 3;
+      header_dict["SpectraSTRetentionTime"] = 4;
+      header_dict["ProductMz"] = 5;
+      header_dict["LibraryIntensity"] = 6;
+      header_dict["SpectraSTAnnotation"] = 7;
+      header_dict["FragmentCharge"] = 8;
+      header_dict["SpectraSTFullPeptideName"] = 9;
+      header_dict["SpectraSTUnknown"] = 10;
+      header_dict["SpectraSTNumberOfProteinsMappedTo"] = 11;
+      header_dict["ProteinName"] = 12;
+    }
+    else
+    {
+      const char* line_end = std::find(pos, data_end, '\n');
+      std::string line(pos, stripCarriageReturn(pos, line_end));
+      pos = line_end == data_end ? data_end : line_end + 1;
+
+      getTSVHeader_(line, delimiter, header, header_dict);
+    }
+
+    TSVColumns columns;
+    resolveTSVColumns_(header_dict, columns);
+
+    // Lines are parsed in chunks: the line boundaries of a chunk are
+    // determined sequentially, then the lines are parsed in parallel and the
+    // transitions are handed on in file order. Modified peptide sequences of
+    // SpectraST (mrm) files are parsed with AASequence, which may add
+    // residues to the (global) residue database and is therefore not done in
+    // parallel.
+    const Size chunk_size = 65536;
+    std::vector<std::pair<const char*, const char*> > lines;
+    std::vector<TSVTransition> chunk;
+    LightConversionState light_state;
+
+    bool spectrast_legacy = false; // we will check below if SpectraST was run in legacy (<5.0) mode or if the RT normalization was forgotten.
+    Size cnt = 0;
+    startProgress(0, size, "loading transition list");
+    while (pos != data_end)
+    {
+      lines.clear();
+      while (pos != data_end && lines.size() < chunk_size)
       {
-        if (tmp_line[header_dict["UniprotID"]] != "NA")
+        const char* line_end = static_cast<const char*>(std::memchr(pos, '\n', data_end - pos));
+        if (line_end == 0)
         {
-          mytransition.uniprot_id                   =                             tmp_line[header_dict["UniprotID"]];
+          line_end = data_end;
         }
+        lines.push_back(std::make_pair(pos, stripCarriageReturn(pos, line_end)));
+        pos = line_end == data_end ? data_end : line_end + 1;
       }
-      if (header_dict.find("FragmentType") != header_dict.end())
-      {
-        mytransition.fragment_type                =                             tmp_line[header_dict["FragmentType"]];
-      }
-      if (header_dict.find("FragmentCharge") != header_dict.end())
-      {
-        mytransition.fragment_charge = String(tmp_line[header_dict["FragmentCharge"]]);
-      }
-      if (header_dict.find("FragmentSeriesNumber") != header_dict.end())
-      {
-        mytransition.fragment_nr                  =                      String(tmp_line[header_dict["FragmentSeriesNumber"]]).toInt();
-      }
-      if (header_dict.find("FragmentMzDelta") != header_dict.end())
-      {
-        mytransition.fragment_mzdelta = String(tmp_line[header_dict["FragmentMzDelta"]]).toInt();
-      }
-      if (header_dict.find("FragmentModification") != header_dict.end())
-      {
-        mytransition.fragment_modification = String(tmp_line[header_dict["FragmentModification"]]).toInt();
-      }
-      if (header_dict.find("SpectraSTAnnotation") != header_dict.end())
+
+      chunk.clear();
+      chunk.resize(lines.size());
+      SignedSize first_error = lines.size();
+      int legacy_lines = 0;
+#ifdef _OPENMP
+#pragma omp parallel if (!mrm)
+#endif
       {
-        // Parses SpectraST fragment ion annotations
-        // Example: y13^2/0.000,b16-18^2/-0.013,y7-45/0.000
-        // Important: m2:8 are not yet supported! See SpectraSTPeakList::annotateInternalFragments for further information
-        mytransition.Annotation = tmp_line[header_dict["SpectraSTAnnotation"]];
-
-        std::vector<String> all_fragment_annotations;
-        String(tmp_line[header_dict["SpectraSTAnnotation"]]).split(",", all_fragment_annotations);
-
-        if (all_fragment_annotations[0].find("[") == std::string::npos && // non-unique peak annotation
-            all_fragment_annotations[0].find("]") == std::string::npos && // non-unique peak annotation
-            all_fragment_annotations[0].find("I") == std::string::npos && // immonium ion
-            all_fragment_annotations[0].find("p") == std::string::npos && // precursor ion
-            all_fragment_annotations[0].find("i") == std::string::npos && // isotope ion
-            all_fragment_annotations[0].find("m") == std::string::npos &&
-            all_fragment_annotations[0].find("?") == std::string::npos
-            )
+        std::vector<String> fields;
+#ifdef _OPENMP
+#pragma omp for schedule(static) reduction(+: legacy_lines)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)lines.size(); ++i)
         {
-          std::vector<String> best_fragment_annotation_with_deviation;
-          all_fragment_annotations[0].split("/", best_fragment_annotation_with_deviation);
-          String best_fragment_annotation = best_fragment_annotation_with_deviation[0];
-
-          if (best_fragment_annotation.find("^") != std::string::npos)
+          Size nr_fields = splitTSVLine(lines[i].first, lines[i].second, delimiter, fields);
+          try
           {
-            std::vector<String> best_fragment_annotation_charge;
-            best_fragment_annotation.split("^", best_fragment_annotation_charge);
-            mytransition.fragment_charge = String(best_fragment_annotation_charge[1]);
-            best_fragment_annotation = best_fragment_annotation_charge[0];
-          }
-          else
-          {
-            mytransition.fragment_charge = 1; // assume 1 (most frequent charge state)
-          }
-
-          if (best_fragment_annotation.find("-") != std::string::npos)
-          {
-            std::vector<String> best_fragment_annotation_modification;
-            best_fragment_annotation.split("-", best_fragment_annotation_modification);
-            mytransition.fragment_type = best_fragment_annotation_modification[0].substr(0, 1);
-            mytransition.fragment_nr = String(best_fragment_annotation_modification[0].substr(1)).toInt();
-            mytransition.fragment_modification = -1 * String(best_fragment_annotation_modification[1]).toInt();
-
+            bool legacy = false;
+            parseTSVLine_(fields, nr_fields, columns, mrm, cnt + i + 1, chunk[i], legacy);
+            if (legacy)
+            {
+              ++legacy_lines;
+            }
           }
-          else if (best_fragment_annotation.find("+") != std::string::npos)
+          catch (...)
           {
-            std::vector<String> best_fragment_annotation_modification;
-            best_fragment_annotation.split("+", best_fragment_annotation_modification);
-            mytransition.fragment_type = best_fragment_annotation_modification[0].substr(0, 1);
-            mytransition.fragment_nr = String(best_fragment_annotation_modification[0].substr(1)).toInt();
-            mytransition.fragment_modification = String(best_fragment_annotation_modification[1]).toInt();
-          }
-          else
-          {
-            mytransition.fragment_type = best_fragment_annotation.substr(0, 1);
-            mytransition.fragment_nr = String(best_fragment_annotation.substr(1)).toInt();
-            mytransition.fragment_modification = 0;
+#ifdef _OPENMP
+#pragma omp critical (OPENMS_TransitionTSVReader_error)
+#endif
+            first_error = std::min(first_error, i);
           }
-
-          mytransition.fragment_mzdelta = String(best_fragment_annotation_with_deviation[1]).toDouble();
         }
       }
 
-      cleanupTransitions_(mytransition);
-
-      transition_list.push_back(mytransition);
-
-#ifdef TRANSITIONTSVREADER_TESTING
-      std::cout << mytransition.precursor << std::endl;
-      std::cout << mytransition.product << std::endl;
-      std::cout << mytransition.rt_calibrated << std::endl;
-      std::cout << mytransition.transition_name << std::endl;
-      std::cout << mytransition.CE << std::endl;
-      std::cout << mytransition.library_intensity << std::endl;
-      std::cout << mytransition.group_id << std::endl;
-      std::cout << mytransition.decoy << std::endl;
-      std::cout << mytransition.PeptideSequence << std::endl;
-      std::cout << mytransition.ProteinName << std::endl;
-      std::cout << mytransition.Annotation << std::endl;
-      std::cout << mytransition.FullPeptideName << std::endl;
-      std::cout << mytransition.precursor_charge << std::endl;
-      std::cout << mytransition.peptide_group_label << std::endl;
-      std::cout << mytransition.fragment_charge << std::endl;
-      std::cout << mytransition.fragment_nr << std::endl;
-      std::cout << mytransition.fragment_mzdelta << std::endl;
-      std::cout << mytransition.fragment_modification << std::endl;
-      std::cout << mytransition.fragment_type << std::endl;
-      std::cout << mytransition.uniprot_id << std::endl;
-#endif
+      if (first_error < (SignedSize)lines.size())
+      {
+        // exceptions cannot leave the parallel region: parse the first
+        // offending line again to throw the original exception
+        std::vector<String> fields;
+        Size nr_fields = splitTSVLine(lines[first_error].first, lines[first_error].second, delimiter, fields);
+        TSVTransition mytransition;
+        bool legacy = false;
+        parseTSVLine_(fields, nr_fields, columns, mrm, cnt + first_error + 1, mytransition, legacy);
+      }
+      spectrast_legacy = spectrast_legacy || legacy_lines > 0;
+      cnt += lines.size();
 
-      tmp_line.clear();
+      if (light_exp != 0)
+      {
+        TSVToTargetedExperiment_(chunk, light_state, *light_exp);
+      }
+      else
+      {
+        transition_list.insert(transition_list.end(), chunk.begin(), chunk.end());
+      }
+      setProgress(pos - data);
     }
+    endProgress();
 
     if (spectrast_legacy && retentionTimeInterpretation_ == "iRT")
     {
@@ -630,19 +808,39 @@ namespace OpenMS
     exp.setProteins(proteins);
   }
 
-  void TransitionTSVReader::TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp)
+  void TransitionTSVReader::TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, LightConversionState& state,
+                                                     OpenSwath::LightTargetedExperiment& exp)
   {
-    std::map<String, int> compound_map;
-    std::map<String, int> protein_map;
-
-    resolveMixedSequenceGroups_(transition_list);
-
     OpenMS::TargetedExperiment::Peptide tramlpeptide;
 
-    Size progress = 0;
-    startProgress(0, transition_list.size(), "converting to Transition List Format");
     for (std::vector<TSVTransition>::iterator tr_it = transition_list.begin(); tr_it != transition_list.end(); ++tr_it)
     {
+      // same check as resolveMixedSequenceGroups_, but while streaming: the
+      // first transition of a peptide label group defines its sequence
+      if (!tr_it->peptide_group_label.empty())
+      {
+        std::map<String, String>::iterator label_it = state.label_sequences.find(tr_it->peptide_group_label);
+        if (label_it == state.label_sequences.end())
+        {
+          state.label_sequences[tr_it->peptide_group_label] = tr_it->PeptideSequence;
+        }
+        else if (!label_it->second.empty() && tr_it->PeptideSequence != label_it->second)
+        {
+          if (override_group_label_check_)
+          {
+            LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << label_it->first <<
+              ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
+          }
+          else
+          {
+            LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << label_it->first <<
+              ". This is most likely an error and to fix this, a new peptide label group will be inferred - " <<
+              "to override this decision, please use the override_group_label_check parameter." << std::endl;
+            tr_it->peptide_group_label = tr_it->group_id;
+          }
+        }
+      }
+
       OpenSwath::LightTransition transition;
       transition.transition_name  = tr_it->transition_name;
       transition.peptide_ref  = tr_it->group_id;
@@ -670,28 +868,27 @@ namespace OpenMS
 
       exp.transitions.push_back(transition);
 
-      // check whether we need a new compound
-      if (compound_map.find(tr_it->group_id) == compound_map.end())
+      // check whether we need a new compound (transitions of a compound are usually consecutive)
+      if (tr_it->group_id != state.last_group_id && state.compound_map.find(tr_it->group_id) == state.compound_map.end())
       {
         OpenSwath::LightCompound compound;
         createPeptide_(tr_it, tramlpeptide);
         OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
         exp.compounds.push_back(compound);
-        compound_map[compound.id] = 0;
+        state.compound_map[compound.id] = 0;
       }
+      state.last_group_id = tr_it->group_id;
 
       // check whether we need a new protein
-      if (tr_it->isPeptide() && protein_map.find(tr_it->ProteinName) == protein_map.end())
+      if (tr_it->isPeptide() && state.protein_map.find(tr_it->ProteinName) == state.protein_map.end())
       {
         OpenSwath::LightProtein protein;
         protein.id = tr_it->ProteinName;
         protein.sequence = "";
         exp.proteins.push_back(protein);
-        protein_map[tr_it->ProteinName] = 0;
+        state.protein_map[tr_it->ProteinName] = 0;
       }
-      setProgress(progress++);
     }
-    endProgress();
   }
 
   void TransitionTSVReader::resolveMixedSequenceGroups_(std::vector<TransitionTSVReader::TSVTransition>& transition_list)
@@ -1447,9 +1644,9 @@ namespace OpenMS
 
   void TransitionTSVReader::convertTSVToTargetedExperiment(const char* filename, FileTypes::Type filetype, OpenSwath::LightTargetedExperiment& targeted_exp)
   {
+    // transitions are converted chunk by chunk while reading
     std::vector<TSVTransition> transition_list;
-    readUnstructuredTSVInput_(filename, filetype, transition_list);
-    TSVToTargetedExperiment_(transition_list, targeted_exp);
+    readUnstructuredTSVInput_(filename, filetype, transition_list, &targeted_exp);
   }
 
   void TransitionTSVReader::validateTargetedExperiment(OpenMS::TargetedExperiment& targeted_exp)
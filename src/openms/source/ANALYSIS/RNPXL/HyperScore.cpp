@@ -104,6 +104,11 @@ namespace OpenMS
       }
     }
 
+    return compute(dot_product, b_ion_count, y_ion_count);
+  }
+
+  double HyperScore::compute(double dot_product, UInt b_ion_count, UInt y_ion_count)
+  {
     // discard very low scoring hits (basically no matching peaks)
     if (dot_product > 1e-1)
     {
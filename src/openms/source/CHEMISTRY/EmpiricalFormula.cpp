@@ -36,6 +36,7 @@
 #include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
 #include <OpenMS/CHEMISTRY/Element.h>
 #include <OpenMS/CHEMISTRY/ElementDB.h>
+#include <OpenMS/CHEMISTRY/IsotopePatternCache.h>
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
@@ -141,6 +142,12 @@ namespace OpenMS
   IsotopeDistribution EmpiricalFormula::getIsotopeDistribution(UInt max_depth) const
   {
     IsotopeDistribution result(max_depth);
+    IsotopePatternCache* cache = IsotopePatternCache::getInstance();
+    if (cache->lookup(*this, max_depth, result))
+    {
+      return result;
+    }
+
     MapType_::const_iterator it = formula_.begin();
     for (; it != formula_.end(); ++it)
     {
@@ -149,6 +156,7 @@ namespace OpenMS
       result += tmp * it->second;
     }
     result.renormalize();
+    cache->insert(*this, max_depth, result);
     return result;
   }
 
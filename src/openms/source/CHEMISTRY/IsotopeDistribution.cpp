@@ -37,9 +37,11 @@
 #include <cstdlib>
 #include <algorithm>
 #include <limits>
+#include <complex>
 
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
 #include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/MATH/MISC/FFT.h>
 
 using namespace std;
 
@@ -265,13 +267,27 @@ namespace OpenMS
 
   void IsotopeDistribution::convolvePow_(ContainerType & result, const ContainerType & input, Size n) const
   {
-    // TODO: Maybe use FFT convolve
     if (n == 1)
     {
       result = input;
       return;
     }
 
+    if (input.empty())
+    {
+      result.clear();
+      return;
+    }
+
+    ContainerType input_l = fillGaps_(input);
+
+    // for long results (large n and no or a high max isotope) the FFT is faster
+    if (n > 1 && useFFTConvolvePow_(input_l.size(), n))
+    {
+      convolvePowFFT_(result, input_l, n);
+      return;
+    }
+
     Size log2n = 0;
     // modification by Chris to prevent infinite loop when n > 2^63
     if (n > (Size(1) << (std::numeric_limits<Size>::digits - 1)))
@@ -286,8 +302,6 @@ namespace OpenMS
       }
     }
 
-    ContainerType input_l = fillGaps_(input);
-
     // get started
     if (n & 1)
     {
@@ -322,6 +336,66 @@ namespace OpenMS
     }
   }
 
+  bool IsotopeDistribution::useFFTConvolvePow_(Size input_size, Size n) const
+  {
+    // size of the full (untruncated) result, which the FFT has to compute
+    // to avoid wrap-around; guard against overflow for huge n
+    if (input_size < 2 || n > (Size(1) << 30) / (input_size - 1))
+    {
+      return false;
+    }
+    const double full_size = double((input_size - 1) * n + 1);
+    // short distributions are not worth the overhead
+    if (full_size < 64.0)
+    {
+      return false;
+    }
+    const double fft_size = double(Math::FFT::nextPowerOfTwo((Size)full_size));
+
+    // size of the (possibly truncated) result the direct method computes in
+    // each of its ~2 log2(n) convolutions
+    double direct_size = full_size;
+    if (max_isotope_ != 0 && double(max_isotope_ + 1) < direct_size)
+    {
+      direct_size = double(max_isotope_ + 1);
+    }
+
+    const double direct_cost = 2.0 * std::log(double(n)) / std::log(2.0) * direct_size * direct_size;
+    const double fft_cost = 8.0 * fft_size * std::log(fft_size) / std::log(2.0);
+    return fft_cost < direct_cost;
+  }
+
+  void IsotopeDistribution::convolvePowFFT_(ContainerType & result, const ContainerType & input, Size n) const
+  {
+    // the n-th convolution power is the inverse transform of the n-th power of the transform
+    const Size full_size = (input.size() - 1) * n + 1;
+    vector<complex<double> > data(Math::FFT::nextPowerOfTwo(full_size));
+    for (Size i = 0; i < input.size(); ++i)
+    {
+      data[i] = input[i].second;
+    }
+    Math::FFT::transform(data);
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      data[i] = pow(data[i], double(n));
+    }
+    Math::FFT::transform(data, true);
+
+    Size result_size = full_size;
+    if (max_isotope_ != 0 && result_size > max_isotope_)
+    {
+      result_size = max_isotope_;
+    }
+    result.resize(result_size);
+    for (Size i = 0; i < result_size; ++i)
+    {
+      // the transform has an absolute error of about 1e-15 (instead of exact
+      // tiny probabilities at the far end), which can also lead to tiny
+      // negative values
+      result[i] = make_pair(n * input[0].first + i, std::max(0.0, data[i].real()));
+    }
+  }
+
   void IsotopeDistribution::convolveSquare_(ContainerType & result, const ContainerType & input) const
   {
     result.clear();
@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/IsotopePatternCache.h>
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /// reads a value written by other threads (atomic with OpenMP 3.1)
+    template <typename T>
+    inline T atomicRead(const T volatile& src)
+    {
+      T value;
+#if defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp atomic read
+      value = src;
+#else
+      value = src;
+#endif
+      return value;
+    }
+
+    /// writes a value read by other threads (atomic with OpenMP 3.1)
+    template <typename T>
+    inline void atomicWrite(T volatile& dest, T value)
+    {
+#if defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp atomic write
+      dest = value;
+#else
+      dest = value;
+#endif
+    }
+  }
+
+  IsotopePatternCache::IsotopePatternCache() :
+    generation_(0),
+    max_size_(100000)
+  {
+  }
+
+  IsotopePatternCache::~IsotopePatternCache()
+  {
+  }
+
+  IsotopePatternCache* IsotopePatternCache::getInstance()
+  {
+    static IsotopePatternCache instance;
+    return &instance;
+  }
+
+  namespace
+  {
+    // creates the instance during static initialization, i.e. before any
+    // threads are started (local statics are not thread-safe in C++03)
+    IsotopePatternCache* const instance_at_startup = IsotopePatternCache::getInstance();
+  }
+
+  IsotopePatternCache::LocalCache_& IsotopePatternCache::getLocalCache_() const
+  {
+    // one cache per thread (lives as long as the thread), so no locking is needed
+    static LocalCache_* local_cache = 0;
+#ifdef _OPENMP
+#pragma omp threadprivate(local_cache)
+#endif
+    if (local_cache == 0)
+    {
+      local_cache = new LocalCache_;
+      local_cache->generation = atomicRead(generation_);
+    }
+
+    // empty the cache if clear() or setMaxSize() was called in the meantime
+    const UInt generation = atomicRead(generation_);
+    if (local_cache->generation != generation)
+    {
+      local_cache->distributions.clear();
+      local_cache->generation = generation;
+    }
+    return *local_cache;
+  }
+
+  void IsotopePatternCache::makeKey_(const EmpiricalFormula& formula, UInt max_depth, Key_& key)
+  {
+    key.first = max_depth;
+    key.second.clear();
+    for (EmpiricalFormula::ConstIterator it = formula.begin(); it != formula.end(); ++it)
+    {
+      if (it->second != 0)
+      {
+        key.second.push_back(*it);
+      }
+    }
+  }
+
+  bool IsotopePatternCache::lookup(const EmpiricalFormula& formula, UInt max_depth, IsotopeDistribution& result) const
+  {
+    LocalCache_& cache = getLocalCache_();
+    if (cache.distributions.empty())
+    {
+      return false;
+    }
+    makeKey_(formula, max_depth, cache.key);
+    boost::unordered_map<Key_, IsotopeDistribution::ContainerType>::const_iterator it = cache.distributions.find(cache.key);
+    if (it == cache.distributions.end())
+    {
+      return false;
+    }
+    result.set(it->second);
+    result.setMaxIsotope(max_depth);
+    return true;
+  }
+
+  void IsotopePatternCache::insert(const EmpiricalFormula& formula, UInt max_depth, const IsotopeDistribution& distribution)
+  {
+    const Size max_size = atomicRead(max_size_);
+    if (max_size == 0)
+    {
+      return;
+    }
+    LocalCache_& cache = getLocalCache_();
+    if (cache.distributions.size() >= max_size)
+    {
+      cache.distributions.clear();
+    }
+    makeKey_(formula, max_depth, cache.key);
+    cache.distributions[cache.key] = distribution.getContainer();
+  }
+
+  Size IsotopePatternCache::size() const
+  {
+    return getLocalCache_().distributions.size();
+  }
+
+  void IsotopePatternCache::clear()
+  {
+#ifdef _OPENMP
+#pragma omp critical (IsotopePatternCache_update)
+#endif
+    atomicWrite(generation_, generation_ + 1);
+  }
+
+  void IsotopePatternCache::setMaxSize(Size max_size)
+  {
+#ifdef _OPENMP
+#pragma omp critical (IsotopePatternCache_update)
+#endif
+    {
+      atomicWrite(max_size_, max_size);
+      atomicWrite(generation_, generation_ + 1);
+    }
+  }
+
+  Size IsotopePatternCache::getMaxSize() const
+  {
+    return atomicRead(max_size_);
+  }
+
+}
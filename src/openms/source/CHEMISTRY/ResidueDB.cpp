@@ -51,7 +51,8 @@ using namespace std;
 
 namespace OpenMS
 {
-  ResidueDB::ResidueDB()
+  ResidueDB::ResidueDB() :
+    frozen_(false)
   {
     readResiduesFromFile_("CHEMISTRY/Residues.xml");
     buildResidueNames_();
@@ -98,6 +99,8 @@ namespace OpenMS
 
   void ResidueDB::setResidues(const String& file_name)
   {
+    frozen_ = false;
+    frozen_mod_names_.clear();
     clearResidues_();
     readResiduesFromFile_(file_name);
     buildResidueNames_();
@@ -460,6 +463,19 @@ namespace OpenMS
     // search if the mod already exists
     String res_name = residue->getName();
 
+    if (frozen_)
+    {
+      boost::unordered_map<String, boost::unordered_map<String, const Residue*> >::const_iterator res_it = frozen_mod_names_.find(res_name);
+      if (res_it != frozen_mod_names_.end())
+      {
+        boost::unordered_map<String, const Residue*>::const_iterator mod_it = res_it->second.find(modification);
+        if (mod_it != res_it->second.end())
+        {
+          return mod_it->second;
+        }
+      }
+    }
+
     if (residue_names_.find(res_name) == residue_names_.end())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
@@ -468,14 +484,59 @@ namespace OpenMS
 
     // terminal mods. don't apply to residue (side chain), so don't consider them:
     const ResidueModification& mod = ModificationsDB::getInstance()->getModification(modification, residue->getOneLetterCode(), ResidueModification::ANYWHERE);
-    String id = mod.getId();
 
-    if (residue_mod_names_.has(res_name) && residue_mod_names_[res_name].has(id))
+    const Residue* res = findModifiedResidue_(res_name, mod.getId());
+    if (res != 0)
     {
-      return residue_mod_names_[res_name][id];
+      return res;
+    }
+
+    if (frozen_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                                       String("Residue " + res_name + " with modification " + mod.getFullId() + " is not part of the frozen residue DB!").c_str());
+    }
+
+    return createModifiedResidue_(residue_names_.find(res_name)->second, mod);
+  }
+
+  const Residue* ResidueDB::findModifiedResidue_(const String& res_name, const String& mod_id) const
+  {
+    Map<String, Map<String, Residue*> >::ConstIterator res_it = residue_mod_names_.find(res_name);
+    if (res_it != residue_mod_names_.end())
+    {
+      Map<String, Residue*>::ConstIterator mod_it = res_it->second.find(mod_id);
+      if (mod_it != res_it->second.end())
+      {
+        return mod_it->second;
+      }
+    }
+    return 0;
+  }
+
+  const Residue* ResidueDB::createModifiedResidue_(const Residue* residue, const ResidueModification& mod)
+  {
+    // modifications are always applied to the unmodified residue (a modified
+    // one would add the difference formula twice)
+    if (residue->isModified())
+    {
+      const String& code = residue->getOneLetterCode();
+      const Residue* unmodified = code.empty() ? 0 : getResidue((unsigned char)code[0]);
+      if (unmodified == 0 || unmodified->isModified())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                                         String("No unmodified residue found for " + residue->getName() + " to apply modification " + mod.getFullId() + " to!").c_str());
+      }
+      residue = unmodified;
     }
 
-    Residue* res = new Residue(*residue_names_[res_name]);
+    const Residue* existing = findModifiedResidue_(residue->getName(), mod.getId());
+    if (existing != 0)
+    {
+      return existing;
+    }
+
+    Residue* res = new Residue(*residue);
     res->setModification_(mod);
     //res->setLossFormulas(vector<EmpiricalFormula>());
     //res->setLossNames(vector<String>());
@@ -485,4 +546,79 @@ namespace OpenMS
     return res;
   }
 
+  void ResidueDB::freeze()
+  {
+    frozen_ = false;
+    frozen_mod_names_.clear();
+
+    ModificationsDB* mod_db = ModificationsDB::getInstance();
+    // unmodified residues are modified by side chain modifications with
+    // matching origin or unspecific origin (cf. ModificationsDB::searchModifications)
+    vector<Residue*> base_residues;
+    for (set<Residue*>::const_iterator it = residues_.begin(); it != residues_.end(); ++it)
+    {
+      if (!(*it)->isModified())
+      {
+        base_residues.push_back(*it);
+      }
+    }
+    for (Size mod_index = 0; mod_index < mod_db->getNumberOfModifications(); ++mod_index)
+    {
+      const ResidueModification& mod = mod_db->getModification(mod_index);
+      if (mod.getTermSpecificity() != ResidueModification::ANYWHERE)
+      {
+        continue;
+      }
+      const String& origin = mod.getOrigin();
+      bool unspecific = origin.empty() || origin == "X" || origin == "." || origin == "N-term" || origin == "C-term";
+
+      for (vector<Residue*>::const_iterator it = base_residues.begin(); it != base_residues.end(); ++it)
+      {
+        const String& code = (*it)->getOneLetterCode();
+        if (code.empty() || (!unspecific && code != origin))
+        {
+          continue;
+        }
+        createModifiedResidue_(*it, mod);
+
+        // index the names used most commonly in queries, resolved exactly as
+        // getModifiedResidue() resolves them
+        vector<String> names;
+        names.push_back(mod.getFullId());
+        names.push_back(mod.getId());
+        names.push_back(mod.getFullName());
+        names.push_back(mod.getUniModAccession());
+        names.push_back(mod.getPSIMODAccession());
+        boost::unordered_map<String, const Residue*>& frozen_names = frozen_mod_names_[(*it)->getName()];
+        for (vector<String>::const_iterator name_it = names.begin(); name_it != names.end(); ++name_it)
+        {
+          if (name_it->empty() || frozen_names.find(*name_it) != frozen_names.end())
+          {
+            continue;
+          }
+          set<const ResidueModification*> mods;
+          try
+          {
+            mod_db->searchModifications(mods, *name_it, code, ResidueModification::ANYWHERE);
+          }
+          catch (Exception::ElementNotFound&)
+          {
+            continue;
+          }
+          if (!mods.empty())
+          {
+            frozen_names[*name_it] = createModifiedResidue_(*it, **mods.begin());
+          }
+        }
+      }
+    }
+
+    frozen_ = true;
+  }
+
+  bool ResidueDB::isFrozen() const
+  {
+    return frozen_;
+  }
+
 }
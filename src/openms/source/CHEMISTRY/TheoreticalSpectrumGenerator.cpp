@@ -42,6 +42,8 @@
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 
+#include <algorithm>
+
 using namespace std;
 
 namespace OpenMS
@@ -110,6 +112,7 @@ namespace OpenMS
   TheoreticalSpectrumGenerator::TheoreticalSpectrumGenerator(const TheoreticalSpectrumGenerator & rhs) :
     DefaultParamHandler(rhs)
   {
+    updateMembers_();
   }
 
   TheoreticalSpectrumGenerator & TheoreticalSpectrumGenerator::operator=(const TheoreticalSpectrumGenerator & rhs)
@@ -117,6 +120,7 @@ namespace OpenMS
     if (this != &rhs)
     {
       DefaultParamHandler::operator=(rhs);
+      updateMembers_();
     }
     return *this;
   }
@@ -157,6 +161,170 @@ namespace OpenMS
     return;
   }
 
+  namespace
+  {
+    /// ladder of fragment ions of one type (prefix or suffix ions with a constant mass offset)
+    struct IonLadder_
+    {
+      char letter;
+      bool prefix;
+      /// mass of the ion (without residues and protons) relative to the sum of its internal residue masses
+      double offset;
+    };
+
+    /**
+      Merges the sorted @p run (of ion type @p run_type) into the sorted
+      first @p size elements of @p mzs (and @p ion_types, if given), which
+      must have room for @p run_size more elements and must not overlap with
+      @p run. Merging from the back needs no additional memory.
+    */
+    void mergeIonRun_(double* mzs, char* ion_types, Size size, const double* run, Size run_size, char run_type)
+    {
+      Size i = size, j = run_size, k = size + run_size;
+      while (j > 0)
+      {
+        --k;
+        if (i > 0 && mzs[i - 1] > run[j - 1])
+        {
+          --i;
+          mzs[k] = mzs[i];
+          if (ion_types != 0) ion_types[k] = ion_types[i];
+        }
+        else
+        {
+          --j;
+          mzs[k] = run[j];
+          if (ion_types != 0) ion_types[k] = run_type;
+        }
+      }
+    }
+  }
+
+  void TheoreticalSpectrumGenerator::getFragmentMZs(std::vector<double> & mzs, const AASequence & peptide, Int charge) const
+  {
+    getFragmentMZs_(mzs, 0, peptide, charge);
+  }
+
+  void TheoreticalSpectrumGenerator::getFragmentMZs(std::vector<double> & mzs, std::vector<char> & ion_types, const AASequence & peptide, Int charge) const
+  {
+    getFragmentMZs_(mzs, &ion_types, peptide, charge);
+  }
+
+  double TheoreticalSpectrumGenerator::getIonIntensity(char ion_letter) const
+  {
+    switch (ion_letter)
+    {
+      case 'a': return a_intensity_;
+      case 'b': return b_intensity_;
+      case 'c': return c_intensity_;
+      case 'x': return x_intensity_;
+      case 'y': return y_intensity_;
+      case 'z': return z_intensity_;
+      default:
+        throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unknown ion type", String(ion_letter));
+    }
+  }
+
+  void TheoreticalSpectrumGenerator::getFragmentMZs_(std::vector<double> & mzs, std::vector<char> * ion_types, const AASequence & peptide, Int charge) const
+  {
+    mzs.clear();
+    if (ion_types != 0) ion_types->clear();
+
+    const Size n = peptide.size();
+    if (n < 2 || charge < 1)
+    {
+      return;
+    }
+
+    static const EmpiricalFormula h2o("H2O");
+    static const EmpiricalFormula nh3("NH3");
+    const double internal_to_full = Residue::getInternalToFull().getMonoWeight();
+    const double n_term_mod = peptide.hasNTerminalModification() ? peptide.getNTerminalModification()->getDiffMonoMass() : 0.0;
+    const double c_term_mod = peptide.hasCTerminalModification() ? peptide.getCTerminalModification()->getDiffMonoMass() : 0.0;
+
+    IonLadder_ ladders[6];
+    Size nr_ladders = 0;
+    if (add_a_ions_) { IonLadder_ l = {'a', true, n_term_mod + Residue::getInternalToAIon().getMonoWeight()}; ladders[nr_ladders++] = l; }
+    if (add_b_ions_) { IonLadder_ l = {'b', true, n_term_mod + Residue::getInternalToBIon().getMonoWeight()}; ladders[nr_ladders++] = l; }
+    if (add_c_ions_) { IonLadder_ l = {'c', true, n_term_mod + Residue::getInternalToCIon().getMonoWeight()}; ladders[nr_ladders++] = l; }
+    if (add_x_ions_) { IonLadder_ l = {'x', false, c_term_mod + Residue::getInternalToXIon().getMonoWeight()}; ladders[nr_ladders++] = l; }
+    if (add_y_ions_) { IonLadder_ l = {'y', false, c_term_mod + Residue::getInternalToYIon().getMonoWeight()}; ladders[nr_ladders++] = l; }
+    if (add_z_ions_) { IonLadder_ l = {'z', false, c_term_mod + Residue::getInternalToZIon().getMonoWeight()}; ladders[nr_ladders++] = l; }
+
+    // losses: (mass, shortest prefix ion, shortest suffix ion) - an ion can
+    // lose water (ammonia) if one of its residues can; no loss comes first
+    double loss_mass[3] = {0.0, h2o.getMonoWeight(), nh3.getMonoWeight()};
+    Size first_prefix[3], first_suffix[3];
+    first_prefix[0] = add_first_prefix_ion_ ? 1 : 2;
+    first_suffix[0] = 1;
+    const Size nr_losses = add_losses_ ? 3 : 1;
+    for (Size l = 1; l < nr_losses; ++l)
+    {
+      first_prefix[l] = n;
+      first_suffix[l] = n;
+    }
+
+    // sizes of the ion runs: prefix and suffix ions of lengths [first, n - 1]
+    Size total = 0;
+    for (Size l = 0; l < nr_losses; ++l)
+    {
+      if (l > 0)
+      {
+        const EmpiricalFormula& loss = (l == 1 ? h2o : nh3);
+        for (Size i = 0; i < n; ++i)
+        {
+          const vector<EmpiricalFormula>& residue_losses = peptide[i].getLossFormulas();
+          if (std::find(residue_losses.begin(), residue_losses.end(), loss) != residue_losses.end())
+          {
+            first_prefix[l] = std::min(first_prefix[l], std::max(first_prefix[0], i + 1));
+            first_suffix[l] = std::min(first_suffix[l], n - i);
+          }
+        }
+      }
+      for (Size t = 0; t < nr_ladders; ++t)
+      {
+        total += n - (ladders[t].prefix ? first_prefix[l] : first_suffix[l]);
+      }
+    }
+    total *= charge;
+
+    // memory layout: merged ions (total) | current run (n - 1) | prefix sums of the residue masses (n + 1)
+    mzs.resize(total + (n - 1) + (n + 1));
+    if (ion_types != 0) ion_types->resize(total);
+    double* run = &mzs[total];
+    double* prefix_mass = run + (n - 1);
+    prefix_mass[0] = 0.0;
+    for (Size i = 0; i < n; ++i)
+    {
+      prefix_mass[i + 1] = prefix_mass[i] + peptide[i].getMonoWeight(Residue::Full) - internal_to_full;
+    }
+    const double peptide_mass = prefix_mass[n];
+
+    char* types = (ion_types != 0 && total > 0) ? &(*ion_types)[0] : 0;
+    Size size = 0;
+    for (Int z = 1; z <= charge; ++z)
+    {
+      for (Size t = 0; t < nr_ladders; ++t)
+      {
+        for (Size l = 0; l < nr_losses; ++l)
+        {
+          const double offset = ladders[t].offset - loss_mass[l] + z * Constants::PROTON_MASS_U;
+          const Size first = ladders[t].prefix ? first_prefix[l] : first_suffix[l];
+          Size run_size = 0;
+          for (Size length = first; length < n; ++length)
+          {
+            const double residues = ladders[t].prefix ? prefix_mass[length] : peptide_mass - prefix_mass[n - length];
+            run[run_size++] = (residues + offset) / z;
+          }
+          mergeIonRun_(&mzs[0], types, size, run, run_size, ladders[t].letter);
+          size += run_size;
+        }
+      }
+    }
+
+    mzs.resize(total);
+  }
+
   void TheoreticalSpectrumGenerator::addAbundantImmoniumIons(RichPeakSpectrum & spec, const AASequence& peptide) const
   {
     RichPeak1D p;
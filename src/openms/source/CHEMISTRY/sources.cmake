@@ -12,6 +12,7 @@ EnzymaticDigestion.cpp
 Enzyme.cpp
 EnzymesDB.cpp
 IsotopeDistribution.cpp
+IsotopePatternCache.cpp
 ModificationDefinition.cpp
 ModificationDefinitionsSet.cpp
 ModificationsDB.cpp
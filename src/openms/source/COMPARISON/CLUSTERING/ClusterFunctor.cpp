@@ -39,6 +39,9 @@
 #include <OpenMS/COMPARISON/CLUSTERING/AverageLinkage.h>
 #include <OpenMS/CONCEPT/Factory.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace std;
 
 namespace OpenMS
@@ -67,6 +70,109 @@ namespace OpenMS
     Factory<ClusterFunctor>::registerProduct(AverageLinkage::getProductName(), &AverageLinkage::create);
   }
 
+  void ClusterFunctor::nearestNeighborChain_(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold, LinkageUpdate update, const ProgressLogger & progress_logger)
+  {
+    const Size n = original_distance.dimensionsize();
+
+    cluster_tree.clear();
+    cluster_tree.reserve(n - 1);
+
+    // each cluster is stored at the index of its smallest element, which is
+    // therefore also the index used for the cluster in the resulting tree
+    std::vector<bool> active(n, true);
+    std::vector<Size> cluster_size(n, 1);
+    std::vector<Size> chain;
+    chain.reserve(n);
+    Size first_active(0);
+
+    progress_logger.startProgress(0, n, "clustering data");
+
+    for (Size remaining = n; remaining > 1; )
+    {
+      if (chain.empty())
+      {
+        while (!active[first_active])
+        {
+          ++first_active;
+        }
+        chain.push_back(first_active);
+      }
+
+      // nearest neighbor of the cluster at the tip of the chain; ties are
+      // resolved in favor of the previous chain element (to guarantee
+      // termination), then in favor of the smallest index
+      const Size a = chain.back();
+      Size b = n;
+      float d_ab = std::numeric_limits<float>::max();
+      if (chain.size() > 1)
+      {
+        b = chain[chain.size() - 2];
+        d_ab = original_distance.getValue(a, b);
+      }
+      for (Size k = first_active; k < n; ++k)
+      {
+        if (k != a && active[k])
+        {
+          float d_ak = original_distance.getValue(a, k);
+          if (d_ak < d_ab || b == n)
+          {
+            b = k;
+            d_ab = d_ak;
+          }
+        }
+      }
+
+      if (chain.size() < 2 || b != chain[chain.size() - 2])
+      {
+        chain.push_back(b);
+        continue;
+      }
+
+      // a and b are reciprocal nearest neighbors: merge them
+      chain.pop_back();
+      chain.pop_back();
+      Size left = std::min(a, b), right = std::max(a, b);
+      cluster_tree.push_back(BinaryTreeNode(left, right, d_ab));
+      for (Size k = first_active; k < n; ++k)
+      {
+        if (k != left && k != right && active[k])
+        {
+          original_distance.setValueQuick(left, k, update(original_distance.getValue(left, k), original_distance.getValue(right, k), cluster_size[left], cluster_size[right]));
+        }
+      }
+      cluster_size[left] += cluster_size[right];
+      active[right] = false;
+      --remaining;
+      progress_logger.setProgress(n - remaining);
+    }
+
+    // bring the steps into the order of the naive algorithm (a merger is
+    // always found after the mergers it depends on, so ties keep this order)
+    std::stable_sort(cluster_tree.begin(), cluster_tree.end(), compareBinaryTreeNode);
+
+    // discard steps at or above the threshold and fill the tree with dummy nodes
+    Size steps(0);
+    while (steps < cluster_tree.size() && cluster_tree[steps].distance < threshold)
+    {
+      ++steps;
+    }
+    cluster_tree.resize(steps, BinaryTreeNode(0, 0, -1.0));
+    std::fill(active.begin(), active.end(), true);
+    for (Size i = 0; i < steps; ++i)
+    {
+      active[cluster_tree[i].right_child] = false;
+    }
+    for (Size i = 1; i < n; ++i)
+    {
+      if (active[i])
+      {
+        cluster_tree.push_back(BinaryTreeNode(0, i, -1.0));
+      }
+    }
+
+    progress_logger.endProgress();
+  }
+
   ClusterFunctor::InsufficientInput::InsufficientInput(const char * file, int line, const char * function, const char * message) throw() :
     BaseException(file, line, function, "ClusterFunctor::InsufficentInput", message)
   {
@@ -74,6 +74,16 @@ namespace OpenMS
     return *this;
   }
 
+  Size SingleLinkage::findRepresentative_(std::vector<Size> & parent, Size i)
+  {
+    while (parent[i] != i)
+    {
+      parent[i] = parent[parent[i]]; // path halving
+      i = parent[i];
+    }
+    return i;
+  }
+
   void SingleLinkage::operator()(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold /*=1*/) const
   {
     // input MUST have >= 2 elements!
@@ -150,54 +160,26 @@ namespace OpenMS
     }
 
     //sort pre-tree
-    std::sort(cluster_tree.begin(), cluster_tree.end(), compareBinaryTreeNode);
-
-    // convert -pre-tree to correct format
-    for (Size i = 0; i < cluster_tree.size(); ++i)
-    {
-      if (cluster_tree[i].right_child < cluster_tree[i].left_child)
-      {
-        std::swap(cluster_tree[i].left_child, cluster_tree[i].right_child);
-      }
-      for (Size k = i + 1; k < cluster_tree.size(); ++k)
-      {
-        if (cluster_tree[k].left_child == cluster_tree[i].right_child)
-        {
-          cluster_tree[k].left_child = cluster_tree[i].left_child;
-        }
-        else if (cluster_tree[k].left_child > cluster_tree[i].right_child)
-        {
-          --cluster_tree[k].left_child;
-        }
-        if (cluster_tree[k].right_child == cluster_tree[i].right_child)
-        {
-          cluster_tree[k].right_child = cluster_tree[i].left_child;
-        }
-        else if (cluster_tree[k].right_child > cluster_tree[i].right_child)
-        {
-          --cluster_tree[k].right_child;
-        }
-      }
+    std::stable_sort(cluster_tree.begin(), cluster_tree.end(), compareBinaryTreeNode);
 
-    }
-    //~ prepare to redo clustering to get all indices for binarytree in min index element representation
-    std::vector<std::set<Size> > clusters(original_distance.dimensionsize());
-    for (Size i = 0; i < original_distance.dimensionsize(); ++i)
+    // convert pre-tree to correct format, i.e. each cluster is represented by
+    // its smallest element (tracked by union-find, the root of each set is its smallest element)
+    std::vector<Size> parent(original_distance.dimensionsize());
+    for (Size i = 0; i < parent.size(); ++i)
     {
-      clusters[i].insert(i);
+      parent[i] = i;
     }
     for (Size cluster_step = 0; cluster_step < cluster_tree.size(); ++cluster_step)
     {
-      Size new_left_child = *(clusters[cluster_tree[cluster_step].left_child].begin());
-      Size new_right_child = *(clusters[cluster_tree[cluster_step].right_child].begin());
-      clusters[cluster_tree[cluster_step].left_child].insert(clusters[cluster_tree[cluster_step].right_child].begin(), clusters[cluster_tree[cluster_step].right_child].end());
-      clusters.erase(clusters.begin() + cluster_tree[cluster_step].right_child);
-      std::swap(cluster_tree[cluster_step].left_child, new_left_child);
-      std::swap(cluster_tree[cluster_step].right_child, new_right_child);
-      if (cluster_tree[cluster_step].left_child > cluster_tree[cluster_step].right_child)
+      Size left = findRepresentative_(parent, cluster_tree[cluster_step].left_child);
+      Size right = findRepresentative_(parent, cluster_tree[cluster_step].right_child);
+      if (left > right)
       {
-        std::swap(cluster_tree[cluster_step].left_child, cluster_tree[cluster_step].right_child);
+        std::swap(left, right);
       }
+      parent[right] = left;
+      cluster_tree[cluster_step].left_child = left;
+      cluster_tree[cluster_step].right_child = right;
     }
 
     endProgress();
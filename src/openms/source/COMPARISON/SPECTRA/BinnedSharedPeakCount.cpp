@@ -101,16 +101,10 @@ namespace OpenMS
     }
 
     double score(0), sum(0);
-    UInt denominator(max(spec1.getFilledBinNumber(), spec2.getFilledBinNumber())), shared_Bins(min(spec1.getBinNumber(), spec2.getBinNumber()));
+    UInt denominator(max(spec1.getFilledBinNumber(), spec2.getFilledBinNumber()));
 
     // all bins at equal position that have both intensity > 0 contribute positively to score
-    for (Size i = 0; i < shared_Bins; ++i)
-    {
-      if (spec1.getBins()[i] > 0 && spec2.getBins()[i] > 0)
-      {
-        sum++;
-      }
-    }
+    sum = BinnedSpectrum::computeBinStatistics(spec1, spec2).shared_bins;
 
     // resulting score normalized to interval [0,1]
     score = sum / denominator;
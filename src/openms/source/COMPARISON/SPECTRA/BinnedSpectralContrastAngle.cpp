@@ -99,18 +99,13 @@ namespace OpenMS
       return 0;
     }
 
-    double score(0), numerator(0), sharedBins(min(spec1.getBinNumber(), spec2.getBinNumber())), sum1(0), sum2(0);
+    double score(0);
 
     // all bins at equal position that have both intensity > 0 contribute positively to score
-    for (Size i = 0; i < sharedBins; ++i)
-    {
-      sum1 += spec1.getBins()[i] * spec1.getBins()[i];
-      sum2 += spec2.getBins()[i] * spec2.getBins()[i];
-      numerator += (spec1.getBins()[i] * spec2.getBins()[i]);
-    }
+    BinnedSpectrum::BinStatistics stats = BinnedSpectrum::computeBinStatistics(spec1, spec2);
 
     // resulting score standardized to interval [0,1]
-    score = numerator / (sqrt(sum1 * sum2));
+    score = stats.dot_product / (sqrt(stats.squared_sum1 * stats.squared_sum2));
 
     return score;
 
@@ -34,25 +34,39 @@
 //
 
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
+#include <OpenMS/KERNEL/ComparatorUtils.h>
 
+#include <algorithm>
+
+// the dense kernel is vectorized by the compiler given the OpenMP 4.0 'simd'
+// directive (floating point reductions are not reordered otherwise)
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define OPENMS_BINNEDSPECTRUM_OMP_SIMD
+#endif
 
 using namespace std;
 
 namespace OpenMS
 {
+  BinnedSpectrum::BinStatistics::BinStatistics() :
+    sum1(0), sum2(0), squared_sum1(0), squared_sum2(0), dot_product(0), squared_dot_product(0), positive_dot_product(0), positive_squared_dot_product(0), agreeing_sum(0), shared_bins(0)
+  {
+  }
+
   BinnedSpectrum::BinnedSpectrum() :
-    bin_spread_(1), bin_size_(2.0), bins_(), raw_spec_()
+    bin_spread_(1), bin_size_(2.0), bins_(), raw_spec_(), filled_bins_(), filled_intensities_(), dense_bins_(), flat_bins_valid_(true)
   {
   }
 
   BinnedSpectrum::BinnedSpectrum(float size, UInt spread, PeakSpectrum ps) :
-    bin_spread_(spread), bin_size_(size), bins_(), raw_spec_(ps)
+    bin_spread_(spread), bin_size_(size), bins_(), raw_spec_(ps), filled_bins_(), filled_intensities_(), dense_bins_(), flat_bins_valid_(true)
   {
     setBinning();
   }
 
   BinnedSpectrum::BinnedSpectrum(const BinnedSpectrum& source) :
-    bin_spread_(source.getBinSpread()), bin_size_(source.getBinSize()), bins_(source.getBins()), raw_spec_(source.raw_spec_)
+    bin_spread_(source.bin_spread_), bin_size_(source.bin_size_), bins_(source.bins_), raw_spec_(source.raw_spec_),
+    filled_bins_(source.filled_bins_), filled_intensities_(source.filled_intensities_), dense_bins_(source.dense_bins_), flat_bins_valid_(source.flat_bins_valid_)
   {
   }
 
@@ -73,9 +87,11 @@ namespace OpenMS
 
     //make all necessary bins accessible
     raw_spec_.sortByPosition();
-    bins_ = SparseVector<float>((UInt)ceil(raw_spec_.back().getMZ() / bin_size_) + bin_spread_, 0, 0);
+    UInt bin_number_total = (UInt)ceil(raw_spec_.back().getMZ() / bin_size_) + bin_spread_;
 
-    //put all peaks into bins
+    //collect the contribution of each peak to its bin and the neighboring binspread many
+    std::vector<std::pair<UInt, float> > contributions;
+    contributions.reserve(raw_spec_.size() * (2 * bin_spread_ + 1));
     UInt bin_number;
     for (Size i = 0; i < raw_spec_.size(); ++i)
     {
@@ -88,22 +104,205 @@ namespace OpenMS
         --bin_number;
       }
 
-      //add peak to corresponding bin
-      bins_[bin_number] = bins_.at(bin_number) + raw_spec_[i].getIntensity();
+      float intensity = raw_spec_[i].getIntensity();
+      // we are not in one of the first bins (0 to bin_spread)
+      UInt first_bin = bin_number >= bin_spread_ ? bin_number - bin_spread_ : 0;
+      for (UInt b = first_bin; b <= bin_number + bin_spread_; ++b)
+      {
+        contributions.push_back(std::make_pair(b, intensity));
+      }
+    }
+
+    //sum up the contributions per bin (in the order of the peaks)
+    std::stable_sort(contributions.begin(), contributions.end(), PairComparatorFirstElement<std::pair<UInt, float> >());
+    filled_bins_.clear();
+    filled_intensities_.clear();
+    for (Size i = 0; i < contributions.size(); )
+    {
+      UInt bin = contributions[i].first;
+      float sum = 0;
+      for ( ; i < contributions.size() && contributions[i].first == bin; ++i)
+      {
+        sum += contributions[i].second;
+      }
+      if (sum != 0)
+      {
+        filled_bins_.push_back(bin);
+        filled_intensities_.push_back(sum);
+      }
+    }
+
+    bins_ = SparseVector<float>(bin_number_total, 0, 0);
+    for (Size i = 0; i < filled_bins_.size(); ++i)
+    {
+      bins_[filled_bins_[i]] = filled_intensities_[i];
+    }
+
+    dense_bins_.clear();
+    if (4 * filled_bins_.size() >= bin_number_total)
+    {
+      dense_bins_.resize(bin_number_total, 0);
+      for (Size i = 0; i < filled_bins_.size(); ++i)
+      {
+        dense_bins_[filled_bins_[i]] = filled_intensities_[i];
+      }
+    }
+    flat_bins_valid_ = true;
+  }
+
+  void BinnedSpectrum::updateFlatBins()
+  {
+    buildFlatBins_();
+  }
 
-      //add peak to neighboring binspread many
-      for (Size j = 0; j < bin_spread_; ++j)
+  void BinnedSpectrum::buildFlatBins_()
+  {
+    filled_bins_.clear();
+    filled_intensities_.clear();
+    dense_bins_.clear();
+    for (Size i = 0; i < bins_.size(); ++i)
+    {
+      float value = bins_.at(i);
+      if (value != 0)
+      {
+        filled_bins_.push_back((UInt)i);
+        filled_intensities_.push_back(value);
+      }
+    }
+    if (4 * filled_bins_.size() >= bins_.size() && !bins_.empty())
+    {
+      dense_bins_.resize(bins_.size(), 0);
+      for (Size i = 0; i < filled_bins_.size(); ++i)
       {
-        bins_[bin_number + j + 1] = bins_.at(bin_number + j + 1) + raw_spec_[i].getIntensity();
-        // we are not in one of the first bins (0 to bin_spread)
-        //not working:  if (bin_number-j-1 >= 0)
-        if (bin_number >= j + 1)
+        dense_bins_[filled_bins_[i]] = filled_intensities_[i];
+      }
+    }
+    flat_bins_valid_ = true;
+  }
+
+  void BinnedSpectrum::getFlatBins_(const BinnedSpectrum& spec, std::vector<UInt>& indices, std::vector<float>& intensities, const UInt*& index_begin, const float*& intensity_begin, Size& size)
+  {
+    const std::vector<UInt>* index_source = &spec.filled_bins_;
+    const std::vector<float>* intensity_source = &spec.filled_intensities_;
+    if (!spec.flat_bins_valid_)
+    {
+      // the flat arrays are outdated, use a temporary copy (the spectrum itself must not change here, it may be shared between threads)
+      indices.clear();
+      intensities.clear();
+      for (Size i = 0; i < spec.bins_.size(); ++i)
+      {
+        float value = spec.bins_.at(i);
+        if (value != 0)
         {
-          bins_[bin_number - j - 1] = bins_.at(bin_number - j - 1) + raw_spec_[i].getIntensity();
+          indices.push_back((UInt)i);
+          intensities.push_back(value);
         }
       }
+      index_source = &indices;
+      intensity_source = &intensities;
+    }
+    size = index_source->size();
+    index_begin = size ? &(*index_source)[0] : 0;
+    intensity_begin = size ? &(*intensity_source)[0] : 0;
+  }
+
+  BinnedSpectrum::BinStatistics BinnedSpectrum::computeBinStatistics(const BinnedSpectrum& spec1, const BinnedSpectrum& spec2)
+  {
+    BinStatistics stats;
+    const UInt shared_bin_number = min(spec1.getBinNumber(), spec2.getBinNumber());
+
+    if (spec1.flat_bins_valid_ && spec2.flat_bins_valid_ && !spec1.dense_bins_.empty() && !spec2.dense_bins_.empty())
+    {
+      // dense: branch-free loop over all shared bins
+      const float* a = &spec1.dense_bins_[0];
+      const float* b = &spec2.dense_bins_[0];
+      double sum1(0), sum2(0), squared_sum1(0), squared_sum2(0), dot_product(0), squared_dot_product(0), positive_dot_product(0), positive_squared_dot_product(0), agreeing_sum(0);
+      UInt shared_bins(0);
+#ifdef OPENMS_BINNEDSPECTRUM_OMP_SIMD
+#pragma omp simd reduction(+: sum1, sum2, squared_sum1, squared_sum2, dot_product, squared_dot_product, positive_dot_product, positive_squared_dot_product, agreeing_sum, shared_bins)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)shared_bin_number; ++i)
+      {
+        float product = a[i] * b[i];
+        bool shared = a[i] > 0 && b[i] > 0;
+        sum1 += a[i];
+        sum2 += b[i];
+        squared_sum1 += a[i] * a[i];
+        squared_sum2 += b[i] * b[i];
+        dot_product += product;
+        squared_dot_product += product * product;
+        positive_dot_product += shared ? product : 0.0f;
+        positive_squared_dot_product += shared ? product * product : 0.0f;
+        agreeing_sum += max(0.0f, (a[i] + b[i]) / 2 - std::fabs(a[i] - b[i]));
+        shared_bins += shared ? 1 : 0;
+      }
+      stats.sum1 = sum1;
+      stats.sum2 = sum2;
+      stats.squared_sum1 = squared_sum1;
+      stats.squared_sum2 = squared_sum2;
+      stats.dot_product = dot_product;
+      stats.squared_dot_product = squared_dot_product;
+      stats.positive_dot_product = positive_dot_product;
+      stats.positive_squared_dot_product = positive_squared_dot_product;
+      stats.agreeing_sum = agreeing_sum;
+      stats.shared_bins = shared_bins;
+      return stats;
     }
 
+    // sparse: merge the sorted filled bins
+    std::vector<UInt> tmp_indices1, tmp_indices2;
+    std::vector<float> tmp_intensities1, tmp_intensities2;
+    const UInt* index1;
+    const UInt* index2;
+    const float* intensity1;
+    const float* intensity2;
+    Size size1, size2;
+    getFlatBins_(spec1, tmp_indices1, tmp_intensities1, index1, intensity1, size1);
+    getFlatBins_(spec2, tmp_indices2, tmp_intensities2, index2, intensity2, size2);
+    // only bins below the shared bin number are considered
+    size1 = lower_bound(index1, index1 + size1, shared_bin_number) - index1;
+    size2 = lower_bound(index2, index2 + size2, shared_bin_number) - index2;
+
+    for (Size i = 0; i < size1; ++i)
+    {
+      stats.sum1 += intensity1[i];
+      stats.squared_sum1 += intensity1[i] * intensity1[i];
+    }
+    for (Size i = 0; i < size2; ++i)
+    {
+      stats.sum2 += intensity2[i];
+      stats.squared_sum2 += intensity2[i] * intensity2[i];
+    }
+
+    Size i1(0), i2(0);
+    while (i1 < size1 && i2 < size2)
+    {
+      if (index1[i1] < index2[i2])
+      {
+        ++i1;
+      }
+      else if (index2[i2] < index1[i1])
+      {
+        ++i2;
+      }
+      else
+      {
+        float a = intensity1[i1], b = intensity2[i2];
+        float product = a * b;
+        stats.dot_product += product;
+        stats.squared_dot_product += product * product;
+        stats.agreeing_sum += max(0.0f, (a + b) / 2 - std::fabs(a - b));
+        if (a > 0 && b > 0)
+        {
+          stats.positive_dot_product += product;
+          stats.positive_squared_dot_product += product * product;
+          ++stats.shared_bins;
+        }
+        ++i1;
+        ++i2;
+      }
+    }
+    return stats;
   }
 
   //yields false if given BinnedSpectrum size or spread differs from this one (comparing those might crash)
@@ -100,18 +100,13 @@ namespace OpenMS
       return 0;
     }
 
-    double score(0), sharedBins(min(spec1.getBinNumber(), spec2.getBinNumber())), sum1(0), sum2(0), summax(0);
+    double score(0);
 
     // all bins at equal position and similar intensities contribute positively to score
-    for (Size i = 0; i < sharedBins; ++i)
-    {
-      sum1 += spec1.getBins()[i];
-      sum2 += spec2.getBins()[i];
-      summax += max((float)0, ((spec1.getBins()[i] + spec2.getBins()[i]) / 2) - fabs(spec1.getBins()[i] - spec2.getBins()[i]));
-    }
+    BinnedSpectrum::BinStatistics stats = BinnedSpectrum::computeBinStatistics(spec1, spec2);
 
     // resulting score normalized to interval [0,1]
-    score = summax * (2 / (sum1 + sum2));
+    score = stats.agreeing_sum * (2 / (stats.sum1 + stats.sum2));
 
     return score;
 
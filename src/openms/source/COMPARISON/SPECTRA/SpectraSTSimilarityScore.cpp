@@ -106,15 +106,11 @@ namespace OpenMS
     {
       *iter2 = (float) * iter2 / magnitude2;
     }
+    bin1.updateFlatBins();
+    bin2.updateFlatBins();
 
-    Size shared_bins = min(bin1.getBinNumber(), bin2.getBinNumber());
-    for (Size s = 0; s < shared_bins; ++s)
-    {
-      if ((double)bin1.getBins()[s] > 0.0 && (double)bin2.getBins()[s] > 0.0)
-      {
-        score += ((double)bin1.getBins()[s] * (double)bin2.getBins()[s]);
-      }
-    }
+    // bins only contribute if they have a positive intensity in both spectra
+    score = BinnedSpectrum::computeBinStatistics(bin1, bin2).positive_dot_product;
 
     return score;
 
@@ -124,14 +120,8 @@ namespace OpenMS
   {
     double score(0);
 
-    Size shared_bins = min(bin1.getBinNumber(), bin2.getBinNumber());
-    for (Size s = 0; s < shared_bins; ++s)
-    {
-      if (bin1.getBins()[s] > 0 && bin2.getBins()[s] > 0)
-      {
-        score += (bin1.getBins()[s] * bin2.getBins()[s]);
-      }
-    }
+    // bins only contribute if they have a positive intensity in both spectra
+    score = BinnedSpectrum::computeBinStatistics(bin1, bin2).positive_dot_product;
 
     return score;
   }
@@ -182,6 +172,7 @@ namespace OpenMS
     {
       *iter = (float) * iter / magnitude;
     }
+    bin.updateFlatBins();
     return bin;
   }
 
@@ -189,14 +180,7 @@ namespace OpenMS
   {
     double numerator(0);
 
-    Size shared_bins = min(bin1.getBinNumber(), bin2.getBinNumber());
-    for (Size s = 0; s < shared_bins; ++s)
-    {
-      if (bin1.getBins()[s] > 0 && bin2.getBins()[s] > 0)
-      {
-        numerator += (pow(bin1.getBins()[s], 2) * pow(bin2.getBins()[s], 2));
-      }
-    }
+    numerator = BinnedSpectrum::computeBinStatistics(bin1, bin2).positive_squared_dot_product;
     numerator = sqrt(numerator);
 
     if (dot_product)
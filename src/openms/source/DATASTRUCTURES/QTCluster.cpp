@@ -41,8 +41,8 @@
 
 #include <vector>
 #include <set>
-#include <map> // for multimap<>
-#include <algorithm> // for min
+#include <map>
+#include <algorithm> // for min, stable_sort
 #include <numeric> // for make_pair
 
 using std::map;
@@ -64,7 +64,7 @@ namespace OpenMS
                        Int y_coord) :
     center_point_(center_point),
     neighbors_(),
-    tmp_neighbors_(NULL),
+    tmp_neighbors_(),
     max_distance_(max_distance),
     num_maps_(num_maps),
     quality_(0.0),
@@ -142,9 +142,6 @@ namespace OpenMS
     // ensure we only add compatible peptide annotations
     OPENMS_PRECONDITION(distance <= max_distance_,
         "Distance cannot be larger than max_distance")
-    // collect_annotations_ implies tmp_neighbors_ != NULL, 
-    OPENMS_PRECONDITION(!collect_annotations_ || tmp_neighbors_ != NULL, 
-        "Initialize the cluster first before adding elements")
 
     Size map_index = element->getMapIndex();
 
@@ -169,7 +166,11 @@ namespace OpenMS
     // annotations
     if (collect_annotations_ && map_index != center_point_->getMapIndex())
     {
-      (*tmp_neighbors_)[map_index].insert(make_pair(distance, element));
+      Neighbor_ neighbor;
+      neighbor.map_index = map_index;
+      neighbor.distance = distance;
+      neighbor.feature = element;
+      tmp_neighbors_.push_back(neighbor);
       changed_ = true;
     }
 
@@ -317,42 +318,45 @@ namespace OpenMS
   {
     OPENMS_PRECONDITION(collect_annotations_,
         "QTCluster::optimizeAnnotations_ should only be called if we use collect_annotations_")
-    OPENMS_PRECONDITION(tmp_neighbors_ != NULL,
-        "QTCluster::optimizeAnnotations_ needs to have working tmp_neighbors_")
     OPENMS_PRECONDITION(!finalized_,
         "QTCluster::optimizeAnnotations_ cannot work on finalized cluster")
 
+    // group neighbors by input map, closest first (stable: equal distances
+    // keep their order of insertion)
+    std::stable_sort(tmp_neighbors_.begin(), tmp_neighbors_.end());
+
     // mapping: peptides -> best distance per input map
     map<set<AASequence>, vector<double> > seq_table;
 
-    for (NeighborMapMulti::iterator n_it = tmp_neighbors_->begin();
-        n_it != tmp_neighbors_->end(); ++n_it)
+    Size skip_map = num_maps_; // input map for which no further checks are needed
+    for (NeighborListType::const_iterator n_it = tmp_neighbors_.begin();
+         n_it != tmp_neighbors_.end(); ++n_it)
     {
-      Size map_index = n_it->first;
-      for (NeighborListType::iterator df_it = n_it->second.begin(); 
-          df_it != n_it->second.end(); ++df_it)
+      Size map_index = n_it->map_index;
+      if (map_index == skip_map)
       {
-        double dist = df_it->first;
-        const set<AASequence>& current = df_it->second->getAnnotations();
-        map<set<AASequence>, vector<double> >::iterator pos =
-          seq_table.find(current);
-        if (pos == seq_table.end())
-        {
-          // new set of annotations, fill vector with max distance for all maps
-          seq_table[current].resize(num_maps_, max_distance_);
-          seq_table[current][map_index] = dist;
-        }
-        else 
-        {
-          // new dist. value for this input map
-          pos->second[map_index] = min(dist, pos->second[map_index]);
-        }
-        if (current.empty()) // unannotated feature
-        {
-          // no need to check further (annotation-specific distances are worse
-          // than this unspecific one):
-          break;
-        }
+        continue;
+      }
+      double dist = n_it->distance;
+      const set<AASequence>& current = n_it->feature->getAnnotations();
+      map<set<AASequence>, vector<double> >::iterator pos =
+        seq_table.find(current);
+      if (pos == seq_table.end())
+      {
+        // new set of annotations, fill vector with max distance for all maps
+        seq_table[current].resize(num_maps_, max_distance_);
+        seq_table[current][map_index] = dist;
+      }
+      else 
+      {
+        // new dist. value for this input map
+        pos->second[map_index] = min(dist, pos->second[map_index]);
+      }
+      if (current.empty()) // unannotated feature
+      {
+        // no need to check further (annotation-specific distances are worse
+        // than this unspecific one):
+        skip_map = map_index;
       }
     }
 
@@ -396,18 +400,17 @@ namespace OpenMS
 
     // report elements that are compatible with the optimal annotation:
     neighbors_.clear();
-    for (NeighborMapMulti::const_iterator n_it = tmp_neighbors_->begin();
-         n_it != tmp_neighbors_->end(); ++n_it)
+    for (NeighborListType::const_iterator n_it = tmp_neighbors_.begin();
+         n_it != tmp_neighbors_.end(); ++n_it)
     {
-      for (std::multimap<double, GridFeature*>::const_iterator df_it =
-             n_it->second.begin(); df_it != n_it->second.end(); ++df_it)
+      if (neighbors_.find(n_it->map_index) != neighbors_.end())
       {
-        const set<AASequence>& current = df_it->second->getAnnotations();
-        if (current.empty() || (current == annotations_))
-        {
-          neighbors_[n_it->first] = make_pair(df_it->first, df_it->second);
-          break; // found the best element for this input map
-        }
+        continue; // already found the best element for this input map
+      }
+      const set<AASequence>& current = n_it->feature->getAnnotations();
+      if (current.empty() || (current == annotations_))
+      {
+        neighbors_[n_it->map_index] = make_pair(n_it->distance, n_it->feature);
       }
     }
 
@@ -417,8 +420,6 @@ namespace OpenMS
 
   void QTCluster::finalizeCluster()
   {
-    OPENMS_PRECONDITION(tmp_neighbors_ != NULL,
-        "Try to finalize QTCluster that was not initialized")
     OPENMS_PRECONDITION(!finalized_,
         "Try to finalize QTCluster that was not initialized")
 
@@ -430,40 +431,22 @@ namespace OpenMS
     finalized_ = true;
 
     // delete memory again
-    delete tmp_neighbors_;
-    tmp_neighbors_ = NULL;
+    NeighborListType().swap(tmp_neighbors_);
   }
 
   void QTCluster::initializeCluster()
   {
-    OPENMS_PRECONDITION(tmp_neighbors_ == NULL,
-        "Try to initialize QTCluster that was not finalized")
     OPENMS_PRECONDITION(finalized_,
         "Try to initialize QTCluster that was not finalized")
 
     finalized_ = false;
 
-    if (tmp_neighbors_ != NULL)
-    {
-      // delete memory again (should never actually happen but lets make sure
-      // we release the memory under all circumstances)
-      delete tmp_neighbors_;
-      tmp_neighbors_ = NULL;
-    }
-
-    // create empty map 
-    tmp_neighbors_ = new NeighborMapMulti();
+    // start with an empty list
+    tmp_neighbors_.clear();
   }
 
   QTCluster::~QTCluster()
   {
-    if (tmp_neighbors_ != NULL)
-    {
-      // delete memory again (should never actually happen but lets make sure
-      // we release the memory under all circumstances)
-      delete tmp_neighbors_;
-      tmp_neighbors_ = NULL;
-    }
   }
 
 } // namespace OpenMS
@@ -70,9 +70,17 @@ namespace OpenMS
     defaults_.setValue("min_trace_length", 5.0, "Minimum expected length of a mass trace (in seconds).", ListUtils::create<String>("advanced"));
     defaults_.setValue("max_trace_length", -1.0, "Maximum expected length of a mass trace (in seconds). Set to a negative value to disable maximal length check during mass trace detection.", ListUtils::create<String>("advanced"));
 
+    defaults_.setValue("chunk:rt_window", 600.0, "Streaming mode only: RT range (in seconds) of the chunks in which potential apices are processed.", ListUtils::create<String>("advanced"));
+    defaults_.setMinFloat("chunk:rt_window", 1.0);
+    defaults_.setValue("chunk:rt_overlap", 300.0, "Streaming mode only: RT range (in seconds) by which mass traces may extend beyond their chunk. Should be larger than the longest expected mass trace; spectra are kept in memory for the chunk plus twice this range.", ListUtils::create<String>("advanced"));
+    defaults_.setMinFloat("chunk:rt_overlap", 0.0);
+    defaults_.setSectionDescription("chunk", "Parameters for processing spectra in streaming mode");
+
     defaultsToParam_();
 
     this->setLogType(CMD);
+
+    startStreaming();
   }
 
   MassTraceDetection::~MassTraceDetection()
@@ -257,19 +265,138 @@ namespace OpenMS
     // Step 2: start extending mass traces beginning with the apex peak (go
     // through all peaks in order of decreasing intensity)
     // *********************************************************************
-    run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces);
+    boost::dynamic_bitset<> peak_visited(total_peak_count);
+    Size trace_number(1);
+    run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces, peak_visited, trace_number, true);
 
     return;
   } // end of MassTraceDetection::run
 
+  void MassTraceDetection::startStreaming()
+  {
+    stream_exp_.clear(true);
+    stream_peak_visited_.clear();
+    stream_chunk_begin_ = -std::numeric_limits<double>::max();
+    stream_spectra_count_ = 0;
+    stream_trace_number_ = 1;
+  }
+
+  void MassTraceDetection::consumeSpectrum(const MSSpectrum<Peak1D>& spectrum, std::vector<MassTrace>& completed_masstraces)
+  {
+    if (spectrum.getMSLevel() != 1) return;
+
+    if (!stream_exp_.empty() && spectrum.getRT() < stream_exp_[stream_exp_.size() - 1].getRT())
+    {
+      throw Exception::Precondition(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                                    String("Spectra must be sorted by RT in streaming mode (RT ") + spectrum.getRT() + " after " + stream_exp_[stream_exp_.size() - 1].getRT() + ").");
+    }
+
+    // remove peaks below the noise threshold (same as in run())
+    std::vector<Size> indices_passing;
+    for (Size peak_idx = 0; peak_idx < spectrum.size(); ++peak_idx)
+    {
+      if (spectrum[peak_idx].getIntensity() > noise_threshold_int_)
+      {
+        indices_passing.push_back(peak_idx);
+      }
+    }
+    MSSpectrum<Peak1D> tmp_spec(spectrum);
+    tmp_spec.select(indices_passing);
+    if (!tmp_spec.isSorted())
+    {
+      tmp_spec.sortByPosition();
+    }
+
+    if (stream_spectra_count_ == 0)
+    {
+      stream_chunk_begin_ = tmp_spec.getRT();
+    }
+    stream_exp_.addSpectrum(tmp_spec);
+    stream_peak_visited_.resize(stream_peak_visited_.size() + tmp_spec.size());
+    ++stream_spectra_count_;
+
+    // process the current chunk once traces of its apices cannot extend
+    // further than the spectra available
+    while (tmp_spec.getRT() >= stream_chunk_begin_ + chunk_rt_window_ + chunk_rt_overlap_)
+    {
+      processStreamingChunk_(stream_chunk_begin_, stream_chunk_begin_ + chunk_rt_window_, completed_masstraces);
+    }
+  }
+
+  void MassTraceDetection::finishStreaming(std::vector<MassTrace>& completed_masstraces)
+  {
+    if (stream_spectra_count_ < 3)
+    {
+      Size spectra_count(stream_spectra_count_);
+      startStreaming();
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                                    "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(spectra_count));
+    }
+
+    processStreamingChunk_(stream_chunk_begin_, std::numeric_limits<double>::max(), completed_masstraces);
+    startStreaming();
+  }
+
+  double MassTraceDetection::getStreamingBoundary() const
+  {
+    if (stream_exp_.empty())
+    {
+      return stream_chunk_begin_;
+    }
+    return stream_exp_[0].getRT();
+  }
+
+  void MassTraceDetection::processStreamingChunk_(double rt_begin, double rt_end, std::vector<MassTrace>& completed_masstraces)
+  {
+    MapIdxSortedByInt chrom_apices;
+    std::vector<Size> spec_offsets;
+    spec_offsets.push_back(0);
+
+    for (Size scan_idx = 0; scan_idx < stream_exp_.size(); ++scan_idx)
+    {
+      const MSSpectrum<Peak1D>& spec = stream_exp_[scan_idx];
+      if (spec.getRT() >= rt_begin && spec.getRT() < rt_end)
+      {
+        for (Size peak_idx = 0; peak_idx < spec.size(); ++peak_idx)
+        {
+          if (spec[peak_idx].getIntensity() > chrom_peak_snr_ * noise_threshold_int_)
+          {
+            chrom_apices.insert(std::make_pair(spec[peak_idx].getIntensity(), std::make_pair(scan_idx, peak_idx)));
+          }
+        }
+      }
+      spec_offsets.push_back(spec_offsets.back() + spec.size());
+    }
+    spec_offsets.pop_back();
+
+    run_(chrom_apices, stream_peak_visited_.size(), stream_exp_, spec_offsets, completed_masstraces, stream_peak_visited_, stream_trace_number_, false);
+
+    // keep only the spectra which may still be part of a trace of the next chunk
+    stream_chunk_begin_ = rt_end;
+    double keep_from(rt_end - chunk_rt_overlap_);
+    Size drop_count(0);
+    while (drop_count < stream_exp_.size() && stream_exp_[drop_count].getRT() < keep_from)
+    {
+      ++drop_count;
+    }
+    if (drop_count > 0)
+    {
+      Size drop_peaks(drop_count < spec_offsets.size() ? spec_offsets[drop_count] : stream_peak_visited_.size());
+      stream_peak_visited_ >>= drop_peaks;
+      stream_peak_visited_.resize(stream_peak_visited_.size() - drop_peaks);
+      stream_exp_.getSpectra().erase(stream_exp_.getSpectra().begin(), stream_exp_.getSpectra().begin() + drop_count);
+    }
+  }
+
   void MassTraceDetection::run_(const MapIdxSortedByInt& chrom_apices,
                                 const Size total_peak_count, 
                                 const MSExperiment<Peak1D>& work_exp, 
                                 const std::vector<Size>& spec_offsets,
-                                std::vector<MassTrace>& found_masstraces)
+                                std::vector<MassTrace>& found_masstraces,
+                                boost::dynamic_bitset<>& peak_visited,
+                                Size& trace_number,
+                                bool report_progress)
   {
-    boost::dynamic_bitset<> peak_visited(total_peak_count);
-    Size trace_number(1);
 
     // check presence of FWHM meta data
     int fwhm_meta_idx(-1);
@@ -294,7 +421,7 @@ namespace OpenMS
     }
      
 
-    this->startProgress(0, total_peak_count, "mass trace detection");
+    if (report_progress) this->startProgress(0, total_peak_count, "mass trace detection");
     Size peaks_detected(0);
 
     for (MapIdxSortedByInt::const_reverse_iterator m_it = chrom_apices.rbegin(); m_it != chrom_apices.rend(); ++m_it)
@@ -547,11 +674,11 @@ namespace OpenMS
         found_masstraces.push_back(new_trace);
 
         peaks_detected += new_trace.getSize();
-        this->setProgress(peaks_detected);
+        if (report_progress) this->setProgress(peaks_detected);
       }
     }
 
-    this->endProgress();
+    if (report_progress) this->endProgress();
 
   }
   
@@ -568,6 +695,8 @@ namespace OpenMS
     min_trace_length_ = (double)param_.getValue("min_trace_length");
     max_trace_length_ = (double)param_.getValue("max_trace_length");
     reestimate_mt_sd_ = param_.getValue("reestimate_mt_sd").toBool();
+    chunk_rt_window_ = (double)param_.getValue("chunk:rt_window");
+    chunk_rt_overlap_ = (double)param_.getValue("chunk:rt_overlap");
   }
 
 }
@@ -37,6 +37,8 @@
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <cmath>
+
 using namespace std;
 namespace OpenMS
 {
@@ -114,4 +116,82 @@ namespace OpenMS
     return *this;
   }
 
+  SpectraMerger::AveragingSettings_ SpectraMerger::getAveragingSettings_(const String& average_type) const
+  {
+    AveragingSettings_ settings;
+
+    // MS level to be averaged
+    settings.ms_level = param_.getValue("average_gaussian:ms_level");
+    if (average_type == "tophat")
+    {
+      settings.ms_level = param_.getValue("average_tophat:ms_level");
+    }
+
+    // spectrum type (profile, centroid or automatic)
+    settings.spectrum_type = param_.getValue("average_gaussian:spectrum_type");
+    if (average_type == "tophat")
+    {
+      settings.spectrum_type = param_.getValue("average_tophat:spectrum_type");
+    }
+
+    settings.gaussian = (average_type == "gaussian");
+
+    // parameters for Gaussian averaging
+    double fwhm(param_.getValue("average_gaussian:rt_FWHM"));
+    settings.factor = -4 * log(2.0) / (fwhm * fwhm); // numerical factor within Gaussian
+    settings.cutoff = param_.getValue("average_gaussian:cutoff");
+
+    // parameters for Top-Hat averaging
+    settings.unit = (param_.getValue("average_tophat:rt_unit") == "scans"); // true if RT unit is 'scans', false if RT unit is 'seconds'
+    double range(param_.getValue("average_tophat:rt_range")); // range of spectra to be averaged over
+    settings.range_seconds = range / 2; // max. +/- <range_seconds> seconds from master spectrum
+    int range_scans = range;
+    if ((range_scans % 2) == 0)
+    {
+      ++range_scans;
+    }
+    settings.range_scans = (range_scans - 1) / 2; // max. +/- <range_scans> scans from master spectrum
+
+    return settings;
+  }
+
+  double SpectraMerger::averagingWeight_(const AveragingSettings_& settings, double rt_master, double rt)
+  {
+    if (settings.gaussian)
+    {
+      return std::exp(settings.factor * pow(rt - rt_master, 2));
+    }
+    return 1;
+  }
+
+  bool SpectraMerger::averagingTerminates_(const AveragingSettings_& settings, double rt_master, double rt, int steps)
+  {
+    if (settings.gaussian)
+    {
+      // Gaussian
+      return std::exp(settings.factor * pow(rt - rt_master, 2)) < settings.cutoff;
+    }
+    else if (settings.unit)
+    {
+      // Top-Hat with RT unit = scans
+      return steps > settings.range_scans;
+    }
+    // Top-Hat with RT unit = seconds
+    return std::abs(rt - rt_master) > settings.range_seconds;
+  }
+
+  void SpectraMerger::normalizeAveragingWeights_(std::vector<std::pair<Size, double> >& block)
+  {
+    double sum(0.0);
+    for (std::vector<std::pair<Size, double> >::const_iterator it = block.begin(); it != block.end(); ++it)
+    {
+      sum += it->second;
+    }
+
+    for (std::vector<std::pair<Size, double> >::iterator it = block.begin(); it != block.end(); ++it)
+    {
+      (*it).second /= sum;
+    }
+  }
+
 }
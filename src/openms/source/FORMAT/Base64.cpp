@@ -38,10 +38,246 @@
 #include <QtCore/QList>
 #include <QtCore/QString>
 
+// Runtime dispatched SSSE3/AVX2 kernels (GCC >= 4.9 and Clang on x86)
+#if (defined(__x86_64__) || defined(__i386__)) && \
+  (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define OPENMS_BASE64_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /*
+      Vectorized Base64 kernels
+
+      The kernels below process the bulk of a Base64 stream in blocks of 12
+      (SSSE3) or 24 (AVX2) bytes, i.e. 16 or 32 characters, following the
+      approach described by W. Mula and D. Lemire ("Faster Base64 Encoding
+      and Decoding using AVX2 Instructions", ACM TWEB 2018). Each kernel
+      returns the number of input bytes (encoding) or characters (decoding)
+      it has consumed; the remaining tail is always processed by the scalar
+      code in Base64::encodeBytes_ and Base64::decodeBytes_. The decoders
+      validate every block and stop at the first block containing a
+      character outside the Base64 alphabet, leaving it to the scalar code.
+
+      The kernels are compiled with function-level target attributes and
+      selected at runtime depending on the capabilities of the CPU, so the
+      library itself does not require any special compiler flags.
+    */
+
+    typedef Size (*EncodeKernel)(const Byte* in, Size in_size, Byte* out);
+    typedef Size (*DecodeKernel)(const Byte* in, Size in_size, Byte* out);
+
+#ifdef OPENMS_BASE64_X86_DISPATCH
+
+    __attribute__((target("ssse3")))
+    inline __m128i encodeBlockSSSE3(__m128i in)
+    {
+      // spread 12 input bytes into four 32 bit lanes of 3 bytes each
+      in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+      // extract the four 6 bit indices of each lane into separate bytes
+      const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+      const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+      const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+      const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+      const __m128i indices = _mm_or_si128(t1, t3);
+
+      // map the indices 0..63 to the ASCII characters of the alphabet
+      __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+      const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+      reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+      const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                              '/' - 63, 'A', 0, 0);
+      return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, reduced), indices);
+    }
+
+    __attribute__((target("ssse3")))
+    Size encodeSSSE3(const Byte* in, Size in_size, Byte* out)
+    {
+      Size i = 0;
+      // each block reads 16 bytes but only consumes 12
+      for (; i + 16 <= in_size; i += 12)
+      {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encodeBlockSSSE3(block));
+        out += 16;
+      }
+      return i;
+    }
+
+    /// Translates 16 Base64 characters into their 6 bit values, returns false if an invalid character was found
+    __attribute__((target("ssse3")))
+    inline bool decodeBlockSSSE3(__m128i& in)
+    {
+      const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                           0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+      const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                           0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+      const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                             0, 0, 0, 0, 0, 0, 0, 0);
+      const __m128i mask_2f = _mm_set1_epi8(0x2f);
+
+      const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+      const __m128i lo_nibbles = _mm_and_si128(in, mask_2f);
+      const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+      const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+      // a character is valid iff its lo and hi class bits do not intersect
+      const __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+      if (_mm_movemask_epi8(invalid) != 0xFFFF)
+      {
+        return false;
+      }
+      const __m128i eq_2f = _mm_cmpeq_epi8(in, mask_2f);
+      const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+      const __m128i values = _mm_add_epi8(in, roll);
+
+      // pack four 6 bit values into 3 bytes per 32 bit lane
+      const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+      const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+      in = _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+      return true;
+    }
+
+    __attribute__((target("ssse3")))
+    Size decodeSSSE3(const Byte* in, Size in_size, Byte* out)
+    {
+      Size i = 0;
+      // each block writes 16 bytes but only produces 12, the following 8
+      // characters guarantee that the excess bytes are still inside the output
+      for (; i + 24 <= in_size; i += 16)
+      {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (!decodeBlockSSSE3(block)) break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+        out += 12;
+      }
+      return i;
+    }
+
+    __attribute__((target("avx2")))
+    Size encodeAVX2(const Byte* in, Size in_size, Byte* out)
+    {
+      const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                              10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+      const __m256i shift_lut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                 '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                 '/' - 63, 'A', 0, 0,
+                                                 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                 '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                 '/' - 63, 'A', 0, 0);
+      Size i = 0;
+      // each block reads 28 bytes but only consumes 24
+      for (; i + 28 <= in_size; i += 24)
+      {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+        __m256i block = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        block = _mm256_shuffle_epi8(block, shuffle);
+
+        const __m256i t0 = _mm256_and_si256(block, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(block, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        const __m256i chars = _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, reduced), indices);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+        out += 32;
+      }
+      return i;
+    }
+
+    __attribute__((target("avx2")))
+    Size decodeAVX2(const Byte* in, Size in_size, Byte* out)
+    {
+      const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                              0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                              0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                              0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+      const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                              0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                              0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                              0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+      const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                                0, 0, 0, 0, 0, 0, 0, 0,
+                                                0, 16, 19, 4, -65, -65, -71, -71,
+                                                0, 0, 0, 0, 0, 0, 0, 0);
+      const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+      const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+
+      Size i = 0;
+      // each block writes 32 bytes but only produces 24, the following 16
+      // characters guarantee that the excess bytes are still inside the output
+      for (; i + 48 <= in_size; i += 32)
+      {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+
+        const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(block, 4), mask_2f);
+        const __m256i lo_nibbles = _mm256_and_si256(block, mask_2f);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) break;
+
+        const __m256i eq_2f = _mm256_cmpeq_epi8(block, mask_2f);
+        const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        const __m256i values = _mm256_add_epi8(block, roll);
+
+        const __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i packed = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        packed = _mm256_shuffle_epi8(packed, pack);
+        // move the 12 bytes of the upper lane next to the ones of the lower lane
+        packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+        out += 24;
+      }
+      return i;
+    }
+
+#endif
+
+    struct Base64Kernels
+    {
+      EncodeKernel encode;
+      DecodeKernel decode;
+    };
+
+    Base64Kernels selectKernels()
+    {
+      Base64Kernels kernels;
+      kernels.encode = 0;
+      kernels.decode = 0;
+#ifdef OPENMS_BASE64_X86_DISPATCH
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+      {
+        kernels.encode = &encodeAVX2;
+        kernels.decode = &decodeAVX2;
+      }
+      else if (__builtin_cpu_supports("ssse3"))
+      {
+        kernels.encode = &encodeSSSE3;
+        kernels.decode = &decodeSSSE3;
+      }
+#endif
+      return kernels;
+    }
+
+    // selected once at library load time, null pointers mean scalar only
+    Base64Kernels base64_kernels = selectKernels();
+  }
+
 
   /*
 
@@ -134,6 +370,97 @@ print s
   {
   }
 
+  void Base64::encodeBytes_(const Byte* in, Size in_size, Byte* out)
+  {
+    Size i = 0;
+    if (base64_kernels.encode != 0)
+    {
+      i = base64_kernels.encode(in, in_size, out);
+      out += (i / 3) * 4;
+    }
+
+    // encode 3 bytes into 4 characters
+    for (; i + 3 <= in_size; i += 3)
+    {
+      UInt int_24bit = (UInt(in[i]) << 16) | (UInt(in[i + 1]) << 8) | UInt(in[i + 2]);
+      out[0] = encoder_[(int_24bit >> 18) & 0x3F];
+      out[1] = encoder_[(int_24bit >> 12) & 0x3F];
+      out[2] = encoder_[(int_24bit >> 6) & 0x3F];
+      out[3] = encoder_[int_24bit & 0x3F];
+      out += 4;
+    }
+
+    // remaining one or two bytes are padded with '='
+    if (i < in_size)
+    {
+      UInt int_24bit = UInt(in[i]) << 16;
+      if (i + 1 < in_size) int_24bit |= UInt(in[i + 1]) << 8;
+      out[0] = encoder_[(int_24bit >> 18) & 0x3F];
+      out[1] = encoder_[(int_24bit >> 12) & 0x3F];
+      out[2] = (i + 1 < in_size) ? encoder_[(int_24bit >> 6) & 0x3F] : '=';
+      out[3] = '=';
+    }
+  }
+
+  void Base64::decodeBytes_(const Byte* in, Size in_size, Size padding, Byte* out)
+  {
+    const Size src_size = in_size - padding;
+    Size i = 0;
+    if (base64_kernels.decode != 0)
+    {
+      i = base64_kernels.decode(in, src_size, out);
+      out += (i / 4) * 3;
+    }
+
+    // decode 4 characters into 3 bytes, padding characters count as zero
+    for (; i < in_size; i += 4)
+    {
+      UInt int_24bit = 0;
+      for (Size k = i; k < i + 4; ++k)
+      {
+        UInt value = 0;
+        if (k < src_size && in[k] >= 43 && in[k] <= 122)
+        {
+          value = (decoder_[in[k] - 43] - 62) & 0x3F;
+        }
+        int_24bit = (int_24bit << 6) | value;
+      }
+      out[0] = (Byte)(int_24bit >> 16);
+      out[1] = (Byte)(int_24bit >> 8);
+      out[2] = (Byte)int_24bit;
+      out += 3;
+    }
+  }
+
+  void Base64::swapByteOrder_(Byte* data, Size count, Size element_size)
+  {
+    if (element_size == 4)
+    {
+      for (Size i = 0; i < count; ++i, data += 4)
+      {
+        std::swap(data[0], data[3]);
+        std::swap(data[1], data[2]);
+      }
+    }
+    else if (element_size == 8)
+    {
+      for (Size i = 0; i < count; ++i, data += 8)
+      {
+        std::swap(data[0], data[7]);
+        std::swap(data[1], data[6]);
+        std::swap(data[2], data[5]);
+        std::swap(data[3], data[4]);
+      }
+    }
+    else
+    {
+      for (Size i = 0; i < count; ++i, data += element_size)
+      {
+        std::reverse(data, data + element_size);
+      }
+    }
+  }
+
   void Base64::encodeStrings(const std::vector<String>& in, String& out, bool zlib_compression, bool append_null_byte)
   {
     out.clear();
@@ -188,45 +515,8 @@ print s
       it = reinterpret_cast<Byte*>(&str[0]);
       end = it + str.size();
     }
-    Byte* to = reinterpret_cast<Byte*>(&out[0]);
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
-    }
 
-    out.resize(written); //no more space is needed
+    encodeBytes_(it, end - it, reinterpret_cast<Byte*>(&out[0]));
   }
 
   void Base64::decodeStrings(const String& in, std::vector<String>& out, bool zlib_compression)
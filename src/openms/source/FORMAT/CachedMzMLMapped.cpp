@@ -0,0 +1,228 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/CachedMzMLMapped.h>
+
+#include <OpenMS/FORMAT/CachedMzML.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/Macros.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace OpenMS
+{
+
+  CachedmzMLMapped::CachedmzMLMapped(const String& filename) :
+    filename_(filename),
+    begin_(0),
+    length_(0)
+  {
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+      region_ = boost::shared_ptr<boost::interprocess::mapped_region>(
+        new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception& /* e */)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+    }
+
+    begin_ = static_cast<const char*>(region_->get_address());
+    length_ = region_->get_size();
+
+    // we expect random access to the data (avoid read-ahead of unused pages)
+    region_->advise(boost::interprocess::mapped_region::advice_random);
+
+    createIndex_();
+  }
+
+  CachedmzMLMapped::CachedmzMLMapped(const CachedmzMLMapped& rhs) :
+    filename_(rhs.filename_),
+    region_(rhs.region_),
+    begin_(rhs.begin_),
+    length_(rhs.length_),
+    spectra_index_(rhs.spectra_index_),
+    chrom_index_(rhs.chrom_index_)
+  {
+  }
+
+  CachedmzMLMapped& CachedmzMLMapped::operator=(const CachedmzMLMapped& rhs)
+  {
+    if (&rhs == this)
+      return *this;
+
+    filename_ = rhs.filename_;
+    region_ = rhs.region_;
+    begin_ = rhs.begin_;
+    length_ = rhs.length_;
+    spectra_index_ = rhs.spectra_index_;
+    chrom_index_ = rhs.chrom_index_;
+
+    return *this;
+  }
+
+  CachedmzMLMapped::~CachedmzMLMapped()
+  {
+  }
+
+  Size CachedmzMLMapped::getNrSpectra() const
+  {
+    return spectra_index_.size();
+  }
+
+  Size CachedmzMLMapped::getNrChromatograms() const
+  {
+    return chrom_index_.size();
+  }
+
+  const String& CachedmzMLMapped::getFilename() const
+  {
+    return filename_;
+  }
+
+  void CachedmzMLMapped::getSpectrumView(Size id, DataArrayView& mz, DataArrayView& intensity, int& ms_level, double& rt) const
+  {
+    OPENMS_PRECONDITION(id < getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    Size offset = spectra_index_[id];
+    Size spec_size = readValue_<Size>(offset);
+    offset += sizeof(Size);
+    ms_level = readValue_<int>(offset);
+    offset += sizeof(int);
+    rt = readValue_<double>(offset);
+    offset += sizeof(double);
+
+    mz.data = begin_ + offset;
+    mz.size = spec_size;
+    intensity.data = begin_ + offset + spec_size * sizeof(CachedmzML::DatumSingleton);
+    intensity.size = spec_size;
+  }
+
+  void CachedmzMLMapped::getChromatogramView(Size id, DataArrayView& rt, DataArrayView& intensity) const
+  {
+    OPENMS_PRECONDITION(id < getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+
+    Size offset = chrom_index_[id];
+    Size chrom_size = readValue_<Size>(offset);
+    offset += sizeof(Size);
+
+    rt.data = begin_ + offset;
+    rt.size = chrom_size;
+    intensity.data = begin_ + offset + chrom_size * sizeof(CachedmzML::DatumSingleton);
+    intensity.size = chrom_size;
+  }
+
+  void CachedmzMLMapped::createIndex_()
+  {
+    // The layout is identical to the one described in CachedmzML: a file
+    // identifier, all spectra (size, ms level, RT, m/z and intensity data),
+    // all chromatograms (size, RT and intensity data) and finally the number
+    // of spectra and chromatograms.
+    const Size header_size = sizeof(int);
+    const Size trailer_size = 2 * sizeof(Size);
+    if (length_ < header_size + trailer_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+        "File is too small to be a cached mzML file. Aborting!", filename_);
+    }
+
+    if (readValue_<int>(0) != CACHED_MZML_FILE_IDENTIFIER)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+        "File might not be a cached mzML file (wrong file magic number). Aborting!", filename_);
+    }
+
+    const Size data_end = length_ - trailer_size;
+    Size exp_size = readValue_<Size>(data_end);
+    Size chrom_size = readValue_<Size>(data_end + sizeof(Size));
+
+    // every spectrum and chromatogram occupies at least its header, which
+    // bounds the counts stored in the trailer by the size of the file
+    const Size spectrum_header = sizeof(Size) + sizeof(int) + sizeof(double);
+    const Size chromatogram_header = sizeof(Size);
+    const Size data_size = data_end - header_size;
+    if (exp_size > data_size / spectrum_header ||
+        chrom_size > (data_size - exp_size * spectrum_header) / chromatogram_header)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+        "Read an invalid number of spectra (" + String(exp_size) + ") or chromatograms (" +
+        String(chrom_size) + "). Aborting!", filename_);
+    }
+
+    spectra_index_.clear();
+    chrom_index_.clear();
+    spectra_index_.reserve(exp_size);
+    chrom_index_.reserve(chrom_size);
+
+    Size offset = header_size;
+    for (Size i = 0; i < exp_size; i++)
+    {
+      if (offset + spectrum_header > data_end)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+          "Unexpected end of file while indexing spectrum " + String(i) + ". Aborting!", filename_);
+      }
+      spectra_index_.push_back(offset);
+      Size spec_size = readValue_<Size>(offset);
+      offset += spectrum_header;
+      if (spec_size > (data_end - offset) / (2 * sizeof(CachedmzML::DatumSingleton)))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+          "Read an invalid spectrum length for spectrum " + String(i) + ". Aborting!", filename_);
+      }
+      offset += 2 * spec_size * sizeof(CachedmzML::DatumSingleton);
+    }
+
+    for (Size i = 0; i < chrom_size; i++)
+    {
+      if (offset + chromatogram_header > data_end)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+          "Unexpected end of file while indexing chromatogram " + String(i) + ". Aborting!", filename_);
+      }
+      chrom_index_.push_back(offset);
+      Size ch_size = readValue_<Size>(offset);
+      offset += chromatogram_header;
+      if (ch_size > (data_end - offset) / (2 * sizeof(CachedmzML::DatumSingleton)))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+          "Read an invalid chromatogram length for chromatogram " + String(i) + ". Aborting!", filename_);
+      }
+      offset += 2 * ch_size * sizeof(CachedmzML::DatumSingleton);
+    }
+  }
+
+}
@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataAveragingConsumer.h>
+
+namespace OpenMS
+{
+
+  MSDataAveragingConsumer::MSDataAveragingConsumer(Interfaces::IMSDataConsumer<>* next_consumer, const Param& param, const String& average_type) :
+    next_consumer_(next_consumer),
+    type_(SpectrumSettings::UNKNOWN),
+    type_determined_(false),
+    window_start_(0),
+    next_spectrum_(0),
+    rt_initialized_(false),
+    last_rt_(0.0)
+  {
+    SpectraMerger merger;
+    merger.setParameters(param);
+    settings_ = merger.getAveragingSettings_(average_type);
+    mz_binning_width_ = merger.getParameters().getValue("mz_binning_width");
+    mz_binning_unit_ = merger.getParameters().getValue("mz_binning_width_unit");
+  }
+
+  MSDataAveragingConsumer::~MSDataAveragingConsumer()
+  {
+  }
+
+  void MSDataAveragingConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataAveragingConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    next_consumer_->setExperimentalSettings(exp);
+  }
+
+  void MSDataAveragingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    if (rt_initialized_ && s.getRT() < last_rt_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Spectra need to be sorted by RT for averaging.");
+    }
+    rt_initialized_ = true;
+    last_rt_ = s.getRT();
+
+    window_.push_back(s);
+    passOnSpectra_(false);
+  }
+
+  void MSDataAveragingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    next_consumer_->consumeChromatogram(c);
+  }
+
+  void MSDataAveragingConsumer::flush()
+  {
+    passOnSpectra_(true);
+    window_start_ += window_.size();
+    window_.clear();
+  }
+
+  Size MSDataAveragingConsumer::getWindowSize() const
+  {
+    return window_.size();
+  }
+
+  void MSDataAveragingConsumer::passOnSpectra_(bool end_of_run)
+  {
+    // The blocks are determined exactly as in SpectraMerger::average(), but
+    // with indices relative to the window.
+    while (next_spectrum_ < window_start_ + window_.size())
+    {
+      const Size n = next_spectrum_ - window_start_; // spectrum index (in window)
+      const double rt = window_[n].getRT();
+
+      if (Int(window_[n].getMSLevel()) != settings_.ms_level)
+      {
+        // pass on unchanged - only RT and MS level are needed for averaging
+        SpectrumType placeholder;
+        placeholder.setRT(rt);
+        placeholder.setMSLevel(window_[n].getMSLevel());
+        next_consumer_->consumeSpectrum(window_[n]);
+        window_[n] = placeholder;
+        ++next_spectrum_;
+        continue;
+      }
+
+      std::vector<std::pair<Size, double> > block;
+      Size m; // spectrum index (in window)
+      int steps;
+      bool terminate_now;
+
+      // go forward (start at next downstream spectrum; the current spectrum will be covered when looking backwards)
+      steps = 0;
+      m = n + 1;
+      terminate_now = false;
+      while (m < window_.size() && !terminate_now)
+      {
+        if (Int(window_[m].getMSLevel()) == settings_.ms_level)
+        {
+          block.push_back(std::make_pair(m, SpectraMerger::averagingWeight_(settings_, rt, window_[m].getRT())));
+          ++steps;
+        }
+        terminate_now = SpectraMerger::averagingTerminates_(settings_, rt, window_[m].getRT(), steps);
+        ++m;
+      }
+
+      // averaging range not complete yet - wait for more spectra
+      if (!terminate_now && !end_of_run) break;
+
+      // go backward (as in SpectraMerger::average(), the first spectrum of the run is never included)
+      steps = 0;
+      m = n;
+      terminate_now = false;
+      Size first_needed = n; // first spectrum (in window) reached when looking backwards
+      while (window_start_ + m != 0 && !terminate_now)
+      {
+        first_needed = m;
+        if (Int(window_[m].getMSLevel()) == settings_.ms_level)
+        {
+          block.push_back(std::make_pair(m, SpectraMerger::averagingWeight_(settings_, rt, window_[m].getRT())));
+          ++steps;
+        }
+        terminate_now = SpectraMerger::averagingTerminates_(settings_, rt, window_[m].getRT(), steps);
+        if (m == 0) break; // only reached if spectra were dropped too early (cannot happen for RT-sorted input)
+        --m;
+      }
+
+      SpectrumType average_spec = window_[n];
+      if (!block.empty())
+      {
+        SpectraMerger::normalizeAveragingWeights_(block);
+
+        // determine type of spectral data (profile or centroided)
+        if (!type_determined_)
+        {
+          type_ = SpectraMerger::averagingSpectrumType_(settings_, window_[n]);
+          type_determined_ = true;
+        }
+
+        if (type_ == SpectrumSettings::PEAKS)
+        {
+          SpectraMerger::averageCentroidBlock_(window_, block, mz_binning_width_, mz_binning_unit_, average_spec);
+        }
+        else
+        {
+          SpectraMerger::averageProfileBlock_(window_, block, mz_binning_width_, mz_binning_unit_, average_spec);
+        }
+      }
+      next_consumer_->consumeSpectrum(average_spec);
+      ++next_spectrum_;
+
+      // spectra before the first one needed by this spectrum are not needed by any later one either (RT-sorted input)
+      for (Size i = 0; i < first_needed; ++i)
+      {
+        window_.pop_front();
+        ++window_start_;
+      }
+    }
+  }
+
+} //end namespace OpenMS
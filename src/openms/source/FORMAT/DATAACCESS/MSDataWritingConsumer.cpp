@@ -34,7 +34,122 @@
 
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
+  void MSDataWritingConsumer::writeSpectrumBatch_()
+  {
+    if (spectra_batch_.empty()) return;
+
+    std::vector<std::string> fragments;
+    encodeBatch_(true, spectra_batch_.size(), fragments);
+
+    // write in order of consumption; the offset of each <spectrum> tag is
+    // known from the sizes of the preceding fragments
+    long offset = ofs_.tellp();
+    for (Size i = 0; i < fragments.size(); ++i)
+    {
+      spectra_offsets.push_back(std::make_pair(spectra_batch_[i].getNativeID(), offset + 3));
+      ofs_ << fragments[i];
+      offset += fragments[i].size();
+    }
+    spectra_batch_.clear();
+  }
+
+  void MSDataWritingConsumer::writeChromatogramBatch_()
+  {
+    if (chromatograms_batch_.empty()) return;
+
+    std::vector<std::string> fragments;
+    encodeBatch_(false, chromatograms_batch_.size(), fragments);
+
+    long offset = ofs_.tellp();
+    for (Size i = 0; i < fragments.size(); ++i)
+    {
+      chromatograms_offsets.push_back(std::make_pair(chromatograms_batch_[i].getNativeID(), offset + 6));
+      ofs_ << fragments[i];
+      offset += fragments[i].size();
+    }
+    chromatograms_batch_.clear();
+  }
+
+  void MSDataWritingConsumer::encodeBatch_(bool spectra, Size size, std::vector<std::string>& fragments)
+  {
+    fragments.resize(size);
+    Size nr_errors = 0;
+
+#ifdef _OPENMP
+    if (omp_in_parallel())
+    {
+      // called from within a parallel region (e.g. by the pipelined mzML
+      // parser in MzMLFile::transform): use the threads of the enclosing team
+      for (Size i = 0; i < size; ++i)
+      {
+#pragma omp task shared(fragments, nr_errors) firstprivate(i)
+        {
+          try
+          {
+            encodeElement_(spectra, i, fragments[i]);
+          }
+          catch (...)
+          {
+#pragma omp atomic
+            ++nr_errors;
+          }
+        }
+      }
+#pragma omp taskwait
+    }
+    else
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (SignedSize i = 0; i < (SignedSize)size; ++i)
+      {
+        try
+        {
+          encodeElement_(spectra, i, fragments[i]);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++nr_errors;
+        }
+      }
+    }
+
+    if (nr_errors != 0)
+    {
+      throw Exception::ConversionError(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+          String(nr_errors) + (spectra ? " spectra" : " chromatograms") + " could not be encoded.");
+    }
+  }
+
+  void MSDataWritingConsumer::encodeElement_(bool spectrum, Size i, std::string& fragment)
+  {
+    std::ostringstream os;
+    os.precision(writtenDigits(double()));
+    if (spectrum)
+    {
+      Internal::MzMLHandler<MapType>::writeSpectrumElement_(os, spectra_batch_[i],
+          spectra_written_ - spectra_batch_.size() + i, spectra_batch_[i].getNativeID(), *validator_, dps_);
+    }
+    else
+    {
+      Internal::MzMLHandler<MapType>::writeChromatogramElement_(os, chromatograms_batch_[i],
+          chromatograms_written_ - chromatograms_batch_.size() + i, *validator_);
+    }
+    fragment = os.str();
+  }
+
 } // namespace OpenMS
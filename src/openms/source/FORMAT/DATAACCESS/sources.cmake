@@ -7,6 +7,7 @@ set(sources_list
   MSDataTransformingConsumer.cpp
   MSDataCachedConsumer.cpp
   MSDataChainingConsumer.cpp
+  MSDataAveragingConsumer.cpp
   NoopMSDataConsumer.cpp
   SwathFileConsumer.cpp
 )
@@ -422,6 +422,12 @@ if (first_line.hasSubstring("File	First Scan	Last Scan	Num of Scans	Charge	Monoi
       return FileTypes::PSMS;
     }
 
+    // OpenSWATH binary transition library (.oswlib)
+    if (first_line.hasPrefix("OMSOSW01"))
+    {
+      return FileTypes::OSWLIB;
+    }
+
     // EDTA file
     // hard to tell... so we don't even try...
 
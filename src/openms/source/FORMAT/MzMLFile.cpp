@@ -38,6 +38,12 @@
 #include <OpenMS/FORMAT/VALIDATORS/XMLValidator.h>
 #include <OpenMS/FORMAT/TextFile.h>
 
+#include <boost/exception_ptr.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -130,10 +136,52 @@ namespace OpenMS
     options_.setSizeOnly(size_only_before_);
   }
 
-  void MzMLFile::safeParse_(const String& filename, Internal::XMLHandler* handler)
+  void MzMLFile::safeParse_(const String& filename, Internal::XMLHandler* handler, bool pipelined)
   {
     try
     {
+#ifdef _OPENMP
+      if (pipelined && omp_get_max_threads() > 1)
+      {
+        // A single thread runs the parser while the remaining threads of the
+        // team decode the binary data (the handler creates tasks for it).
+        // Exceptions must not leave the parallel region, they are stored and
+        // re-thrown afterwards.
+        bool has_error = false;
+        Exception::BaseException error;
+        boost::exception_ptr other_error;
+#pragma omp parallel
+        {
+#pragma omp single
+          {
+            try
+            {
+              parse_(filename, handler);
+            }
+            catch (Exception::BaseException& e)
+            {
+              has_error = true;
+              error = e;
+            }
+            catch (...)
+            {
+              other_error = boost::current_exception();
+            }
+          }
+        }
+        if (other_error)
+        {
+          boost::rethrow_exception(other_error);
+        }
+        if (has_error)
+        {
+          throw error;
+        }
+        return;
+      }
+#else
+      (void)pipelined;
+#endif
       parse_(filename, handler);
     }
     catch (Exception::BaseException& e)
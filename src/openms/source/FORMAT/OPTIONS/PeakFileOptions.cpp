@@ -63,7 +63,9 @@ namespace OpenMS
     write_index_(true),
     np_config_mz_(),
     np_config_int_(),
-    maximal_data_pool_size_(100)
+    maximal_data_pool_size_(100),
+    pipelined_decoding_(true),
+    pipelined_transform_(false)
   {
   }
 
@@ -89,7 +91,9 @@ namespace OpenMS
     write_index_(options.write_index_),
     np_config_mz_(options.np_config_mz_),
     np_config_int_(options.np_config_int_),
-    maximal_data_pool_size_(options.maximal_data_pool_size_)
+    maximal_data_pool_size_(options.maximal_data_pool_size_),
+    pipelined_decoding_(options.pipelined_decoding_),
+    pipelined_transform_(options.pipelined_transform_)
   {
   }
 
@@ -329,4 +333,24 @@ namespace OpenMS
     maximal_data_pool_size_ = size;
   }
 
+  void PeakFileOptions::setPipelinedDecoding(bool pipelined)
+  {
+    pipelined_decoding_ = pipelined;
+  }
+
+  bool PeakFileOptions::getPipelinedDecoding() const
+  {
+    return pipelined_decoding_;
+  }
+
+  void PeakFileOptions::setPipelinedTransform(bool pipelined)
+  {
+    pipelined_transform_ = pipelined;
+  }
+
+  bool PeakFileOptions::getPipelinedTransform() const
+  {
+    return pipelined_transform_;
+  }
+
 } // namespace OpenMS
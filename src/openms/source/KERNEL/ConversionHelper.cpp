@@ -37,7 +37,7 @@
 namespace OpenMS
 {
   void MapConversion::convert(UInt64 const input_map_index,
-                              MSExperiment<>& input_map,
+                              MSExperiment<> const& input_map,
                               ConsensusMap& output_map,
                               Size n)
   {
@@ -46,14 +46,23 @@ namespace OpenMS
     // see @todo above
     output_map.setUniqueId();
 
-    input_map.updateRanges(1);
-    if (n > input_map.getSize())
+    // count MS1 peaks directly instead of calling updateRanges(1), so the
+    // input map can stay const (and does not have to be copied by callers)
+    Size num_peaks = 0;
+    for (MSExperiment<>::ConstIterator it = input_map.begin(); it != input_map.end(); ++it)
     {
-      n = input_map.getSize();
+      if (it->getMSLevel() == 1)
+      {
+        num_peaks += it->size();
+      }
+    }
+    if (n > num_peaks)
+    {
+      n = num_peaks;
     }
     output_map.reserve(n);
     std::vector<Peak2D> tmp;
-    tmp.reserve(input_map.getSize());
+    tmp.reserve(num_peaks);
 
     // TODO Avoid tripling the memory consumption by this call
     input_map.get2DData(tmp);
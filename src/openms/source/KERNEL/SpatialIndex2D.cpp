@@ -0,0 +1,427 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/SpatialIndex2D.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /// Returns true if the box contains no position (default-constructed box); points are not empty
+    bool isEmptyBox(const SpatialIndex2D::BoxType& box)
+    {
+      return box.minPosition()[0] > box.maxPosition()[0] || box.minPosition()[1] > box.maxPosition()[1];
+    }
+
+    SpatialIndex2D::BoxType pointBox(double rt, double mz)
+    {
+      DPosition<2> pos(rt, mz);
+      return SpatialIndex2D::BoxType(pos, pos);
+    }
+  }
+
+  SpatialIndex2D::SpatialIndex2D() :
+    boxes_(),
+    spectrum_offsets_(),
+    grid_area_(),
+    tile_offsets_(),
+    tile_items_()
+  {
+    tile_count_[0] = tile_count_[1] = 0;
+    tile_size_[0] = tile_size_[1] = 1.0;
+  }
+
+  void SpatialIndex2D::build(const std::vector<BoxType>& boxes, Size items_per_tile)
+  {
+    if (boxes.size() > numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, __PRETTY_FUNCTION__, boxes.size());
+    }
+    clear();
+    boxes_ = boxes;
+    buildTiles_(items_per_tile);
+  }
+
+  void SpatialIndex2D::build(const FeatureMap& map, bool use_convex_hulls)
+  {
+    if (map.size() > numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, __PRETTY_FUNCTION__, map.size());
+    }
+    clear();
+    boxes_.reserve(map.size());
+    for (FeatureMap::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      // features without convex hull are represented by their centroid
+      if (use_convex_hulls && !it->getConvexHulls().empty())
+      {
+        boxes_.push_back(it->getConvexHull().getBoundingBox());
+      }
+      else
+      {
+        boxes_.push_back(pointBox(it->getRT(), it->getMZ()));
+      }
+    }
+    buildTiles_(4);
+  }
+
+  void SpatialIndex2D::build(const ConsensusMap& map, bool use_subelements)
+  {
+    if (map.size() > numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, __PRETTY_FUNCTION__, map.size());
+    }
+    clear();
+    boxes_.reserve(map.size());
+    for (ConsensusMap::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      // consensus features without sub-elements are represented by their centroid
+      if (use_subelements && !it->getFeatures().empty())
+      {
+        BoxType box;
+        for (ConsensusFeature::HandleSetType::const_iterator h_it = it->getFeatures().begin(); h_it != it->getFeatures().end(); ++h_it)
+        {
+          box.enlarge(h_it->getRT(), h_it->getMZ());
+        }
+        boxes_.push_back(box);
+      }
+      else
+      {
+        boxes_.push_back(pointBox(it->getRT(), it->getMZ()));
+      }
+    }
+    buildTiles_(4);
+  }
+
+  void SpatialIndex2D::build(const MSExperiment<>& map, UInt ms_level)
+  {
+    Size peak_count = 0;
+    for (MSExperiment<>::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      if (it->getMSLevel() == ms_level) peak_count += it->size();
+    }
+    if (peak_count > numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, __PRETTY_FUNCTION__, peak_count);
+    }
+
+    clear();
+    boxes_.reserve(peak_count);
+    spectrum_offsets_.reserve(map.size() + 1);
+    for (MSExperiment<>::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      spectrum_offsets_.push_back(boxes_.size());
+      if (it->getMSLevel() != ms_level) continue;
+
+      for (MSSpectrum<>::ConstIterator p_it = it->begin(); p_it != it->end(); ++p_it)
+      {
+        boxes_.push_back(pointBox(it->getRT(), p_it->getMZ()));
+      }
+    }
+    spectrum_offsets_.push_back(boxes_.size());
+    buildTiles_(4);
+  }
+
+  void SpatialIndex2D::buildTiles_(Size items_per_tile)
+  {
+    grid_area_ = BoxType();
+    Size item_count = 0;
+    for (Size i = 0; i < boxes_.size(); ++i)
+    {
+      if (isEmptyBox(boxes_[i])) continue;
+
+      grid_area_.enlarge(boxes_[i].minPosition());
+      grid_area_.enlarge(boxes_[i].maxPosition());
+      ++item_count;
+    }
+    if (item_count == 0)
+    {
+      tile_count_[0] = tile_count_[1] = 0;
+      tile_offsets_.clear();
+      tile_items_.clear();
+      return;
+    }
+
+    // choose about item_count / items_per_tile square-ish tiles; a dimension
+    // without extent (e.g. a single spectrum) gets a single tile
+    const Size target = std::max(item_count / std::max(items_per_tile, Size(1)), Size(1));
+    const double extent[2] = {grid_area_.maxPosition()[0] - grid_area_.minPosition()[0],
+                              grid_area_.maxPosition()[1] - grid_area_.minPosition()[1]};
+    if (extent[0] > 0.0 && extent[1] > 0.0)
+    {
+      tile_count_[0] = tile_count_[1] = Size(std::ceil(std::sqrt(double(target))));
+    }
+    else
+    {
+      tile_count_[0] = extent[0] > 0.0 ? target : 1;
+      tile_count_[1] = extent[1] > 0.0 ? target : 1;
+    }
+    for (UInt dim = 0; dim < 2; ++dim)
+    {
+      tile_size_[dim] = extent[dim] > 0.0 ? extent[dim] / tile_count_[dim] : 1.0;
+    }
+
+    // count the items per tile first, then fill them in (tiles are stored contiguously)
+    const Size tiles = tile_count_[0] * tile_count_[1];
+    tile_offsets_.assign(tiles + 1, 0);
+    for (UInt pass = 0; pass < 2; ++pass)
+    {
+      std::vector<Size> fill;
+      if (pass == 1)
+      {
+        for (Size t = 0; t < tiles; ++t)
+        {
+          tile_offsets_[t + 1] += tile_offsets_[t];
+        }
+        tile_items_.resize(tile_offsets_[tiles]);
+        fill.assign(tile_offsets_.begin(), tile_offsets_.end() - 1);
+      }
+      for (Size i = 0; i < boxes_.size(); ++i)
+      {
+        const BoxType& box = boxes_[i];
+        if (isEmptyBox(box)) continue;
+
+        const Size rt_first = tileOf_(box.minPosition()[0], 0), rt_last = tileOf_(box.maxPosition()[0], 0);
+        const Size mz_first = tileOf_(box.minPosition()[1], 1), mz_last = tileOf_(box.maxPosition()[1], 1);
+        for (Size rt_tile = rt_first; rt_tile <= rt_last; ++rt_tile)
+        {
+          for (Size mz_tile = mz_first; mz_tile <= mz_last; ++mz_tile)
+          {
+            const Size tile = rt_tile * tile_count_[1] + mz_tile;
+            if (pass == 0)
+            {
+              ++tile_offsets_[tile + 1];
+            }
+            else
+            {
+              tile_items_[fill[tile]++] = UInt32(i);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  Size SpatialIndex2D::tileOf_(double value, UInt dim) const
+  {
+    const double pos = (value - grid_area_.minPosition()[dim]) / tile_size_[dim];
+    if (!(pos > 0.0)) return 0;
+    if (pos >= double(tile_count_[dim])) return tile_count_[dim] - 1;
+    return std::min(Size(pos), tile_count_[dim] - 1);
+  }
+
+  void SpatialIndex2D::clear()
+  {
+    boxes_.clear();
+    spectrum_offsets_.clear();
+    grid_area_ = BoxType();
+    tile_count_[0] = tile_count_[1] = 0;
+    tile_size_[0] = tile_size_[1] = 1.0;
+    tile_offsets_.clear();
+    tile_items_.clear();
+  }
+
+  Size SpatialIndex2D::size() const
+  {
+    return boxes_.size();
+  }
+
+  bool SpatialIndex2D::empty() const
+  {
+    return boxes_.empty();
+  }
+
+  const SpatialIndex2D::BoxType& SpatialIndex2D::getBox(Size item) const
+  {
+    return boxes_[item];
+  }
+
+  PeakIndex SpatialIndex2D::getPeakIndex(Size item) const
+  {
+    if (spectrum_offsets_.empty())
+    {
+      return PeakIndex(item);
+    }
+    // last spectrum starting at or before the item (skips spectra without items)
+    const Size spectrum = std::upper_bound(spectrum_offsets_.begin(), spectrum_offsets_.end(), item) - spectrum_offsets_.begin() - 1;
+    return PeakIndex(spectrum, item - spectrum_offsets_[spectrum]);
+  }
+
+  void SpatialIndex2D::findInArea(double rt_min, double rt_max, double mz_min, double mz_max, std::vector<Size>& items) const
+  {
+    items.clear();
+    if (tile_items_.empty() || rt_min > rt_max || mz_min > mz_max)
+    {
+      return;
+    }
+    const BoxType area(DPosition<2>(rt_min, mz_min), DPosition<2>(rt_max, mz_max));
+    if (!area.intersects(grid_area_))
+    {
+      return;
+    }
+
+    const Size rt_first = tileOf_(rt_min, 0), rt_last = tileOf_(rt_max, 0);
+    const Size mz_first = tileOf_(mz_min, 1), mz_last = tileOf_(mz_max, 1);
+    for (Size rt_tile = rt_first; rt_tile <= rt_last; ++rt_tile)
+    {
+      for (Size mz_tile = mz_first; mz_tile <= mz_last; ++mz_tile)
+      {
+        const Size tile = rt_tile * tile_count_[1] + mz_tile;
+        for (Size i = tile_offsets_[tile]; i < tile_offsets_[tile + 1]; ++i)
+        {
+          const BoxType& box = boxes_[tile_items_[i]];
+          if (!box.intersects(area)) continue;
+
+          // items spanning several tiles are only reported by the tile that
+          // contains the lower corner of their intersection with the area
+          if (tileOf_(std::max(box.minPosition()[0], rt_min), 0) == rt_tile &&
+              tileOf_(std::max(box.minPosition()[1], mz_min), 1) == mz_tile)
+          {
+            items.push_back(tile_items_[i]);
+          }
+        }
+      }
+    }
+    std::sort(items.begin(), items.end());
+  }
+
+  void SpatialIndex2D::findNearest(double rt, double mz, Size k, std::vector<Size>& items, double rt_scale, double mz_scale) const
+  {
+    if (!(rt_scale > 0.0) || !(mz_scale > 0.0))
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "RT and m/z scale must be positive.", String(rt_scale) + "/" + String(mz_scale));
+    }
+    items.clear();
+    if (k == 0 || tile_items_.empty())
+    {
+      return;
+    }
+
+    const double pos[2] = {rt, mz};
+    const double scale[2] = {rt_scale, mz_scale};
+    const SignedSize center[2] = {SignedSize(tileOf_(rt, 0)), SignedSize(tileOf_(mz, 1))};
+    const SignedSize count[2] = {SignedSize(tile_count_[0]), SignedSize(tile_count_[1])};
+
+    // the k best (squared distance, item) pairs seen so far; the worst on top
+    std::priority_queue<std::pair<double, Size> > best;
+
+    // visit the tiles in rings of growing size around the tile of the position
+    for (SignedSize ring = 0; ; ++ring)
+    {
+      const SignedSize lo[2] = {center[0] - ring, center[1] - ring};
+      const SignedSize hi[2] = {center[0] + ring, center[1] + ring};
+      for (SignedSize rt_tile = std::max(lo[0], SignedSize(0)); rt_tile <= std::min(hi[0], count[0] - 1); ++rt_tile)
+      {
+        // inner columns only contribute their first and last tile to the ring
+        const bool full_column = (rt_tile == lo[0] || rt_tile == hi[0]);
+        const SignedSize step = full_column ? 1 : std::max(hi[1] - lo[1], SignedSize(1));
+        for (SignedSize mz_tile = lo[1]; mz_tile <= hi[1]; mz_tile += step)
+        {
+          if (mz_tile < 0 || mz_tile >= count[1]) continue;
+
+          const Size tile = rt_tile * tile_count_[1] + mz_tile;
+          for (Size i = tile_offsets_[tile]; i < tile_offsets_[tile + 1]; ++i)
+          {
+            const Size item = tile_items_[i];
+            const BoxType& box = boxes_[item];
+
+            // the point of the box closest to the position; items spanning
+            // several tiles are only considered in the tile containing it
+            double closest[2], distance = 0.0;
+            for (UInt dim = 0; dim < 2; ++dim)
+            {
+              closest[dim] = std::min(std::max(pos[dim], box.minPosition()[dim]), box.maxPosition()[dim]);
+              const double diff = (pos[dim] - closest[dim]) / scale[dim];
+              distance += diff * diff;
+            }
+            if (SignedSize(tileOf_(closest[0], 0)) != rt_tile || SignedSize(tileOf_(closest[1], 1)) != mz_tile) continue;
+
+            const std::pair<double, Size> candidate(distance, item);
+            if (best.size() < k)
+            {
+              best.push(candidate);
+            }
+            else if (candidate < best.top())
+            {
+              best.pop();
+              best.push(candidate);
+            }
+          }
+        }
+      }
+
+      // lower bound on the distance of all items in tiles not visited yet
+      double bound = numeric_limits<double>::max();
+      bool done = true;
+      for (UInt dim = 0; dim < 2; ++dim)
+      {
+        if (lo[dim] > 0)
+        {
+          const double border = grid_area_.minPosition()[dim] + lo[dim] * tile_size_[dim];
+          bound = std::min(bound, std::max(pos[dim] - border, 0.0) / scale[dim]);
+          done = false;
+        }
+        if (hi[dim] + 1 < count[dim])
+        {
+          const double border = grid_area_.minPosition()[dim] + (hi[dim] + 1) * tile_size_[dim];
+          bound = std::min(bound, std::max(border - pos[dim], 0.0) / scale[dim]);
+          done = false;
+        }
+      }
+      if (done || (best.size() == k && best.top().first < bound * bound))
+      {
+        break;
+      }
+    }
+
+    items.resize(best.size());
+    for (Size i = best.size(); i > 0; --i)
+    {
+      items[i - 1] = best.top().second;
+      best.pop();
+    }
+  }
+
+} // namespace OpenMS
@@ -18,6 +18,7 @@ MRMFeature.cpp
 MRMTransitionGroup.cpp
 MSExperiment.cpp
 MSSpectrum.cpp
+MSSpectrumArrays.cpp
 OnDiscMSExperiment.cpp
 Peak1D.cpp
 Peak2D.cpp
@@ -25,6 +26,7 @@ PeakIndex.cpp
 RangeManager.cpp
 RichPeak1D.cpp
 RichPeak2D.cpp
+SpatialIndex2D.cpp
 StandardTypes.cpp
 ChromatogramPeak.cpp
 MSChromatogram.cpp
@@ -0,0 +1,139 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/MATH/MISC/FFT.h>
+
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <cmath>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace Math
+  {
+
+    Size FFT::nextPowerOfTwo(Size n)
+    {
+      Size result = 1;
+      while (result < n)
+      {
+        result <<= 1;
+      }
+      return result;
+    }
+
+    void FFT::transform(std::vector<std::complex<double> >& data, bool inverse)
+    {
+      const Size n = data.size();
+      if (n == 0 || (n & (n - 1)) != 0)
+      {
+        throw Exception::InvalidSize(__FILE__, __LINE__, __PRETTY_FUNCTION__, n);
+      }
+
+      // bit-reversal permutation
+      for (Size i = 1, j = 0; i < n; ++i)
+      {
+        Size bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+          j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+          swap(data[i], data[j]);
+        }
+      }
+
+      // butterflies (twiddle factors are computed directly for each length, to avoid accumulating rounding errors)
+      const double sign = inverse ? 1.0 : -1.0;
+      for (Size length = 2; length <= n; length <<= 1)
+      {
+        const Size half = length >> 1;
+        const double angle = sign * 2.0 * Constants::PI / length;
+        for (Size k = 0; k < half; ++k)
+        {
+          const complex<double> w(cos(angle * k), sin(angle * k));
+          for (Size i = k; i < n; i += length)
+          {
+            const complex<double> u = data[i];
+            const complex<double> v = data[i + half] * w;
+            data[i] = u + v;
+            data[i + half] = u - v;
+          }
+        }
+      }
+
+      if (inverse)
+      {
+        for (Size i = 0; i < n; ++i)
+        {
+          data[i] /= (double)n;
+        }
+      }
+    }
+
+    void FFT::convolve(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& result)
+    {
+      result.clear();
+      if (a.empty() || b.empty())
+      {
+        return;
+      }
+
+      const Size result_size = a.size() + b.size() - 1;
+      const Size n = nextPowerOfTwo(result_size);
+      vector<complex<double> > fa(a.begin(), a.end()), fb(b.begin(), b.end());
+      fa.resize(n);
+      fb.resize(n);
+      transform(fa);
+      transform(fb);
+      for (Size i = 0; i < n; ++i)
+      {
+        fa[i] *= fb[i];
+      }
+      transform(fa, true);
+
+      result.resize(result_size);
+      for (Size i = 0; i < result_size; ++i)
+      {
+        result[i] = fa[i].real();
+      }
+    }
+
+  }
+}
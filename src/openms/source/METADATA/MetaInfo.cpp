@@ -34,6 +34,9 @@
 
 #include <OpenMS/METADATA/MetaInfo.h>
 
+#include <algorithm>
+#include <new>
+
 using namespace std;
 
 namespace OpenMS
@@ -41,17 +44,24 @@ namespace OpenMS
 
   MetaInfoRegistry MetaInfo::registry_ = MetaInfoRegistry();
 
-  MetaInfo::MetaInfo()
+  MetaInfo::MetaInfo() :
+    entries_(reinterpret_cast<Entry_*>(&inline_storage_)),
+    size_(0),
+    capacity_(INLINE_CAPACITY)
   {
   }
 
-  MetaInfo::MetaInfo(const MetaInfo & rhs)
+  MetaInfo::MetaInfo(const MetaInfo & rhs) :
+    entries_(reinterpret_cast<Entry_*>(&inline_storage_)),
+    size_(0),
+    capacity_(INLINE_CAPACITY)
   {
     *this = rhs;
   }
 
   MetaInfo::~MetaInfo()
   {
+    destroy_();
   }
 
   MetaInfo & MetaInfo::operator=(const MetaInfo & rhs)
@@ -59,14 +69,20 @@ namespace OpenMS
     if (this == &rhs)
       return *this;
 
-    index_to_value_ = rhs.index_to_value_;
+    clear();
+    reserve_(rhs.size_);
+    for (UInt i = 0; i < rhs.size_; ++i)
+    {
+      new (entries_ + i) Entry_(rhs.entries_[i]);
+      ++size_;
+    }
 
     return *this;
   }
 
   bool MetaInfo::operator==(const MetaInfo & rhs) const
   {
-    return index_to_value_ == rhs.index_to_value_;
+    return size_ == rhs.size_ && std::equal(entries_, entries_ + size_, rhs.entries_);
   }
 
   bool MetaInfo::operator!=(const MetaInfo & rhs) const
@@ -74,20 +90,90 @@ namespace OpenMS
     return !(operator==(rhs));
   }
 
-  const DataValue & MetaInfo::getValue(const String & name) const
+  MetaInfo::Entry_ * MetaInfo::lowerBound_(UInt index) const
   {
-    map<UInt, DataValue>::const_iterator it = index_to_value_.find(registry_.getIndex(name));
-    if (it != index_to_value_.end())
+    Entry_ * first = entries_;
+    Size count = size_;
+    while (count > 0)
     {
-      return it->second;
+      Size step = count / 2;
+      if (first[step].first < index)
+      {
+        first += step + 1;
+        count -= step + 1;
+      }
+      else
+      {
+        count = step;
+      }
     }
-    return DataValue::EMPTY;
+    return first;
+  }
+
+  MetaInfo::Entry_ * MetaInfo::find_(UInt index) const
+  {
+    Entry_ * it = lowerBound_(index);
+    if (it != entries_ + size_ && it->first == index)
+    {
+      return it;
+    }
+    return 0;
+  }
+
+  void MetaInfo::reserve_(Size capacity)
+  {
+    if (capacity <= capacity_) return;
+
+    Entry_ * new_entries = static_cast<Entry_ *>(::operator new(capacity * sizeof(Entry_)));
+    Size constructed = 0;
+    try
+    {
+      for (; constructed < size_; ++constructed)
+      {
+        new (new_entries + constructed) Entry_(entries_[constructed]);
+      }
+    }
+    catch (...)
+    {
+      for (Size i = 0; i < constructed; ++i)
+      {
+        new_entries[i].~Entry_();
+      }
+      ::operator delete(new_entries);
+      throw;
+    }
+
+    UInt size = size_;
+    destroy_();
+    entries_ = new_entries;
+    size_ = size;
+    capacity_ = (UInt)capacity;
+  }
+
+  void MetaInfo::destroy_()
+  {
+    for (UInt i = 0; i < size_; ++i)
+    {
+      entries_[i].~Entry_();
+    }
+    if (entries_ != reinterpret_cast<Entry_*>(&inline_storage_))
+    {
+      ::operator delete(entries_);
+      entries_ = reinterpret_cast<Entry_*>(&inline_storage_);
+      capacity_ = INLINE_CAPACITY;
+    }
+    size_ = 0;
+  }
+
+  const DataValue & MetaInfo::getValue(const String & name) const
+  {
+    return getValue(registry_.getIndex(name));
   }
 
   const DataValue & MetaInfo::getValue(UInt index) const
   {
-    map<UInt, DataValue>::const_iterator it = index_to_value_.find(index);
-    if (it != index_to_value_.end())
+    const Entry_ * it = find_(index);
+    if (it != 0)
     {
       return it->second;
     }
@@ -97,13 +183,40 @@ namespace OpenMS
   void MetaInfo::setValue(const String & name, const DataValue & value)
   {
     UInt index = registry_.registerName(name); // no-op if name is already registered
-    index_to_value_[index] = value;
+    setValue(index, value);
   }
 
   void MetaInfo::setValue(UInt index, const DataValue & value)
   {
     // @TODO: check if that index is registered in MetaInfoRegistry?
-    index_to_value_[index] = value;
+    Entry_ * it = lowerBound_(index);
+    if (it != entries_ + size_ && it->first == index)
+    {
+      it->second = value;
+      return;
+    }
+
+    // copy first: 'value' might refer to an entry which is moved below
+    Entry_ entry(index, value);
+    Size pos = it - entries_;
+    if (size_ == capacity_)
+    {
+      reserve_(2 * capacity_);
+    }
+    Entry_ * end = entries_ + size_;
+    if (pos == size_)
+    {
+      new (end) Entry_(entry);
+      ++size_;
+    }
+    else
+    {
+      // shift the entries behind the insert position by one
+      new (end) Entry_(*(end - 1));
+      ++size_;
+      std::copy_backward(entries_ + pos, end - 1, end);
+      entries_[pos] = entry;
+    }
   }
 
   MetaInfoRegistry & MetaInfo::registry()
@@ -116,62 +229,62 @@ namespace OpenMS
     UInt index = registry_.getIndex(name);
     if (index != UInt(-1))
     {
-      return (index_to_value_.find(index) != index_to_value_.end());
+      return find_(index) != 0;
     }
     return false;
   }
 
   bool MetaInfo::exists(UInt index) const
   {
-    return (index_to_value_.find(index) != index_to_value_.end());
+    return find_(index) != 0;
   }
 
   void MetaInfo::removeValue(const String & name)
   {
-    map<UInt, DataValue>::iterator it = index_to_value_.find(registry_.getIndex(name));
-    if (it != index_to_value_.end())
-    {
-      index_to_value_.erase(it);
-    }
+    removeValue(registry_.getIndex(name));
   }
 
   void MetaInfo::removeValue(UInt index)
   {
-    map<UInt, DataValue>::iterator it = index_to_value_.find(index);
-    if (it != index_to_value_.end())
+    Entry_ * it = find_(index);
+    if (it != 0)
     {
-      index_to_value_.erase(it);
+      std::copy(it + 1, entries_ + size_, it);
+      --size_;
+      entries_[size_].~Entry_();
     }
   }
 
   void MetaInfo::getKeys(vector<String> & keys) const
   {
-    keys.resize(index_to_value_.size());
-    UInt i = 0;
-    for (map<UInt, DataValue>::const_iterator it = index_to_value_.begin(); it != index_to_value_.end(); ++it)
+    keys.resize(size_);
+    for (UInt i = 0; i < size_; ++i)
     {
-      keys[i++] = registry_.getName(it->first);
+      keys[i] = registry_.getName(entries_[i].first);
     }
   }
 
   void MetaInfo::getKeys(vector<UInt> & keys) const
   {
-    keys.resize(index_to_value_.size());
-    UInt i = 0;
-    for (map<UInt, DataValue>::const_iterator it = index_to_value_.begin(); it != index_to_value_.end(); ++it)
+    keys.resize(size_);
+    for (UInt i = 0; i < size_; ++i)
     {
-      keys[i++] = it->first;
+      keys[i] = entries_[i].first;
     }
   }
 
   bool MetaInfo::empty() const
   {
-    return index_to_value_.empty();
+    return size_ == 0;
   }
 
   void MetaInfo::clear()
   {
-    index_to_value_.clear();
+    for (UInt i = 0; i < size_; ++i)
+    {
+      entries_[i].~Entry_();
+    }
+    size_ = 0;
   }
 
 } //namespace
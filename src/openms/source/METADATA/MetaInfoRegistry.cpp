@@ -32,8 +32,6 @@
 // $Authors: Marc Sturm, Hendrik Weisser $
 // -------------------------------------------------------------------------
 
-#include <sstream>
-
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 
 using namespace std;
@@ -41,82 +39,70 @@ using namespace std;
 namespace OpenMS
 {
 
-  MetaInfoRegistry::MetaInfoRegistry() :
-    next_index_(1024), name_to_index_(), index_to_name_(), index_to_description_(), index_to_unit_()
+  namespace
   {
-    name_to_index_["isotopic_range"] = 1;
-    index_to_name_[1] = "isotopic_range";
-    index_to_description_[1] = "consecutive numbering of the peaks in an isotope pattern. 0 is the monoisotopic peak";
-    index_to_unit_[1] = "";
-
-    name_to_index_["cluster_id"] = 2;
-    index_to_name_[2] = "cluster_id";
-    index_to_description_[2] = "consecutive numbering of isotope clusters in a spectrum";
-    index_to_unit_[2] = "";
-
-    name_to_index_["label"] = 3;
-    index_to_name_[3] = "label";
-    index_to_description_[3] = "label e.g. shown in visialization";
-    index_to_unit_[3] = "";
-
-    name_to_index_["icon"] = 4;
-    index_to_name_[4] = "icon";
-    index_to_description_[4] = "icon shown in visialization";
-    index_to_unit_[4] = "";
-
-    name_to_index_["color"] = 5;
-    index_to_name_[5] = "color";
-    index_to_description_[5] = "color used for visialization e.g. #FF00FF for purple";
-    index_to_unit_[5] = "";
-
-    name_to_index_["RT"] = 6;
-    index_to_name_[6] = "RT";
-    index_to_description_[6] = "the retention time of an identification";
-    index_to_unit_[6] = "";
-
-    name_to_index_["MZ"] = 7;
-    index_to_name_[7] = "MZ";
-    index_to_description_[7] = "the MZ of an identification";
-    index_to_unit_[7] = "";
-
-    name_to_index_["predicted_RT"] = 8;
-    index_to_name_[8] = "predicted_RT";
-    index_to_description_[8] = "the predicted retention time of a peptide hit";
-    index_to_unit_[8] = "";
-
-    name_to_index_["predicted_RT_p_value"] = 9;
-    index_to_name_[9] = "predicted_RT_p_value";
-    index_to_description_[9] = "the predicted RT p-value of a peptide hit";
-    index_to_unit_[9] = "";
-
-    name_to_index_["spectrum_reference"] = 10;
-    index_to_name_[10] = "spectrum_reference";
-    index_to_description_[10] = "Refenference to a spectrum or feature number";
-    index_to_unit_[10] = "";
-
-    name_to_index_["ID"] = 11;
-    index_to_name_[11] = "ID";
-    index_to_description_[11] = "Some type of identifier";
-    index_to_unit_[11] = "";
-
-    name_to_index_["low_quality"] = 12;
-    index_to_name_[12] = "low_quality";
-    index_to_description_[12] = "Flag which indicatest that some entity has a low quality (e.g. a feature pair)";
-    index_to_unit_[12] = "";
-
-    name_to_index_["charge"] = 13;
-    index_to_name_[13] = "charge";
-    index_to_description_[13] = "Charge of a feature or peak";
-    index_to_unit_[13] = "";
+    /**
+      @brief Reads a published value (pointer or index), paired with storeRelease()
+
+      The flush after the read orders all subsequent reads of the data the
+      value refers to after the read of the value itself. With OpenMP 3.1 the
+      read is atomic as well.
+    */
+    template <typename T>
+    inline T loadAcquire(const T volatile& src)
+    {
+      T value;
+#if defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp atomic read
+      value = src;
+#else
+      value = src;
+#endif
+#pragma omp flush
+      return value;
+    }
+
+    /// Publishes a value after all data it refers to has been written (see loadAcquire())
+    template <typename T>
+    inline void storeRelease(T volatile& dst, T value)
+    {
+#pragma omp flush
+#if defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp atomic write
+      dst = value;
+#else
+      dst = value;
+#endif
+    }
+  }
+
+  MetaInfoRegistry::MetaInfoRegistry()
+  {
+    init_();
+    insert_(1, "isotopic_range", "consecutive numbering of the peaks in an isotope pattern. 0 is the monoisotopic peak", "");
+    insert_(2, "cluster_id", "consecutive numbering of isotope clusters in a spectrum", "");
+    insert_(3, "label", "label e.g. shown in visialization", "");
+    insert_(4, "icon", "icon shown in visialization", "");
+    insert_(5, "color", "color used for visialization e.g. #FF00FF for purple", "");
+    insert_(6, "RT", "the retention time of an identification", "");
+    insert_(7, "MZ", "the MZ of an identification", "");
+    insert_(8, "predicted_RT", "the predicted retention time of a peptide hit", "");
+    insert_(9, "predicted_RT_p_value", "the predicted RT p-value of a peptide hit", "");
+    insert_(10, "spectrum_reference", "Refenference to a spectrum or feature number", "");
+    insert_(11, "ID", "Some type of identifier", "");
+    insert_(12, "low_quality", "Flag which indicatest that some entity has a low quality (e.g. a feature pair)", "");
+    insert_(13, "charge", "Charge of a feature or peak", "");
   }
 
   MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs)
   {
+    init_();
     *this = rhs;
   }
 
   MetaInfoRegistry::~MetaInfoRegistry()
   {
+    clear_();
   }
 
   MetaInfoRegistry& MetaInfoRegistry::operator=(const MetaInfoRegistry& rhs)
@@ -125,201 +111,303 @@ namespace OpenMS
 
 #pragma omp critical (MetaInfoRegistry)
     {
+      clear_();
+      init_();
+      for (UInt b = 0; b < MAX_BLOCKS; ++b)
+      {
+        if (rhs.blocks_[b] == 0) continue;
+        for (UInt i = 0; i < BLOCK_SIZE; ++i)
+        {
+          const Entry_* entry = rhs.blocks_[b][i];
+          if (entry != 0)
+          {
+            insert_(b * BLOCK_SIZE + i, entry->name, entry->description, entry->unit);
+          }
+        }
+      }
       next_index_ = rhs.next_index_;
-      name_to_index_ = rhs.name_to_index_;
-      index_to_name_ = rhs.index_to_name_;
-      index_to_description_ = rhs.index_to_description_;
-      index_to_unit_ = rhs.index_to_unit_;
     }
     return *this;
   }
 
-  UInt MetaInfoRegistry::registerName(const String& name, const String& description, const String& unit)
+  void MetaInfoRegistry::init_()
   {
-    UInt rv;
-#pragma omp critical (MetaInfoRegistry)
+    next_index_ = 1024;
+    name_count_ = 0;
+    for (UInt b = 0; b < MAX_BLOCKS; ++b)
     {
-      map<String, UInt>::iterator it = name_to_index_.find(name);
-      if (it == name_to_index_.end())
-      {
-        name_to_index_[name] = next_index_;
-        index_to_name_[next_index_] = name;
-        index_to_description_[next_index_] = description;
-        index_to_unit_[next_index_] = unit;
-        rv = next_index_++;
-      }
-      else
-      {
-        rv = it->second;
-      }
+      blocks_[b] = 0;
     }
-    return rv;
+    NameTable_* table = new NameTable_;
+    table->mask = 63;
+    table->slots = new volatile UInt[table->mask + 1]();
+    name_table_ = table;
   }
 
-  void MetaInfoRegistry::setDescription(UInt index, const String& description)
+  void MetaInfoRegistry::clear_()
   {
-    map<UInt, String>::iterator pos;
-#pragma omp critical (MetaInfoRegistry)
+    for (UInt b = 0; b < MAX_BLOCKS; ++b)
     {
-      pos = index_to_description_.find(index);
-      if (pos != index_to_description_.end())
+      if (blocks_[b] == 0) continue;
+      for (UInt i = 0; i < BLOCK_SIZE; ++i)
       {
-        pos->second = description;
+        delete blocks_[b][i];
       }
-      else
+      delete[] blocks_[b];
+      blocks_[b] = 0;
+    }
+    NameTable_* table = name_table_;
+    retired_name_tables_.push_back(table);
+    for (Size i = 0; i < retired_name_tables_.size(); ++i)
+    {
+      delete[] retired_name_tables_[i]->slots;
+      delete retired_name_tables_[i];
+    }
+    retired_name_tables_.clear();
+    name_table_ = 0;
+    name_count_ = 0;
+  }
+
+  UInt MetaInfoRegistry::hash_(const String& name)
+  {
+    // FNV-1a
+    UInt hash = 2166136261u;
+    for (String::const_iterator it = name.begin(); it != name.end(); ++it)
+    {
+      hash ^= (unsigned char)*it;
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+
+  void MetaInfoRegistry::insertIntoTable_(NameTable_* table, const String& name, UInt index)
+  {
+    UInt pos = hash_(name) & table->mask;
+    while (table->slots[pos] != 0)
+    {
+      pos = (pos + 1) & table->mask;
+    }
+    storeRelease(table->slots[pos], index);
+  }
+
+  void MetaInfoRegistry::insert_(UInt index, const String& name, const String& description, const String& unit)
+  {
+    UInt block = index / BLOCK_SIZE;
+    if (blocks_[block] == 0)
+    {
+      storeRelease(blocks_[block], new EntryPtr_[BLOCK_SIZE]());
+    }
+
+    Entry_* entry = new Entry_;
+    entry->name = name;
+    entry->description = description;
+    entry->unit = unit;
+    // the entry has to be complete before it becomes visible to readers
+    storeRelease(blocks_[block][index % BLOCK_SIZE], entry);
+
+    // keep the hash table at most half full; readers still using the old
+    // table either find the name there or do not know it yet
+    NameTable_* table = name_table_;
+    if (2 * (name_count_ + 1) > table->mask + 1)
+    {
+      NameTable_* new_table = new NameTable_;
+      new_table->mask = 2 * table->mask + 1;
+      new_table->slots = new volatile UInt[new_table->mask + 1]();
+      for (UInt pos = 0; pos <= table->mask; ++pos)
       {
-        throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
+        UInt old_index = table->slots[pos];
+        if (old_index != 0)
+        {
+          insertIntoTable_(new_table, findEntry_(old_index)->name, old_index);
+        }
       }
+      storeRelease(name_table_, new_table);
+      retired_name_tables_.push_back(table);
+      table = new_table;
     }
+
+    insertIntoTable_(table, name, index);
+    ++name_count_;
   }
 
-  void MetaInfoRegistry::setDescription(const String& name, const String& description)
+  const MetaInfoRegistry::Entry_* MetaInfoRegistry::findEntry_(UInt index) const
   {
-    map<String, UInt>::iterator pos;
-#pragma omp critical (MetaInfoRegistry)
+    if (index / BLOCK_SIZE >= MAX_BLOCKS)
+    {
+      return 0;
+    }
+    const EntryPtr_* block = loadAcquire(blocks_[index / BLOCK_SIZE]);
+    if (block == 0)
     {
-      pos = name_to_index_.find(name);
-      if (pos != name_to_index_.end())
+      return 0;
+    }
+    return loadAcquire(block[index % BLOCK_SIZE]);
+  }
+
+  UInt MetaInfoRegistry::findIndex_(const String& name) const
+  {
+    const NameTable_* table = loadAcquire(name_table_);
+    UInt pos = hash_(name) & table->mask;
+    while (true)
+    {
+      UInt index = loadAcquire(table->slots[pos]);
+      if (index == 0)
       {
-        index_to_description_[pos->second] = description;
+        return UInt(-1);
       }
-      else
+      if (findEntry_(index)->name == name)
       {
-        throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered name!", name);
+        return index;
       }
+      pos = (pos + 1) & table->mask;
     }
   }
 
-  void MetaInfoRegistry::setUnit(UInt index, const String& unit)
+  UInt MetaInfoRegistry::registerName(const String& name, const String& description, const String& unit)
   {
-    map<UInt, String>::iterator pos;
+    // fast path for names which are already registered
+    UInt rv = findIndex_(name);
+    if (rv != UInt(-1))
+    {
+      return rv;
+    }
+
+    // exceptions must not leave the critical section, the overflow is reported afterwards
+    bool overflow = false;
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = index_to_unit_.find(index);
-      if (pos != index_to_unit_.end())
+      // the name might have been registered by another thread in the meantime
+      rv = findIndex_(name);
+      if (rv == UInt(-1))
       {
-        pos->second = unit;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
+        if (next_index_ / BLOCK_SIZE >= MAX_BLOCKS)
+        {
+          overflow = true;
+        }
+        else
+        {
+          insert_(next_index_, name, description, unit);
+          rv = next_index_++;
+        }
       }
     }
+    if (overflow)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, __PRETTY_FUNCTION__, MAX_BLOCKS * BLOCK_SIZE, MAX_BLOCKS * BLOCK_SIZE);
+    }
+    return rv;
   }
 
-  void MetaInfoRegistry::setUnit(const String& name, const String& unit)
+  void MetaInfoRegistry::setDescription(UInt index, const String& description)
   {
-    map<String, UInt>::iterator pos;
+    const Entry_* entry = findEntry_(index);
+    if (entry == 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = name_to_index_.find(name);
-      if (pos != name_to_index_.end())
-      {
-        index_to_unit_[pos->second] = unit;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered name!", name);
-      }
+      const_cast<Entry_*>(entry)->description = description;
     }
   }
 
-  UInt MetaInfoRegistry::getIndex(const String& name) const
+  void MetaInfoRegistry::setDescription(const String& name, const String& description)
   {
-    UInt rv = UInt(-1);
+    UInt index = findIndex_(name);
+    if (index == UInt(-1))
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered name!", name);
+    }
+    setDescription(index, description);
+  }
+
+  void MetaInfoRegistry::setUnit(UInt index, const String& unit)
+  {
+    const Entry_* entry = findEntry_(index);
+    if (entry == 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      map<String, UInt>::const_iterator it = name_to_index_.find(name);
-      if (it != name_to_index_.end())
-      {
-        rv = it->second;
-      }
+      const_cast<Entry_*>(entry)->unit = unit;
     }
-    return rv;
+  }
+
+  void MetaInfoRegistry::setUnit(const String& name, const String& unit)
+  {
+    UInt index = findIndex_(name);
+    if (index == UInt(-1))
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered name!", name);
+    }
+    setUnit(index, unit);
+  }
+
+  UInt MetaInfoRegistry::getIndex(const String& name) const
+  {
+    return findIndex_(name);
   }
 
   String MetaInfoRegistry::getDescription(UInt index) const
   {
+    const Entry_* entry = findEntry_(index);
+    if (entry == 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
+    }
     String result;
 #pragma omp critical (MetaInfoRegistry)
     {
-      map<UInt, String>::const_iterator it = index_to_description_.find(index);
-      if (it == index_to_description_.end())
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
-      }
-      result = it->second;
+      result = entry->description;
     }
     return result;
   }
 
   String MetaInfoRegistry::getDescription(const String& name) const
   {
-    String rv;
-    UInt index = getIndex(name); // this has to be outside the OpenMP "critical" block!
-    if (index == UInt(-1)) // not found
+    UInt index = findIndex_(name);
+    if (index == UInt(-1))
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered Name!", name);
     }
-    else
-    {
-#pragma omp critical (MetaInfoRegistry)
-      {
-        rv = (index_to_description_.find(index))->second;
-      }
-    }
-    return rv;
+    return getDescription(index);
   }
 
   String MetaInfoRegistry::getUnit(UInt index) const
   {
+    const Entry_* entry = findEntry_(index);
+    if (entry == 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
+    }
     String result;
 #pragma omp critical (MetaInfoRegistry)
     {
-      map<UInt, String>::const_iterator it = index_to_unit_.find(index);
-      if (it == index_to_unit_.end())
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
-      }
-      result = it->second;
+      result = entry->unit;
     }
     return result;
   }
 
   String MetaInfoRegistry::getUnit(const String& name) const
   {
-    String rv;
-    UInt index = getIndex(name); // this has to be outside the OpenMP "critical" block!
-    if (index == UInt(-1)) // not found
+    UInt index = findIndex_(name);
+    if (index == UInt(-1))
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered Name!", name);
     }
-    else
-    {
-#pragma omp critical (MetaInfoRegistry)
-      {
-        rv = (index_to_unit_.find(index))->second;
-      }
-    }
-    return rv;
+    return getUnit(index);
   }
 
   String MetaInfoRegistry::getName(UInt index) const
   {
-    String rv;
-#pragma omp critical (MetaInfoRegistry)
+    const Entry_* entry = findEntry_(index);
+    if (entry == 0)
     {
-      map<UInt, String>::const_iterator it = index_to_name_.find(index);
-      if (it != index_to_name_.end())
-      {
-        rv = it->second;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
-      }
+      throw Exception::InvalidValue(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Unregistered index!", String(index));
     }
-    return rv;
+    // names never change once registered
+    return entry->name;
   }
 
 } //namespace
@@ -504,6 +504,9 @@ protected:
 
     /// check if all available preferences get set by the .ini file. If there are some missing entries fill them with default values.
     void checkPreferences_();
+
+    /// Replaces @p old_data by @p new_data in all @p layers that share @p old_data (after the file was reloaded)
+    void replacePeakData_(const std::vector<std::pair<const SpectrumWidget*, Size> >& layers, LayerData::ExperimentSharedPtrType old_data, const LayerData::ExperimentSharedPtrType& new_data);
     ///@name reimplemented Qt events
     //@{
     void closeEvent(QCloseEvent* event);
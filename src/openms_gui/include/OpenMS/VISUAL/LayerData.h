@@ -41,13 +41,17 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
 #include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/SpatialIndex2D.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/VISUAL/MultiGradient.h>
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
 #include <OpenMS/VISUAL/ANNOTATION/Annotations1DContainer.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/DataFilters.h>
 
 #include <boost/shared_ptr.hpp>
 
+#include <QtCore/QFuture>
+
 #include <vector>
 #include <bitset>
 
@@ -122,6 +126,9 @@ public:
     /// SharedPtr on MSExperiment
     typedef boost::shared_ptr<ExperimentType> ExperimentSharedPtrType;
 
+    /// SharedPtr on the maximum intensity pyramid of the peak data
+    typedef boost::shared_ptr<const MaxIntensityPyramid> PyramidSharedPtrType;
+
     //@}
 
     /// Default constructor
@@ -136,6 +143,8 @@ public:
       param(),
       gradient(),
       filters(),
+      pyramid(),
+      centroid_index(),
       annotations_1d(),
       modifiable(false),
       modified(false),
@@ -295,6 +304,17 @@ public:
     /// Filters to apply before painting
     DataFilters filters;
 
+    /**
+      @brief Maximum intensity pyramid of the peak data (computed in the background for large maps, 2D view)
+
+      The background computation reads the peak data, so it must not be modified in place
+      meanwhile. Replace the shared pointer instead (see SpectrumCanvas::setLayerPeakData()).
+    */
+    QFuture<PyramidSharedPtrType> pyramid;
+
+    /// Index of the (consensus) feature centroids (built on demand in the 2D view, reset when the layer is modified)
+    boost::shared_ptr<const SpatialIndex2D> centroid_index;
+
     /// Annotations of all spectra of the experiment (1D view)
     std::vector<Annotations1DContainer> annotations_1d;
 
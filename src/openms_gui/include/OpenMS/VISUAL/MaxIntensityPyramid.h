@@ -0,0 +1,175 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_VISUAL_MAXINTENSITYPYRAMID_H
+#define OPENMS_VISUAL_MAXINTENSITYPYRAMID_H
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+//OpenMS
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+//STL
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+      @brief Precomputed maximum intensities of a peak map at several resolutions.
+
+      Used by Spectrum2DCanvas to draw large peak maps without touching every
+      peak in the visible area on each repaint. The MS1 peaks are binned into a
+      grid of rows (groups of consecutive MS1 scans) and uniform m/z bins, and
+      the maximum intensity of each cell is stored. Each further level halves
+      the resolution in both dimensions, so a query for the current zoom only
+      has to look at about as many cells as there are pixels (see query()).
+
+      The finest level has at most @p max_rows rows and @p max_mz_bins m/z
+      bins (see build()). If the visible area is zoomed in further, the
+      pyramid cannot answer the query and the peaks have to be drawn directly.
+
+      The pyramid can be stored to disk (see store() and getCacheFilename())
+      and loaded again for the same peak map (see load()).
+
+      @ingroup Visual
+  */
+  class OPENMS_GUI_DLLAPI MaxIntensityPyramid
+  {
+public:
+    /// Default constructor (empty pyramid)
+    MaxIntensityPyramid();
+
+    /**
+      @brief Builds the pyramid from the MS1 spectra of @p map
+
+      The spectra have to be sorted by RT and their peaks by m/z.
+
+      @param map The peak map
+      @param max_rows Maximum number of rows (groups of MS1 scans) in the finest level
+      @param max_mz_bins Maximum number of m/z bins in the finest level
+    */
+    void build(const MSExperiment<>& map, Size max_rows = 2048, Size max_mz_bins = 4096);
+
+    /// Removes all data
+    void clear();
+
+    /// Returns true if the pyramid contains no data
+    bool empty() const;
+
+    /**
+      @brief Returns true if the pyramid was built from a map with the same MS1 scans as @p map
+
+      Compares the retention times of the MS1 scans, the number of MS1 peaks
+      and the m/z range.
+    */
+    bool isValidFor(const MSExperiment<>& map) const;
+
+    /// Returns the number of levels (0 for an empty pyramid)
+    Size getNumberOfLevels() const;
+
+    /// Returns the number of rows of level @p level
+    Size getRowCount(Size level) const;
+
+    /// Returns the number of m/z bins of level @p level
+    Size getMZBinCount(Size level) const;
+
+    /// Returns the maximum intensity of a cell (-1 if the cell contains no peaks)
+    float getMaximum(Size level, Size row, Size mz_bin) const;
+
+    /**
+      @brief Computes the maximum intensity for each pixel of an image of the given area
+
+      The area [@p rt_min, @p rt_max) x [@p mz_min, @p mz_max) is divided
+      into @p rt_pixels x @p mz_pixels pixels. The result is stored row-wise
+      (RT pixels, then m/z pixels) in @p image, with -1 for pixels without
+      peaks. The coarsest level that still resolves the pixels is used; a cell
+      is attributed to the pixel containing the RT of its first scan and the
+      center of its m/z bin.
+
+      @return false (and @p image is not filled) if the pyramid is empty or
+      even its finest level is too coarse for the requested pixels.
+    */
+    bool query(double rt_min, double rt_max, Size rt_pixels, double mz_min, double mz_max, Size mz_pixels, std::vector<float>& image) const;
+
+    /**
+      @brief Stores the pyramid in a binary file (native byte order)
+
+      @exception Exception::UnableToCreateFile if the file cannot be written
+    */
+    void store(const String& filename) const;
+
+    /**
+      @brief Loads a pyramid stored with store() if it is valid for @p map (see isValidFor())
+
+      @return false if the file does not exist, is not a valid pyramid file or
+      belongs to a different map (the pyramid is empty then).
+    */
+    bool load(const String& filename, const MSExperiment<>& map);
+
+    /// Returns the name of the cache file for the data file @p filename
+    static String getCacheFilename(const String& filename);
+
+protected:
+
+    /// Collects the RTs of all MS1 scans, their number of peaks and their m/z range
+    static void collectMS1Info_(const MSExperiment<>& map, std::vector<double>& rts, UInt64& peak_count, double& mz_min, double& mz_max);
+
+    /// Computes all levels from the finest one
+    void buildCoarseLevels_();
+
+    /// RTs of all MS1 scans
+    std::vector<double> scan_rts_;
+    /// number of MS1 peaks
+    UInt64 peak_count_;
+    /// m/z range of the MS1 peaks
+    double mz_min_;
+    double mz_max_;
+    /// number of MS1 scans per row in the finest level
+    Size scans_per_row_;
+    /// m/z width of a bin in the finest level
+    double mz_bin_width_;
+    /// number of rows of each level
+    std::vector<Size> rows_;
+    /// number of m/z bins of each level
+    std::vector<Size> mz_bins_;
+    /// maximum intensities of each level (row-wise)
+    std::vector<std::vector<float> > levels_;
+  };
+
+}
+
+#endif // OPENMS_VISUAL_MAXINTENSITYPYRAMID_H
@@ -139,6 +139,9 @@ protected slots:
     /// Reacts on changed layer parameters
     void currentLayerParametersChanged_();
 
+    /// Repaints after a maximum intensity pyramid was computed in the background
+    void pyramidFinished_();
+
 protected:
     // Docu in base class
     bool finishAdding_();
@@ -188,6 +191,20 @@ protected:
     */
     void paintMaximumIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter& p);
 
+    /**
+      @brief Paints maximum intensities using the precomputed pyramid of the layer (see LayerData::pyramid).
+
+      @return false (nothing painted) if the pyramid is not available yet, does not fit
+      the current data, cannot resolve the pixels or data filters are active.
+    */
+    bool paintMaximumIntensitiesFromPyramid_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count);
+
+    /// Starts computing the maximum intensity pyramid of a (large) peak layer in the background
+    void startPyramidComputation_(Size layer_index);
+
+    /// Returns the centroid index of the current (consensus) feature layer (see LayerData::centroid_index), building it if necessary
+    const SpatialIndex2D& getCentroidIndex_();
+
     /**
       @brief Paints the precursor peaks.
 
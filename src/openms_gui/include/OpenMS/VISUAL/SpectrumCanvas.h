@@ -600,6 +600,18 @@ public slots:
     ///Updates layer @p i when the data in the corresponding file changes
     virtual void updateLayer(Size i) = 0;
 
+    /**
+        @brief Replaces the peak data of layer @p i by @p data (e.g. when the file was reloaded)
+
+        The old data is not modified, as it may still be read in the background (see Spectrum2DCanvas).
+        Call updateLayer() afterwards.
+    */
+    inline void setLayerPeakData(Size i, const ExperimentSharedPtrType & data)
+    {
+      OPENMS_PRECONDITION(i < layers_.size(), "SpectrumCanvas::setLayerPeakData(i, data) index overflow");
+      layers_[i].getPeakData() = data;
+    }
+
 signals:
 
     /// Signal emitted whenever the modification status of a layer changes (editing and storing)
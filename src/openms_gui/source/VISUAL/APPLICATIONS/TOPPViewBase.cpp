@@ -3852,6 +3852,18 @@ namespace OpenMS
     updateViewBar();
   }
 
+  void TOPPViewBase::replacePeakData_(const std::vector<std::pair<const SpectrumWidget*, Size> >& layers, LayerData::ExperimentSharedPtrType old_data, const LayerData::ExperimentSharedPtrType& new_data)
+  {
+    for (Size i = 0; i != layers.size(); ++i)
+    {
+      SpectrumCanvas* canvas = layers[i].first->canvas();
+      if (canvas->getLayer(layers[i].second).getPeakData() == old_data)
+      {
+        canvas->setLayerPeakData(layers[i].second, new_data);
+      }
+    }
+  }
+
   void TOPPViewBase::fileChanged_(const String& filename)
   {
     // check if file has been deleted
@@ -3935,17 +3947,21 @@ namespace OpenMS
         // reload data
         if (layer.type == LayerData::DT_PEAK) //peak data
         {
+          // load into a new map: the old one must not be modified, as it may still be read
+          // in the background (maximum intensity pyramid of the 2D view)
+          LayerData::ExperimentSharedPtrType peaks(new LayerData::ExperimentType());
           try
           {
-            FileHandler().loadExperiment(layer.filename, *layer.getPeakData());
+            FileHandler().loadExperiment(layer.filename, *peaks);
           }
           catch (Exception::BaseException& e)
           {
             QMessageBox::critical(this, "Error", (String("Error while loading file") + layer.filename + "\nError message: " + e.what()).toQString());
-            layer.getPeakData()->clear(true);
+            peaks->clear(true);
           }
-          layer.getPeakData()->sortSpectra(true);
-          layer.getPeakData()->updateRanges(1);
+          peaks->sortSpectra(true);
+          peaks->updateRanges(1);
+          replacePeakData_(needs_update, layer.getPeakData(), peaks);
         }
         else if (layer.type == LayerData::DT_FEATURE) //feature data
         {
@@ -3976,17 +3992,19 @@ namespace OpenMS
         else if (layer.type == LayerData::DT_CHROMATOGRAM) //chromatgram
         {
           //TODO CHROM
+          LayerData::ExperimentSharedPtrType chromatograms(new LayerData::ExperimentType());
           try
           {
-            FileHandler().loadExperiment(layer.filename, *layer.getPeakData());
+            FileHandler().loadExperiment(layer.filename, *chromatograms);
           }
           catch (Exception::BaseException& e)
           {
             QMessageBox::critical(this, "Error", (String("Error while loading file") + layer.filename + "\nError message: " + e.what()).toQString());
-            layer.getPeakData()->clear(true);
+            chromatograms->clear(true);
           }
-          layer.getPeakData()->sortChromatograms(true);
-          layer.getPeakData()->updateRanges(1);
+          chromatograms->sortChromatograms(true);
+          chromatograms->updateRanges(1);
+          replacePeakData_(needs_update, layer.getPeakData(), chromatograms);
 
         }
         /*      else if (layer.type == LayerData::DT_IDENT) // identifications
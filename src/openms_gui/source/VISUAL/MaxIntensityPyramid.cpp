@@ -0,0 +1,435 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /// file header (followed by the MS1 scan RTs and the cells of the finest level)
+    struct PyramidHeader
+    {
+      char magic[8];
+      UInt64 byte_order;
+      UInt64 scan_count;
+      UInt64 peak_count;
+      double mz_min;
+      double mz_max;
+      UInt64 scans_per_row;
+      double mz_bin_width;
+      UInt64 rows;
+      UInt64 mz_bins;
+    };
+
+    const char PYRAMID_MAGIC[8] = {'O', 'M', 'S', 'P', 'Y', 'R', '0', '1'};
+
+    /// written in native byte order; reads back differently on a machine with another endianness
+    const UInt64 BYTE_ORDER_MARK = (UInt64(0x01020304) << 32) | UInt64(0x05060708);
+
+    /// Index of the first cell whose center lies at or right of @p position (clamped to [0, count])
+    Size firstCellFrom(double position, double origin, double width, Size count)
+    {
+      double c = std::ceil((position - origin) / width - 0.5);
+      if (c <= 0.0) return 0;
+      if (c >= double(count)) return count;
+      return Size(c);
+    }
+  }
+
+  MaxIntensityPyramid::MaxIntensityPyramid() :
+    scan_rts_(),
+    peak_count_(0),
+    mz_min_(0.0),
+    mz_max_(0.0),
+    scans_per_row_(1),
+    mz_bin_width_(1.0),
+    rows_(),
+    mz_bins_(),
+    levels_()
+  {
+  }
+
+  void MaxIntensityPyramid::collectMS1Info_(const MSExperiment<>& map, std::vector<double>& rts, UInt64& peak_count, double& mz_min, double& mz_max)
+  {
+    rts.clear();
+    peak_count = 0;
+    mz_min = numeric_limits<double>::max();
+    mz_max = -numeric_limits<double>::max();
+    for (MSExperiment<>::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      if (it->getMSLevel() != 1) continue;
+
+      rts.push_back(it->getRT());
+      if (!it->empty())
+      {
+        peak_count += it->size();
+        mz_min = std::min(mz_min, it->front().getMZ());
+        mz_max = std::max(mz_max, it->back().getMZ());
+      }
+    }
+    if (peak_count == 0)
+    {
+      mz_min = 0.0;
+      mz_max = 0.0;
+    }
+  }
+
+  void MaxIntensityPyramid::build(const MSExperiment<>& map, Size max_rows, Size max_mz_bins)
+  {
+    clear();
+    collectMS1Info_(map, scan_rts_, peak_count_, mz_min_, mz_max_);
+    if (peak_count_ == 0)
+    {
+      clear();
+      return;
+    }
+
+    max_rows = std::max(max_rows, Size(1));
+    max_mz_bins = std::max(max_mz_bins, Size(1));
+
+    scans_per_row_ = (scan_rts_.size() + max_rows - 1) / max_rows;
+    const Size rows = (scan_rts_.size() + scans_per_row_ - 1) / scans_per_row_;
+    Size mz_bins = max_mz_bins;
+    mz_bin_width_ = (mz_max_ - mz_min_) / mz_bins;
+    if (!(mz_bin_width_ > 0.0)) // all peaks have the same m/z
+    {
+      mz_bins = 1;
+      mz_bin_width_ = 1.0;
+    }
+
+    rows_.push_back(rows);
+    mz_bins_.push_back(mz_bins);
+    levels_.push_back(std::vector<float>(rows * mz_bins, -1.0f));
+
+    std::vector<float>& cells = levels_[0];
+    Size scan_index = 0;
+    for (MSExperiment<>::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      if (it->getMSLevel() != 1) continue;
+
+      float* row = &cells[(scan_index / scans_per_row_) * mz_bins];
+      for (MSSpectrum<>::ConstIterator peak = it->begin(); peak != it->end(); ++peak)
+      {
+        const double pos = (peak->getMZ() - mz_min_) / mz_bin_width_;
+        const Size bin = (pos <= 0.0) ? 0 : std::min(Size(pos), mz_bins - 1);
+        if (peak->getIntensity() > row[bin])
+        {
+          row[bin] = peak->getIntensity();
+        }
+      }
+      ++scan_index;
+    }
+
+    buildCoarseLevels_();
+  }
+
+  void MaxIntensityPyramid::buildCoarseLevels_()
+  {
+    rows_.resize(1);
+    mz_bins_.resize(1);
+    levels_.resize(1);
+    while (rows_.back() > 1 || mz_bins_.back() > 1)
+    {
+      const Size fine_rows = rows_.back();
+      const Size fine_bins = mz_bins_.back();
+      const Size rows = (fine_rows + 1) / 2;
+      const Size bins = (fine_bins + 1) / 2;
+
+      std::vector<float> coarse(rows * bins, -1.0f);
+      const std::vector<float>& fine = levels_.back();
+      for (Size r = 0; r < fine_rows; ++r)
+      {
+        const float* fine_row = &fine[r * fine_bins];
+        float* coarse_row = &coarse[(r / 2) * bins];
+        for (Size b = 0; b < fine_bins; ++b)
+        {
+          coarse_row[b / 2] = std::max(coarse_row[b / 2], fine_row[b]);
+        }
+      }
+
+      rows_.push_back(rows);
+      mz_bins_.push_back(bins);
+      levels_.push_back(std::vector<float>());
+      levels_.back().swap(coarse);
+    }
+  }
+
+  void MaxIntensityPyramid::clear()
+  {
+    scan_rts_.clear();
+    peak_count_ = 0;
+    mz_min_ = 0.0;
+    mz_max_ = 0.0;
+    scans_per_row_ = 1;
+    mz_bin_width_ = 1.0;
+    rows_.clear();
+    mz_bins_.clear();
+    levels_.clear();
+  }
+
+  bool MaxIntensityPyramid::empty() const
+  {
+    return levels_.empty();
+  }
+
+  bool MaxIntensityPyramid::isValidFor(const MSExperiment<>& map) const
+  {
+    if (empty()) return false;
+
+    std::vector<double> rts;
+    UInt64 peak_count;
+    double mz_min, mz_max;
+    collectMS1Info_(map, rts, peak_count, mz_min, mz_max);
+    return peak_count == peak_count_ &&
+           mz_min == mz_min_ &&
+           mz_max == mz_max_ &&
+           rts == scan_rts_;
+  }
+
+  Size MaxIntensityPyramid::getNumberOfLevels() const
+  {
+    return levels_.size();
+  }
+
+  Size MaxIntensityPyramid::getRowCount(Size level) const
+  {
+    return rows_[level];
+  }
+
+  Size MaxIntensityPyramid::getMZBinCount(Size level) const
+  {
+    return mz_bins_[level];
+  }
+
+  float MaxIntensityPyramid::getMaximum(Size level, Size row, Size mz_bin) const
+  {
+    return levels_[level][row * mz_bins_[level] + mz_bin];
+  }
+
+  bool MaxIntensityPyramid::query(double rt_min, double rt_max, Size rt_pixels, double mz_min, double mz_max, Size mz_pixels, std::vector<float>& image) const
+  {
+    if (empty() || rt_pixels == 0 || mz_pixels == 0 || !(rt_max > rt_min) || !(mz_max > mz_min))
+    {
+      return false;
+    }
+
+    const double rt_pixel_size = (rt_max - rt_min) / rt_pixels;
+    const double mz_pixel_size = (mz_max - mz_min) / mz_pixels;
+
+    // the finest level has to provide at least one row per RT pixel (on
+    // average) and m/z bins not wider than a pixel, otherwise gaps appear
+    const Size visible_scans = std::lower_bound(scan_rts_.begin(), scan_rts_.end(), rt_max) - std::lower_bound(scan_rts_.begin(), scan_rts_.end(), rt_min);
+    if (visible_scans / scans_per_row_ < rt_pixels || mz_bin_width_ > mz_pixel_size)
+    {
+      return false;
+    }
+
+    // use the coarsest level that still fulfills these conditions
+    Size level = 0;
+    while (level + 1 < levels_.size() &&
+           visible_scans / (scans_per_row_ << (level + 1)) >= rt_pixels &&
+           mz_bin_width_ * double(Size(1) << (level + 1)) <= mz_pixel_size)
+    {
+      ++level;
+    }
+    const Size scans_per_row = scans_per_row_ << level;
+    const double mz_bin_width = mz_bin_width_ * double(Size(1) << level);
+    const Size rows = rows_[level];
+    const Size bins = mz_bins_[level];
+    const std::vector<float>& cells = levels_[level];
+
+    // pixel p contains the rows [row_begin[p], row_begin[p + 1]) (by the RT of their first scan)
+    std::vector<Size> row_begin(rt_pixels + 1);
+    for (Size p = 0; p <= rt_pixels; ++p)
+    {
+      const Size scan = std::lower_bound(scan_rts_.begin(), scan_rts_.end(), rt_min + p * rt_pixel_size) - scan_rts_.begin();
+      row_begin[p] = std::min((scan + scans_per_row - 1) / scans_per_row, rows);
+    }
+    // ... and the m/z bins [bin_begin[p], bin_begin[p + 1]) (by their center)
+    std::vector<Size> bin_begin(mz_pixels + 1);
+    for (Size p = 0; p <= mz_pixels; ++p)
+    {
+      bin_begin[p] = firstCellFrom(mz_min + p * mz_pixel_size, mz_min_, mz_bin_width, bins);
+    }
+
+    image.assign(rt_pixels * mz_pixels, -1.0f);
+    for (Size rt_pixel = 0; rt_pixel < rt_pixels; ++rt_pixel)
+    {
+      float* image_row = &image[rt_pixel * mz_pixels];
+      for (Size row = row_begin[rt_pixel]; row < row_begin[rt_pixel + 1]; ++row)
+      {
+        const float* cell_row = &cells[row * bins];
+        for (Size mz_pixel = 0; mz_pixel < mz_pixels; ++mz_pixel)
+        {
+          for (Size bin = bin_begin[mz_pixel]; bin < bin_begin[mz_pixel + 1]; ++bin)
+          {
+            image_row[mz_pixel] = std::max(image_row[mz_pixel], cell_row[bin]);
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  void MaxIntensityPyramid::store(const String& filename) const
+  {
+    PyramidHeader header;
+    std::memcpy(header.magic, PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.scan_count = scan_rts_.size();
+    header.peak_count = peak_count_;
+    header.mz_min = mz_min_;
+    header.mz_max = mz_max_;
+    header.scans_per_row = scans_per_row_;
+    header.mz_bin_width = mz_bin_width_;
+    header.rows = empty() ? 0 : rows_[0];
+    header.mz_bins = empty() ? 0 : mz_bins_[0];
+
+    // write to a temporary file first and rename it afterwards, so a
+    // concurrently running TOPPView never sees a partially written file
+    String tmp_filename = filename + "." + File::getUniqueName() + ".tmp";
+    {
+      std::ofstream ofs(tmp_filename.c_str(), std::ios::binary);
+      if (!ofs)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, tmp_filename);
+      }
+      ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      if (!scan_rts_.empty())
+      {
+        ofs.write(reinterpret_cast<const char*>(&scan_rts_[0]), scan_rts_.size() * sizeof(double));
+      }
+      if (!empty() && !levels_[0].empty())
+      {
+        ofs.write(reinterpret_cast<const char*>(&levels_[0][0]), levels_[0].size() * sizeof(float));
+      }
+      if (!ofs)
+      {
+        ofs.close();
+        File::remove(tmp_filename);
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+      }
+    }
+
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    {
+      File::remove(tmp_filename);
+      // another instance may have created the very same file in the meantime (rename fails on Windows then)
+      if (!File::exists(filename))
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, __PRETTY_FUNCTION__, filename);
+      }
+    }
+  }
+
+  bool MaxIntensityPyramid::load(const String& filename, const MSExperiment<>& map)
+  {
+    clear();
+
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    if (!ifs) return false;
+
+    PyramidHeader header;
+    ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!ifs ||
+        std::memcmp(header.magic, PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC)) != 0 ||
+        header.byte_order != BYTE_ORDER_MARK ||
+        header.scans_per_row == 0 ||
+        !(header.mz_bin_width > 0.0) ||
+        header.rows == 0 || header.mz_bins == 0 ||
+        header.rows != (header.scan_count + header.scans_per_row - 1) / header.scans_per_row)
+    {
+      return false;
+    }
+
+    // check against the map before reading the (large) cell data
+    std::vector<double> rts;
+    UInt64 peak_count;
+    double mz_min, mz_max;
+    collectMS1Info_(map, rts, peak_count, mz_min, mz_max);
+    if (rts.size() != header.scan_count || peak_count != header.peak_count ||
+        mz_min != header.mz_min || mz_max != header.mz_max)
+    {
+      return false;
+    }
+
+    scan_rts_.resize(header.scan_count);
+    if (!scan_rts_.empty())
+    {
+      ifs.read(reinterpret_cast<char*>(&scan_rts_[0]), scan_rts_.size() * sizeof(double));
+    }
+    if (!ifs || scan_rts_ != rts)
+    {
+      clear();
+      return false;
+    }
+
+    levels_.resize(1);
+    levels_[0].resize(header.rows * header.mz_bins);
+    ifs.read(reinterpret_cast<char*>(&levels_[0][0]), levels_[0].size() * sizeof(float));
+    if (!ifs)
+    {
+      clear();
+      return false;
+    }
+
+    peak_count_ = header.peak_count;
+    mz_min_ = header.mz_min;
+    mz_max_ = header.mz_max;
+    scans_per_row_ = header.scans_per_row;
+    mz_bin_width_ = header.mz_bin_width;
+    rows_.assign(1, header.rows);
+    mz_bins_.assign(1, header.mz_bins);
+    buildCoarseLevels_();
+    return true;
+  }
+
+  String MaxIntensityPyramid::getCacheFilename(const String& filename)
+  {
+    return filename + ".pyramid";
+  }
+
+} //namespace OpenMS
@@ -46,6 +46,7 @@
 #include <OpenMS/VISUAL/DIALOGS/FeatureEditDialog.h>
 #include <OpenMS/SYSTEM/FileWatcher.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
 //STL
 #include <algorithm>
 
@@ -56,6 +57,8 @@
 #include <QtGui/QBitmap>
 #include <QtGui/QPolygon>
 #include <QtCore/QTime>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QtConcurrentRun>
 #include <QtGui/QComboBox>
 #include <QtGui/QFileDialog>
 #include <QtGui/QMessageBox>
@@ -100,6 +103,8 @@ namespace OpenMS
     defaults_.setValue("dot:feature_icon_size", 4, "Icon size used for features and consensus features.");
     defaults_.setMinInt("dot:feature_icon_size", 1);
     defaults_.setMaxInt("dot:feature_icon_size", 999);
+    defaults_.setValue("dot:pyramid_cache", "false", "Store the precomputed overview of large peak maps in a file next to the data file ('<file>.pyramid') and reuse it when the file is opened again.");
+    defaults_.setValidStrings("dot:pyramid_cache", ListUtils::create<String>("true,false"));
     defaults_.setValue("mapping_of_mz_to", "y_axis", "Determines which axis is the m/z axis.");
     defaults_.setValidStrings("mapping_of_mz_to", ListUtils::create<String>("x_axis,y_axis"));
     defaultsToParam_();
@@ -211,42 +216,29 @@ namespace OpenMS
     }
     else if (getCurrentLayer().type == LayerData::DT_FEATURE)
     {
-      for (FeatureMapType::ConstIterator i = getCurrentLayer().getFeatureMap()->begin();
-           i != getCurrentLayer().getFeatureMap()->end();
-           ++i)
+      const FeatureMapType & features = *getCurrentLayer().getFeatureMap();
+      vector<Size> in_area;
+      getCentroidIndex_().findInArea(area.minPosition()[1], area.maxPosition()[1], area.minPosition()[0], area.maxPosition()[0], in_area);
+      for (vector<Size>::const_iterator i = in_area.begin(); i != in_area.end(); ++i)
       {
-        if (i->getRT() >= area.minPosition()[1] &&
-            i->getRT() <= area.maxPosition()[1] &&
-            i->getMZ() >= area.minPosition()[0] &&
-            i->getMZ() <= area.maxPosition()[0] &&
-            getCurrentLayer().filters.passes(*i))
+        if (features[*i].getIntensity() > max_int && getCurrentLayer().filters.passes(features[*i]))
         {
-          if (i->getIntensity() > max_int)
-          {
-            max_int = i->getIntensity();
-            max_pi = PeakIndex(i - getCurrentLayer().getFeatureMap()->begin());
-          }
+          max_int = features[*i].getIntensity();
+          max_pi = PeakIndex(*i);
         }
       }
     }
     else if (getCurrentLayer().type == LayerData::DT_CONSENSUS)
     {
-      for (ConsensusMapType::ConstIterator i = getCurrentLayer().getConsensusMap()->begin();
-           i != getCurrentLayer().getConsensusMap()->end();
-           ++i)
+      const ConsensusMapType & features = *getCurrentLayer().getConsensusMap();
+      vector<Size> in_area;
+      getCentroidIndex_().findInArea(area.minPosition()[1], area.maxPosition()[1], area.minPosition()[0], area.maxPosition()[0], in_area);
+      for (vector<Size>::const_iterator i = in_area.begin(); i != in_area.end(); ++i)
       {
-        // consensus feature in visible area?
-        if (i->getRT() >= area.minPosition()[1] &&
-            i->getRT() <= area.maxPosition()[1] &&
-            i->getMZ() >= area.minPosition()[0] &&
-            i->getMZ() <= area.maxPosition()[0] &&
-            getCurrentLayer().filters.passes(*i))
+        if (features[*i].getIntensity() > max_int && getCurrentLayer().filters.passes(features[*i]))
         {
-          if (i->getIntensity() > max_int)
-          {
-            max_int = i->getIntensity();
-            max_pi = PeakIndex(i - getCurrentLayer().getConsensusMap()->begin());
-          }
+          max_int = features[*i].getIntensity();
+          max_pi = PeakIndex(*i);
         }
       }
     }
@@ -637,6 +629,12 @@ namespace OpenMS
   {
     //set painter to black (we operate directly on the pixels for all colored data)
     painter.setPen(Qt::black);
+
+    if (paintMaximumIntensitiesFromPyramid_(layer_index, rt_pixel_count, mz_pixel_count))
+    {
+      return;
+    }
+
     //temporary variables
     Int image_width = buffer_.width();
     Int image_height = buffer_.height();
@@ -725,6 +723,132 @@ namespace OpenMS
     }
   }
 
+  bool Spectrum2DCanvas::paintMaximumIntensitiesFromPyramid_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count)
+  {
+    const LayerData & layer = getLayer(layer_index);
+    // the pyramid contains all peaks, so it cannot be used with filters
+    if (layer.filters.size() > 0 || !layer.pyramid.isFinished() || layer.pyramid.resultCount() == 0)
+    {
+      return false;
+    }
+    const LayerData::PyramidSharedPtrType pyramid = layer.pyramid.result();
+    if (!pyramid || !pyramid->isValidFor(*layer.getPeakData()))
+    {
+      return false;
+    }
+
+    const double rt_min = visible_area_.minPosition()[1];
+    const double rt_max = visible_area_.maxPosition()[1];
+    const double mz_min = visible_area_.minPosition()[0];
+    const double mz_max = visible_area_.maxPosition()[0];
+    std::vector<float> image;
+    if (!pyramid->query(rt_min, rt_max, rt_pixel_count, mz_min, mz_max, mz_pixel_count, image))
+    {
+      return false;
+    }
+
+    Int image_width = buffer_.width();
+    Int image_height = buffer_.height();
+    double snap_factor = snap_factors_[layer_index];
+    double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
+    double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
+    for (Size rt = 0; rt < rt_pixel_count; ++rt)
+    {
+      for (Size mz = 0; mz < mz_pixel_count; ++mz)
+      {
+        float max = image[rt * mz_pixel_count + mz];
+        if (max >= 0.0)
+        {
+          QPoint pos;
+          dataToWidget_(mz_min + mz_step_size * (mz + 0.5), rt_min + rt_step_size * (rt + 0.5), pos);
+          if (pos.y() < image_height && pos.x() < image_width)
+          {
+            buffer_.setPixel(pos.x(), pos.y(), heightColor_(max, layer.gradient, snap_factor).rgb());
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  namespace
+  {
+    /// minimum number of MS1 peaks for which a maximum intensity pyramid is computed
+    const UInt64 PYRAMID_MIN_PEAKS = 1000000;
+
+    /// Loads the pyramid for @p map from @p cache_file (if not empty), or builds (and stores) it
+    LayerData::PyramidSharedPtrType computePyramid(LayerData::ExperimentSharedPtrType map, String cache_file)
+    {
+      boost::shared_ptr<MaxIntensityPyramid> pyramid(new MaxIntensityPyramid());
+      if (!cache_file.empty() && pyramid->load(cache_file, *map))
+      {
+        return pyramid;
+      }
+      pyramid->build(*map);
+      if (!cache_file.empty())
+      {
+        try
+        {
+          pyramid->store(cache_file);
+        }
+        catch (Exception::BaseException&)
+        {
+          // the cache is optional (e.g. the directory might be read-only)
+        }
+      }
+      return pyramid;
+    }
+  }
+
+  void Spectrum2DCanvas::startPyramidComputation_(Size layer_index)
+  {
+    LayerData & layer = getLayer_(layer_index);
+    layer.pyramid = QFuture<LayerData::PyramidSharedPtrType>();
+    if (layer.type != LayerData::DT_PEAK || layer.getPeakData()->getSize() < PYRAMID_MIN_PEAKS)
+    {
+      return;
+    }
+
+    String cache_file;
+    if (layer.param.getValue("dot:pyramid_cache") == "true" && !layer.filename.empty())
+    {
+      cache_file = MaxIntensityPyramid::getCacheFilename(layer.filename);
+    }
+
+    QFutureWatcher<LayerData::PyramidSharedPtrType> * watcher = new QFutureWatcher<LayerData::PyramidSharedPtrType>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(pyramidFinished_()));
+    layer.pyramid = QtConcurrent::run(computePyramid, layer.getPeakData(), cache_file);
+    watcher->setFuture(layer.pyramid);
+  }
+
+  const SpatialIndex2D & Spectrum2DCanvas::getCentroidIndex_()
+  {
+    LayerData & layer = getCurrentLayer_();
+    const Size size = (layer.type == LayerData::DT_FEATURE) ? layer.getFeatureMap()->size() : layer.getConsensusMap()->size();
+    // features are added/removed without resetting the index in some places
+    if (!layer.centroid_index || layer.centroid_index->size() != size)
+    {
+      boost::shared_ptr<SpatialIndex2D> index(new SpatialIndex2D());
+      if (layer.type == LayerData::DT_FEATURE)
+      {
+        index->build(*layer.getFeatureMap());
+      }
+      else
+      {
+        index->build(*layer.getConsensusMap());
+      }
+      layer.centroid_index = index;
+    }
+    return *layer.centroid_index;
+  }
+
+  void Spectrum2DCanvas::pyramidFinished_()
+  {
+    update_buffer_ = true;
+    update_(__PRETTY_FUNCTION__);
+    sender()->deleteLater();
+  }
+
   void Spectrum2DCanvas::paintFeatureData_(Size layer_index, QPainter& painter)
   {
     const LayerData& layer = getLayer(layer_index);
@@ -1244,6 +1368,7 @@ namespace OpenMS
       {
         setLayerFlag(LayerData::P_PRECURSORS, true); // show precursors if no MS1 data is contained
       }
+      startPyramidComputation_(current_layer_);
     }
     else if (layers_.back().type == LayerData::DT_FEATURE)  //feature data
     {
@@ -2820,6 +2945,7 @@ namespace OpenMS
   {
     //update nearest peak
     selected_peak_.clear();
+    startPyramidComputation_(i);
     recalculateRanges_(0, 1, 2);
     resetZoom(false);     //no repaint as this is done in intensityModeChange_() anyway
     intensityModeChange_();
@@ -942,6 +942,8 @@ namespace OpenMS
   void SpectrumCanvas::modificationStatus_(Size layer_index, bool modified)
   {
     LayerData & layer = getLayer_(layer_index);
+    // (consensus) features might have been moved
+    layer.centroid_index.reset();
     if (layer.modified != modified)
     {
       layer.modified = modified;
@@ -80,7 +80,7 @@ public:
     ///Type definitions
     //@{
     /// Cross Correlation array
-    typedef std::map<int, double> XCorrArrayType;
+    typedef OpenSwath::Scoring::XCorrArrayType XCorrArrayType;
     /// Cross Correlation matrix
     typedef std::vector<std::vector<XCorrArrayType> > XCorrMatrixType;
 
@@ -152,6 +152,10 @@ public:
 
 private:
 
+    /// Fetches the intensities of the given transitions and standardizes them (see Scoring::standardize_data())
+    static void standardizedIntensities_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids,
+                                         std::vector<std::vector<double> >& intensities);
+
     /** @name Members */
     //@{
     /// the precomputed cross correlation matrix
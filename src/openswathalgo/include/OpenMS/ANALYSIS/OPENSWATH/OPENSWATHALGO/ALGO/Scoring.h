@@ -35,8 +35,10 @@
 #ifndef OPENMS_ANALYSIS_OPENSWATH_OPENSWATHALGO_ALGO_SCORING_H
 #define OPENMS_ANALYSIS_OPENSWATH_OPENSWATHALGO_ALGO_SCORING_H
 
+#include <algorithm>
+#include <limits>
 #include <numeric>
-#include <map>
+#include <utility>
 #include <vector>
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/OpenSwathAlgoConfig.h>
@@ -53,8 +55,42 @@ namespace OpenSwath
   {
     /** @name Type defs */
     //@{
-    /// Cross Correlation array
-    typedef std::map<int, double> XCorrArrayType;
+    /**
+      @brief Cross Correlation array
+
+      Holds (lag, value) pairs in ascending lag order in a single contiguous
+      vector. Provides the subset of the std::map interface used by callers
+      (iteration, size() and find()).
+    */
+    struct XCorrArrayType
+    {
+      typedef std::vector<std::pair<int, double> > ContainerType;
+      typedef ContainerType::iterator iterator;
+      typedef ContainerType::const_iterator const_iterator;
+
+      ContainerType data;
+
+      iterator begin() { return data.begin(); }
+      const_iterator begin() const { return data.begin(); }
+      iterator end() { return data.end(); }
+      const_iterator end() const { return data.end(); }
+      std::size_t size() const { return data.size(); }
+      bool empty() const { return data.empty(); }
+
+      /// Returns the entry for lag @p lag or end() if there is none
+      iterator find(int lag)
+      {
+        iterator it = std::lower_bound(data.begin(), data.end(), std::make_pair(lag, -std::numeric_limits<double>::infinity()));
+        return (it != data.end() && it->first == lag) ? it : data.end();
+      }
+
+      /// Returns the entry for lag @p lag or end() if there is none
+      const_iterator find(int lag) const
+      {
+        const_iterator it = std::lower_bound(data.begin(), data.end(), std::make_pair(lag, -std::numeric_limits<double>::infinity()));
+        return (it != data.end() && it->first == lag) ? it : data.end();
+      }
+    };
     //@}
 
     /** @name Helper functions */
@@ -102,13 +138,36 @@ namespace OpenSwath
     OPENSWATHALGO_DLLAPI XCorrArrayType normalizedCrossCorrelation(std::vector<double>& data1,
                                                             std::vector<double>& data2, int maxdelay, int lag);
 
-    /// Calculate crosscorrelation on std::vector data without normalization
-    OPENSWATHALGO_DLLAPI XCorrArrayType calculateCrossCorrelation(std::vector<double>& data1,
-                                                      std::vector<double>& data2, int maxdelay, int lag);
+    /**
+      @brief Calculate crosscorrelation on std::vector data that is already standardized
+
+      Same as normalizedCrossCorrelation() but expects both inputs to be
+      standardized (see standardize_data()) and leaves them untouched. This
+      allows callers that correlate one trace with many others to standardize
+      each trace only once.
+    */
+    OPENSWATHALGO_DLLAPI XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                                                       const std::vector<double>& normalized_data2, int maxdelay, int lag);
+
+    /**
+      @brief Calculate crosscorrelation on std::vector data without normalization
+
+      Lags without any overlap are set to zero. For lag 1 and chromatograms of
+      at least 128 points, the correlation is computed via FFT in O(n log n);
+      the lags closest to the maximum are then recomputed by direct summation,
+      so that xcorrArrayGetMaxPeak() returns exactly the same lag and value
+      as the direct computation. All other values agree with the direct sum
+      up to rounding.
+    */
+    OPENSWATHALGO_DLLAPI XCorrArrayType calculateCrossCorrelation(const std::vector<double>& data1,
+                                                                  const std::vector<double>& data2, int maxdelay, int lag);
 
-    /// Find best peak in an cross-correlation (highest apex)
+    /// Find best peak in an cross-correlation (highest apex, the smallest lag wins on ties)
     OPENSWATHALGO_DLLAPI XCorrArrayType::iterator xcorrArrayGetMaxPeak(XCorrArrayType & array);
 
+    /// Find best peak in an cross-correlation (highest apex, the smallest lag wins on ties)
+    OPENSWATHALGO_DLLAPI XCorrArrayType::const_iterator xcorrArrayGetMaxPeak(const XCorrArrayType & array);
+
     /// Standardize a vector (subtract mean, divide by standard deviation)
     OPENSWATHALGO_DLLAPI void standardize_data(std::vector<double>& data);
 
@@ -65,6 +65,12 @@ public:
       To use this function, each thread should call this function to produce an
       individual copy on which it can operate.
 
+      @note The implementations in OpenMS (SpectrumAccessOpenMS,
+      SpectrumAccessOpenMSCached, SpectrumAccessOpenMSCachedMapped and
+      SpectrumAccessOpenMSInMemory) can in addition be shared directly between
+      threads that call getSpectrumById() and getSpectrumMetaById()
+      concurrently, which is what ChromatogramExtractorAlgorithm relies on.
+
     */
     virtual boost::shared_ptr<ISpectrumAccess> lightClone() const = 0;
 
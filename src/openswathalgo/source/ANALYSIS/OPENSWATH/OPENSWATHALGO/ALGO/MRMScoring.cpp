@@ -49,64 +49,64 @@ namespace OpenSwath
     return xcorr_matrix_;
   }
 
+  void MRMScoring::standardizedIntensities_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids,
+                                            std::vector<std::vector<double> >& intensities)
+  {
+    intensities.resize(native_ids.size());
+    for (std::size_t i = 0; i < native_ids.size(); i++)
+    {
+      intensities[i].clear();
+      mrmfeature->getFeature(native_ids[i])->getIntensity(intensities[i]);
+      Scoring::standardize_data(intensities[i]);
+    }
+  }
+
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    // standardize each trace only once instead of once per pair
+    std::vector<std::vector<double> > intensities;
+    standardizedIntensities_(mrmfeature, native_ids, intensities);
     xcorr_matrix_.resize(native_ids.size());
     for (std::size_t i = 0; i < native_ids.size(); i++)
     {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
       xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = i; j < native_ids.size(); j++)
       {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelationPost(intensities[i], intensities[j], boost::numeric_cast<int>(intensities[i].size()), 1);
       }
     }
   }
 
   void MRMScoring::initializeMS1XCorr(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids, std::string precursor_id)
   {
-    std::vector<double> intensityi, intensity_ms1;
+    std::vector<double> intensity_ms1;
     mrmfeature->getPrecursorFeature(precursor_id)->getIntensity(intensity_ms1);
+    Scoring::standardize_data(intensity_ms1);
+    std::vector<std::vector<double> > intensities;
+    standardizedIntensities_(mrmfeature, native_ids, intensities);
     ms1_xcorr_vector_.resize(native_ids.size());
     for (std::size_t i = 0; i < native_ids.size(); i++)
     {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      ms1_xcorr_vector_[i] = Scoring::normalizedCrossCorrelation(
-        intensityi, intensity_ms1, boost::numeric_cast<int>(intensityi.size()), 1);
+      ms1_xcorr_vector_[i] = Scoring::normalizedCrossCorrelationPost(
+        intensities[i], intensity_ms1, boost::numeric_cast<int>(intensities[i].size()), 1);
     }
   }
 
   void MRMScoring::initializeXCorrIdMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids_identification, std::vector<String> native_ids_detection)
   { 
-    std::vector<double> intensityi, intensityj;
+    std::vector<std::vector<double> > intensities_identification, intensities_detection;
+    standardizedIntensities_(mrmfeature, native_ids_identification, intensities_identification);
+    standardizedIntensities_(mrmfeature, native_ids_detection, intensities_detection);
     xcorr_matrix_.resize(native_ids_identification.size());
     for (std::size_t i = 0; i < native_ids_identification.size(); i++)
     { 
-      String native_id = native_ids_identification[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
       xcorr_matrix_[i].resize(native_ids_detection.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = 0; j < native_ids_detection.size(); j++)
       {
-        String native_id2 = native_ids_detection[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelationPost(intensities_identification[i], intensities_detection[j],
+                                                                      boost::numeric_cast<int>(intensities_identification[i].size()), 1);
       }
     }
   }
@@ -35,7 +35,9 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/ALGO/Scoring.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/Macros.h>
 #include <cmath>
+#include <complex>
 
+#include <boost/math/special_functions/fpclassify.hpp> // for isfinite
 #include <boost/numeric/conversion/cast.hpp>
 
 namespace OpenSwath
@@ -43,6 +45,167 @@ namespace OpenSwath
   namespace Scoring
   {
 
+    namespace
+    {
+      /// minimal chromatogram length for which calculateCrossCorrelation uses the FFT
+      const int XCORR_FFT_MIN_SIZE = 128;
+      /// minimal maximum delay for which calculateCrossCorrelation uses the FFT (few lags are cheaper to sum directly)
+      const int XCORR_FFT_MIN_DELAY = 32;
+
+      /// sum of data1[i] * data2[i + delay] over all overlapping i (in ascending order of i)
+      inline double directCrossCorrelation_(const double* data1, const double* data2, int datasize, int delay)
+      {
+        const int begin = delay < 0 ? -delay : 0;
+        const int end = delay > 0 ? datasize - delay : datasize;
+        const double* x = data1 + begin;
+        const double* y = data2 + begin + delay;
+        double sxy = 0;
+        for (int k = 0; k < end - begin; ++k)
+        {
+          sxy += x[k] * y[k];
+        }
+        return sxy;
+      }
+
+      /**
+        @brief In-place iterative radix-2 FFT
+
+        The size of @p a must be a power of two and @p twiddle must hold
+        exp(-2 pi i k / a.size()) for k < a.size() / 2. The inverse transform
+        is not scaled.
+      */
+      void fft_(std::vector<std::complex<double> >& a, const std::vector<std::complex<double> >& twiddle, bool inverse)
+      {
+        const std::size_t n = a.size();
+        for (std::size_t i = 1, j = 0; i < n; ++i)
+        {
+          std::size_t bit = n >> 1;
+          for (; j & bit; bit >>= 1)
+          {
+            j ^= bit;
+          }
+          j ^= bit;
+          if (i < j)
+          {
+            std::swap(a[i], a[j]);
+          }
+        }
+
+        // std::complex<double> is laid out as two doubles (real, imaginary);
+        // working on the raw values avoids the inf/NaN handling of its operator*
+        double* values = reinterpret_cast<double*>(&a[0]);
+        const double* w = reinterpret_cast<const double*>(&twiddle[0]);
+        const double sign = inverse ? -1.0 : 1.0;
+        for (std::size_t len = 2; len <= n; len <<= 1)
+        {
+          const std::size_t half = len >> 1;
+          const std::size_t stride = n / len;
+          for (std::size_t i = 0; i < n; i += len)
+          {
+            double* lo = values + 2 * i;
+            double* hi = values + 2 * (i + half);
+            for (std::size_t k = 0; k < half; ++k)
+            {
+              const double w_re = w[2 * k * stride];
+              const double w_im = sign * w[2 * k * stride + 1];
+              const double v_re = hi[2 * k] * w_re - hi[2 * k + 1] * w_im;
+              const double v_im = hi[2 * k] * w_im + hi[2 * k + 1] * w_re;
+              hi[2 * k] = lo[2 * k] - v_re;
+              hi[2 * k + 1] = lo[2 * k + 1] - v_im;
+              lo[2 * k] += v_re;
+              lo[2 * k + 1] += v_im;
+            }
+          }
+        }
+      }
+
+      /**
+        @brief Cross-correlation for lags -maxdelay..maxdelay (step 1) via FFT
+
+        Returns false (and leaves @p result untouched) if the input is not finite.
+      */
+      bool fftCrossCorrelation_(const std::vector<double>& data1, const std::vector<double>& data2,
+                                int maxdelay, XCorrArrayType& result)
+      {
+        const int datasize = boost::numeric_cast<int>(data1.size());
+        double sumsq1 = 0, sumsq2 = 0;
+        for (int i = 0; i < datasize; ++i)
+        {
+          sumsq1 += data1[i] * data1[i];
+          sumsq2 += data2[i] * data2[i];
+        }
+        if (!boost::math::isfinite(sumsq1) || !boost::math::isfinite(sumsq2))
+        {
+          return false;
+        }
+
+        std::size_t fft_size = 1;
+        while (fft_size < 2 * data1.size())
+        {
+          fft_size <<= 1;
+        }
+        const double pi = 3.14159265358979323846;
+        std::vector<std::complex<double> > twiddle(fft_size / 2);
+        for (std::size_t k = 0; k < twiddle.size(); ++k)
+        {
+          twiddle[k] = std::polar(1.0, -2.0 * pi * k / fft_size);
+        }
+
+        // transform both (real) inputs at once as z = data1 + i * data2
+        std::vector<std::complex<double> > z(fft_size), product(fft_size);
+        for (int i = 0; i < datasize; ++i)
+        {
+          z[i] = std::complex<double>(data1[i], data2[i]);
+        }
+        fft_(z, twiddle, false);
+        for (std::size_t k = 0; k < fft_size; ++k)
+        {
+          // separate the spectra: F1 = (Z[k] + conj(Z[-k])) / 2, F2 = (Z[k] - conj(Z[-k])) / 2i
+          const std::complex<double> zk = z[k];
+          const std::complex<double> zmk = std::conj(z[(fft_size - k) & (fft_size - 1)]);
+          const double f1_re = 0.5 * (zk.real() + zmk.real());
+          const double f1_im = 0.5 * (zk.imag() + zmk.imag());
+          const double f2_re = 0.5 * (zk.imag() - zmk.imag());
+          const double f2_im = -0.5 * (zk.real() - zmk.real());
+          // conj(F1) * F2
+          product[k] = std::complex<double>(f1_re * f2_re + f1_im * f2_im, f1_re * f2_im - f1_im * f2_re);
+        }
+        fft_(product, twiddle, true);
+        const std::vector<std::complex<double> >& f1 = product;
+
+        // lag d ends up at (cyclic) position d
+        const int max_overlap_delay = std::min(maxdelay, datasize - 1);
+        result.data.clear();
+        result.data.reserve(2 * maxdelay + 1);
+        double max_value = -std::numeric_limits<double>::infinity();
+        for (int delay = -maxdelay; delay <= maxdelay; ++delay)
+        {
+          double sxy = 0;
+          if (std::abs(delay) <= max_overlap_delay)
+          {
+            std::size_t pos = delay < 0 ? fft_size + delay : delay;
+            sxy = f1[pos].real() / fft_size;
+          }
+          result.data.push_back(std::make_pair(delay, sxy));
+          max_value = std::max(max_value, sxy);
+        }
+
+        // The rounding error of the FFT is far below this bound (relative to
+        // the Cauchy-Schwarz bound of the correlation). Recompute all lags that
+        // could be the maximum by direct summation, which makes the maximum
+        // (and its lag) identical to the direct computation.
+        const double tolerance = 1e-9 * std::sqrt(sumsq1 * sumsq2);
+        for (XCorrArrayType::iterator it = result.begin(); it != result.end(); ++it)
+        {
+          if (it->second >= max_value - 2 * tolerance && std::abs(it->first) <= max_overlap_delay)
+          {
+            it->second = directCrossCorrelation_(&data1[0], &data2[0], datasize, it->first);
+          }
+        }
+        return true;
+      }
+    }
+
     void normalize_sum(double x[], unsigned int n)
     {
       double sumx = std::accumulate(&x[0], &x[0] + n, 0.0);
@@ -103,12 +266,18 @@ namespace OpenSwath
     }
 
     XCorrArrayType::iterator xcorrArrayGetMaxPeak(XCorrArrayType& array)
+    {
+      const XCorrArrayType& const_array = array;
+      return array.begin() + (xcorrArrayGetMaxPeak(const_array) - const_array.begin());
+    }
+
+    XCorrArrayType::const_iterator xcorrArrayGetMaxPeak(const XCorrArrayType& array)
     {
       OPENSWATH_PRECONDITION(array.size() > 0, "Cannot get highest apex from empty array.");
 
-      XCorrArrayType::iterator max_it = array.begin();
+      XCorrArrayType::const_iterator max_it = array.begin();
       double max = array.begin()->second;
-      for (XCorrArrayType::iterator it = array.begin(); it != array.end(); ++it)
+      for (XCorrArrayType::const_iterator it = array.begin(); it != array.end(); ++it)
       {
         if (it->second > max)
         {
@@ -146,36 +315,46 @@ namespace OpenSwath
       // normalize the data
       standardize_data(data1);
       standardize_data(data2);
-      std::map<int, double> result = calculateCrossCorrelation(data1, data2, maxdelay, lag);
-      for (std::map<int, double>::iterator it = result.begin(); it != result.end(); ++it)
+      return normalizedCrossCorrelationPost(data1, data2, maxdelay, lag);
+    }
+
+    XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                                  const std::vector<double>& normalized_data2, int maxdelay, int lag)
+    {
+      XCorrArrayType result = calculateCrossCorrelation(normalized_data1, normalized_data2, maxdelay, lag);
+      for (XCorrArrayType::iterator it = result.begin(); it != result.end(); ++it)
       {
-        it->second = it->second / data1.size();
+        it->second = it->second / normalized_data1.size();
       }
       return result;
     }
 
-    XCorrArrayType calculateCrossCorrelation(std::vector<double>& data1,
-                                             std::vector<double>& data2, int maxdelay, int lag)
+    XCorrArrayType calculateCrossCorrelation(const std::vector<double>& data1,
+                                             const std::vector<double>& data2, int maxdelay, int lag)
     {
       OPENSWATH_PRECONDITION(data1.size() != 0 && data1.size() == data2.size(), "Both data vectors need to have the same length");
 
       XCorrArrayType result;
       int datasize = boost::numeric_cast<int>(data1.size());
-      int i, j, delay;
 
-      for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
+      if (lag == 1 && maxdelay >= XCORR_FFT_MIN_DELAY && datasize >= XCORR_FFT_MIN_SIZE &&
+          fftCrossCorrelation_(data1, data2, maxdelay, result))
+      {
+        return result;
+      }
+
+      if (lag > 0)
+      {
+        result.data.reserve(2 * (maxdelay / lag) + 1);
+      }
+      for (int delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
         double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        if (delay > -datasize && delay < datasize)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
-          {
-            continue;
-          }
-          sxy += (data1[i]) * (data2[j]);
+          sxy = directCrossCorrelation_(&data1[0], &data2[0], datasize, delay);
         }
-        result[delay] = sxy;
+        result.data.push_back(std::make_pair(delay, sxy));
       }
       return result;
     }
@@ -234,12 +413,12 @@ namespace OpenSwath
 
         if (denominator > 0)
         {
-          result[delay] = sxy / denominator;
+          result.data.push_back(std::make_pair(delay, sxy / denominator));
         }
         else
         {
           // e.g. if all datapoints are zero
-          result[delay] = 0;
+          result.data.push_back(std::make_pair(delay, 0.0));
         }
       }
       return result;
@@ -136,12 +136,14 @@ set(kernel_executables_list
   MSExperiment_test
   OnDiscMSExperiment_test
   MSSpectrum_test
+  MSSpectrumArrays_test
   Peak1D_test
   Peak2D_test
   PeakIndex_test
   RangeUtils_test
   RichPeak1D_test
   RichPeak2D_test
+  SpatialIndex2D_test
   StandardTypes_test
 )
 
@@ -181,7 +183,7 @@ set(format_executables_list
   MascotInfile_test
   MascotRemoteQuery_test
   MascotXMLFile_test
-  #MSDataWritingConsumer_test
+  MSDataWritingConsumer_test
   MsInspectFile_test
   MzDataFile_test
   MzIdentMLFile_test
@@ -232,6 +234,7 @@ set(format_executables_list
   MSDataCachedConsumer_test
   MSDataTransformingConsumer_test
   MSDataChainingConsumer_test
+  MSDataAveragingConsumer_test
   SpectrumAccessQuadMZTransforming_test
 )
 
@@ -242,6 +245,7 @@ set(math_executables_list
   BilinearInterpolation_test
   BSpline2d_test
   CubicSpline2d_test
+  FFT_test
   GammaDistributionFitter_test
   GaussFitter_test
   GumbelDistributionFitter_test
@@ -358,6 +362,7 @@ set(chemistry_executables_list
   FastaIteratorIntern_test
   FastaIterator_test
   IsotopeDistribution_test
+  IsotopePatternCache_test
   ModificationDefinition_test
   ModificationDefinitionsSet_test
   ModificationsDB_test
@@ -465,6 +470,7 @@ set(analysis_executables_list
   ProteinInference_test
   ProtonDistributionModel_test
   ProteinResolver_test
+  ProteinSuffixArray_test
   PSLPFormulation_test
   PSProteinInference_test
   QTClusterFinder_test
@@ -577,6 +583,7 @@ if(NOT DISABLE_OPENSWATH)
     MRMIonSeries_test
     MRMRTNormalizer_test
     TransitionTSVReader_test
+    TransitionBinaryLibrary_test
     ChromatogramExtractor_test
     ChromatogramExtractorAlgorithm_test
     OpenSwathHelper_test
@@ -589,12 +596,14 @@ if(NOT DISABLE_OPENSWATH)
     OpenSwathMRMFeatureAccessOpenMS_test
     SpectrumAddition_test
     OpenSwathSpectrumAccessOpenMS_test
+    OpenSwathSpectrumAccessOpenMSCachedMapped_test
     OpenSwathDataAccessHelper_test
     MRMFeatureScoring_test
     MRMFeatureFinderScoring_test
     SpectrumHelpers_test
     StatsHelpers_test
     CachedMzML_test
+    CachedMzMLMapped_test
   )
 endif(NOT DISABLE_OPENSWATH)
 
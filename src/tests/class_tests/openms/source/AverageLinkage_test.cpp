@@ -40,6 +40,7 @@
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
 #include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
 #include <vector>
+#include <cmath>
 //#include <iostream>
 ///////////////////////////
 
@@ -146,6 +147,45 @@ START_SECTION((void operator()(DistanceMatrix< float > &original_distance, std::
 }
 END_SECTION
 
+START_SECTION((void operator()(DistanceMatrix< float > &original_distance, std::vector<BinaryTreeNode>& cluster_tree, const float threshold=1) const) [larger input])
+{
+	// three well separated groups of elements on a line, stored interleaved
+	Size n = 30;
+	vector<double> x(n);
+	for (Size i = 0; i < n; ++i)
+	{
+		x[i] = (i % 3) * 0.4 + i * 0.001;
+	}
+	DistanceMatrix<float> matrix(n, 1);
+	for (Size i = 1; i < n; ++i)
+	{
+		for (Size j = 0; j < i; ++j)
+		{
+			matrix.setValueQuick(i, j, fabs(x[i] - x[j]));
+		}
+	}
+	matrix.updateMinElement();
+
+	AverageLinkage al;
+	vector< BinaryTreeNode > result;
+	al(matrix, result, 0.3f);
+	TEST_EQUAL(result.size(), n - 1)
+	for (Size i = 0; i < n - 3; ++i)
+	{
+		TEST_EQUAL(result[i].left_child < result[i].right_child, true)
+		TEST_EQUAL(result[i].left_child % 3, result[i].right_child % 3)
+		TEST_EQUAL(result[i].distance < 0.1, true)
+		if (i > 0) TEST_EQUAL(result[i - 1].distance <= result[i].distance, true)
+	}
+	TEST_EQUAL(result[n - 3].left_child, 0)
+	TEST_EQUAL(result[n - 3].right_child, 1)
+	TEST_EQUAL(result[n - 3].distance, -1.0)
+	TEST_EQUAL(result[n - 2].left_child, 0)
+	TEST_EQUAL(result[n - 2].right_child, 2)
+	TEST_EQUAL(result[n - 2].distance, -1.0)
+}
+END_SECTION
+
 START_SECTION((static const String getProductName()))
 {
 	AverageLinkage al5;
@@ -195,6 +195,57 @@ START_SECTION((template < typename ToType > void decode(const String &in, ByteOr
 }
 END_SECTION
 
+START_SECTION([EXTRA] long arrays (vectorized code path))
+{
+  // long arrays are encoded and decoded block-wise by the SSSE3/AVX2 kernels
+  // (if supported by the CPU), the remainder by the scalar code. Test all
+  // lengths around the block sizes and compare against Qt as a reference.
+  Base64 b64;
+  String str;
+  for (Size n = 0; n < 70; ++n)
+  {
+    std::vector<double> data_double, res_double;
+    std::vector<float> data, res;
+    for (Size i = 0; i < n; ++i)
+    {
+      data_double.push_back(i * 1234.5678 + 0.125);
+      data.push_back(i * 17.25f - 3.5f);
+    }
+
+    std::vector<double> tmp_double = data_double;
+    b64.encode(tmp_double, Base64::BYTEORDER_LITTLEENDIAN, str);
+    if (n > 0)
+    {
+      QByteArray raw(reinterpret_cast<const char*>(&data_double[0]), (int)(n * sizeof(double)));
+      TEST_EQUAL(str, String(raw.toBase64().constData()))
+    }
+    b64.decode(str, Base64::BYTEORDER_LITTLEENDIAN, res_double);
+    TEST_EQUAL(res_double.size(), n)
+    TEST_EQUAL(res_double == data_double, true)
+
+    tmp_double = data_double;
+    b64.encode(tmp_double, Base64::BYTEORDER_BIGENDIAN, str);
+    b64.decode(str, Base64::BYTEORDER_BIGENDIAN, res_double);
+    TEST_EQUAL(res_double == data_double, true)
+
+    std::vector<float> tmp = data;
+    b64.encode(tmp, Base64::BYTEORDER_BIGENDIAN, str);
+    b64.decode(str, Base64::BYTEORDER_BIGENDIAN, res);
+    TEST_EQUAL(res.size(), n)
+    TEST_EQUAL(res == data, true)
+  }
+
+  // an invalid character inside a vectorized block falls back to the scalar
+  // code and does not change the number of decoded values
+  std::vector<double> data_double(20, 42.0), res_double;
+  b64.encode(data_double, Base64::BYTEORDER_LITTLEENDIAN, str);
+  str[5] = '.';
+  b64.decode(str, Base64::BYTEORDER_LITTLEENDIAN, res_double);
+  TEST_EQUAL(res_double.size(), 20)
+  TEST_REAL_SIMILAR(res_double[19], 42.0)
+}
+END_SECTION
+
 START_SECTION([EXTRA] zlib functionality)
 {
   TOLERANCE_ABSOLUTE(0.001)
@@ -236,6 +236,83 @@ START_SECTION((bool checkCompliance(const BinnedSpectrum &bs) const ))
 }
 END_SECTION
 
+START_SECTION((void updateFlatBins()))
+{
+	BinnedSpectrum bs(1.5, 2, s1);
+	UInt filled = bs.getFilledBinNumber();
+	bs.getBins()[0] = 1.0f; // bin 0 is empty in this spectrum
+	TEST_EQUAL(bs.getFilledBinNumber(), filled + 1)
+	bs.updateFlatBins();
+	TEST_EQUAL(bs.getFilledBinNumber(), filled + 1)
+	TEST_REAL_SIMILAR(BinnedSpectrum::computeBinStatistics(bs, bs).sum1, BinnedSpectrum::computeBinStatistics(*bs1, *bs1).sum1 + 1.0)
+}
+END_SECTION
+
+START_SECTION((static BinStatistics computeBinStatistics(const BinnedSpectrum& spec1, const BinnedSpectrum& spec2)))
+{
+	PeakSpectrum s2;
+	Peak1D peak;
+	peak.setMZ(1.0);
+	peak.setIntensity(1.0);
+	s2.push_back(peak);
+	peak.setMZ(3.0);
+	peak.setIntensity(2.0);
+	s2.push_back(peak);
+	peak.setMZ(7.0);
+	peak.setIntensity(4.0);
+	s2.push_back(peak);
+	PeakSpectrum s3;
+	peak.setMZ(3.0);
+	peak.setIntensity(3.0);
+	s3.push_back(peak);
+	peak.setMZ(5.0);
+	peak.setIntensity(5.0);
+	s3.push_back(peak);
+
+	// bins (size 1, no spread): s2 has 0 -> 1, 2 -> 2, 6 -> 4; s3 has 2 -> 3, 4 -> 5
+	BinnedSpectrum bs2(1, 0, s2), bs3(1, 0, s3);
+	BinnedSpectrum::BinStatistics stats = BinnedSpectrum::computeBinStatistics(bs2, bs3);
+	// only the first 5 bins are shared
+	TEST_REAL_SIMILAR(stats.sum1, 3.0)
+	TEST_REAL_SIMILAR(stats.sum2, 8.0)
+	TEST_REAL_SIMILAR(stats.squared_sum1, 5.0)
+	TEST_REAL_SIMILAR(stats.squared_sum2, 34.0)
+	TEST_REAL_SIMILAR(stats.dot_product, 6.0)
+	TEST_REAL_SIMILAR(stats.squared_dot_product, 36.0)
+	TEST_REAL_SIMILAR(stats.positive_dot_product, 6.0)
+	TEST_REAL_SIMILAR(stats.positive_squared_dot_product, 36.0)
+	TEST_REAL_SIMILAR(stats.agreeing_sum, 1.5)
+	TEST_EQUAL(stats.shared_bins, 1)
+
+	// negative intensities in both spectra only contribute to the unrestricted products
+	bs2.getBins()[1] = -1.0f;
+	bs3.getBins()[1] = -1.0f;
+	bs2.updateFlatBins();
+	bs3.updateFlatBins();
+	stats = BinnedSpectrum::computeBinStatistics(bs2, bs3);
+	TEST_REAL_SIMILAR(stats.dot_product, 7.0)
+	TEST_REAL_SIMILAR(stats.squared_dot_product, 37.0)
+	TEST_REAL_SIMILAR(stats.positive_dot_product, 6.0)
+	TEST_REAL_SIMILAR(stats.positive_squared_dot_product, 36.0)
+	BinnedSpectrum sparse2(bs2);
+	sparse2.getBins(); // invalidates the flat bins
+	stats = BinnedSpectrum::computeBinStatistics(sparse2, bs3);
+	TEST_REAL_SIMILAR(stats.positive_dot_product, 6.0)
+	TEST_REAL_SIMILAR(stats.positive_squared_dot_product, 36.0)
+
+	// dense and sparse representations yield the same result
+	BinnedSpectrum::BinStatistics dense = BinnedSpectrum::computeBinStatistics(*bs1, *bs1);
+	BinnedSpectrum copy(*bs1);
+	copy.getBins(); // invalidates the flat bins, comparison falls back to the sparse vector
+	BinnedSpectrum::BinStatistics sparse = BinnedSpectrum::computeBinStatistics(copy, *bs1);
+	TEST_REAL_SIMILAR(dense.dot_product, sparse.dot_product)
+	TEST_REAL_SIMILAR(dense.squared_sum1, sparse.squared_sum1)
+	TEST_REAL_SIMILAR(dense.agreeing_sum, sparse.agreeing_sum)
+	TEST_EQUAL(dense.shared_bins, sparse.shared_bins)
+	TEST_EQUAL(dense.shared_bins, bs1->getFilledBinNumber())
+}
+END_SECTION
+
 START_SECTION(([BinnedSpectrum::NoSpectrumIntegrated] NoSpectrumIntegrated(const char *file, int line, const char *function, const char *message="BinnedSpectrum hasn't got a PeakSpectrum to base on yet")))
 {
   NOT_TESTABLE
@@ -0,0 +1,198 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/CachedMzMLMapped.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/CachedMzML.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+#include <fstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CachedmzMLMapped, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// Create a single cached file and use it for all tests
+std::string tmp_filename;
+NEW_TMP_FILE(tmp_filename);
+MSExperiment<> exp;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+CachedmzML().writeMemdump(exp, tmp_filename);
+
+CachedmzMLMapped* ptr = 0;
+CachedmzMLMapped* nullPointer = 0;
+
+START_SECTION(explicit CachedmzMLMapped(const String& filename))
+{
+  ptr = new CachedmzMLMapped(tmp_filename);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+
+  std::string unused_tmp_filename;
+  NEW_TMP_FILE(unused_tmp_filename);
+  TEST_EXCEPTION(Exception::FileNotFound, CachedmzMLMapped cache_fail(unused_tmp_filename))
+  TEST_EXCEPTION(Exception::ParseError, CachedmzMLMapped cache_fail(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML")))
+
+  // a corrupt spectrum count in the trailer is rejected (and not used to allocate memory)
+  std::string corrupt_filename;
+  NEW_TMP_FILE(corrupt_filename);
+  {
+    std::ifstream ifs(tmp_filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    Size huge_count = Size(-1) / 2;
+    content.replace(content.size() - 2 * sizeof(Size), sizeof(Size), reinterpret_cast<const char*>(&huge_count), sizeof(Size));
+    std::ofstream ofs(corrupt_filename.c_str(), std::ios::binary);
+    ofs << content;
+  }
+  TEST_EXCEPTION(Exception::ParseError, CachedmzMLMapped cache_fail(corrupt_filename))
+}
+END_SECTION
+
+START_SECTION(~CachedmzMLMapped())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(Size getNrSpectra() const)
+{
+  CachedmzMLMapped cache(tmp_filename);
+  TEST_EQUAL(cache.getNrSpectra(), 4)
+}
+END_SECTION
+
+START_SECTION(Size getNrChromatograms() const)
+{
+  CachedmzMLMapped cache(tmp_filename);
+  TEST_EQUAL(cache.getNrChromatograms(), 2)
+}
+END_SECTION
+
+START_SECTION(const String& getFilename() const)
+{
+  CachedmzMLMapped cache(tmp_filename);
+  TEST_EQUAL(cache.getFilename(), tmp_filename)
+}
+END_SECTION
+
+START_SECTION(CachedmzMLMapped(const CachedmzMLMapped& rhs))
+{
+  CachedmzMLMapped* cache = new CachedmzMLMapped(tmp_filename);
+  CachedmzMLMapped copy(*cache);
+  delete cache;
+
+  // the mapping is shared and stays valid after the original is gone
+  TEST_EQUAL(copy.getNrSpectra(), 4)
+  TEST_EQUAL(copy.getNrChromatograms(), 2)
+  CachedmzMLMapped::DataArrayView mz, intensity;
+  int ms_level = -1;
+  double rt = -1.0;
+  copy.getSpectrumView(0, mz, intensity, ms_level, rt);
+  TEST_EQUAL(mz.size, exp.getSpectrum(0).size())
+  TEST_REAL_SIMILAR(mz[0], exp.getSpectrum(0)[0].getMZ())
+}
+END_SECTION
+
+START_SECTION(CachedmzMLMapped& operator=(const CachedmzMLMapped& rhs))
+{
+  CachedmzMLMapped cache(tmp_filename);
+  CachedmzMLMapped other(tmp_filename);
+  other = cache;
+  TEST_EQUAL(other.getNrSpectra(), 4)
+  TEST_EQUAL(other.getNrChromatograms(), 2)
+}
+END_SECTION
+
+START_SECTION(void getSpectrumView(Size id, DataArrayView& mz, DataArrayView& intensity, int& ms_level, double& rt) const)
+{
+  CachedmzMLMapped cache(tmp_filename);
+  for (Size k = 0; k < cache.getNrSpectra(); k++)
+  {
+    CachedmzMLMapped::DataArrayView mz, intensity;
+    int ms_level = -1;
+    double rt = -1.0;
+    cache.getSpectrumView(k, mz, intensity, ms_level, rt);
+
+    TEST_EQUAL(mz.size, exp.getSpectrum(k).size())
+    TEST_EQUAL(intensity.size, exp.getSpectrum(k).size())
+    TEST_EQUAL(ms_level, static_cast<int>(exp.getSpectrum(k).getMSLevel()))
+    TEST_REAL_SIMILAR(rt, exp.getSpectrum(k).getRT())
+    for (Size i = 0; i < mz.size; i++)
+    {
+      TEST_REAL_SIMILAR(mz[i], exp.getSpectrum(k)[i].getMZ())
+      TEST_REAL_SIMILAR(intensity[i], exp.getSpectrum(k)[i].getIntensity())
+    }
+
+    std::vector<double> mz_copy;
+    mz.copyTo(mz_copy);
+    TEST_EQUAL(mz_copy.size(), mz.size)
+
+    // iterating over the view yields the same values
+    std::vector<double> mz_iterated(mz.begin(), mz.end());
+    TEST_EQUAL(mz_iterated == mz_copy, true)
+  }
+}
+END_SECTION
+
+START_SECTION(void getChromatogramView(Size id, DataArrayView& rt, DataArrayView& intensity) const)
+{
+  CachedmzMLMapped cache(tmp_filename);
+  for (Size k = 0; k < cache.getNrChromatograms(); k++)
+  {
+    CachedmzMLMapped::DataArrayView rt, intensity;
+    cache.getChromatogramView(k, rt, intensity);
+
+    TEST_EQUAL(rt.size > 0, true)
+    TEST_EQUAL(rt.size, exp.getChromatogram(k).size())
+    TEST_EQUAL(intensity.size, exp.getChromatogram(k).size())
+    for (Size i = 0; i < rt.size; i++)
+    {
+      TEST_REAL_SIMILAR(rt[i], exp.getChromatogram(k)[i].getRT())
+      TEST_REAL_SIMILAR(intensity[i], exp.getChromatogram(k)[i].getIntensity())
+    }
+  }
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -38,10 +38,73 @@
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCachedMapped.h>
+#include <OpenMS/FORMAT/CachedMzML.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace OpenMS;
 using namespace std;
 
+// spectrum access which fails to read one of the spectra
+class FailingSpectrumAccess :
+  public OpenSwath::ISpectrumAccess
+{
+public:
+  FailingSpectrumAccess(OpenSwath::SpectrumAccessPtr input, int failing_id) :
+    input_(input),
+    failing_id_(failing_id)
+  {
+  }
+
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const
+  {
+    return boost::shared_ptr<OpenSwath::ISpectrumAccess>(new FailingSpectrumAccess(input_, failing_id_));
+  }
+
+  OpenSwath::SpectrumPtr getSpectrumById(int id)
+  {
+    if (id == failing_id_) throw std::bad_alloc();
+    return input_->getSpectrumById(id);
+  }
+
+  std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const
+  {
+    return input_->getSpectraByRT(RT, deltaRT);
+  }
+
+  size_t getNrSpectra() const
+  {
+    return input_->getNrSpectra();
+  }
+
+  OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const
+  {
+    return input_->getSpectrumMetaById(id);
+  }
+
+  OpenSwath::ChromatogramPtr getChromatogramById(int id)
+  {
+    return input_->getChromatogramById(id);
+  }
+
+  std::size_t getNrChromatograms() const
+  {
+    return input_->getNrChromatograms();
+  }
+
+  std::string getChromatogramNativeID(int id) const
+  {
+    return input_->getChromatogramNativeID(id);
+  }
+
+private:
+  OpenSwath::SpectrumAccessPtr input_;
+  int failing_id_;
+};
+
 START_TEST(ChromatogramExtractorAlgorithm, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -151,6 +214,127 @@ START_SECTION(void extractChromatograms(const OpenSwath::SpectrumAccessPtr input
 }
 END_SECTION
 
+START_SECTION([EXTRA] extractChromatograms with multiple threads)
+{
+  // the spectra of a single map are distributed over all threads, the result
+  // has to be identical to the single-threaded extraction
+  boost::shared_ptr<MSExperiment<Peak1D> > exp(new MSExperiment<Peak1D>);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = 618.31; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr1";
+    coordinates.push_back(coord);
+    coord.mz = 628.45; coord.rt_start = 3050; coord.rt_end = 3150; coord.id = "tr2";
+    coordinates.push_back(coord);
+    coord.mz = 654.38; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr3";
+    coordinates.push_back(coord);
+  }
+
+  std::vector< OpenSwath::ChromatogramPtr > out_single, out_multi;
+  for (int i = 0; i < 3; i++)
+  {
+    out_single.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    out_multi.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+
+  ChromatogramExtractorAlgorithm extractor;
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  extractor.extractChromatograms(expptr, out_single, coordinates, 0.05, false, "tophat");
+  omp_set_num_threads(std::max(4, max_threads));
+  extractor.extractChromatograms(expptr, out_multi, coordinates, 0.05, false, "tophat");
+  omp_set_num_threads(max_threads);
+#else
+  extractor.extractChromatograms(expptr, out_single, coordinates, 0.05, false, "tophat");
+  extractor.extractChromatograms(expptr, out_multi, coordinates, 0.05, false, "tophat");
+#endif
+
+  TEST_EQUAL(out_single[0]->getTimeArray()->data.size(), 59)
+  TEST_EQUAL(out_single[1]->getTimeArray()->data.size() < 59, true)
+  for (Size k = 0; k < out_single.size(); k++)
+  {
+    TEST_EQUAL(out_multi[k]->getTimeArray()->data == out_single[k]->getTimeArray()->data, true)
+    TEST_EQUAL(out_multi[k]->getIntensityArray()->data == out_single[k]->getIntensityArray()->data, true)
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] extractChromatograms propagates errors of the spectrum access)
+{
+  boost::shared_ptr<MSExperiment<Peak1D> > exp(new MSExperiment<Peak1D>);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr failingptr(new FailingSpectrumAccess(SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp), 30));
+
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+  coord.mz = 618.31; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr1";
+  coordinates.push_back(coord);
+  std::vector< OpenSwath::ChromatogramPtr > out(1, OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+
+  // the original exception leaves the (parallel) extraction
+  ChromatogramExtractorAlgorithm extractor;
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(std::max(4, max_threads));
+  TEST_EXCEPTION(std::bad_alloc, extractor.extractChromatograms(failingptr, out, coordinates, 0.05, false, "tophat"))
+  omp_set_num_threads(max_threads);
+#else
+  TEST_EXCEPTION(std::bad_alloc, extractor.extractChromatograms(failingptr, out, coordinates, 0.05, false, "tophat"))
+#endif
+}
+END_SECTION
+
+START_SECTION([EXTRA] extractChromatograms from memory-mapped cached data)
+{
+  // the zero-copy path for cached data has to give the same result as the in-memory data
+  boost::shared_ptr<MSExperiment<Peak1D> > exp(new MSExperiment<Peak1D>);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  {
+    CachedmzML cache;
+    cache.writeMemdump(*exp, tmp_filename + ".cached");
+    cache.writeMetadata(*exp, tmp_filename, true);
+  }
+  OpenSwath::SpectrumAccessPtr mappedptr(new SpectrumAccessOpenMSCachedMapped(tmp_filename));
+
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = 618.31; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr1";
+    coordinates.push_back(coord);
+    coord.mz = 628.45; coord.rt_start = 3050; coord.rt_end = 3150; coord.id = "tr2";
+    coordinates.push_back(coord);
+    coord.mz = 654.38; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr3";
+    coordinates.push_back(coord);
+  }
+
+  std::vector< OpenSwath::ChromatogramPtr > out_memory, out_mapped;
+  for (int i = 0; i < 3; i++)
+  {
+    out_memory.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    out_mapped.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+
+  ChromatogramExtractorAlgorithm extractor;
+  extractor.extractChromatograms(expptr, out_memory, coordinates, 0.05, false, "tophat");
+  extractor.extractChromatograms(mappedptr, out_mapped, coordinates, 0.05, false, "tophat");
+
+  TEST_EQUAL(out_mapped[0]->getTimeArray()->data.size(), 59)
+  for (Size k = 0; k < out_memory.size(); k++)
+  {
+    TEST_EQUAL(out_mapped[k]->getTimeArray()->data == out_memory[k]->getTimeArray()->data, true)
+    TEST_EQUAL(out_mapped[k]->getIntensityArray()->data == out_memory[k]->getIntensityArray()->data, true)
+  }
+}
+END_SECTION
+
 ///////////////////////////////////////////////////////////////////////////
 /// Private functions
 ///////////////////////////////////////////////////////////////////////////
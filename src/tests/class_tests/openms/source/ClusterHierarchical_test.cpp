@@ -163,6 +163,20 @@ class LowlevelComparator
 
 #pragma clang diagnostic pop
 
+// fails for all pairs involving the last element
+class ThrowingComparator
+{
+	public:
+	double operator()(const Size first, const Size second) const
+	{
+		if (max(first, second) == 99)
+		{
+			throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__, "no similarity");
+		}
+		return 1.0;
+	}
+};
+
 START_TEST(ClusterHierarchical, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -237,6 +251,16 @@ START_SECTION((template <typename Data, typename SimilarityComparator> void clus
 			TEST_EQUAL(tree[i].right_child, result[i].right_child);
 			TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
 	}
+
+	// exceptions of the comparator are passed on unchanged (also from parallel regions)
+	vector<Size> failing(100);
+	for (Size i = 0; i < failing.size(); ++i)
+	{
+		failing[i] = i;
+	}
+	ThrowingComparator tc;
+	DistanceMatrix<float> failing_matrix;
+	TEST_EXCEPTION(Exception::IllegalArgument, ch.cluster(failing, tc, sl, result, failing_matrix));
 }
 END_SECTION
 
@@ -279,6 +303,12 @@ START_SECTION((void cluster(std::vector<PeakSpectrum>& data, const BinnedSpectru
 			TEST_EQUAL(tree[i].right_child, result[i].right_child);
 			TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
 	}
+
+	// empty spectra cannot be binned (also when binning in parallel)
+	vector<PeakSpectrum> with_empty(d);
+	with_empty.push_back(PeakSpectrum());
+	DistanceMatrix<float> empty_matrix;
+	TEST_EXCEPTION(BinnedSpectrum::NoSpectrumIntegrated, ch.cluster(with_empty, bspc, 1.5, 2, sl, result, empty_matrix));
 }
 END_SECTION
 
@@ -0,0 +1,136 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/MATH/MISC/FFT.h>
+///////////////////////////
+
+#include <OpenMS/CONCEPT/Constants.h>
+
+#include <complex>
+#include <vector>
+
+using namespace OpenMS;
+using namespace OpenMS::Math;
+using namespace std;
+
+START_TEST(FFT, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION(static Size nextPowerOfTwo(Size n))
+{
+  TEST_EQUAL(FFT::nextPowerOfTwo(0), 1)
+  TEST_EQUAL(FFT::nextPowerOfTwo(1), 1)
+  TEST_EQUAL(FFT::nextPowerOfTwo(2), 2)
+  TEST_EQUAL(FFT::nextPowerOfTwo(3), 4)
+  TEST_EQUAL(FFT::nextPowerOfTwo(1000), 1024)
+  TEST_EQUAL(FFT::nextPowerOfTwo(1024), 1024)
+}
+END_SECTION
+
+START_SECTION(static void transform(std::vector<std::complex<double> >& data, bool inverse = false))
+{
+  // transform of a delta is constant
+  vector<complex<double> > data(8);
+  data[0] = 1.0;
+  FFT::transform(data);
+  for (Size i = 0; i < data.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(data[i].real(), 1.0)
+    TEST_REAL_SIMILAR(data[i].imag(), 0.0)
+  }
+
+  // compare with the naive DFT and transform back
+  vector<complex<double> > input(16);
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    input[i] = complex<double>(double(i % 5) - 1.5, double(i % 3));
+  }
+  data = input;
+  FFT::transform(data);
+  TOLERANCE_ABSOLUTE(1e-9)
+  for (Size k = 0; k < input.size(); ++k)
+  {
+    complex<double> sum(0.0, 0.0);
+    for (Size j = 0; j < input.size(); ++j)
+    {
+      const double angle = -2.0 * Constants::PI * double(j * k) / double(input.size());
+      sum += input[j] * complex<double>(cos(angle), sin(angle));
+    }
+    TEST_REAL_SIMILAR(data[k].real(), sum.real())
+    TEST_REAL_SIMILAR(data[k].imag(), sum.imag())
+  }
+  FFT::transform(data, true);
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(data[i].real(), input[i].real())
+    TEST_REAL_SIMILAR(data[i].imag(), input[i].imag())
+  }
+
+  vector<complex<double> > wrong_size(6);
+  TEST_EXCEPTION(Exception::InvalidSize, FFT::transform(wrong_size))
+  vector<complex<double> > empty;
+  TEST_EXCEPTION(Exception::InvalidSize, FFT::transform(empty))
+}
+END_SECTION
+
+START_SECTION(static void convolve(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& result))
+{
+  vector<double> a, b, result;
+  a.push_back(1.0);
+  a.push_back(2.0);
+  a.push_back(3.0);
+  b.push_back(0.5);
+  b.push_back(-1.0);
+  FFT::convolve(a, b, result);
+  TEST_EQUAL(result.size(), 4)
+  TOLERANCE_ABSOLUTE(1e-12)
+  TEST_REAL_SIMILAR(result[0], 0.5)
+  TEST_REAL_SIMILAR(result[1], 0.0)
+  TEST_REAL_SIMILAR(result[2], -0.5)
+  TEST_REAL_SIMILAR(result[3], -3.0)
+
+  FFT::convolve(a, vector<double>(), result);
+  TEST_EQUAL(result.size(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
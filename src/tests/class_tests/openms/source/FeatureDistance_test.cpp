@@ -157,6 +157,29 @@ START_SECTION((std::pair<bool, double> operator()(const BaseFeature& left, const
 }
 END_SECTION
 
+START_SECTION((FeatureDistance(const FeatureDistance& other)))
+{
+	FeatureDistance dist(1000.0, true);
+	Param param = dist.getDefaults();
+	param.setValue("distance_RT:max_difference", 100.0);
+	param.setValue("distance_MZ:max_difference", 1.0);
+	dist.setParameters(param);
+	FeatureDistance dist2(dist);
+	TEST_EQUAL(dist.getParameters(), dist2.getParameters());
+	BaseFeature left, right;
+	left.setRT(100.0);
+	left.setMZ(100.0);
+	left.setIntensity(100.0);
+	right.setRT(110.0);
+	right.setMZ(100.1);
+	right.setIntensity(200.0);
+	TEST_EQUAL(dist2(left, right) == dist(left, right), true);
+	// constraints are kept:
+	right.setRT(300.0);
+	TEST_EQUAL(dist2(left, right).first, false);
+}
+END_SECTION
+
 START_SECTION((FeatureDistance& operator=(const FeatureDistance& other)))
 {
 	FeatureDistance dist(1000.0, true);
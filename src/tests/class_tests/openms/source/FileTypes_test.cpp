@@ -103,6 +103,7 @@ START_SECTION((static Type nameToType(const String &name)))
   TEST_EQUAL(FileTypes::EDTA, FileTypes::nameToType("edta"));
   TEST_EQUAL(FileTypes::CSV, FileTypes::nameToType("csv"));
   TEST_EQUAL(FileTypes::TXT, FileTypes::nameToType("txt"));
+  TEST_EQUAL(FileTypes::OSWLIB, FileTypes::nameToType("oswlib"));
 }
 END_SECTION
 
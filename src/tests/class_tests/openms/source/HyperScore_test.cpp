@@ -112,6 +112,16 @@ START_SECTION((static double compute(double fragment_mass_tolerance, bool fragme
 }
 END_SECTION
 
+START_SECTION((static double compute(double dot_product, UInt b_ion_count, UInt y_ion_count)))
+{
+  // same values as for the full match of 5 and 10 y-ions above
+  TEST_REAL_SIMILAR(HyperScore::compute(5.0, 0, 5), 7.39693);
+  TEST_REAL_SIMILAR(HyperScore::compute(10.0, 0, 10), 18.407);
+  // no matching peaks
+  TEST_REAL_SIMILAR(HyperScore::compute(0.0, 0, 0), 0.0);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
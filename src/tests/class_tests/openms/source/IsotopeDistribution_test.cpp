@@ -364,6 +364,38 @@ START_SECTION(IsotopeDistribution operator *(Size factor) const)
 	}
 END_SECTION
 
+START_SECTION(([EXTRA] FFT-based convolution power of long distributions))
+{
+  // without max isotope, C1000 is computed via the FFT; compare with repeated convolution
+  IsotopeDistribution carbon(EmpiricalFormula("C").getIsotopeDistribution(0));
+  IsotopeDistribution power = carbon * 1000;
+  IsotopeDistribution sum(carbon);
+  for (Size i = 1; i < 1000; ++i)
+  {
+    sum += carbon;
+  }
+  TEST_EQUAL(power.size(), 1001)
+  TEST_EQUAL(power.size(), sum.size())
+  TOLERANCE_ABSOLUTE(1e-12)
+  for (Size i = 0; i != power.size(); ++i)
+  {
+    TEST_EQUAL(power.getContainer()[i].first, sum.getContainer()[i].first)
+    TEST_REAL_SIMILAR(power.getContainer()[i].second, sum.getContainer()[i].second)
+  }
+
+  // with max isotope, the result is truncated
+  IsotopeDistribution carbon_100(carbon);
+  carbon_100.setMaxIsotope(100);
+  power = carbon_100 * 1000;
+  TEST_EQUAL(power.size(), 100)
+  for (Size i = 0; i != power.size(); ++i)
+  {
+    TEST_EQUAL(power.getContainer()[i].first, sum.getContainer()[i].first)
+    TEST_REAL_SIMILAR(power.getContainer()[i].second, sum.getContainer()[i].second)
+  }
+}
+END_SECTION
+
 START_SECTION(bool operator!=(const IsotopeDistribution &isotope_distribution) const)
   IsotopeDistribution iso1(1);
   IsotopeDistribution iso2(2);
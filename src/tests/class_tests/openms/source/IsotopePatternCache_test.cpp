@@ -0,0 +1,172 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/IsotopePatternCache.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(IsotopePatternCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+IsotopePatternCache* ptr = 0;
+IsotopePatternCache* nullPointer = 0;
+
+START_SECTION(static IsotopePatternCache* getInstance())
+{
+  ptr = IsotopePatternCache::getInstance();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr, IsotopePatternCache::getInstance())
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  EmpiricalFormula("C6H12O6").getIsotopeDistribution(5);
+  TEST_NOT_EQUAL(ptr->size(), 0)
+  ptr->clear();
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  ptr->clear();
+  EmpiricalFormula("C6H12O6").getIsotopeDistribution(5);
+  TEST_EQUAL(ptr->size(), 1)
+  // charge and zero counts are ignored
+  EmpiricalFormula("C6H12O6S0+").getIsotopeDistribution(5);
+  TEST_EQUAL(ptr->size(), 1)
+  // different max isotope
+  EmpiricalFormula("C6H12O6").getIsotopeDistribution(3);
+  TEST_EQUAL(ptr->size(), 2)
+}
+END_SECTION
+
+START_SECTION(bool lookup(const EmpiricalFormula& formula, UInt max_depth, IsotopeDistribution& result) const)
+{
+  ptr->clear();
+  EmpiricalFormula ef("C100H202");
+  IsotopeDistribution result;
+  TEST_EQUAL(ptr->lookup(ef, 4, result), false)
+  IsotopeDistribution computed = ef.getIsotopeDistribution(4);
+  TEST_EQUAL(ptr->lookup(ef, 4, result), true)
+  TEST_EQUAL(result == computed, true)
+  TEST_EQUAL(result.getMaxIsotope(), 4)
+  TEST_EQUAL(ptr->lookup(ef, 5, result), false)
+  // cached and freshly computed distributions are identical
+  TEST_EQUAL(ef.getIsotopeDistribution(4) == computed, true)
+}
+END_SECTION
+
+START_SECTION(void insert(const EmpiricalFormula& formula, UInt max_depth, const IsotopeDistribution& distribution))
+{
+  ptr->clear();
+  IsotopeDistribution dist(2);
+  IsotopeDistribution::ContainerType container;
+  container.push_back(make_pair<Size, double>(1, 0.25));
+  container.push_back(make_pair<Size, double>(2, 0.75));
+  dist.set(container);
+  ptr->insert(EmpiricalFormula("H"), 2, dist);
+  TEST_EQUAL(EmpiricalFormula("H").getIsotopeDistribution(2) == dist, true)
+  ptr->clear();
+  TEST_EQUAL(EmpiricalFormula("H").getIsotopeDistribution(2) == dist, false)
+}
+END_SECTION
+
+START_SECTION(void setMaxSize(Size max_size))
+{
+  ptr->clear();
+  ptr->setMaxSize(2);
+  TEST_EQUAL(ptr->getMaxSize(), 2)
+  EmpiricalFormula("C1").getIsotopeDistribution(2);
+  EmpiricalFormula("C2").getIsotopeDistribution(2);
+  TEST_EQUAL(ptr->size(), 2)
+  // cache is emptied when full
+  EmpiricalFormula("C3").getIsotopeDistribution(2);
+  TEST_EQUAL(ptr->size(), 1)
+  // changing the size empties the cache
+  ptr->setMaxSize(3);
+  TEST_EQUAL(ptr->size(), 0)
+  EmpiricalFormula("C4").getIsotopeDistribution(2);
+  TEST_EQUAL(ptr->size(), 1)
+  // disabled
+  ptr->setMaxSize(0);
+  TEST_EQUAL(ptr->size(), 0)
+  EmpiricalFormula("C4").getIsotopeDistribution(2);
+  TEST_EQUAL(ptr->size(), 0)
+  // re-enabled
+  ptr->setMaxSize(100000);
+  EmpiricalFormula("C4").getIsotopeDistribution(2);
+  TEST_EQUAL(ptr->size(), 1)
+}
+END_SECTION
+
+START_SECTION(Size getMaxSize() const)
+{
+  TEST_EQUAL(ptr->getMaxSize(), 100000)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] concurrent access))
+{
+  ptr->clear();
+  IsotopeDistribution reference = EmpiricalFormula("C50H100N10O20S").getIsotopeDistribution(10);
+  ptr->clear();
+  Size mismatches = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: mismatches)
+#endif
+  for (SignedSize i = 0; i < 1000; ++i)
+  {
+    if (EmpiricalFormula("C50H100N10O20S").getIsotopeDistribution(10) != reference) ++mismatches;
+    IsotopeDistribution averagine(5);
+    averagine.estimateFromPeptideWeight(500.0 + (i % 50));
+  }
+  TEST_EQUAL(mismatches, 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
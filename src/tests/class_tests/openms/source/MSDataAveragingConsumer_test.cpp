@@ -0,0 +1,192 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataAveragingConsumer.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+using namespace OpenMS;
+
+// collects all spectra passed on by the averaging consumer
+class CollectingConsumer :
+  public Interfaces::IMSDataConsumer<>
+{
+public:
+  void consumeSpectrum(SpectrumType& s) { exp.addSpectrum(s); }
+  void consumeChromatogram(ChromatogramType& c) { exp.addChromatogram(c); }
+  void setExpectedSize(Size, Size) {}
+  void setExperimentalSettings(const ExperimentalSettings&) {}
+
+  MSExperiment<> exp;
+};
+
+// compares streaming and in-memory averaging of the given file
+void testAveraging(const String& filename, const Param& p, const String& average_type)
+{
+  MSExperiment<> exp;
+  MzMLFile().load(filename, exp);
+  MSExperiment<> exp_in_memory = exp;
+  SpectraMerger merger;
+  merger.setParameters(p);
+  merger.average(exp_in_memory, average_type);
+
+  CollectingConsumer collector;
+  MSDataAveragingConsumer consumer(&collector, p, average_type);
+  Size max_window_size = 0;
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    consumer.consumeSpectrum(exp[i]);
+    max_window_size = std::max(max_window_size, consumer.getWindowSize());
+  }
+  consumer.flush();
+  TEST_EQUAL(consumer.getWindowSize(), 0)
+  TEST_EQUAL(max_window_size < exp.size(), true)
+
+  TEST_EQUAL(collector.exp.size(), exp_in_memory.size())
+  if (collector.exp.size() != exp_in_memory.size()) return;
+  for (Size i = 0; i < exp_in_memory.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(collector.exp[i].getRT(), exp_in_memory[i].getRT())
+    TEST_EQUAL(collector.exp[i].size(), exp_in_memory[i].size())
+    if (collector.exp[i].size() != exp_in_memory[i].size()) continue;
+    for (Size j = 0; j < exp_in_memory[i].size(); ++j)
+    {
+      TEST_EQUAL(collector.exp[i][j].getMZ() == exp_in_memory[i][j].getMZ(), true)
+      TEST_EQUAL(collector.exp[i][j].getIntensity() == exp_in_memory[i][j].getIntensity(), true)
+    }
+  }
+}
+
+START_TEST(MSDataAveragingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSDataAveragingConsumer* ptr = 0;
+MSDataAveragingConsumer* nullPointer = 0;
+CollectingConsumer collector;
+
+START_SECTION((MSDataAveragingConsumer(Interfaces::IMSDataConsumer<>* next_consumer, const Param& param, const String& average_type)))
+{
+  ptr = new MSDataAveragingConsumer(&collector, Param(), "gaussian");
+  TEST_NOT_EQUAL(ptr, nullPointer)
+}
+END_SECTION
+
+START_SECTION((~MSDataAveragingConsumer()))
+{
+  delete ptr;
+}
+END_SECTION
+
+Param p;
+p.setValue("mz_binning_width", 0.0001);
+p.setValue("mz_binning_width_unit", "Da");
+p.setValue("average_gaussian:ms_level", 1);
+p.setValue("average_gaussian:rt_FWHM", 5.0);
+p.setValue("average_tophat:ms_level", 1);
+p.setValue("average_tophat:rt_range", 5.0);
+p.setValue("average_tophat:rt_unit", "scans");
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  // results are identical to the in-memory averaging
+  testAveraging(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_3.mzML"), p, "gaussian"); // profile mode
+  testAveraging(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_4.mzML"), p, "gaussian"); // centroid mode
+  testAveraging(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_4.mzML"), p, "tophat");
+
+  // spectra have to be sorted by RT
+  MSDataAveragingConsumer consumer(&collector, p, "gaussian");
+  MSSpectrum<> s;
+  s.setRT(10.0);
+  consumer.consumeSpectrum(s);
+  s.setRT(5.0);
+  TEST_EXCEPTION(Exception::IllegalArgument, consumer.consumeSpectrum(s))
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  collector.exp.clear(true);
+  MSDataAveragingConsumer consumer(&collector, p, "gaussian");
+  MSChromatogram<> c;
+  consumer.consumeChromatogram(c);
+  TEST_EQUAL(collector.exp.getChromatograms().size(), 1)
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  collector.exp.clear(true);
+  MSDataAveragingConsumer consumer(&collector, p, "tophat");
+  MSSpectrum<> s;
+  s.setMSLevel(1);
+  s.setRT(10.0);
+  consumer.consumeSpectrum(s);
+  TEST_EQUAL(collector.exp.size(), 0) // waiting for the next spectra
+  TEST_EQUAL(consumer.getWindowSize(), 1)
+  consumer.flush();
+  TEST_EQUAL(collector.exp.size(), 1)
+  TEST_EQUAL(consumer.getWindowSize(), 0)
+}
+END_SECTION
+
+START_SECTION((Size getWindowSize() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+{
+  NOT_TESTABLE // passed on to the next consumer
+}
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& exp)))
+{
+  NOT_TESTABLE // passed on to the next consumer
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -33,92 +33,220 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
 
 ///////////////////////////
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 ///////////////////////////
 
+#include <OpenMS/FORMAT/IndexedMzMLFile.h>
+
 using namespace OpenMS;
 using namespace std;
 
+// writes all spectra and chromatograms of exp using the given batch size
+void writeWithBatchSize(const MSExperiment<>& exp, const String& filename, Size batch_size)
+{
+  PlainMSDataWritingConsumer consumer(filename);
+  consumer.getOptions().setWriteIndex(true);
+  consumer.setWriteBatchSize(batch_size);
+  consumer.setExperimentalSettings(exp);
+  consumer.setExpectedSize(exp.getNrSpectra(), exp.getNrChromatograms());
+  for (Size i = 0; i < exp.getNrSpectra(); ++i)
+  {
+    MSSpectrum<> s = exp[i];
+    consumer.consumeSpectrum(s);
+  }
+  for (Size i = 0; i < exp.getNrChromatograms(); ++i)
+  {
+    MSChromatogram<> c = exp.getChromatograms()[i];
+    consumer.consumeChromatogram(c);
+  }
+}
+
+String readFile(const String& filename)
+{
+  ifstream ifs(filename.c_str(), ios::binary);
+  return String(string((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>()));
+}
+
 START_TEST(MSDataWritingConsumer, "$Id$")
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
-MSDataWritingConsumer* ptr = 0;
-MSDataWritingConsumer* null_ptr = 0;
-START_SECTION(MSDataWritingConsumer())
+MSExperiment<> exp;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+
+PlainMSDataWritingConsumer* ptr = 0;
+PlainMSDataWritingConsumer* null_ptr = 0;
+START_SECTION((MSDataWritingConsumer(String filename)))
 {
-	ptr = new MSDataWritingConsumer();
-	TEST_NOT_EQUAL(ptr, null_ptr)
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  ptr = new PlainMSDataWritingConsumer(tmp_filename);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getNrSpectraWritten(), 0)
+  TEST_EQUAL(ptr->getNrChromatogramsWritten(), 0)
 }
 END_SECTION
 
-START_SECTION(~MSDataWritingConsumer())
+START_SECTION((virtual ~MSDataWritingConsumer()))
 {
-	delete ptr;
+  delete ptr;
 }
 END_SECTION
 
-START_SECTION((virtual void setExperimentalSettings(const ExperimentalSettings &exp)))
+START_SECTION((void setWriteBatchSize(Size batch_size)))
 {
-  // TODO
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  PlainMSDataWritingConsumer consumer(tmp_filename);
+  TEST_EQUAL(consumer.getWriteBatchSize(), 100)
+  consumer.setWriteBatchSize(7);
+  TEST_EQUAL(consumer.getWriteBatchSize(), 7)
+  consumer.setWriteBatchSize(0);
+  TEST_EQUAL(consumer.getWriteBatchSize(), 1)
 }
 END_SECTION
 
-START_SECTION((virtual void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+START_SECTION((Size getWriteBatchSize() const))
 {
-  // TODO
+  NOT_TESTABLE // tested above
 }
 END_SECTION
 
-START_SECTION((virtual void consumeSpectrum(SpectrumType &s)))
+START_SECTION((virtual void setExperimentalSettings(const ExperimentalSettings &exp)))
 {
-  // TODO
+  NOT_TESTABLE // tested below
 }
 END_SECTION
 
-START_SECTION((virtual void consumeChromatogram(ChromatogramType &c)))
+START_SECTION((virtual void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
 {
-  // TODO
+  NOT_TESTABLE // tested below
 }
 END_SECTION
 
-START_SECTION((MSDataWritingConsumer(String filename)))
+START_SECTION((virtual void consumeSpectrum(SpectrumType &s)))
 {
-  // TODO
+  TEST_EQUAL(exp.getNrSpectra() > 2, true)
+  TEST_EQUAL(exp.getNrChromatograms() > 0, true)
+
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  writeWithBatchSize(exp, tmp_filename, 2);
+
+  MSExperiment<> result;
+  MzMLFile().load(tmp_filename, result);
+  TEST_EQUAL(result.getNrSpectra(), exp.getNrSpectra())
+  TEST_EQUAL(result.getNrChromatograms(), exp.getNrChromatograms())
+  for (Size i = 0; i < result.getNrSpectra(); ++i)
+  {
+    TEST_STRING_EQUAL(result.getSpectrum(i).getNativeID(), exp.getSpectrum(i).getNativeID())
+    TEST_EQUAL(result.getSpectrum(i).size(), exp.getSpectrum(i).size())
+    TEST_REAL_SIMILAR(result.getSpectrum(i).getRT(), exp.getSpectrum(i).getRT())
+  }
+
+  // the index written on the fly points to the correct spectra
+  IndexedMzMLFile indexed(tmp_filename);
+  TEST_EQUAL(indexed.getParsingSuccess(), true)
+  TEST_EQUAL(indexed.getNrSpectra(), exp.getNrSpectra())
+  for (Size i = 0; i < indexed.getNrSpectra(); ++i)
+  {
+    TEST_EQUAL(indexed.getSpectrumById(i)->getMZArray()->data.size(), exp.getSpectrum(i).size())
+  }
 }
 END_SECTION
 
-START_SECTION((virtual ~MSDataWritingConsumer()))
+START_SECTION((virtual void consumeChromatogram(ChromatogramType &c)))
+{
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  writeWithBatchSize(exp, tmp_filename, 2);
+
+  MSExperiment<> result;
+  MzMLFile().load(tmp_filename, result);
+  TEST_EQUAL(result.getNrChromatograms(), exp.getNrChromatograms())
+  for (Size i = 0; i < result.getNrChromatograms(); ++i)
+  {
+    TEST_STRING_EQUAL(result.getChromatogram(i).getNativeID(), exp.getChromatogram(i).getNativeID())
+    TEST_EQUAL(result.getChromatogram(i).size(), exp.getChromatogram(i).size())
+  }
+
+  IndexedMzMLFile indexed(tmp_filename);
+  TEST_EQUAL(indexed.getParsingSuccess(), true)
+  TEST_EQUAL(indexed.getNrChromatograms(), exp.getNrChromatograms())
+  for (Size i = 0; i < indexed.getNrChromatograms(); ++i)
+  {
+    TEST_EQUAL(indexed.getChromatogramById(i)->getTimeArray()->data.size(), exp.getChromatogram(i).size())
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] output does not depend on the batch size)
 {
-  // TODO
+  std::string tmp_single, tmp_small, tmp_large;
+  NEW_TMP_FILE(tmp_single);
+  NEW_TMP_FILE(tmp_small);
+  NEW_TMP_FILE(tmp_large);
+  writeWithBatchSize(exp, tmp_single, 1);
+  writeWithBatchSize(exp, tmp_small, 3);
+  writeWithBatchSize(exp, tmp_large, 1000);
+
+  String single = readFile(tmp_single);
+  TEST_EQUAL(single.empty(), false)
+  TEST_EQUAL(readFile(tmp_small) == single, true)
+  TEST_EQUAL(readFile(tmp_large) == single, true)
 }
 END_SECTION
 
 START_SECTION((virtual void addDataProcessing(DataProcessing d)))
 {
-  // TODO
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  {
+    PlainMSDataWritingConsumer consumer(tmp_filename);
+    DataProcessing dp;
+    dp.getProcessingActions().insert(DataProcessing::SMOOTHING);
+    consumer.addDataProcessing(dp);
+    consumer.setExpectedSize(1, 0);
+    MSSpectrum<> s = exp.getSpectrum(0);
+    consumer.consumeSpectrum(s);
+  }
+  MSExperiment<> result;
+  MzMLFile().load(tmp_filename, result);
+  TEST_EQUAL(result.getNrSpectra(), 1)
+  TEST_EQUAL(result.getSpectrum(0).getDataProcessing().empty(), false)
+  TEST_EQUAL(result.getSpectrum(0).getDataProcessing().back()->getProcessingActions().count(DataProcessing::SMOOTHING), 1)
 }
 END_SECTION
 
 START_SECTION((virtual Size getNrSpectraWritten()))
 {
-  // TODO
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  PlainMSDataWritingConsumer consumer(tmp_filename);
+  consumer.setExpectedSize(2, 1);
+  MSSpectrum<> s = exp.getSpectrum(0);
+  consumer.consumeSpectrum(s);
+  consumer.consumeSpectrum(s);
+  // buffered spectra are counted as well
+  TEST_EQUAL(consumer.getNrSpectraWritten(), 2)
+  TEST_EQUAL(consumer.getNrChromatogramsWritten(), 0)
+  MSChromatogram<> c = exp.getChromatogram(0);
+  consumer.consumeChromatogram(c);
+  TEST_EQUAL(consumer.getNrSpectraWritten(), 2)
+  TEST_EQUAL(consumer.getNrChromatogramsWritten(), 1)
 }
 END_SECTION
 
 START_SECTION((virtual Size getNrChromatogramsWritten()))
 {
-  // TODO
+  NOT_TESTABLE // tested above
 }
 END_SECTION
 
-
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
-
-
-
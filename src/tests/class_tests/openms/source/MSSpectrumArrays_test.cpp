@@ -0,0 +1,342 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/MSSpectrumArrays.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractor.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractorAlgorithm.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(MSSpectrumArrays, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSSpectrum<> spec;
+spec.setRT(12.5);
+spec.setMSLevel(2);
+spec.setName("spectrum");
+Peak1D p;
+for (Size i = 0; i < 10; ++i)
+{
+  p.setMZ(100.0 + i);
+  p.setIntensity(10.0f * i);
+  spec.push_back(p);
+}
+
+MSSpectrumArrays<>* ptr = 0;
+MSSpectrumArrays<>* nullPointer = 0;
+START_SECTION(MSSpectrumArrays())
+{
+  ptr = new MSSpectrumArrays<>();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getMSLevel(), 1)
+  TEST_REAL_SIMILAR(ptr->getRT(), -1.0)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(template <typename PeakT> explicit MSSpectrumArrays(const MSSpectrum<PeakT>& spectrum))
+{
+  MSSpectrumArrays<> arrays(spec);
+  TEST_EQUAL(arrays.size(), 10)
+  TEST_REAL_SIMILAR(arrays.getRT(), 12.5)
+  TEST_EQUAL(arrays.getMSLevel(), 2)
+  TEST_REAL_SIMILAR(arrays.getMZ(3), 103.0)
+  TEST_REAL_SIMILAR(arrays.getIntensity(3), 30.0)
+
+  MSSpectrumArrays<float> float_arrays(spec);
+  TEST_EQUAL(float_arrays.size(), 10)
+  TEST_REAL_SIMILAR(float_arrays.getMZ(9), 109.0)
+}
+END_SECTION
+
+START_SECTION(template <typename PeakT> void assign(const MSSpectrum<PeakT>& spectrum))
+{
+  MSSpectrumArrays<> arrays;
+  arrays.push_back(1.0, 1.0f);
+  arrays.assign(spec);
+  TEST_EQUAL(arrays.size(), 10)
+  TEST_REAL_SIMILAR(arrays.getMZ(0), 100.0)
+  TEST_EQUAL(arrays.getMSLevel(), 2)
+}
+END_SECTION
+
+START_SECTION(template <typename PeakT> void toSpectrum(MSSpectrum<PeakT>& spectrum) const)
+{
+  MSSpectrumArrays<> arrays(spec);
+  MSSpectrum<> out;
+  out.setName("kept");
+  out.push_back(p);
+  out.getFloatDataArrays().resize(1);
+  arrays.toSpectrum(out);
+  TEST_EQUAL(out.size(), 10)
+  TEST_EQUAL(out.getName(), "kept")
+  TEST_EQUAL(out.getFloatDataArrays().size(), 0)
+  TEST_REAL_SIMILAR(out.getRT(), 12.5)
+  TEST_EQUAL(out.getMSLevel(), 2)
+  for (Size i = 0; i < out.size(); ++i)
+  {
+    TEST_EQUAL(out[i].getMZ(), spec[i].getMZ())
+    TEST_EQUAL(out[i].getIntensity(), spec[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION(bool operator==(const MSSpectrumArrays& rhs) const)
+{
+  MSSpectrumArrays<> a(spec), b(spec);
+  TEST_EQUAL(a == b, true)
+  b.setRT(1.0);
+  TEST_EQUAL(a == b, false)
+  b = a;
+  b.push_back(200.0, 1.0f);
+  TEST_EQUAL(a == b, false)
+}
+END_SECTION
+
+START_SECTION(bool operator!=(const MSSpectrumArrays& rhs) const)
+{
+  MSSpectrumArrays<> a(spec), b(spec);
+  TEST_EQUAL(a != b, false)
+  b.setMSLevel(1);
+  TEST_EQUAL(a != b, true)
+}
+END_SECTION
+
+START_SECTION(double getRT() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void setRT(double rt))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(UInt getMSLevel() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void setMSLevel(UInt ms_level))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size size() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(bool empty() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void clear())
+{
+  MSSpectrumArrays<> arrays(spec);
+  arrays.clear();
+  TEST_EQUAL(arrays.empty(), true)
+  TEST_EQUAL(arrays.getIntensityArray().size(), 0)
+  TEST_EQUAL(arrays.getMSLevel(), 2)
+}
+END_SECTION
+
+START_SECTION(void reserve(Size n))
+{
+  MSSpectrumArrays<> arrays;
+  arrays.reserve(100);
+  TEST_EQUAL(arrays.getMZArray().capacity() >= 100, true)
+  TEST_EQUAL(arrays.getIntensityArray().capacity() >= 100, true)
+}
+END_SECTION
+
+START_SECTION(void push_back(MZType mz, IntensityType intensity))
+{
+  MSSpectrumArrays<> arrays;
+  arrays.push_back(5.0, 2.0f);
+  TEST_EQUAL(arrays.size(), 1)
+  TEST_REAL_SIMILAR(arrays.getMZ(0), 5.0)
+  TEST_REAL_SIMILAR(arrays.getIntensity(0), 2.0)
+}
+END_SECTION
+
+START_SECTION(void push_back(const PeakType& peak))
+{
+  MSSpectrumArrays<> arrays;
+  arrays.push_back(p);
+  TEST_EQUAL(arrays.size(), 1)
+  TEST_REAL_SIMILAR(arrays.getMZ(0), p.getMZ())
+  TEST_REAL_SIMILAR(arrays.getIntensity(0), p.getIntensity())
+}
+END_SECTION
+
+START_SECTION(ConstPeakReference operator[](Size i) const)
+{
+  const MSSpectrumArrays<> arrays(spec);
+  TEST_REAL_SIMILAR(arrays[4].getMZ(), 104.0)
+  TEST_REAL_SIMILAR(arrays[4].getIntensity(), 40.0)
+
+  // templated spectrum code works on both layouts
+  ChromatogramExtractor extractor;
+  Size peak_idx_spec = 0, peak_idx_arrays = 0;
+  double intensity_spec = 0, intensity_arrays = 0;
+  extractor.extract_value_tophat(spec, 104.2, peak_idx_spec, intensity_spec, 2.0, false);
+  extractor.extract_value_tophat(arrays, 104.2, peak_idx_arrays, intensity_arrays, 2.0, false);
+  TEST_REAL_SIMILAR(intensity_spec, 90.0)
+  TEST_REAL_SIMILAR(intensity_arrays, intensity_spec)
+  TEST_EQUAL(peak_idx_arrays, peak_idx_spec)
+}
+END_SECTION
+
+START_SECTION(MZType getMZ(Size i) const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(IntensityType getIntensity(Size i) const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(const MZArray& getMZArray() const)
+{
+  // the arrays can be consumed directly, e.g. by the iterator based extraction
+  const MSSpectrumArrays<> arrays(spec);
+  std::vector<double> intensities(arrays.getIntensityArray().begin(), arrays.getIntensityArray().end());
+  std::vector<double>::const_iterator mz_it = arrays.getMZArray().begin();
+  std::vector<double>::const_iterator int_it = intensities.begin();
+  double intensity = 0;
+  ChromatogramExtractorAlgorithm().extract_value_tophat(arrays.getMZArray().begin(), mz_it, arrays.getMZArray().end(), int_it,
+                                                        104.2, intensity, 2.0, false);
+  TEST_REAL_SIMILAR(intensity, 90.0)
+}
+END_SECTION
+
+START_SECTION(MZArray& getMZArray())
+{
+  MSSpectrumArrays<> arrays;
+  std::vector<double> mz(3, 1.0);
+  std::vector<float> intensity(3, 2.0f);
+  arrays.getMZArray().swap(mz);
+  arrays.getIntensityArray().swap(intensity);
+  TEST_EQUAL(arrays.size(), 3)
+  TEST_REAL_SIMILAR(arrays.getIntensity(2), 2.0)
+}
+END_SECTION
+
+START_SECTION(const IntensityArray& getIntensityArray() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(IntensityArray& getIntensityArray())
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void sortByPosition())
+{
+  MSSpectrumArrays<> arrays;
+  arrays.push_back(3.0, 3.0f);
+  arrays.push_back(1.0, 1.0f);
+  arrays.push_back(2.0, 2.0f);
+  arrays.push_back(1.0, 4.0f);
+  TEST_EQUAL(arrays.isSorted(), false)
+  arrays.sortByPosition();
+  TEST_EQUAL(arrays.isSorted(), true)
+  TEST_REAL_SIMILAR(arrays.getMZ(0), 1.0)
+  TEST_REAL_SIMILAR(arrays.getIntensity(0), 1.0)
+  TEST_REAL_SIMILAR(arrays.getMZ(1), 1.0)
+  TEST_REAL_SIMILAR(arrays.getIntensity(1), 4.0)
+  TEST_REAL_SIMILAR(arrays.getIntensity(2), 2.0)
+  TEST_REAL_SIMILAR(arrays.getIntensity(3), 3.0)
+}
+END_SECTION
+
+START_SECTION(bool isSorted() const)
+{
+  TEST_EQUAL(MSSpectrumArrays<>().isSorted(), true)
+  TEST_EQUAL(MSSpectrumArrays<>(spec).isSorted(), true)
+}
+END_SECTION
+
+START_SECTION(Size MZBegin(double mz) const)
+{
+  MSSpectrumArrays<> arrays(spec);
+  TEST_EQUAL(arrays.MZBegin(99.0), 0)
+  TEST_EQUAL(arrays.MZBegin(103.0), 3)
+  TEST_EQUAL(arrays.MZBegin(103.5), 4)
+  TEST_EQUAL(arrays.MZBegin(200.0), 10)
+  TEST_EQUAL(arrays.MZBegin(103.0), Size(spec.MZBegin(103.0) - spec.begin()))
+}
+END_SECTION
+
+START_SECTION(Size MZEnd(double mz) const)
+{
+  MSSpectrumArrays<> arrays(spec);
+  TEST_EQUAL(arrays.MZEnd(99.0), 0)
+  TEST_EQUAL(arrays.MZEnd(103.0), 4)
+  TEST_EQUAL(arrays.MZEnd(200.0), 10)
+  TEST_EQUAL(arrays.MZEnd(103.0), Size(spec.MZEnd(103.0) - spec.begin()))
+}
+END_SECTION
+
+START_SECTION(Size findNearest(double mz) const)
+{
+  MSSpectrumArrays<> arrays(spec);
+  TEST_EQUAL(arrays.findNearest(0.0), 0)
+  TEST_EQUAL(arrays.findNearest(103.4), 3)
+  TEST_EQUAL(arrays.findNearest(103.6), 4)
+  TEST_EQUAL(arrays.findNearest(500.0), 9)
+  TEST_EXCEPTION(Exception::Precondition, MSSpectrumArrays<>().findNearest(1.0))
+
+  MSSpectrumArrays<float> float_arrays(spec);
+  TEST_EQUAL(float_arrays.findNearest(103.6), 4)
+}
+END_SECTION
+
+START_SECTION(Int findNearest(double mz, double tolerance) const)
+{
+  MSSpectrumArrays<> arrays(spec);
+  TEST_EQUAL(arrays.findNearest(103.4, 0.5), 3)
+  TEST_EQUAL(arrays.findNearest(103.4, 0.1), -1)
+  TEST_EQUAL(MSSpectrumArrays<>().findNearest(1.0, 1.0), -1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
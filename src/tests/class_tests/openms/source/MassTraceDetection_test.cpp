@@ -35,6 +35,10 @@
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
+
+#include <algorithm>
+#include <cmath>
 
 ///////////////////////////
 #include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
@@ -237,7 +241,118 @@ START_SECTION((void run(MSExperiment< Peak1D >::ConstAreaIterator &begin, MSExpe
 END_SECTION
 
 
+START_SECTION((void startStreaming()))
+{
+    // discards spectra consumed before
+    std::vector<MassTrace> streamed_mt;
+    test_mtd.consumeSpectrum(input[0], streamed_mt);
+    test_mtd.startStreaming();
+    TEST_EXCEPTION(Exception::InvalidValue, test_mtd.finishStreaming(streamed_mt))
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(const MSSpectrum<Peak1D>& spectrum, std::vector<MassTrace>& completed_masstraces)))
+{
+    // the whole map fits into a single chunk: same result as run()
+    std::vector<MassTrace> streamed_mt;
+    test_mtd.startStreaming();
+    for (Size i = 0; i < input.size(); ++i)
+    {
+      test_mtd.consumeSpectrum(input[i], streamed_mt);
+    }
+    TEST_EQUAL(streamed_mt.size(), 0)
+    test_mtd.finishStreaming(streamed_mt);
+    TEST_EQUAL(streamed_mt.size(), 3)
+    ABORT_IF(streamed_mt.size() != 3)
+    for (Size i = 0; i < streamed_mt.size(); ++i)
+    {
+        TEST_EQUAL(streamed_mt[i].getSize(), exp_mt_lengths[i]);
+        TEST_REAL_SIMILAR(streamed_mt[i].getCentroidRT(), exp_mt_rts[i]);
+        TEST_REAL_SIMILAR(streamed_mt[i].getCentroidMZ(), exp_mt_mzs[i]);
+        TEST_REAL_SIMILAR(streamed_mt[i].computePeakArea(), exp_mt_ints[i]);
+    }
+
+    // spectra must be sorted by RT
+    test_mtd.startStreaming();
+    test_mtd.consumeSpectrum(input[1], streamed_mt);
+    TEST_EXCEPTION(Exception::Precondition, test_mtd.consumeSpectrum(input[0], streamed_mt))
+    test_mtd.startStreaming();
+}
+END_SECTION
+
+START_SECTION((void finishStreaming(std::vector<MassTrace>& completed_masstraces)))
+{
+    // three Gaussian elution profiles (apex at 20, 50 and 80 seconds), one spectrum per second
+    MSExperiment<Peak1D> synthetic;
+    for (Size rt = 0; rt < 100; ++rt)
+    {
+      MSSpectrum<Peak1D> spec;
+      spec.setRT(rt);
+      spec.setMSLevel(1);
+      for (Size j = 0; j < 3; ++j)
+      {
+        double diff((double)rt - 20.0 - 30.0 * j);
+        Peak1D peak;
+        peak.setMZ(200.0 + 100.0 * j);
+        peak.setIntensity(1e5 * std::exp(-diff * diff / 18.0));
+        spec.push_back(peak);
+      }
+      synthetic.addSpectrum(spec);
+    }
 
+    MassTraceDetection mtd;
+    std::vector<MassTrace> batch_mt;
+    mtd.run(synthetic, batch_mt);
+    TEST_EQUAL(batch_mt.size(), 3)
+
+    Param p_stream(mtd.getParameters());
+    p_stream.setValue("chunk:rt_window", 10.0);
+    p_stream.setValue("chunk:rt_overlap", 30.0);
+    mtd.setParameters(p_stream);
+
+    std::vector<MassTrace> streamed_mt;
+    mtd.startStreaming();
+    for (Size i = 0; i < synthetic.size(); ++i)
+    {
+      mtd.consumeSpectrum(synthetic[i], streamed_mt);
+      // traces are completed as soon as their chunk has been processed
+      if (synthetic[i].getRT() == 45.0)
+      {
+        TEST_EQUAL(streamed_mt.size(), 1)
+        TEST_REAL_SIMILAR(mtd.getStreamingBoundary(), 0.0)
+      }
+      // spectra which can no longer be part of a trace have been discarded
+      if (synthetic[i].getRT() == 70.0)
+      {
+        TEST_EQUAL(streamed_mt.size(), 2)
+        TEST_REAL_SIMILAR(mtd.getStreamingBoundary(), 10.0)
+      }
+    }
+    mtd.finishStreaming(streamed_mt);
+    TEST_EQUAL(streamed_mt.size(), 3)
+    ABORT_IF(streamed_mt.size() != 3)
+
+    std::sort(batch_mt.begin(), batch_mt.end(), CmpMassTraceByMZ());
+    std::sort(streamed_mt.begin(), streamed_mt.end(), CmpMassTraceByMZ());
+    for (Size i = 0; i < streamed_mt.size(); ++i)
+    {
+      TEST_EQUAL(streamed_mt[i].getSize(), batch_mt[i].getSize())
+      TEST_REAL_SIMILAR(streamed_mt[i].getCentroidRT(), batch_mt[i].getCentroidRT())
+      TEST_REAL_SIMILAR(streamed_mt[i].getCentroidMZ(), batch_mt[i].getCentroidMZ())
+    }
+    // labels stay unique across chunks
+    TEST_NOT_EQUAL(streamed_mt[0].getLabel(), streamed_mt[1].getLabel())
+    TEST_NOT_EQUAL(streamed_mt[1].getLabel(), streamed_mt[2].getLabel())
+    TEST_NOT_EQUAL(streamed_mt[0].getLabel(), streamed_mt[2].getLabel())
+}
+END_SECTION
+
+START_SECTION((double getStreamingBoundary() const))
+{
+    // tested above
+    NOT_TESTABLE
+}
+END_SECTION
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
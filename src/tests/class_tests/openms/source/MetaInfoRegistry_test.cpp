@@ -39,6 +39,8 @@
 
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 
+#include <set>
+
 ///////////////////////////
 
 START_TEST(MetaInfoRegistry, "$Id$")
@@ -174,6 +176,40 @@ START_SECTION((MetaInfoRegistry& operator=(const MetaInfoRegistry& rhs)))
 	TEST_STRING_EQUAL(mir2.getUnit("retention time"), "sec")
 END_SECTION
 
+START_SECTION(([EXTRA] concurrent registration and lookup))
+{
+	// many names (the internal hash table grows several times), each
+	// registered by several threads at once
+	MetaInfoRegistry mir2;
+	const int name_count = 5000;
+	Size mismatches = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: mismatches)
+#endif
+	for (int i = 0; i < 4 * name_count; ++i)
+	{
+		String name = "concurrent_" + String(i % name_count);
+		UInt index = mir2.registerName(name);
+		if (mir2.getIndex(name) != index || mir2.getName(index) != name || mir2.getIndex("label") != 3)
+		{
+			++mismatches;
+		}
+	}
+	TEST_EQUAL(mismatches, 0)
+
+	// every name got its own index
+	std::set<UInt> indices;
+	for (int i = 0; i < name_count; ++i)
+	{
+		indices.insert(mir2.getIndex("concurrent_" + String(i)));
+	}
+	TEST_EQUAL(indices.size(), name_count)
+	TEST_EQUAL(*indices.begin(), 1024)
+	TEST_EQUAL(*indices.rbegin(), 1024 + name_count - 1)
+	TEST_EQUAL(mir2.getIndex("concurrent_"), UInt(-1))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
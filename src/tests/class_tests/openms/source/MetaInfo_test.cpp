@@ -243,6 +243,43 @@ START_SECTION((void removeValue(const String& name)))
 	i.removeValue("icon");
 END_SECTION
 
+START_SECTION(([EXTRA] many values in arbitrary order))
+	// more values than are stored inline
+	MetaInfo i;
+	for (UInt index = 20; index > 0; --index)
+	{
+		i.setValue(index * 7 % 23, String(index));
+	}
+	std::vector<UInt> keys;
+	i.getKeys(keys);
+	TEST_EQUAL(keys.size(), 20)
+	for (Size k = 1; k < keys.size(); ++k)
+	{
+		TEST_EQUAL(keys[k - 1] < keys[k], true)
+	}
+	TEST_STRING_EQUAL(String(i.getValue(7)), "1")
+	TEST_STRING_EQUAL(String(i.getValue(20 * 7 % 23)), "20")
+
+	// copies are independent
+	MetaInfo i2(i);
+	TEST_EQUAL(i == i2, true)
+	i2.removeValue(7);
+	TEST_EQUAL(i == i2, false)
+	TEST_EQUAL(i.exists(7), true)
+	TEST_EQUAL(i2.exists(7), false)
+	i2.setValue(7, String("1"));
+	TEST_EQUAL(i == i2, true)
+
+	// setting a value from another value of the same object
+	i.setValue(1000, i.getValue(7));
+	TEST_STRING_EQUAL(String(i.getValue(1000)), "1")
+
+	i.clear();
+	TEST_EQUAL(i.empty(), true)
+	i.setValue(3, String("x"));
+	TEST_STRING_EQUAL(String(i.getValue(3)), "x")
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
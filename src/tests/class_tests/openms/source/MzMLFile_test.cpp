@@ -40,6 +40,11 @@
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace OpenMS;
 using namespace std;
@@ -54,6 +59,15 @@ DRange<1> makeRange(double a, double b)
 
 ///////////////////////////
 
+// counts the spectra the consumer receives from within a parallel region
+Size spectra_in_parallel = 0;
+void recordParallelSpectrum(MSSpectrum<>& /* s */)
+{
+#ifdef _OPENMP
+  if (omp_in_parallel()) ++spectra_in_parallel;
+#endif
+}
+
 START_TEST(MzMLFile, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -893,6 +907,45 @@ START_SECTION([EXTRA] load intensity range)
   TEST_EQUAL(exp[3].size(),0)
 END_SECTION
 
+START_SECTION([EXTRA] load with pipelined decoding)
+{
+  // small data pools force several batches to be in flight
+  MzMLFile file;
+  file.getOptions().setMaxDataPoolSize(1);
+  file.getOptions().setPipelinedDecoding(true);
+  MSExperiment<> exp_pipelined;
+  file.load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp_pipelined);
+
+  file.getOptions().setPipelinedDecoding(false);
+  MSExperiment<> exp;
+  file.load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+
+  TEST_EQUAL(exp_pipelined.size(), 4)
+  TEST_EQUAL(exp_pipelined.getChromatograms().size(), 2)
+  TEST_EQUAL(exp_pipelined.size(), exp.size())
+  for (Size i = 0; i < exp.size(); i++)
+  {
+    TEST_EQUAL(exp_pipelined[i] == exp[i], true)
+  }
+  for (Size i = 0; i < exp.getChromatograms().size(); i++)
+  {
+    TEST_EQUAL(exp_pipelined.getChromatograms()[i] == exp.getChromatograms()[i], true)
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] transform does not call the consumer in a parallel region by default)
+{
+  MzMLFile file;
+  file.getOptions().setMaxDataPoolSize(1);
+  MSDataTransformingConsumer consumer;
+  consumer.setSpectraProcessingPtr(&recordParallelSpectrum);
+  spectra_in_parallel = 0;
+  file.transform(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), &consumer);
+  TEST_EQUAL(spectra_in_parallel, 0)
+}
+END_SECTION
+
 START_SECTION((Size loadSize(const String & filename, Size& scount, Size& ccount)))
 {
   MzMLFile file;
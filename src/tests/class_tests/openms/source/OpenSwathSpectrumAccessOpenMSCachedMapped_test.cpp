@@ -0,0 +1,214 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCachedMapped.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/CachedMzML.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SpectrumAccessOpenMSCachedMapped, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// Create a cached file (data and meta data) and use it for all tests
+std::string tmp_filename;
+NEW_TMP_FILE(tmp_filename);
+MSExperiment<> exp;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+{
+  CachedmzML cache;
+  cache.writeMemdump(exp, tmp_filename + ".cached");
+  cache.writeMetadata(exp, tmp_filename, true);
+}
+
+SpectrumAccessOpenMSCachedMapped* ptr = 0;
+SpectrumAccessOpenMSCachedMapped* nullPointer = 0;
+
+START_SECTION(explicit SpectrumAccessOpenMSCachedMapped(String filename))
+{
+  ptr = new SpectrumAccessOpenMSCachedMapped(tmp_filename);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+
+  std::string unused_tmp_filename;
+  NEW_TMP_FILE(unused_tmp_filename);
+  TEST_EXCEPTION(Exception::FileNotFound, SpectrumAccessOpenMSCachedMapped spectrum_acc_fail(unused_tmp_filename))
+}
+END_SECTION
+
+START_SECTION(~SpectrumAccessOpenMSCachedMapped())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(size_t getNrSpectra() const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  TEST_EQUAL(spectrum_acc.getNrSpectra(), 4)
+}
+END_SECTION
+
+START_SECTION(size_t getNrChromatograms() const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  TEST_EQUAL(spectrum_acc.getNrChromatograms(), 2)
+}
+END_SECTION
+
+START_SECTION(boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const)
+{
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> sa_clone;
+  {
+    SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+    sa_clone = spectrum_acc.lightClone();
+  }
+  // the clone shares the mapping and outlives the original object
+  TEST_EQUAL(sa_clone->getNrSpectra(), 4)
+  TEST_EQUAL(sa_clone->getNrChromatograms(), 2)
+  OpenSwath::SpectrumPtr sptr = sa_clone->getSpectrumById(0);
+  TEST_EQUAL(sptr->getMZArray()->data.size(), exp.getSpectrum(0).size())
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr getSpectrumById(int id))
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  for (Size k = 0; k < spectrum_acc.getNrSpectra(); k++)
+  {
+    OpenSwath::SpectrumPtr sptr = spectrum_acc.getSpectrumById(k);
+    TEST_EQUAL(sptr->getMZArray()->data.size(), exp.getSpectrum(k).size())
+    TEST_EQUAL(sptr->getIntensityArray()->data.size(), exp.getSpectrum(k).size())
+    for (Size i = 0; i < sptr->getMZArray()->data.size(); i++)
+    {
+      TEST_REAL_SIMILAR(sptr->getMZArray()->data[i], exp.getSpectrum(k)[i].getMZ())
+      TEST_REAL_SIMILAR(sptr->getIntensityArray()->data[i], exp.getSpectrum(k)[i].getIntensity())
+    }
+  }
+}
+END_SECTION
+
+START_SECTION(void getSpectrumViewById(int id, DataArrayView& mz, DataArrayView& intensity) const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  SpectrumAccessOpenMSCachedMapped::DataArrayView mz, intensity;
+  spectrum_acc.getSpectrumViewById(1, mz, intensity);
+  TEST_EQUAL(mz.size, exp.getSpectrum(1).size())
+  TEST_EQUAL(intensity.size, exp.getSpectrum(1).size())
+  for (Size i = 0; i < mz.size; i++)
+  {
+    TEST_REAL_SIMILAR(mz[i], exp.getSpectrum(1)[i].getMZ())
+    TEST_REAL_SIMILAR(intensity[i], exp.getSpectrum(1)[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  OpenSwath::SpectrumMeta spmeta = spectrum_acc.getSpectrumMetaById(0);
+  TEST_REAL_SIMILAR(spmeta.RT, exp.getSpectrum(0).getRT())
+  TEST_EQUAL(spmeta.ms_level, static_cast<int>(exp.getSpectrum(0).getMSLevel()))
+}
+END_SECTION
+
+START_SECTION(SpectrumSettings getSpectraMetaInfo(int id) const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  SpectrumSettings settings = spectrum_acc.getSpectraMetaInfo(0);
+  TEST_EQUAL(settings.getNativeID(), exp.getSpectrum(0).getNativeID())
+}
+END_SECTION
+
+START_SECTION(std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  std::vector<std::size_t> result = spectrum_acc.getSpectraByRT(exp.getSpectrum(0).getRT(), 0.01);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 0)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::ChromatogramPtr getChromatogramById(int id))
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  OpenSwath::ChromatogramPtr cptr = spectrum_acc.getChromatogramById(0);
+  TEST_EQUAL(cptr->getTimeArray()->data.size(), exp.getChromatogram(0).size())
+  for (Size i = 0; i < cptr->getTimeArray()->data.size(); i++)
+  {
+    TEST_REAL_SIMILAR(cptr->getTimeArray()->data[i], exp.getChromatogram(0)[i].getRT())
+    TEST_REAL_SIMILAR(cptr->getIntensityArray()->data[i], exp.getChromatogram(0)[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION(void getChromatogramViewById(int id, DataArrayView& rt, DataArrayView& intensity) const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  SpectrumAccessOpenMSCachedMapped::DataArrayView rt, intensity;
+  spectrum_acc.getChromatogramViewById(1, rt, intensity);
+  TEST_EQUAL(rt.size, exp.getChromatogram(1).size())
+  for (Size i = 0; i < rt.size; i++)
+  {
+    TEST_REAL_SIMILAR(rt[i], exp.getChromatogram(1)[i].getRT())
+    TEST_REAL_SIMILAR(intensity[i], exp.getChromatogram(1)[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION(ChromatogramSettings getChromatogramMetaInfo(int id) const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  TEST_EQUAL(spectrum_acc.getChromatogramMetaInfo(0).getNativeID(), exp.getChromatogram(0).getNativeID())
+}
+END_SECTION
+
+START_SECTION(std::string getChromatogramNativeID(int id) const)
+{
+  SpectrumAccessOpenMSCachedMapped spectrum_acc(tmp_filename);
+  TEST_EQUAL(spectrum_acc.getChromatogramNativeID(1), exp.getChromatogram(1).getNativeID())
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -246,6 +246,42 @@ START_SECTION(void setMaxDataPoolSize(Size size))
 }
 END_SECTION
 
+START_SECTION(bool getPipelinedDecoding() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getPipelinedDecoding(), true);
+}
+END_SECTION
+
+START_SECTION(void setPipelinedDecoding(bool pipelined))
+{
+	PeakFileOptions tmp;
+	tmp.setPipelinedDecoding(false);
+	TEST_EQUAL(tmp.getPipelinedDecoding(), false);
+	tmp.setPipelinedDecoding(true);
+	TEST_EQUAL(tmp.getPipelinedDecoding(), true);
+}
+END_SECTION
+
+START_SECTION(bool getPipelinedTransform() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getPipelinedTransform(), false);
+}
+END_SECTION
+
+START_SECTION(void setPipelinedTransform(bool pipelined))
+{
+	PeakFileOptions tmp;
+	tmp.setPipelinedTransform(true);
+	TEST_EQUAL(tmp.getPipelinedTransform(), true);
+	PeakFileOptions copy(tmp);
+	TEST_EQUAL(copy.getPipelinedTransform(), true);
+	tmp.setPipelinedTransform(false);
+	TEST_EQUAL(tmp.getPipelinedTransform(), false);
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -140,6 +140,48 @@ START_SECTION((template <typename PeakType> void pick(const MSSpectrum<PeakType>
 
 END_SECTION
 
+START_SECTION((template <typename MZType> void pick(const MSSpectrumArrays<MZType>& input, MSSpectrumArrays<MZType>& output) const))
+  MSSpectrumArrays<> input_arrays(input[0]), tmp_arrays;
+  pp_hires.pick(input_arrays, tmp_arrays);
+  TEST_EQUAL(tmp_arrays.size(), output[0].size())
+  TEST_REAL_SIMILAR(tmp_arrays.getRT(), input[0].getRT())
+  for (Size peak_idx = 0; peak_idx < tmp_arrays.size(); ++peak_idx)
+  {
+    TEST_REAL_SIMILAR(tmp_arrays.getMZ(peak_idx), output[0][peak_idx].getMZ())
+    TEST_REAL_SIMILAR(tmp_arrays.getIntensity(peak_idx), output[0][peak_idx].getIntensity())
+  }
+END_SECTION
+
+START_SECTION((template <typename MZType> void pick(const MSSpectrumArrays<MZType>& input, MSSpectrumArrays<MZType>& output, std::vector<PeakBoundary>& boundaries) const))
+  MSSpectrum<Peak1D> tmp_spec;
+  std::vector<PeakPickerHiRes::PeakBoundary> tmp_boundaries, arrays_boundaries;
+  pp_hires.pick(input[0], tmp_spec, tmp_boundaries);
+
+  MSSpectrumArrays<> input_arrays(input[0]), tmp_arrays;
+  pp_hires.pick(input_arrays, tmp_arrays, arrays_boundaries);
+  TEST_EQUAL(tmp_arrays.size(), tmp_spec.size())
+  TEST_EQUAL(arrays_boundaries.size(), tmp_boundaries.size())
+  ABORT_IF(arrays_boundaries.size() != tmp_boundaries.size())
+  for (Size peak_idx = 0; peak_idx < tmp_arrays.size(); ++peak_idx)
+  {
+    TEST_EQUAL(tmp_arrays.getMZ(peak_idx), tmp_spec[peak_idx].getMZ())
+    TEST_EQUAL(tmp_arrays.getIntensity(peak_idx), tmp_spec[peak_idx].getIntensity())
+    TEST_EQUAL(arrays_boundaries[peak_idx].mz_min, tmp_boundaries[peak_idx].mz_min)
+    TEST_EQUAL(arrays_boundaries[peak_idx].mz_max, tmp_boundaries[peak_idx].mz_max)
+  }
+
+  // single precision m/z: every picked peak is close to a peak picked with double precision
+  MSSpectrumArrays<float> input_float(input[0]), tmp_float;
+  pp_hires.pick(input_float, tmp_float);
+  TEST_EQUAL(tmp_float.empty(), false)
+  Size far_peaks = 0;
+  for (Size peak_idx = 0; peak_idx < tmp_float.size(); ++peak_idx)
+  {
+    if (tmp_spec.findNearest(tmp_float.getMZ(peak_idx), 0.001) == -1) ++far_peaks;
+  }
+  TEST_EQUAL(far_peaks, 0)
+END_SECTION
+
 START_SECTION([EXTRA](template <typename PeakType> void pickExperiment(const MSExperiment<PeakType>& input, MSExperiment<PeakType>& output)))
   // does the same as pick method for spectra
   NOT_TESTABLE
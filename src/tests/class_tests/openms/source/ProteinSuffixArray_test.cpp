@@ -0,0 +1,255 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArray.h>
+///////////////////////////
+
+#include <OpenMS/SYSTEM/File.h>
+
+#include <fstream>
+#include <iterator>
+#include <set>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ProteinSuffixArray, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+vector<String> proteins;
+proteins.push_back("MPEPTIDEKAAAR");
+proteins.push_back("PEPTIDEPEPTIDE");
+proteins.push_back("");
+proteins.push_back("XXXPEPTIDEK");
+
+std::string tmp_filename;
+NEW_TMP_FILE(tmp_filename);
+
+ProteinSuffixArray* ptr = 0;
+ProteinSuffixArray* nullPointer = 0;
+
+START_SECTION(ProteinSuffixArray())
+{
+  ptr = new ProteinSuffixArray();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isLoaded(), false)
+  TEST_EQUAL(ptr->getNumberOfProteins(), 0)
+}
+END_SECTION
+
+START_SECTION(~ProteinSuffixArray())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(static UInt64 computeChecksum(const std::vector<String>& sequences))
+{
+  vector<String> other(proteins);
+  TEST_EQUAL(ProteinSuffixArray::computeChecksum(proteins) == ProteinSuffixArray::computeChecksum(other), true)
+  // different partitioning into proteins
+  other[0] += other[1];
+  other[1] = "";
+  TEST_EQUAL(ProteinSuffixArray::computeChecksum(proteins) == ProteinSuffixArray::computeChecksum(other), false)
+  // I/L substitution
+  other = proteins;
+  other[0].substitute('L', 'I');
+  other[1].substitute('I', 'L');
+  TEST_EQUAL(ProteinSuffixArray::computeChecksum(proteins) == ProteinSuffixArray::computeChecksum(other), false)
+}
+END_SECTION
+
+START_SECTION(static String getCacheFilename(const String& directory, UInt64 checksum))
+{
+  TEST_STRING_EQUAL(ProteinSuffixArray::getCacheFilename("dir", 255), "dir/00000000000000ff.psa")
+}
+END_SECTION
+
+START_SECTION(static void build(const std::vector<String>& sequences, const String& filename))
+{
+  ProteinSuffixArray::build(proteins, tmp_filename);
+  TEST_EQUAL(File::exists(tmp_filename), true)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, ProteinSuffixArray::build(proteins, "/does/not/exist/index.psa"))
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename))
+{
+  ProteinSuffixArray index;
+  index.load(tmp_filename);
+  TEST_EQUAL(index.isLoaded(), true)
+
+  std::string unused_tmp_filename;
+  NEW_TMP_FILE(unused_tmp_filename);
+  TEST_EXCEPTION(Exception::FileNotFound, index.load(unused_tmp_filename))
+  TEST_EXCEPTION(Exception::ParseError, index.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+  // failed loading leaves the previous index intact
+  TEST_EQUAL(index.isLoaded(), true)
+
+  // a suffix array entry pointing outside of the text is rejected
+  std::string corrupt_filename;
+  NEW_TMP_FILE(corrupt_filename);
+  {
+    ifstream ifs(tmp_filename.c_str(), ios::binary);
+    string content((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+    // header (40 bytes) and protein starts (5 * 8 bytes) precede the suffix array
+    UInt32 invalid = 1000000;
+    content.replace(80, sizeof(UInt32), reinterpret_cast<const char*>(&invalid), sizeof(UInt32));
+    ofstream ofs(corrupt_filename.c_str(), ios::binary);
+    ofs << content;
+  }
+  TEST_EXCEPTION(Exception::ParseError, index.load(corrupt_filename))
+
+  // truncated file
+  {
+    ifstream ifs(tmp_filename.c_str(), ios::binary);
+    string content((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+    ofstream ofs(corrupt_filename.c_str(), ios::binary | ios::trunc);
+    ofs << content.substr(0, content.size() - 1);
+  }
+  TEST_EXCEPTION(Exception::ParseError, index.load(corrupt_filename))
+}
+END_SECTION
+
+ProteinSuffixArray index;
+index.load(tmp_filename);
+
+START_SECTION(bool isLoaded() const)
+{
+  TEST_EQUAL(index.isLoaded(), true)
+  TEST_EQUAL(ProteinSuffixArray().isLoaded(), false)
+}
+END_SECTION
+
+START_SECTION(UInt64 getChecksum() const)
+{
+  TEST_EQUAL(index.getChecksum() == ProteinSuffixArray::computeChecksum(proteins), true)
+}
+END_SECTION
+
+START_SECTION(bool matches(const std::vector<String>& sequences) const)
+{
+  TEST_EQUAL(index.matches(proteins), true)
+  vector<String> other(proteins);
+  other[3] = "XXXPEPTIDEL"; // same length, different sequence
+  TEST_EQUAL(index.matches(other), false)
+  other = proteins;
+  other.pop_back();
+  TEST_EQUAL(index.matches(other), false)
+  other = proteins;
+  other[0] += other[1];
+  other[1] = "";
+  TEST_EQUAL(index.matches(other), false)
+  TEST_EQUAL(ProteinSuffixArray().matches(proteins), false)
+}
+END_SECTION
+
+START_SECTION(Size getNumberOfProteins() const)
+{
+  TEST_EQUAL(index.getNumberOfProteins(), 4)
+}
+END_SECTION
+
+START_SECTION(void findAll(const String& peptide, std::vector<Hit>& hits) const)
+{
+  vector<ProteinSuffixArray::Hit> hits;
+  index.findAll("PEPTIDE", hits);
+  set<pair<Size, Size> > found;
+  for (Size i = 0; i < hits.size(); ++i)
+  {
+    found.insert(make_pair(hits[i].protein_index, hits[i].position));
+  }
+  TEST_EQUAL(hits.size(), 4)
+  TEST_EQUAL(found.size(), 4)
+  TEST_EQUAL(found.count(make_pair(Size(0), Size(1))), 1)
+  TEST_EQUAL(found.count(make_pair(Size(1), Size(0))), 1)
+  TEST_EQUAL(found.count(make_pair(Size(1), Size(7))), 1)
+  TEST_EQUAL(found.count(make_pair(Size(3), Size(3))), 1)
+
+  // hits are appended
+  index.findAll("AAAR", hits);
+  TEST_EQUAL(hits.size(), 5)
+  TEST_EQUAL(hits[4].protein_index, 0)
+  TEST_EQUAL(hits[4].position, 9)
+
+  // matches must not span protein boundaries
+  hits.clear();
+  index.findAll("AARPEP", hits);
+  TEST_EQUAL(hits.size(), 0)
+  index.findAll("PEPTIDEPEPTIDEX", hits);
+  TEST_EQUAL(hits.size(), 0)
+  index.findAll("", hits);
+  TEST_EQUAL(hits.size(), 0)
+  index.findAll("XXX", hits);
+  TEST_EQUAL(hits.size(), 1)
+
+  // unloaded index has no hits
+  hits.clear();
+  ProteinSuffixArray().findAll("PEPTIDE", hits);
+  TEST_EQUAL(hits.size(), 0)
+}
+END_SECTION
+
+START_SECTION(ProteinSuffixArray(const ProteinSuffixArray& rhs))
+{
+  ProteinSuffixArray copy(index);
+  TEST_EQUAL(copy.isLoaded(), true)
+  TEST_EQUAL(copy.getChecksum() == index.getChecksum(), true)
+  vector<ProteinSuffixArray::Hit> hits;
+  copy.findAll("PEPTIDEK", hits);
+  TEST_EQUAL(hits.size(), 2)
+}
+END_SECTION
+
+START_SECTION(ProteinSuffixArray& operator=(const ProteinSuffixArray& rhs))
+{
+  ProteinSuffixArray copy;
+  copy = index;
+  TEST_EQUAL(copy.isLoaded(), true)
+  TEST_EQUAL(copy.getNumberOfProteins(), 4)
+  vector<ProteinSuffixArray::Hit> hits;
+  copy.findAll("PEPTIDEK", hits);
+  TEST_EQUAL(hits.size(), 2)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
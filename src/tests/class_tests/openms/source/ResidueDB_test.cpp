@@ -178,6 +178,65 @@ START_SECTION(Size getNumberOfModifiedResidues() const)
 	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), 2)
 END_SECTION
 
+START_SECTION(void freeze())
+	const Residue* ox_met = ptr->getModifiedResidue(ptr->getResidue("M"), "Oxidation");
+	TEST_EQUAL(ptr->isFrozen(), false)
+	ptr->freeze();
+	TEST_EQUAL(ptr->isFrozen(), true)
+	TEST_EQUAL(ptr->getNumberOfModifiedResidues() > 2, true)
+	Size num_mod_res = ptr->getNumberOfModifiedResidues();
+
+	// previously created residues are kept
+	TEST_EQUAL(ptr->getModifiedResidue(ptr->getResidue("M"), "Oxidation"), ox_met)
+	TEST_EQUAL(ptr->getModifiedResidue(ptr->getResidue("M"), "Oxidation (M)"), ox_met)
+	TEST_EQUAL(ptr->getModifiedResidue(ptr->getResidue("M"), "UniMod:35"), ox_met)
+
+	// lookups of other modifications do not create new residues
+	const Residue* phospho_ser = ptr->getModifiedResidue(ptr->getResidue("S"), "Phospho");
+	TEST_STRING_EQUAL(phospho_ser->getOneLetterCode(), "S")
+	TEST_STRING_EQUAL(phospho_ser->getModificationName(), "Phospho")
+	TEST_EQUAL(ptr->getModifiedResidue(ptr->getResidue("S"), "Phospho (S)"), phospho_ser)
+	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), num_mod_res)
+
+	// freezing again does not change anything
+	ptr->freeze();
+	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), num_mod_res)
+
+	TEST_EXCEPTION(Exception::ElementNotFound, ptr->getModifiedResidue(ptr->getResidue("S"), "NoSuchModification"))
+END_SECTION
+
+START_SECTION([EXTRA] freeze() creates modified residues from unmodified ones)
+	TEST_EQUAL(ptr->isFrozen(), true)
+	const Residue* ox_met = ptr->getModifiedResidue(ptr->getResidue("M"), "Oxidation");
+	const Residue* diox_met = ptr->getModifiedResidue(ptr->getResidue("M"), "Dioxidation");
+	TOLERANCE_ABSOLUTE(0.0001)
+	TEST_REAL_SIMILAR(ptr->getResidue("M")->getMonoWeight(), 149.051049)
+	TEST_REAL_SIMILAR(ox_met->getMonoWeight(), 165.045964)
+	TEST_REAL_SIMILAR(diox_met->getMonoWeight(), 181.040879)
+	TEST_REAL_SIMILAR(ptr->getModifiedResidue(ptr->getResidue("S"), "Phospho")->getMonoWeight(), 185.008924)
+	TEST_REAL_SIMILAR(ptr->getModifiedResidue(ptr->getResidue("C"), "Carbamidomethyl")->getMonoWeight(), 178.041213)
+	// a modified residue as input resolves to the same residue
+	TEST_EQUAL(ptr->getModifiedResidue(ox_met, "Dioxidation"), diox_met)
+END_SECTION
+
+START_SECTION(bool isFrozen() const)
+	NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(const Residue* getModifiedResidue(const Residue* residue, const String& name) [concurrent access when frozen])
+	const Residue* ox_met = ptr->getModifiedResidue(ptr->getResidue("M"), "Oxidation");
+	Size mismatches = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: mismatches)
+#endif
+	for (SignedSize i = 0; i < 1000; ++i)
+	{
+		if (ptr->getModifiedResidue(ptr->getResidue("M"), "Oxidation") != ox_met) ++mismatches;
+		if (ptr->getModifiedResidue(ptr->getResidue("C"), "Carbamidomethyl")->getOneLetterCode() != "C") ++mismatches;
+	}
+	TEST_EQUAL(mismatches, 0)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
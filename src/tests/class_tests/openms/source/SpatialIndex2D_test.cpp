@@ -0,0 +1,297 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/SpatialIndex2D.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SpatialIndex2D, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// four features, the last one with a convex hull
+FeatureMap fmap;
+{
+  Feature f;
+  f.setRT(10.0);
+  f.setMZ(500.0);
+  fmap.push_back(f);
+  f.setRT(20.0);
+  f.setMZ(600.0);
+  fmap.push_back(f);
+  f.setRT(30.0);
+  f.setMZ(500.5);
+  fmap.push_back(f);
+  f.setRT(45.0);
+  f.setMZ(701.0);
+  ConvexHull2D hull;
+  hull.addPoint(DPosition<2>(40.0, 700.0));
+  hull.addPoint(DPosition<2>(50.0, 702.0));
+  f.getConvexHulls().push_back(hull);
+  fmap.push_back(f);
+}
+
+SpatialIndex2D* ptr = 0;
+SpatialIndex2D* nullPointer = 0;
+
+START_SECTION((SpatialIndex2D()))
+{
+  ptr = new SpatialIndex2D();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->size(), 0)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void build(const FeatureMap& map, bool use_convex_hulls = false)))
+{
+  SpatialIndex2D index;
+  vector<Size> items;
+  index.build(fmap);
+  TEST_EQUAL(index.size(), 4)
+  // centroids only
+  index.findInArea(41.0, 42.0, 700.0, 703.0, items);
+  TEST_EQUAL(items.size(), 0)
+
+  index.build(fmap, true);
+  TEST_EQUAL(index.size(), 4)
+  index.findInArea(41.0, 42.0, 700.0, 703.0, items);
+  TEST_EQUAL(items.size(), 1)
+  TEST_EQUAL(items[0], 3)
+  TEST_REAL_SIMILAR(index.getBox(3).minPosition()[0], 40.0)
+  TEST_REAL_SIMILAR(index.getBox(3).maxPosition()[1], 702.0)
+  // features without convex hull are represented by their centroid
+  TEST_REAL_SIMILAR(index.getBox(0).minPosition()[0], 10.0)
+  TEST_REAL_SIMILAR(index.getBox(0).maxPosition()[0], 10.0)
+  TEST_REAL_SIMILAR(index.getBox(0).minPosition()[1], 500.0)
+}
+END_SECTION
+
+START_SECTION((void build(const ConsensusMap& map, bool use_subelements = false)))
+{
+  ConsensusMap cmap;
+  ConsensusFeature cf;
+  cf.setRT(100.0);
+  cf.setMZ(300.0);
+  Peak2D p;
+  p.setRT(95.0);
+  p.setMZ(299.9);
+  cf.insert(0, p, 0);
+  p.setRT(105.0);
+  p.setMZ(300.1);
+  cf.insert(1, p, 0);
+  cmap.push_back(cf);
+  cf = ConsensusFeature();
+  cf.setRT(200.0);
+  cf.setMZ(400.0);
+  cmap.push_back(cf);
+
+  SpatialIndex2D index;
+  vector<Size> items;
+  index.build(cmap);
+  TEST_EQUAL(index.size(), 2)
+  index.findInArea(94.0, 96.0, 299.0, 301.0, items);
+  TEST_EQUAL(items.size(), 0)
+
+  index.build(cmap, true);
+  index.findInArea(94.0, 96.0, 299.0, 301.0, items);
+  TEST_EQUAL(items.size(), 1)
+  TEST_EQUAL(items[0], 0)
+  index.findInArea(199.0, 201.0, 399.0, 401.0, items);
+  TEST_EQUAL(items.size(), 1)
+  TEST_EQUAL(items[0], 1)
+}
+END_SECTION
+
+START_SECTION((void build(const MSExperiment<>& map, UInt ms_level = 1)))
+{
+  MSExperiment<> exp;
+  MSSpectrum<> spec;
+  Peak1D peak;
+  spec.setRT(1.0);
+  spec.setMSLevel(1);
+  peak.setMZ(100.0);
+  spec.push_back(peak);
+  peak.setMZ(200.0);
+  spec.push_back(peak);
+  exp.addSpectrum(spec);
+  spec.clear(true);
+  spec.setRT(1.5);
+  spec.setMSLevel(2);
+  peak.setMZ(150.0);
+  spec.push_back(peak);
+  exp.addSpectrum(spec);
+  spec.clear(true);
+  spec.setRT(2.0);
+  spec.setMSLevel(1);
+  spec.push_back(peak);
+  exp.addSpectrum(spec);
+
+  SpatialIndex2D index;
+  vector<Size> items;
+  index.build(exp);
+  TEST_EQUAL(index.size(), 3)
+  index.findInArea(0.0, 3.0, 140.0, 160.0, items);
+  TEST_EQUAL(items.size(), 1)
+  TEST_EQUAL(items[0], 2)
+  TEST_EQUAL(index.getPeakIndex(1) == PeakIndex(0, 1), true)
+  TEST_EQUAL(index.getPeakIndex(2) == PeakIndex(2, 0), true)
+
+  index.build(exp, 2);
+  TEST_EQUAL(index.size(), 1)
+  TEST_EQUAL(index.getPeakIndex(0) == PeakIndex(1, 0), true)
+}
+END_SECTION
+
+START_SECTION((void build(const std::vector<BoxType>& boxes, Size items_per_tile = 4)))
+{
+  // many overlapping boxes in tiny tiles
+  vector<SpatialIndex2D::BoxType> boxes;
+  for (Size i = 0; i < 100; ++i)
+  {
+    boxes.push_back(SpatialIndex2D::BoxType(DPosition<2>(double(i), 100.0 + i), DPosition<2>(i + 10.5, 110.5 + i)));
+  }
+  boxes.push_back(SpatialIndex2D::BoxType()); // empty box
+  SpatialIndex2D index;
+  index.build(boxes, 1);
+  TEST_EQUAL(index.size(), 101)
+
+  vector<Size> items;
+  index.findInArea(50.0, 50.0, 150.0, 150.0, items);
+  TEST_EQUAL(items.size(), 11) // boxes 40 - 50
+  TEST_EQUAL(items.front(), 40)
+  TEST_EQUAL(items.back(), 50)
+  index.findInArea(-1000.0, 1000.0, -1000.0, 1000.0, items);
+  TEST_EQUAL(items.size(), 100)
+}
+END_SECTION
+
+SpatialIndex2D index;
+index.build(fmap);
+
+START_SECTION((void findInArea(double rt_min, double rt_max, double mz_min, double mz_max, std::vector<Size>& items) const))
+{
+  vector<Size> items;
+  index.findInArea(5.0, 25.0, 400.0, 650.0, items);
+  TEST_EQUAL(items.size(), 2)
+  TEST_EQUAL(items[0], 0)
+  TEST_EQUAL(items[1], 1)
+  // borders are included
+  index.findInArea(10.0, 10.0, 500.0, 500.0, items);
+  TEST_EQUAL(items.size(), 1)
+  TEST_EQUAL(items[0], 0)
+  // invalid area
+  index.findInArea(25.0, 5.0, 400.0, 650.0, items);
+  TEST_EQUAL(items.size(), 0)
+  index.findInArea(1000.0, 2000.0, 400.0, 650.0, items);
+  TEST_EQUAL(items.size(), 0)
+  SpatialIndex2D().findInArea(5.0, 25.0, 400.0, 650.0, items);
+  TEST_EQUAL(items.size(), 0)
+}
+END_SECTION
+
+START_SECTION((void findNearest(double rt, double mz, Size k, std::vector<Size>& items, double rt_scale = 1.0, double mz_scale = 1.0) const))
+{
+  vector<Size> items;
+  index.findNearest(29.0, 500.0, 2, items);
+  TEST_EQUAL(items.size(), 2)
+  TEST_EQUAL(items[0], 2)
+  TEST_EQUAL(items[1], 0)
+  // 0.01 m/z count as much as 1 second
+  index.findNearest(29.0, 500.0, 2, items, 1.0, 0.01);
+  TEST_EQUAL(items.size(), 2)
+  TEST_EQUAL(items[0], 0)
+  TEST_EQUAL(items[1], 2)
+  // far outside of the data
+  index.findNearest(-1000.0, 2000.0, 1, items);
+  TEST_EQUAL(items.size(), 1)
+  TEST_EQUAL(items[0], 3)
+  index.findNearest(29.0, 500.0, 10, items);
+  TEST_EQUAL(items.size(), 4)
+  index.findNearest(29.0, 500.0, 0, items);
+  TEST_EQUAL(items.size(), 0)
+  TEST_EXCEPTION(Exception::InvalidValue, index.findNearest(29.0, 500.0, 1, items, 0.0, 1.0))
+}
+END_SECTION
+
+START_SECTION((PeakIndex getPeakIndex(Size item) const))
+{
+  TEST_EQUAL(index.getPeakIndex(2) == PeakIndex(2), true)
+}
+END_SECTION
+
+START_SECTION((const BoxType& getBox(Size item) const))
+{
+  TEST_REAL_SIMILAR(index.getBox(1).minPosition()[0], 20.0)
+  TEST_REAL_SIMILAR(index.getBox(1).minPosition()[1], 600.0)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  TEST_EQUAL(index.size(), 4)
+}
+END_SECTION
+
+START_SECTION((bool empty() const))
+{
+  TEST_EQUAL(index.empty(), false)
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  SpatialIndex2D tmp(index);
+  tmp.clear();
+  TEST_EQUAL(tmp.empty(), true)
+  vector<Size> items;
+  tmp.findNearest(29.0, 500.0, 1, items);
+  TEST_EQUAL(items.size(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
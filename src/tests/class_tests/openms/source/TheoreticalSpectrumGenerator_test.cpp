@@ -307,6 +307,117 @@ START_SECTION(void getSpectrum(RichPeakSpectrum& spec, const AASequence& peptide
   }
 END_SECTION
 
+START_SECTION(void getFragmentMZs(std::vector<double>& mzs, std::vector<char>& ion_types, const AASequence& peptide, Int charge = 1) const)
+  TheoreticalSpectrumGenerator tsg;
+  Param param(tsg.getParameters());
+  param.setValue("add_metainfo", "true");
+  tsg.setParameters(param);
+
+  vector<double> mzs;
+  vector<char> ion_types;
+  tsg.getFragmentMZs(mzs, ion_types, peptide, 1);
+  TEST_EQUAL(mzs.size(), 11)
+  TEST_EQUAL(ion_types.size(), 11)
+
+  TOLERANCE_ABSOLUTE(0.001)
+  double result[] = {147.113, 204.135, 261.16, 303.203, 348.192, 431.262, 476.251, 518.294, 575.319, 632.341, 665.362};
+  char result_types[] = {'y', 'y', 'b', 'y', 'b', 'y', 'b', 'y', 'b', 'b', 'y'};
+  for (Size i = 0; i != mzs.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(mzs[i], result[i])
+    TEST_EQUAL(ion_types[i], result_types[i])
+  }
+
+  // same m/z values as getSpectrum() for all supported ion types, charges, losses and terminal modifications
+  param.setValue("add_first_prefix_ion", "true");
+  param.setValue("add_a_ions", "true");
+  param.setValue("add_c_ions", "true");
+  param.setValue("add_x_ions", "true");
+  param.setValue("add_z_ions", "true");
+  param.setValue("add_losses", "true");
+  tsg.setParameters(param);
+  // (arginine is avoided, since its specific losses are not supported)
+  TOLERANCE_ABSOLUTE(1e-4)
+  const char* sequences[] = {"IFSQVGK", "DFPLANGEK", "(Acetyl)PEPTM(Oxidation)IDEK", "SAMPLEK(Amidated)", "GK"};
+  for (Size s = 0; s != 5; ++s)
+  {
+    AASequence seq = AASequence::fromString(sequences[s]);
+    for (Int charge = 1; charge <= 3; ++charge)
+    {
+      RichPeakSpectrum spec;
+      tsg.getSpectrum(spec, seq, charge);
+      tsg.getFragmentMZs(mzs, ion_types, seq, charge);
+      TEST_EQUAL(mzs.size(), spec.size())
+      ABORT_IF(mzs.size() != spec.size())
+      for (Size i = 0; i != mzs.size(); ++i)
+      {
+        TEST_REAL_SIMILAR(mzs[i], spec[i].getMZ())
+      }
+    }
+  }
+
+  // buffers are overwritten
+  tsg.getFragmentMZs(mzs, ion_types, AASequence::fromString("K"), 1);
+  TEST_EQUAL(mzs.size(), 0)
+  TEST_EQUAL(ion_types.size(), 0)
+
+/* for quick benchmarking against getSpectrum()
+  param.setValue("add_metainfo", "false");
+  param.setValue("add_losses", "false");
+  tsg.setParameters(param);
+  AASequence long_peptide = AASequence::fromString("LVNELTEFAKTCVADESHAGCEK");
+  for (Size i = 0; i != 1e6; ++i)
+  {
+    RichPeakSpectrum spec;
+    tsg.getSpectrum(spec, long_peptide, 2);
+  }
+  for (Size i = 0; i != 1e6; ++i)
+  {
+    tsg.getFragmentMZs(mzs, long_peptide, 2);
+  }
+*/
+END_SECTION
+
+START_SECTION(void getFragmentMZs(std::vector<double>& mzs, const AASequence& peptide, Int charge = 1) const)
+  TheoreticalSpectrumGenerator tsg;
+  vector<double> mzs;
+  vector<char> ion_types;
+  tsg.getFragmentMZs(mzs, peptide, 2);
+  vector<double> mzs2;
+  tsg.getFragmentMZs(mzs2, ion_types, peptide, 2);
+  TEST_EQUAL(mzs.size(), 22)
+  TEST_EQUAL(mzs == mzs2, true)
+END_SECTION
+
+START_SECTION(double getIonIntensity(char ion_letter) const)
+  TheoreticalSpectrumGenerator tsg;
+  Param param(tsg.getParameters());
+  param.setValue("add_a_ions", "true");
+  param.setValue("a_intensity", 0.25);
+  param.setValue("y_intensity", 0.5);
+  tsg.setParameters(param);
+  TEST_REAL_SIMILAR(tsg.getIonIntensity('a'), 0.25)
+  TEST_REAL_SIMILAR(tsg.getIonIntensity('b'), 1.0)
+  TEST_REAL_SIMILAR(tsg.getIonIntensity('y'), 0.5)
+  TEST_EXCEPTION(Exception::InvalidValue, tsg.getIonIntensity('q'))
+
+  // same intensities as getSpectrum() for a-, b- and y-ions
+  RichPeakSpectrum spec;
+  tsg.getSpectrum(spec, peptide, 1);
+  vector<double> mzs;
+  vector<char> ion_types;
+  tsg.getFragmentMZs(mzs, ion_types, peptide, 1);
+  TEST_EQUAL(ion_types.size(), spec.size())
+  ABORT_IF(ion_types.size() != spec.size())
+  Size a_ions = 0;
+  for (Size i = 0; i != ion_types.size(); ++i)
+  {
+    if (ion_types[i] == 'a') ++a_ions;
+    TEST_REAL_SIMILAR(tsg.getIonIntensity(ion_types[i]), spec[i].getIntensity())
+  }
+  TEST_EQUAL(a_ions, 5)
+END_SECTION
+
 START_SECTION(([EXTRA] bugfix test where losses lead to formulae with negative element frequencies))
 {
   AASequence tmp_aa = AASequence::fromString("RDAGGPALKK");
@@ -0,0 +1,452 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/TransitionBinaryLibrary.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace OpenMS;
+using namespace std;
+
+/// Copies @p source to @p target, overwriting the bytes at @p offset with @p value
+template <typename T>
+void storeCorrupted(const std::string& source, const std::string& target, Size offset, T value)
+{
+  std::ifstream ifs(source.c_str(), std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  std::memcpy(&data[offset], &value, sizeof(T));
+  std::ofstream ofs(target.c_str(), std::ios::binary);
+  ofs.write(&data[0], data.size());
+}
+
+START_TEST(TransitionBinaryLibrary, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwath::LightTargetedExperiment exp;
+{
+  const double precursor_mz[] = {500.5, 400.25, 500.5, 650.0, 399.0};
+  const char* peptide_ref[] = {"PEPTIDEK_2", "DECOY_PEPTIDE_2", "PEPTIDEK_2", "unknown", "DECOY_PEPTIDE_2"};
+  for (Size i = 0; i < 5; ++i)
+  {
+    OpenSwath::LightTransition tr;
+    tr.transition_name = String("tr_") + i;
+    tr.peptide_ref = peptide_ref[i];
+    tr.library_intensity = 100.0 * (i + 1);
+    tr.product_mz = 300.0 + i;
+    tr.precursor_mz = precursor_mz[i];
+    tr.fragment_charge = (i % 2) + 1;
+    tr.decoy = (i == 1 || i == 4);
+    tr.detecting_transition = (i != 2);
+    tr.quantifying_transition = (i != 3);
+    tr.identifying_transition = (i == 0);
+    exp.transitions.push_back(tr);
+  }
+
+  OpenSwath::LightCompound peptide;
+  peptide.id = "PEPTIDEK_2";
+  peptide.rt = 44.5;
+  peptide.charge = 2;
+  peptide.sequence = "PEPTIDEK";
+  peptide.peptide_group_label = "PEPTIDEK_gr1";
+  peptide.protein_refs.push_back("P1");
+  peptide.protein_refs.push_back("P2");
+  OpenSwath::LightModification mod;
+  mod.location = 1;
+  mod.unimod_id = "UniMod:21";
+  peptide.modifications.push_back(mod);
+  mod.location = -1;
+  mod.unimod_id = "UniMod:1";
+  peptide.modifications.push_back(mod);
+  exp.compounds.push_back(peptide);
+
+  OpenSwath::LightCompound decoy;
+  decoy.id = "DECOY_PEPTIDE_2";
+  decoy.rt = 12.0;
+  decoy.charge = 2;
+  decoy.sequence = "KEDITPEP";
+  decoy.protein_refs.push_back("DECOY_P1");
+  exp.compounds.push_back(decoy);
+
+  OpenSwath::LightCompound metabolite;
+  metabolite.id = "glucose";
+  metabolite.rt = 3.25;
+  metabolite.charge = -1;
+  metabolite.sum_formula = "C6H12O6";
+  metabolite.compound_name = "Glucose";
+  exp.compounds.push_back(metabolite);
+
+  const char* protein_id[] = {"P1", "P2", "DECOY_P1", "P3"};
+  for (Size i = 0; i < 4; ++i)
+  {
+    OpenSwath::LightProtein protein;
+    protein.id = protein_id[i];
+    protein.sequence = String("MPEPTIDEK") + i;
+    exp.proteins.push_back(protein);
+  }
+}
+
+std::string tmp_filename;
+NEW_TMP_FILE(tmp_filename);
+
+TransitionBinaryLibrary* ptr = 0;
+TransitionBinaryLibrary* nullPointer = 0;
+
+START_SECTION(TransitionBinaryLibrary())
+{
+  ptr = new TransitionBinaryLibrary();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isLoaded(), false)
+  TEST_EQUAL(ptr->getNumberOfTransitions(), 0)
+}
+END_SECTION
+
+START_SECTION(~TransitionBinaryLibrary())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(static void store(const String& filename, const OpenSwath::LightTargetedExperiment& exp))
+{
+  TransitionBinaryLibrary::store(tmp_filename, exp);
+  TEST_EQUAL(File::exists(tmp_filename), true)
+  TEST_EQUAL(FileHandler::getTypeByContent(tmp_filename), FileTypes::OSWLIB)
+  // an existing library is replaced
+  TransitionBinaryLibrary::store(tmp_filename, exp);
+  TEST_EQUAL(File::exists(tmp_filename), true)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, TransitionBinaryLibrary::store("/does/not/exist/library.oswlib", exp))
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename))
+{
+  TransitionBinaryLibrary library;
+  library.load(tmp_filename);
+  TEST_EQUAL(library.isLoaded(), true)
+
+  std::string unused_tmp_filename;
+  NEW_TMP_FILE(unused_tmp_filename);
+  TEST_EXCEPTION(Exception::FileNotFound, library.load(unused_tmp_filename))
+  TEST_EXCEPTION(Exception::ParseError, library.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+  // failed loading leaves the previous library intact
+  TEST_EQUAL(library.isLoaded(), true)
+  TEST_EQUAL(library.getNumberOfTransitions(), 5)
+
+  // empty library
+  std::string empty_filename;
+  NEW_TMP_FILE(empty_filename);
+  TransitionBinaryLibrary::store(empty_filename, OpenSwath::LightTargetedExperiment());
+  library.load(empty_filename);
+  TEST_EQUAL(library.isLoaded(), true)
+  TEST_EQUAL(library.getNumberOfTransitions(), 0)
+  TEST_EQUAL(library.getNumberOfCompounds(), 0)
+  TEST_EQUAL(library.getNumberOfProteins(), 0)
+
+  // corrupt content (offsets refer to the library of the test: 64 byte header, 5 transitions, 3 compounds, 4 proteins)
+  std::string corrupt_filename;
+  NEW_TMP_FILE(corrupt_filename);
+  // counts that overflow the computed file size
+  storeCorrupted(tmp_filename, corrupt_filename, 16, UInt64(1) << 63);
+  TEST_EXCEPTION(Exception::ParseError, library.load(corrupt_filename))
+  // string offset (name of the first transition) outside the string table
+  storeCorrupted(tmp_filename, corrupt_filename, 184, UInt64(1) << 40);
+  TEST_EXCEPTION(Exception::ParseError, library.load(corrupt_filename))
+  // protein reference starts not monotone
+  storeCorrupted(tmp_filename, corrupt_filename, 416, UInt64(100));
+  TEST_EXCEPTION(Exception::ParseError, library.load(corrupt_filename))
+  // transition index in the precursor order out of range
+  storeCorrupted(tmp_filename, corrupt_filename, 596, UInt32(7));
+  TEST_EXCEPTION(Exception::ParseError, library.load(corrupt_filename))
+  // unchanged copy is fine
+  storeCorrupted(tmp_filename, corrupt_filename, 0, 'O');
+  library.load(corrupt_filename);
+  TEST_EQUAL(library.getNumberOfTransitions(), 5)
+}
+END_SECTION
+
+TransitionBinaryLibrary library;
+library.load(tmp_filename);
+
+START_SECTION(bool isLoaded() const)
+{
+  TEST_EQUAL(library.isLoaded(), true)
+  TEST_EQUAL(TransitionBinaryLibrary().isLoaded(), false)
+}
+END_SECTION
+
+START_SECTION(Size getNumberOfTransitions() const)
+{
+  TEST_EQUAL(library.getNumberOfTransitions(), 5)
+}
+END_SECTION
+
+START_SECTION(Size getNumberOfCompounds() const)
+{
+  TEST_EQUAL(library.getNumberOfCompounds(), 3)
+}
+END_SECTION
+
+START_SECTION(Size getNumberOfProteins() const)
+{
+  TEST_EQUAL(library.getNumberOfProteins(), 4)
+}
+END_SECTION
+
+START_SECTION(double getPrecursorMZ(Size index) const)
+{
+  TEST_REAL_SIMILAR(library.getPrecursorMZ(0), 500.5)
+  TEST_REAL_SIMILAR(library.getPrecursorMZ(1), 400.25)
+  TEST_REAL_SIMILAR(library.getPrecursorMZ(4), 399.0)
+}
+END_SECTION
+
+START_SECTION(double getProductMZ(Size index) const)
+{
+  TEST_REAL_SIMILAR(library.getProductMZ(0), 300.0)
+  TEST_REAL_SIMILAR(library.getProductMZ(3), 303.0)
+}
+END_SECTION
+
+START_SECTION(double getLibraryIntensity(Size index) const)
+{
+  TEST_REAL_SIMILAR(library.getLibraryIntensity(0), 100.0)
+  TEST_REAL_SIMILAR(library.getLibraryIntensity(4), 500.0)
+}
+END_SECTION
+
+START_SECTION(bool isDecoy(Size index) const)
+{
+  TEST_EQUAL(library.isDecoy(0), false)
+  TEST_EQUAL(library.isDecoy(1), true)
+  TEST_EQUAL(library.isDecoy(4), true)
+}
+END_SECTION
+
+START_SECTION(const char* getTransitionName(Size index) const)
+{
+  TEST_STRING_EQUAL(library.getTransitionName(0), "tr_0")
+  TEST_STRING_EQUAL(library.getTransitionName(4), "tr_4")
+}
+END_SECTION
+
+START_SECTION(const char* getPeptideRef(Size index) const)
+{
+  TEST_STRING_EQUAL(library.getPeptideRef(0), "PEPTIDEK_2")
+  TEST_STRING_EQUAL(library.getPeptideRef(3), "unknown")
+}
+END_SECTION
+
+START_SECTION(const char* getCompoundID(Size index) const)
+{
+  TEST_STRING_EQUAL(library.getCompoundID(0), "PEPTIDEK_2")
+  TEST_STRING_EQUAL(library.getCompoundID(2), "glucose")
+}
+END_SECTION
+
+START_SECTION(double getCompoundRT(Size index) const)
+{
+  TEST_REAL_SIMILAR(library.getCompoundRT(0), 44.5)
+  TEST_REAL_SIMILAR(library.getCompoundRT(2), 3.25)
+}
+END_SECTION
+
+START_SECTION(void getTransition(Size index, OpenSwath::LightTransition& transition) const)
+{
+  for (Size i = 0; i < exp.transitions.size(); ++i)
+  {
+    OpenSwath::LightTransition tr;
+    library.getTransition(i, tr);
+    TEST_STRING_EQUAL(tr.transition_name, exp.transitions[i].transition_name)
+    TEST_STRING_EQUAL(tr.peptide_ref, exp.transitions[i].peptide_ref)
+    TEST_REAL_SIMILAR(tr.library_intensity, exp.transitions[i].library_intensity)
+    TEST_REAL_SIMILAR(tr.product_mz, exp.transitions[i].product_mz)
+    TEST_REAL_SIMILAR(tr.precursor_mz, exp.transitions[i].precursor_mz)
+    TEST_EQUAL(tr.fragment_charge, exp.transitions[i].fragment_charge)
+    TEST_EQUAL(tr.decoy, exp.transitions[i].decoy)
+    TEST_EQUAL(tr.detecting_transition, exp.transitions[i].detecting_transition)
+    TEST_EQUAL(tr.quantifying_transition, exp.transitions[i].quantifying_transition)
+    TEST_EQUAL(tr.identifying_transition, exp.transitions[i].identifying_transition)
+  }
+}
+END_SECTION
+
+START_SECTION(void getCompound(Size index, OpenSwath::LightCompound& compound) const)
+{
+  OpenSwath::LightCompound c;
+  library.getCompound(0, c);
+  TEST_STRING_EQUAL(c.id, "PEPTIDEK_2")
+  TEST_REAL_SIMILAR(c.rt, 44.5)
+  TEST_EQUAL(c.charge, 2)
+  TEST_STRING_EQUAL(c.sequence, "PEPTIDEK")
+  TEST_STRING_EQUAL(c.peptide_group_label, "PEPTIDEK_gr1")
+  TEST_EQUAL(c.isPeptide(), true)
+  TEST_EQUAL(c.protein_refs.size(), 2)
+  TEST_STRING_EQUAL(c.protein_refs[0], "P1")
+  TEST_STRING_EQUAL(c.protein_refs[1], "P2")
+  TEST_EQUAL(c.modifications.size(), 2)
+  TEST_EQUAL(c.modifications[0].location, 1)
+  TEST_STRING_EQUAL(c.modifications[0].unimod_id, "UniMod:21")
+  TEST_EQUAL(c.modifications[1].location, -1)
+  TEST_STRING_EQUAL(c.modifications[1].unimod_id, "UniMod:1")
+
+  // previous content is replaced
+  library.getCompound(2, c);
+  TEST_STRING_EQUAL(c.id, "glucose")
+  TEST_EQUAL(c.charge, -1)
+  TEST_STRING_EQUAL(c.sequence, "")
+  TEST_STRING_EQUAL(c.sum_formula, "C6H12O6")
+  TEST_STRING_EQUAL(c.compound_name, "Glucose")
+  TEST_EQUAL(c.isPeptide(), false)
+  TEST_EQUAL(c.protein_refs.size(), 0)
+  TEST_EQUAL(c.modifications.size(), 0)
+}
+END_SECTION
+
+START_SECTION(void getProtein(Size index, OpenSwath::LightProtein& protein) const)
+{
+  OpenSwath::LightProtein p;
+  library.getProtein(2, p);
+  TEST_STRING_EQUAL(p.id, "DECOY_P1")
+  TEST_STRING_EQUAL(p.sequence, "MPEPTIDEK2")
+}
+END_SECTION
+
+START_SECTION(void getLightTargetedExperiment(OpenSwath::LightTargetedExperiment& exp) const)
+{
+  OpenSwath::LightTargetedExperiment result;
+  result.transitions.push_back(OpenSwath::LightTransition());
+  library.getLightTargetedExperiment(result);
+  TEST_EQUAL(result.transitions.size(), 5)
+  TEST_EQUAL(result.compounds.size(), 3)
+  TEST_EQUAL(result.proteins.size(), 4)
+  for (Size i = 0; i < result.transitions.size(); ++i)
+  {
+    TEST_STRING_EQUAL(result.transitions[i].transition_name, exp.transitions[i].transition_name)
+  }
+  for (Size i = 0; i < result.compounds.size(); ++i)
+  {
+    TEST_STRING_EQUAL(result.compounds[i].id, exp.compounds[i].id)
+  }
+  for (Size i = 0; i < result.proteins.size(); ++i)
+  {
+    TEST_STRING_EQUAL(result.proteins[i].id, exp.proteins[i].id)
+    TEST_STRING_EQUAL(result.proteins[i].sequence, exp.proteins[i].sequence)
+  }
+  TEST_REAL_SIMILAR(result.getCompoundByRef("DECOY_PEPTIDE_2").rt, 12.0)
+}
+END_SECTION
+
+START_SECTION(void selectTransitions(double lower, double upper, double min_upper_edge_dist, OpenSwath::LightTargetedExperiment& exp) const)
+{
+  // same result as selecting from the whole library
+  const double windows[][3] = {{399.0, 500.5, 0.0}, {399.0, 501.0, 0.0}, {399.0, 501.0, 1.0}, {300.0, 700.0, 0.0}, {600.0, 700.0, 0.0}, {0.0, 100.0, 0.0}};
+  for (Size w = 0; w < 6; ++w)
+  {
+    OpenSwath::LightTargetedExperiment expected, result;
+    OpenSwathHelper::selectSwathTransitions(exp, expected, windows[w][2], windows[w][0], windows[w][1]);
+    library.selectTransitions(windows[w][0], windows[w][1], windows[w][2], result);
+    TEST_EQUAL(result.transitions.size(), expected.transitions.size())
+    TEST_EQUAL(result.compounds.size(), expected.compounds.size())
+    TEST_EQUAL(result.proteins.size(), expected.proteins.size())
+    for (Size i = 0; i < std::min(result.transitions.size(), expected.transitions.size()); ++i)
+    {
+      TEST_STRING_EQUAL(result.transitions[i].transition_name, expected.transitions[i].transition_name)
+    }
+    for (Size i = 0; i < std::min(result.compounds.size(), expected.compounds.size()); ++i)
+    {
+      TEST_STRING_EQUAL(result.compounds[i].id, expected.compounds[i].id)
+    }
+    for (Size i = 0; i < std::min(result.proteins.size(), expected.proteins.size()); ++i)
+    {
+      TEST_STRING_EQUAL(result.proteins[i].id, expected.proteins[i].id)
+    }
+  }
+
+  OpenSwath::LightTargetedExperiment result;
+  library.selectTransitions(400.0, 501.0, 0.0, result);
+  TEST_EQUAL(result.transitions.size(), 3)
+  TEST_STRING_EQUAL(result.transitions[0].transition_name, "tr_0")
+  TEST_STRING_EQUAL(result.transitions[1].transition_name, "tr_1")
+  TEST_STRING_EQUAL(result.transitions[2].transition_name, "tr_2")
+  TEST_EQUAL(result.compounds.size(), 2)
+  TEST_EQUAL(result.proteins.size(), 3)
+
+  // results are appended
+  library.selectTransitions(600.0, 700.0, 0.0, result);
+  TEST_EQUAL(result.transitions.size(), 4)
+  TEST_STRING_EQUAL(result.transitions[3].transition_name, "tr_3")
+  TEST_EQUAL(result.compounds.size(), 2)
+
+  // unloaded library selects nothing
+  OpenSwath::LightTargetedExperiment empty;
+  TransitionBinaryLibrary().selectTransitions(0.0, 1000.0, 0.0, empty);
+  TEST_EQUAL(empty.transitions.size(), 0)
+}
+END_SECTION
+
+START_SECTION(TransitionBinaryLibrary(const TransitionBinaryLibrary& rhs))
+{
+  TransitionBinaryLibrary copy(library);
+  TEST_EQUAL(copy.isLoaded(), true)
+  TEST_EQUAL(copy.getNumberOfTransitions(), 5)
+  TEST_STRING_EQUAL(copy.getTransitionName(3), "tr_3")
+}
+END_SECTION
+
+START_SECTION(TransitionBinaryLibrary& operator=(const TransitionBinaryLibrary& rhs))
+{
+  TransitionBinaryLibrary copy;
+  copy = library;
+  TEST_EQUAL(copy.isLoaded(), true)
+  TEST_EQUAL(copy.getNumberOfCompounds(), 3)
+  TEST_STRING_EQUAL(copy.getCompoundID(1), "DECOY_PEPTIDE_2")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
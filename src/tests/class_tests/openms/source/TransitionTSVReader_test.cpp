@@ -39,6 +39,8 @@
 #include <boost/assign/std/vector.hpp>
 #include <boost/assign/list_of.hpp>
 
+#include <fstream>
+
 ///////////////////////////
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionTSVReader.h>
 ///////////////////////////
@@ -81,6 +83,57 @@ START_SECTION( void convertTSVToTargetedExperiment(const char * filename, OpenMS
 }
 END_SECTION
 
+START_SECTION( void convertTSVToTargetedExperiment(const char * filename, FileTypes::Type filetype, OpenSwath::LightTargetedExperiment & targeted_exp))
+{
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  {
+    std::ofstream os(tmp_filename.c_str());
+    os << "PrecursorMz\tProductMz\tTr_recalibrated\ttransition_name\tCE\tLibraryIntensity\ttransition_group_id\tdecoy\tPeptideSequence\tProteinName\tFullUniModPeptideName\tPrecursorCharge\tPeptideGroupLabel\tFragmentCharge\n";
+    os << "500.5\t600.1\t40.0\ttr_1\t-1\t100\tPEPTIDEK_2\t0\tPEPTIDEK\tProt1\tPEPTIDEK\t2\tgroup_1\t1\n";
+    os << "500.5\t700.2\t40.0\ttr_2\t-1\t50\tPEPTIDEK_2\t0\tPEPTIDEK\tProt1\tPEPTIDEK\t2\tgroup_1\t\n";
+    // different sequence in the same label group
+    os << "450.2\t500.3\t30.0\ttr_3\t-1\t80\tPEPTIDER_2\t1\tPEPTIDER\tProt2\tPEPTIDER\t2\tgroup_1\t2\n";
+    os << "500.5\t800.3\t40.0\ttr_4\t-1\t20\tPEPTIDEK_2\t0\tPEPTIDEK\tProt1\tPEPTIDEK\t2\tgroup_1\t1";
+  }
+
+  TransitionTSVReader reader;
+  OpenSwath::LightTargetedExperiment light_exp;
+  reader.convertTSVToTargetedExperiment(tmp_filename.c_str(), FileTypes::TSV, light_exp);
+  TEST_EQUAL(light_exp.transitions.size(), 4)
+  TEST_EQUAL(light_exp.compounds.size(), 2)
+  TEST_EQUAL(light_exp.proteins.size(), 2)
+  TEST_EQUAL(light_exp.transitions[1].transition_name, "tr_2")
+  TEST_EQUAL(light_exp.transitions[1].fragment_charge, 0)
+  TEST_EQUAL(light_exp.transitions[2].decoy, true)
+  TEST_REAL_SIMILAR(light_exp.transitions[3].product_mz, 800.3)
+  TEST_EQUAL(light_exp.compounds[0].id, "PEPTIDEK_2")
+  TEST_EQUAL(light_exp.compounds[0].peptide_group_label, "group_1")
+  TEST_EQUAL(light_exp.compounds[1].peptide_group_label, "PEPTIDER_2")
+
+  // same result as via the TargetedExperiment
+  TargetedExperiment exp;
+  reader.convertTSVToTargetedExperiment(tmp_filename.c_str(), FileTypes::TSV, exp);
+  TEST_EQUAL(exp.getTransitions().size(), 4)
+  TEST_EQUAL(exp.getPeptides().size(), 2)
+  TEST_EQUAL(exp.getPeptides()[1].getPeptideGroupLabel(), "PEPTIDER_2")
+
+  // line with a missing column
+  std::string broken_filename;
+  NEW_TMP_FILE(broken_filename);
+  {
+    std::ofstream os(broken_filename.c_str());
+    os << "PrecursorMz\tProductMz\tTr_recalibrated\ttransition_name\tCE\tLibraryIntensity\ttransition_group_id\tdecoy\tPeptideSequence\tProteinName\n";
+    os << "500.5\t600.1\t40.0\ttr_1\t-1\t100\tPEPTIDEK_2\t0\tPEPTIDEK\tProt1\n";
+    os << "500.5\t600.1\t40.0\ttr_2\t-1\t100\tPEPTIDEK_2\t0\tPEPTIDEK\n";
+  }
+  OpenSwath::LightTargetedExperiment broken_exp;
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::IllegalArgument, reader.convertTSVToTargetedExperiment(broken_filename.c_str(), FileTypes::TSV, broken_exp),
+    "Error reading the file on line 2: length of the header and length of the line do not match: 9 != 10")
+  TEST_EXCEPTION(Exception::FileNotFound, reader.convertTSVToTargetedExperiment("/does/not/exist.tsv", FileTypes::TSV, broken_exp))
+}
+END_SECTION
+
 START_SECTION( void validateTargetedExperiment(OpenMS::TargetedExperiment & targeted_exp))
 {
   NOT_TESTABLE
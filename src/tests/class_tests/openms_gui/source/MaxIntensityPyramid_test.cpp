@@ -0,0 +1,244 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+namespace
+{
+  void addSpectrum(MSExperiment<>& exp, double rt, UInt ms_level, const double* mzs, const double* intensities, Size size)
+  {
+    MSSpectrum<> spec;
+    spec.setRT(rt);
+    spec.setMSLevel(ms_level);
+    for (Size i = 0; i < size; ++i)
+    {
+      Peak1D p;
+      p.setMZ(mzs[i]);
+      p.setIntensity(intensities[i]);
+      spec.push_back(p);
+    }
+    exp.addSpectrum(spec);
+  }
+}
+
+START_TEST(MaxIntensityPyramid, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// four MS1 scans (m/z 100 - 500) and one MS2 scan, which is ignored
+MSExperiment<> exp;
+{
+  const double mz1[] = {100.0, 250.0}, int1[] = {10.0, 5.0};
+  const double mz2[] = {150.0, 500.0}, int2[] = {20.0, 7.0};
+  const double mz3[] = {300.0}, int3[] = {1000.0};
+  const double mz4[] = {350.0}, int4[] = {3.0};
+  const double mz5[] = {120.0, 450.0}, int5[] = {1.0, 8.0};
+  addSpectrum(exp, 1.0, 1, mz1, int1, 2);
+  addSpectrum(exp, 2.0, 1, mz2, int2, 2);
+  addSpectrum(exp, 2.5, 2, mz3, int3, 1);
+  addSpectrum(exp, 3.0, 1, mz4, int4, 1);
+  addSpectrum(exp, 4.0, 1, mz5, int5, 2);
+}
+
+MaxIntensityPyramid* ptr = 0;
+MaxIntensityPyramid* nullPointer = 0;
+
+START_SECTION((MaxIntensityPyramid()))
+  ptr = new MaxIntensityPyramid();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getNumberOfLevels(), 0)
+  delete ptr;
+END_SECTION
+
+// two rows with two scans each, four m/z bins of width 100
+MaxIntensityPyramid pyramid;
+pyramid.build(exp, 2, 4);
+
+START_SECTION((void build(const MSExperiment<>& map, Size max_rows = 2048, Size max_mz_bins = 4096)))
+  TEST_EQUAL(pyramid.empty(), false)
+  TEST_EQUAL(pyramid.getNumberOfLevels(), 3)
+
+  MaxIntensityPyramid no_peaks;
+  no_peaks.build(MSExperiment<>());
+  TEST_EQUAL(no_peaks.empty(), true)
+END_SECTION
+
+START_SECTION((Size getNumberOfLevels() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size getRowCount(Size level) const))
+  TEST_EQUAL(pyramid.getRowCount(0), 2)
+  TEST_EQUAL(pyramid.getRowCount(1), 1)
+  TEST_EQUAL(pyramid.getRowCount(2), 1)
+END_SECTION
+
+START_SECTION((Size getMZBinCount(Size level) const))
+  TEST_EQUAL(pyramid.getMZBinCount(0), 4)
+  TEST_EQUAL(pyramid.getMZBinCount(1), 2)
+  TEST_EQUAL(pyramid.getMZBinCount(2), 1)
+END_SECTION
+
+START_SECTION((float getMaximum(Size level, Size row, Size mz_bin) const))
+  TEST_REAL_SIMILAR(pyramid.getMaximum(0, 0, 0), 20.0)
+  TEST_REAL_SIMILAR(pyramid.getMaximum(0, 0, 1), 5.0)
+  TEST_REAL_SIMILAR(pyramid.getMaximum(0, 0, 2), -1.0)
+  TEST_REAL_SIMILAR(pyramid.getMaximum(0, 0, 3), 7.0) // the last m/z belongs to the last bin
+  TEST_REAL_SIMILAR(pyramid.getMaximum(0, 1, 0), 1.0)
+  TEST_REAL_SIMILAR(pyramid.getMaximum(0, 1, 1), -1.0)
+  TEST_REAL_SIMILAR(pyramid.getMaximum(0, 1, 2), 3.0)
+  TEST_REAL_SIMILAR(pyramid.getMaximum(0, 1, 3), 8.0)
+
+  TEST_REAL_SIMILAR(pyramid.getMaximum(1, 0, 0), 20.0)
+  TEST_REAL_SIMILAR(pyramid.getMaximum(1, 0, 1), 8.0)
+  TEST_REAL_SIMILAR(pyramid.getMaximum(2, 0, 0), 20.0)
+END_SECTION
+
+START_SECTION((bool query(double rt_min, double rt_max, Size rt_pixels, double mz_min, double mz_max, Size mz_pixels, std::vector<float>& image) const))
+  vector<float> image;
+
+  // finest level
+  TEST_EQUAL(pyramid.query(0.5, 4.5, 2, 100.0, 500.0, 4, image), true)
+  TEST_EQUAL(image.size(), 8)
+  TEST_REAL_SIMILAR(image[0], 20.0)
+  TEST_REAL_SIMILAR(image[1], 5.0)
+  TEST_REAL_SIMILAR(image[2], -1.0)
+  TEST_REAL_SIMILAR(image[3], 7.0)
+  TEST_REAL_SIMILAR(image[4], 1.0)
+  TEST_REAL_SIMILAR(image[5], -1.0)
+  TEST_REAL_SIMILAR(image[6], 3.0)
+  TEST_REAL_SIMILAR(image[7], 8.0)
+
+  // coarser level
+  TEST_EQUAL(pyramid.query(0.5, 4.5, 1, 100.0, 500.0, 2, image), true)
+  TEST_EQUAL(image.size(), 2)
+  TEST_REAL_SIMILAR(image[0], 20.0)
+  TEST_REAL_SIMILAR(image[1], 8.0)
+
+  // part of the map
+  TEST_EQUAL(pyramid.query(2.5, 4.5, 1, 300.0, 500.0, 2, image), true)
+  TEST_EQUAL(image.size(), 2)
+  TEST_REAL_SIMILAR(image[0], 3.0)
+  TEST_REAL_SIMILAR(image[1], 8.0)
+
+  // too fine for the pyramid
+  TEST_EQUAL(pyramid.query(0.5, 4.5, 8, 100.0, 500.0, 4, image), false)
+  TEST_EQUAL(pyramid.query(0.5, 4.5, 2, 100.0, 500.0, 8, image), false)
+  // invalid area
+  TEST_EQUAL(pyramid.query(4.5, 0.5, 2, 100.0, 500.0, 4, image), false)
+  TEST_EQUAL(MaxIntensityPyramid().query(0.5, 4.5, 2, 100.0, 500.0, 4, image), false)
+END_SECTION
+
+START_SECTION((bool isValidFor(const MSExperiment<>& map) const))
+  TEST_EQUAL(pyramid.isValidFor(exp), true)
+  TEST_EQUAL(MaxIntensityPyramid().isValidFor(exp), false)
+
+  MSExperiment<> changed = exp;
+  changed[0][0].setMZ(90.0);
+  TEST_EQUAL(pyramid.isValidFor(changed), false)
+  changed = exp;
+  changed[4].pop_back();
+  TEST_EQUAL(pyramid.isValidFor(changed), false)
+  // MS2 scans do not matter
+  changed = exp;
+  changed[2].clear(true);
+  TEST_EQUAL(pyramid.isValidFor(changed), true)
+END_SECTION
+
+START_SECTION((void clear()))
+  MaxIntensityPyramid tmp(pyramid);
+  tmp.clear();
+  TEST_EQUAL(tmp.empty(), true)
+  TEST_EQUAL(tmp.getNumberOfLevels(), 0)
+  TEST_EQUAL(tmp.isValidFor(exp), false)
+END_SECTION
+
+START_SECTION((bool empty() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+std::string tmp_filename;
+NEW_TMP_FILE(tmp_filename);
+
+START_SECTION((void store(const String& filename) const))
+  pyramid.store(tmp_filename);
+  TEST_EXCEPTION(Exception::UnableToCreateFile, pyramid.store("/does/not/exist/test.pyramid"))
+END_SECTION
+
+START_SECTION((bool load(const String& filename, const MSExperiment<>& map)))
+  MaxIntensityPyramid loaded;
+  TEST_EQUAL(loaded.load(tmp_filename, exp), true)
+  TEST_EQUAL(loaded.getNumberOfLevels(), pyramid.getNumberOfLevels())
+  for (Size level = 0; level < pyramid.getNumberOfLevels(); ++level)
+  {
+    TEST_EQUAL(loaded.getRowCount(level), pyramid.getRowCount(level))
+    TEST_EQUAL(loaded.getMZBinCount(level), pyramid.getMZBinCount(level))
+    for (Size row = 0; row < pyramid.getRowCount(level); ++row)
+    {
+      for (Size bin = 0; bin < pyramid.getMZBinCount(level); ++bin)
+      {
+        TEST_REAL_SIMILAR(loaded.getMaximum(level, row, bin), pyramid.getMaximum(level, row, bin))
+      }
+    }
+  }
+  TEST_EQUAL(loaded.isValidFor(exp), true)
+
+  // different map
+  MSExperiment<> changed = exp;
+  changed[1][1].setMZ(510.0);
+  TEST_EQUAL(loaded.load(tmp_filename, changed), false)
+  TEST_EQUAL(loaded.empty(), true)
+
+  // missing file
+  std::string missing_filename;
+  NEW_TMP_FILE(missing_filename);
+  TEST_EQUAL(loaded.load(missing_filename, exp), false)
+END_SECTION
+
+START_SECTION((static String getCacheFilename(const String& filename)))
+  TEST_STRING_EQUAL(MaxIntensityPyramid::getCacheFilename("data/test.mzML"), "data/test.mzML.pyramid")
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -36,6 +36,8 @@
 
 #include "OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/ALGO/Scoring.h"
 
+#include <cmath>
+
 #ifdef USE_BOOST_UNIT_TEST
 
 // include boost unit test framework
@@ -200,8 +202,8 @@ BOOST_AUTO_TEST_CASE(test_calculateCrossCorrelation)
   Scoring::standardize_data(data1);
   Scoring::standardize_data(data2);
 
-  std::map<int, double> result = Scoring::calculateCrossCorrelation(data1, data2, 2, 1);
-  for(std::map<int, double>::iterator it = result.begin(); it != result.end(); it++)
+  Scoring::XCorrArrayType result = Scoring::calculateCrossCorrelation(data1, data2, 2, 1);
+  for(Scoring::XCorrArrayType::iterator it = result.begin(); it != result.end(); it++)
   {
     it->second = it->second / 6.0;
   }
@@ -231,7 +233,7 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelation)
   std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
   std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
 
-  std::map<int, double> result = Scoring::normalizedCrossCorrelation(data1, data2, 2, 1);
+  Scoring::XCorrArrayType result = Scoring::normalizedCrossCorrelation(data1, data2, 2, 1);
 
   TEST_REAL_SIMILAR (result.find( 2)->second, -0.7374631);
   TEST_REAL_SIMILAR (result.find( 1)->second, -0.567846);
@@ -242,6 +244,87 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelation)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelationPost)
+//START_SECTION((XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1, const std::vector<double>& normalized_data2, int maxdelay, int lag)))
+{
+  static const double arr1[] = {0,1,3,5,2,0};
+  static const double arr2[] = {1,3,5,2,0,0};
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+
+  Scoring::standardize_data(data1);
+  Scoring::standardize_data(data2);
+  std::vector<double> data1_copy(data1);
+
+  Scoring::XCorrArrayType result = Scoring::normalizedCrossCorrelationPost(data1, data2, 2, 1);
+
+  TEST_EQUAL (result.size(), 5)
+  TEST_EQUAL (result.begin()->first, -2)
+  TEST_REAL_SIMILAR (result.find( 2)->second, -0.7374631);
+  TEST_REAL_SIMILAR (result.find( 1)->second, -0.567846);
+  TEST_REAL_SIMILAR (result.find( 0)->second,  0.4159292);
+  TEST_REAL_SIMILAR (result.find(-1)->second,  0.8215339);
+  TEST_REAL_SIMILAR (result.find(-2)->second,  0.15634218);
+  TEST_EQUAL (result.find(3) == result.end(), true)
+  // input is not modified
+  TEST_EQUAL (data1 == data1_copy, true)
+
+  // lags without overlap are zero
+  result = Scoring::normalizedCrossCorrelationPost(data1, data2, 8, 1);
+  TEST_EQUAL (result.size(), 17)
+  TEST_EQUAL (result.find(-6)->second, 0.0)
+  TEST_EQUAL (result.find(8)->second, 0.0)
+  TEST_REAL_SIMILAR (result.find(-1)->second,  0.8215339);
+}
+END_SECTION
+
+BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_calculateCrossCorrelation_long)
+//START_SECTION((XCorrArrayType calculateCrossCorrelation(const std::vector<double>& data1, const std::vector<double>& data2, int maxdelay, int lag)) [long chromatograms])
+{
+  // long chromatograms are correlated via FFT, compare with the direct sum
+  const int n = 300;
+  std::vector<double> data1(n), data2(n);
+  for (int i = 0; i < n; ++i)
+  {
+    data1[i] = std::exp(-(i - 140.0) * (i - 140.0) / 50.0) + 0.01 * (i % 7);
+    data2[i] = 0.5 * std::exp(-(i - 143.0) * (i - 143.0) / 60.0) + 0.01 * (i % 5);
+  }
+  Scoring::standardize_data(data1);
+  Scoring::standardize_data(data2);
+
+  Scoring::XCorrArrayType result = Scoring::calculateCrossCorrelation(data1, data2, n, 1);
+  TEST_EQUAL (result.size(), 2 * n + 1)
+
+  int max_delay = -n;
+  double max_value = 0.0;
+  int mismatches = 0;
+  for (int delay = -n; delay <= n; ++delay)
+  {
+    double sxy = 0;
+    for (int i = 0; i < n; ++i)
+    {
+      if (i + delay >= 0 && i + delay < n)
+      {
+        sxy += data1[i] * data2[i + delay];
+      }
+    }
+    if (sxy > max_value)
+    {
+      max_value = sxy;
+      max_delay = delay;
+    }
+    if (std::fabs(result.find(delay)->second - sxy) > 1e-9) ++mismatches;
+  }
+  TEST_EQUAL (mismatches, 0)
+
+  // the maximum is identical to the direct computation
+  Scoring::XCorrArrayType::const_iterator max_peak = Scoring::xcorrArrayGetMaxPeak(static_cast<const Scoring::XCorrArrayType&>(result));
+  TEST_EQUAL (max_peak->first, max_delay)
+  TEST_EQUAL (max_peak->second, max_value)
+  TEST_EQUAL (max_peak->first, 3)
+}
+END_SECTION
+
 BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_calcxcorr_legacy_mquest_)
 //START_SECTION((MRMFeatureScoring::XCorrArrayType MRMFeatureScoring::calcxcorr(std::vector<double>& data1, std::vector<double>& data2, bool normalize)))
 {
@@ -251,7 +334,7 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_calcxcorr_legacy_mquest_)
   std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
   std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
 
-  std::map<int, double> result = Scoring::calcxcorr_legacy_mquest_(data1, data2, true);
+  Scoring::XCorrArrayType result = Scoring::calcxcorr_legacy_mquest_(data1, data2, true);
 
   TEST_REAL_SIMILAR (result.find( 2)->second, -0.7374631);
   TEST_REAL_SIMILAR (result.find( 1)->second, -0.567846);
@@ -39,8 +39,11 @@
 #include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/ElutionPeakDetection.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <limits>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -94,6 +97,16 @@ using namespace std;
   @endcode
   By default, the linear model is used.
 
+  With the @p streaming flag, the input is processed while it is being read
+  instead of loading the whole map into memory first. Mass traces are then
+  detected in consecutive RT chunks (see parameters 'algorithm:mtd:chunk:*')
+  and passed on to elution peak detection and feature assembly as soon as they
+  are complete, so the memory required no longer grows with the length of the
+  run. Results may deviate slightly from the default mode for mass traces
+  close to chunk boundaries (and, if 'algorithm:epd:width_filtering' is 'auto',
+  since the peak width distribution is estimated per chunk). The spectra in
+  the input file must be sorted by RT.
+
   <B>The command line parameters of this tool are:</B>
   @verbinclude TOPP_FeatureFinderMetabo.cli
   <B>INI file documentation of this tool:</B>
@@ -103,6 +116,189 @@ using namespace std;
 // We do not want this class to show up in the docu:
 /// @cond TOPPCLASSES
 
+/// Splits mass traces by elution peak detection (if @p epdet is given) or estimates their FWHM
+void detectElutionPeaks(ElutionPeakDetection* epdet, std::vector<MassTrace>& m_traces, std::vector<MassTrace>& m_traces_final)
+{
+  m_traces_final.clear();
+  if (epdet != 0)
+  {
+    std::vector<MassTrace> splitted_mtraces;
+    // fill mass traces with smoothed data as well .. bad design..
+    epdet->detectPeaks(m_traces, splitted_mtraces);
+    if (epdet->getParameters().getValue("width_filtering") == "auto")
+    {
+      epdet->filterByPeakWidth(splitted_mtraces, m_traces_final);
+    }
+    else
+    {
+      m_traces_final = splitted_mtraces;
+    }
+  }
+  else // no elution peak detection
+  {
+    m_traces_final = m_traces;
+    for (Size i = 0; i < m_traces_final.size(); ++i) // estimate FWHM, so .getIntensity() can be called later
+    {
+      m_traces_final[i].estimateFWHM(false);
+    }
+  }
+}
+
+/**
+  @brief Runs the FeatureFinderMetabo pipeline on spectra while they are being read
+
+  Spectra are passed to MassTraceDetection in streaming mode. Completed mass
+  traces are processed by elution peak detection right away and then wait
+  until all traces they might be assembled with are known: feature assembly
+  runs on all traces whose centroid RT lies before the streaming boundary of
+  MassTraceDetection, and only features whose monoisotopic trace is more than
+  'local_rt_range' away from that boundary are accepted. Traces of rejected
+  features are assembled again with the next chunk.
+*/
+class FFMetaboStreamingConsumer :
+  public Interfaces::IMSDataConsumer<MSExperiment<Peak1D> >
+{
+public:
+  FFMetaboStreamingConsumer(MassTraceDetection& mtdet, ElutionPeakDetection* epdet, FeatureFindingMetabo& ffmet, bool force) :
+    mtdet_(mtdet),
+    epdet_(epdet),
+    ffmet_(ffmet),
+    force_(force),
+    local_rt_range_((double)ffmet.getParameters().getValue("local_rt_range")),
+    spectra_count_(0),
+    trace_count_(0)
+  {
+    mtdet_.startStreaming();
+  }
+
+  void consumeSpectrum(SpectrumType& s)
+  {
+    if (s.getMSLevel() != 1) return;
+
+    // determine type of spectral data (profile or centroided)
+    if (spectra_count_ == 0 && s.getType() == SpectrumSettings::RAWDATA && !force_)
+    {
+      throw OpenMS::Exception::FileEmpty(__FILE__, __LINE__, __FUNCTION__,
+          "Error: Profile data provided but centroided spectra expected. To enforce processing of the data set the -force flag.");
+    }
+    ++spectra_count_;
+    polarities_.insert(s.getInstrumentSettings().getPolarity());
+
+    std::vector<MassTrace> m_traces;
+    mtdet_.consumeSpectrum(s, m_traces);
+    if (!m_traces.empty())
+    {
+      processMassTraces_(m_traces, false);
+    }
+  }
+
+  void consumeChromatogram(ChromatogramType& /* c */)
+  {
+  }
+
+  void setExpectedSize(Size /* expectedSpectra */, Size /* expectedChromatograms */)
+  {
+  }
+
+  void setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    settings_ = exp;
+  }
+
+  /// Processes all remaining mass traces and returns the features found
+  void finish(FeatureMap& feat_map)
+  {
+    std::vector<MassTrace> m_traces;
+    mtdet_.finishStreaming(m_traces);
+    processMassTraces_(m_traces, true);
+    feat_map.swap(feat_map_);
+  }
+
+  Size getSpectraCount() const
+  {
+    return spectra_count_;
+  }
+
+  /// Number of mass traces passed to feature assembly
+  Size getTraceCount() const
+  {
+    return trace_count_;
+  }
+
+  const set<IonSource::Polarity>& getPolarities() const
+  {
+    return polarities_;
+  }
+
+  StringList getPrimaryMSRunPath() const
+  {
+    MSExperiment<Peak1D> tmp;
+    tmp = settings_;
+    return tmp.getPrimaryMSRunPath();
+  }
+
+protected:
+  void processMassTraces_(std::vector<MassTrace>& m_traces, bool final)
+  {
+    std::vector<MassTrace> m_traces_final;
+    detectElutionPeaks(epdet_, m_traces, m_traces_final);
+    trace_count_ += m_traces_final.size();
+    pending_.insert(pending_.end(), m_traces_final.begin(), m_traces_final.end());
+
+    // traces after the boundary may still be assembled with traces of later chunks
+    double boundary(final ? std::numeric_limits<double>::max() : mtdet_.getStreamingBoundary());
+    std::vector<MassTrace> ready, waiting;
+    for (Size i = 0; i < pending_.size(); ++i)
+    {
+      if (pending_[i].getCentroidRT() < boundary)
+      {
+        ready.push_back(pending_[i]);
+      }
+      else
+      {
+        waiting.push_back(pending_[i]);
+      }
+    }
+    if (ready.empty()) return;
+
+    FeatureMap chunk_map;
+    ffmet_.run(ready, chunk_map);
+
+    std::set<String> assembled;
+    for (Size i = 0; i < chunk_map.size(); ++i)
+    {
+      if (final || chunk_map[i].getRT() < boundary - local_rt_range_)
+      {
+        feat_map_.push_back(chunk_map[i]);
+        std::vector<String> labels;
+        chunk_map[i].getMetaValue(3).toString().split('_', labels);
+        if (labels.empty()) labels.push_back(chunk_map[i].getMetaValue(3).toString());
+        assembled.insert(labels.begin(), labels.end());
+      }
+    }
+    for (Size i = 0; i < ready.size(); ++i)
+    {
+      if (assembled.find(ready[i].getLabel()) == assembled.end())
+      {
+        waiting.push_back(ready[i]);
+      }
+    }
+    pending_.swap(waiting);
+  }
+
+  MassTraceDetection& mtdet_;
+  ElutionPeakDetection* epdet_;
+  FeatureFindingMetabo& ffmet_;
+  bool force_;
+  double local_rt_range_;
+  Size spectra_count_;
+  Size trace_count_;
+  std::vector<MassTrace> pending_;
+  FeatureMap feat_map_;
+  set<IonSource::Polarity> polarities_;
+  ExperimentalSettings settings_;
+};
+
 class TOPPFeatureFinderMetabo :
   public TOPPBase
 {
@@ -120,6 +316,7 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("mzML"));
     registerOutputFile_("out", "<file>", "", "FeatureXML file with metabolite features");
     setValidFormats_("out", ListUtils::create<String>("featureXML"));
+    registerFlag_("streaming", "Process the input in RT chunks while reading it, which limits the memory usage for long runs (see 'algorithm:mtd:chunk:*'). Results may differ slightly at chunk boundaries.", true);
 
     addEmptyLine_();
     registerSubsection_("algorithm", "Algorithm parameters section");
@@ -170,40 +367,6 @@ protected:
     String in = getStringOption_("in");
     String out = getStringOption_("out");
 
-    //-------------------------------------------------------------
-    // loading input
-    //-------------------------------------------------------------
-    MzMLFile mz_data_file;
-    mz_data_file.setLogType(log_type_);
-    MSExperiment<Peak1D> ms_peakmap;
-    std::vector<Int> ms_level(1, 1);
-    mz_data_file.getOptions().setMSLevels(ms_level);
-    mz_data_file.load(in, ms_peakmap);
-
-    if (ms_peakmap.empty())
-    {
-      LOG_WARN << "The given file does not contain any conventional peak data, but might"
-                  " contain chromatograms. This tool currently cannot handle them, sorry.";
-      return INCOMPATIBLE_INPUT_DATA;
-    }
-
-    // determine type of spectral data (profile or centroided)
-    SpectrumSettings::SpectrumType spectrum_type = ms_peakmap[0].getType();
-
-    if (spectrum_type == SpectrumSettings::RAWDATA)
-    {
-      if (!getFlag_("force"))
-      {
-        throw OpenMS::Exception::FileEmpty(__FILE__, __LINE__, __FUNCTION__,
-            "Error: Profile data provided but centroided spectra expected. To enforce processing of the data set the -force flag.");
-      }
-    }
-
-    // make sure the spectra are sorted by m/z
-    ms_peakmap.sortSpectra(true);
-
-    vector<MassTrace> m_traces;
-
     //-------------------------------------------------------------
     // set parameters
     //-------------------------------------------------------------
@@ -221,7 +384,8 @@ protected:
     writeDebug_("Parameters passed to FeatureFindingMetabo", ffm_param, 3);
 
     //-------------------------------------------------------------
-    // configure and run mass trace detection
+    // configure mass trace detection, elution peak detection and
+    // feature finding
     //-------------------------------------------------------------
 
     MassTraceDetection mtdet;
@@ -229,64 +393,99 @@ protected:
     mtd_param.remove("chrom_fwhm");
     mtdet.setParameters(mtd_param);
 
-    mtdet.run(ms_peakmap, m_traces);
+    ElutionPeakDetection epdet;
+    ElutionPeakDetection* epdet_ptr = 0;
+    if (epd_param.getValue("enabled").toBool())
+    {
+      epd_param.remove("enabled"); // artificially added above
+      epd_param.insert("", common_param);
+      epdet.setParameters(epd_param);
+      epdet_ptr = &epdet;
+    }
+    else if (ffm_param.getValue("use_smoothed_intensities").toBool())
+    {
+      LOG_WARN << "Without EPD, smoothing is not supported. Setting 'use_smoothed_intensities' to false!" << std::endl;
+      ffm_param.setValue("use_smoothed_intensities", "false");
+    }
 
+    ffm_param.insert("", common_param);
+    ffm_param.remove("noise_threshold_int");
+    ffm_param.remove("chrom_peak_snr");
+
+    FeatureFindingMetabo ffmet;
+    ffmet.setParameters(ffm_param);
 
     //-------------------------------------------------------------
-    // configure and run elution peak detection
+    // loading input and running the algorithms
     //-------------------------------------------------------------
+    MzMLFile mz_data_file;
+    mz_data_file.setLogType(log_type_);
+    std::vector<Int> ms_level(1, 1);
+    mz_data_file.getOptions().setMSLevels(ms_level);
 
-    std::vector<MassTrace> m_traces_final;
-    if (epd_param.getValue("enabled").toBool())
+    FeatureMap feat_map;
+    Size input_trace_count(0);
+    set<IonSource::Polarity> pols;
+
+    if (getFlag_("streaming"))
     {
-      std::vector<MassTrace> splitted_mtraces;
-      epd_param.remove("enabled"); // artificially added above
-      epd_param.insert("", common_param);
-      ElutionPeakDetection epdet;
-      epdet.setParameters(epd_param);
-      // fill mass traces with smoothed data as well .. bad design..
-      epdet.detectPeaks(m_traces, splitted_mtraces);
-      if (epdet.getParameters().getValue("width_filtering") == "auto")
-      {
-        m_traces_final.clear();
-        epdet.filterByPeakWidth(splitted_mtraces, m_traces_final);
-      }
-      else
+      FFMetaboStreamingConsumer consumer(mtdet, epdet_ptr, ffmet, getFlag_("force"));
+      mz_data_file.transform(in, &consumer, true);
+
+      if (consumer.getSpectraCount() == 0)
       {
-        m_traces_final = splitted_mtraces;
+        LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                    " contain chromatograms. This tool currently cannot handle them, sorry.";
+        return INCOMPATIBLE_INPUT_DATA;
       }
+
+      consumer.finish(feat_map);
+      feat_map.setPrimaryMSRunPath(consumer.getPrimaryMSRunPath());
+      input_trace_count = consumer.getTraceCount();
+      pols = consumer.getPolarities();
     }
-    else // no elution peak detection
+    else
     {
-      m_traces_final = m_traces;
-      for (Size i = 0; i < m_traces_final.size(); ++i) // estimate FWHM, so .getIntensity() can be called later
+      MSExperiment<Peak1D> ms_peakmap;
+      mz_data_file.load(in, ms_peakmap);
+
+      if (ms_peakmap.empty())
       {
-        m_traces_final[i].estimateFWHM(false);
+        LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                    " contain chromatograms. This tool currently cannot handle them, sorry.";
+        return INCOMPATIBLE_INPUT_DATA;
       }
-      if (ffm_param.getValue("use_smoothed_intensities").toBool())
+
+      // determine type of spectral data (profile or centroided)
+      SpectrumSettings::SpectrumType spectrum_type = ms_peakmap[0].getType();
+
+      if (spectrum_type == SpectrumSettings::RAWDATA)
       {
-        LOG_WARN << "Without EPD, smoothing is not supported. Setting 'use_smoothed_intensities' to false!" << std::endl;
-        ffm_param.setValue("use_smoothed_intensities", "false");
+        if (!getFlag_("force"))
+        {
+          throw OpenMS::Exception::FileEmpty(__FILE__, __LINE__, __FUNCTION__,
+              "Error: Profile data provided but centroided spectra expected. To enforce processing of the data set the -force flag.");
+        }
       }
-    }
 
+      // make sure the spectra are sorted by m/z
+      ms_peakmap.sortSpectra(true);
 
-//    std::cout << "m_traces: " << m_traces_final.size() << std::endl;
+      vector<MassTrace> m_traces;
+      mtdet.run(ms_peakmap, m_traces);
 
-    //-------------------------------------------------------------
-    // configure and run feature finding
-    //-------------------------------------------------------------
+      std::vector<MassTrace> m_traces_final;
+      detectElutionPeaks(epdet_ptr, m_traces, m_traces_final);
 
-    ffm_param.insert("", common_param);
-    ffm_param.remove("noise_threshold_int");
-    ffm_param.remove("chrom_peak_snr");
+      feat_map.setPrimaryMSRunPath(ms_peakmap.getPrimaryMSRunPath());
+      ffmet.run(m_traces_final, feat_map);
+      input_trace_count = m_traces_final.size();
 
-    FeatureMap feat_map;
-    feat_map.setPrimaryMSRunPath(ms_peakmap.getPrimaryMSRunPath());
-
-    FeatureFindingMetabo ffmet;
-    ffmet.setParameters(ffm_param);
-    ffmet.run(m_traces_final, feat_map);
+      for (Size i = 0; i < ms_peakmap.size(); ++i)
+      {
+        pols.insert(ms_peakmap[i].getInstrumentSettings().getPolarity());
+      }
+    }
 
     Size trace_count(0);
     for (Size i = 0; i < feat_map.size(); ++i)
@@ -297,10 +496,10 @@ protected:
     }
 
     LOG_INFO << "-- FF-Metabo stats --\n"
-             << "Input traces:    " << m_traces_final.size() << "\n"
+             << "Input traces:    " << input_trace_count << "\n"
              << "Output features: " << feat_map.size() << " (total trace count: " << trace_count << ")" << std::endl;
 
-    if (trace_count != m_traces_final.size())
+    if (trace_count != input_trace_count)
     {
       LOG_ERROR << "FF-Metabo: Internal error. Not all mass traces have been assembled to features! Aborting." << std::endl;
       return UNEXPECTED_RESULT;
@@ -312,11 +511,6 @@ protected:
     // store ionization mode of spectra (useful for post-processing by AccurateMassSearch tool)
     if (feat_map.size() > 0)
     {
-      set<IonSource::Polarity> pols;
-      for (Size i = 0; i < ms_peakmap.size(); ++i)
-      {
-        pols.insert(ms_peakmap[i].getInstrumentSettings().getPolarity());
-      }
       // concat to single string
       StringList sl_pols;
       for (set<IonSource::Polarity>::const_iterator it = pols.begin();
@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionTSVReader.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/TransitionBinaryLibrary.h>
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <OpenMS/CONCEPT/Exception.h>
@@ -53,6 +54,11 @@ using namespace OpenMS;
 
   @brief Converts OpenSWATH transition TSV files to TraML files
 
+  Alternatively, the transitions can be written as binary transition library
+  ("oswlib", see TransitionBinaryLibrary), which OpenSwathWorkflow maps into
+  memory instead of parsing it. This is recommended for large assay libraries
+  that are used repeatedly.
+
   The OpenSWATH transition TSV files need to have the following headers, all fields need to be separated by tabs:
 
         <ul>
@@ -145,8 +151,10 @@ protected:
     setValidFormats_("in", ListUtils::create<String>(formats));
     setValidStrings_("in_type", ListUtils::create<String>(formats));
 
-    registerOutputFile_("out", "<file>", "", "Output TraML file");
-    setValidFormats_("out", ListUtils::create<String>("TraML"));
+    registerOutputFile_("out", "<file>", "", "Output TraML file or binary transition library");
+    setValidFormats_("out", ListUtils::create<String>("TraML,oswlib"));
+    registerStringOption_("out_type", "<type>", "", "output file type -- default: determined from file extension\n", false);
+    setValidStrings_("out_type", ListUtils::create<String>("TraML,oswlib"));
 
     registerSubsection_("algorithm", "Algorithm parameters section");
 
@@ -178,16 +186,33 @@ protected:
     }
 
     String out = getStringOption_("out");
+    FileTypes::Type out_type = FileTypes::nameToType(getStringOption_("out_type"));
+
+    if (out_type == FileTypes::UNKNOWN)
+    {
+      out_type = fh.getTypeByFileName(out);
+    }
+
     const char* tr_file = in.c_str();
     Param reader_parameters = getParam_().copy("algorithm:", true);
 
-    TraMLFile traml;
-    TargetedExperiment targeted_exp;
-
     TransitionTSVReader tsv_reader = TransitionTSVReader();
     std::cout << "Reading " << in << std::endl;
     tsv_reader.setLogType(log_type_);
     tsv_reader.setParameters(reader_parameters);
+
+    if (out_type == FileTypes::OSWLIB)
+    {
+      OpenSwath::LightTargetedExperiment transition_exp;
+      tsv_reader.convertTSVToTargetedExperiment(tr_file, in_type, transition_exp);
+
+      std::cout << "Writing " << out << std::endl;
+      TransitionBinaryLibrary::store(out, transition_exp);
+      return EXECUTION_OK;
+    }
+
+    TraMLFile traml;
+    TargetedExperiment targeted_exp;
     tsv_reader.convertTSVToTargetedExperiment(tr_file, in_type, targeted_exp);
     tsv_reader.validateTargetedExperiment(targeted_exp);
 
@@ -51,6 +51,7 @@
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/TransformationXMLFile.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionTSVReader.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/TransitionBinaryLibrary.h>
 #include <OpenMS/FORMAT/CachedMzML.h>
 #include <OpenMS/FORMAT/SwathFile.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/SwathWindowLoader.h>
@@ -76,6 +77,10 @@
 
 #include <assert.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define OPENSWATH_WORKFLOW_DEBUG
 
 using namespace OpenMS;
@@ -516,12 +521,28 @@ namespace OpenMS
       // in which they were given to the program / acquired. This gives much
       // better load balancing than static allocation.
 #ifdef _OPENMP
-#pragma omp parallel for schedule(dynamic,1)
+      // If there are fewer SWATH maps than threads, the remaining threads
+      // are used to extract the chromatograms of a single map in parallel
+      // (the spectrum access objects can be shared between threads).
+      int nr_ms2_maps = 0;
+      for (Size i = 0; i < swath_maps.size(); ++i)
+      {
+        if (!swath_maps[i].ms1) ++nr_ms2_maps;
+      }
+      const int max_threads = omp_get_max_threads();
+      const int outer_threads = std::max(1, std::min(max_threads, nr_ms2_maps));
+      const int inner_threads = std::max(1, max_threads / outer_threads);
+      const int nested = omp_get_nested();
+      omp_set_nested(inner_threads > 1);
+#pragma omp parallel for schedule(dynamic,1) num_threads(outer_threads)
 #endif
       for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(swath_maps.size()); ++i)
       {
         if (!swath_maps[i].ms1) // skip MS1
         {
+#ifdef _OPENMP
+          omp_set_num_threads(inner_threads);
+#endif
 
           OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
 
@@ -629,6 +650,9 @@ namespace OpenMS
           } // continue 2 (no continue due to OpenMP)
         } // continue 1 (no continue due to OpenMP)
       }
+#ifdef _OPENMP
+      omp_set_nested(nested);
+#endif
       this->endProgress();
     }
 
@@ -1542,10 +1566,10 @@ protected:
     registerInputFileList_("in", "<files>", StringList(), "Input files separated by blank");
     setValidFormats_("in", ListUtils::create<String>("mzML,mzXML"));
 
-    registerInputFile_("tr", "<file>", "", "transition file ('TraML','tsv' or 'csv')");
-    setValidFormats_("tr", ListUtils::create<String>("traML,tsv,csv"));
+    registerInputFile_("tr", "<file>", "", "transition file ('TraML','tsv', 'csv' or binary transition library 'oswlib', see ConvertTSVToTraML)");
+    setValidFormats_("tr", ListUtils::create<String>("traML,tsv,csv,oswlib"));
     registerStringOption_("tr_type", "<type>", "", "input file type -- default: determined from file extension or content\n", false);
-    setValidStrings_("tr_type", ListUtils::create<String>("traML,tsv,csv"));
+    setValidStrings_("tr_type", ListUtils::create<String>("traML,tsv,csv,oswlib"));
 
     // one of the following two needs to be set
     registerInputFile_("tr_irt", "<file>", "", "transition file ('TraML')", false);
@@ -1975,6 +1999,12 @@ protected:
       TraMLFile().load(tr_file, targeted_exp);
       OpenSwathDataAccessHelper::convertTargetedExp(targeted_exp, transition_exp);
     }
+    else if (tr_type == FileTypes::OSWLIB)
+    {
+      TransitionBinaryLibrary library;
+      library.load(tr_file);
+      library.getLightTargetedExperiment(transition_exp);
+    }
     else
     {
       TransitionTSVReader().convertTSVToTargetedExperiment(tr_file.c_str(), tr_type, transition_exp);
@@ -46,6 +46,7 @@
 #include <OpenMS/CHEMISTRY/EnzymesDB.h>
 
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
 
@@ -65,7 +66,7 @@
 
 #include <OpenMS/FILTERING/ID/IDFilter.h>
 
-#include <map>
+#include <set>
 #include <algorithm>
 
 #ifdef _OPENMP
@@ -166,6 +167,301 @@ class SimpleSearchEngine :
       registerIntOption_("report:top_hits", "<num>", 1, "Maximum number of top scoring hits per spectrum that are reported.", false, true);
     }
 
+    /**
+      @brief Sorted array of candidate peptide masses with a bucket table
+
+      The bucket table stores for each (1 Da) mass bucket the index of the
+      first candidate with at least that mass, so that looking up the
+      candidates matching a precursor mass only requires a binary search
+      within a single bucket.
+    */
+    class PrecursorMassIndex_
+    {
+public:
+      explicit PrecursorMassIndex_(const vector<double>& sorted_masses) :
+        masses_(sorted_masses),
+        min_mass_(0.0)
+      {
+        if (masses_.empty())
+        {
+          return;
+        }
+        min_mass_ = floor(masses_.front());
+        Size nr_buckets = (Size)((masses_.back() - min_mass_) / BUCKET_WIDTH) + 2;
+        bucket_start_.resize(nr_buckets + 1);
+        Size idx = 0;
+        for (Size b = 0; b <= nr_buckets; ++b)
+        {
+          const double bucket_mass = min_mass_ + b * BUCKET_WIDTH;
+          while (idx < masses_.size() && masses_[idx] < bucket_mass) ++idx;
+          bucket_start_[b] = idx;
+        }
+      }
+
+      /// returns the index of the first candidate with mass >= @p mass
+      Size lowerBound(double mass) const
+      {
+        if (masses_.empty() || mass <= masses_.front()) return 0;
+        if (mass > masses_.back()) return masses_.size();
+        const Size bucket = (Size)((mass - min_mass_) / BUCKET_WIDTH);
+        return lower_bound(masses_.begin() + bucket_start_[bucket], masses_.begin() + bucket_start_[bucket + 1], mass) - masses_.begin();
+      }
+
+      /**
+        @brief Returns the half-open index range of candidates that match @p precursor_mass
+
+        A candidate matches if the precursor mass lies within the tolerance
+        window (of total width @p tolerance) around the candidate mass.
+      */
+      pair<Size, Size> findCandidates(double precursor_mass, double tolerance, bool tolerance_unit_ppm) const
+      {
+        // conservative range first (the window is relative to the candidate mass), then apply the exact criterion
+        double left, right;
+        if (tolerance_unit_ppm)
+        {
+          left = precursor_mass / (1.0 + tolerance * 1e-6);
+          right = precursor_mass / (1.0 - tolerance * 1e-6);
+        }
+        else
+        {
+          left = precursor_mass - tolerance;
+          right = precursor_mass + tolerance;
+        }
+        Size first = lowerBound(left);
+        Size last = lowerBound(right);
+        while (last < masses_.size() && matches_(masses_[last], precursor_mass, tolerance, tolerance_unit_ppm)) ++last;
+        while (first < last && !matches_(masses_[first], precursor_mass, tolerance, tolerance_unit_ppm)) ++first;
+        while (last > first && !matches_(masses_[last - 1], precursor_mass, tolerance, tolerance_unit_ppm)) --last;
+        return make_pair(first, last);
+      }
+
+private:
+      static bool matches_(double candidate_mass, double precursor_mass, double tolerance, bool tolerance_unit_ppm)
+      {
+        const double half_window = tolerance_unit_ppm ? 0.5 * candidate_mass * tolerance * 1e-6 : 0.5 * tolerance;
+        return precursor_mass >= candidate_mass - half_window && precursor_mass <= candidate_mass + half_window;
+      }
+
+      static const double BUCKET_WIDTH;
+
+      const vector<double>& masses_;
+      double min_mass_;
+      vector<Size> bucket_start_;
+    };
+
+    /**
+      @brief Inverted index from (binned) fragment m/z to candidate peptides
+
+      The theoretical fragment ions of all candidates are stored in a single
+      array grouped by m/z bin and, within a bin, ordered by candidate index
+      (candidates are sorted by mass). Scoring a spectrum walks over its
+      peaks once and accumulates the HyperScore statistics (dot product and
+      number of matching b- and y-ions) of all candidates in the precursor
+      window at the same time, instead of comparing the spectrum with each
+      candidate separately. As in HyperScore::compute, a theoretical peak is
+      matched to its nearest experimental peak if that is within the
+      fragment mass tolerance.
+    */
+    class FragmentIndex_
+    {
+public:
+      /// Match statistics of the candidates of one spectrum
+      struct Accumulator_
+      {
+        vector<double> dot_product;
+        vector<UInt> b_ion_count;
+        vector<UInt> y_ion_count;
+        vector<double> exp_mz;
+      };
+
+      FragmentIndex_(const vector<AASequence>& candidates, const TheoreticalSpectrumGenerator& spectrum_generator, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm) :
+        tolerance_(fragment_mass_tolerance),
+        tolerance_unit_ppm_(fragment_mass_tolerance_unit_ppm)
+      {
+        // bins of the size of the tolerance (at m/z 1000 for ppm) so only a few bins need to be checked per peak
+        bin_width_ = std::max(1e-3, tolerance_unit_ppm_ ? 1000.0 * tolerance_ * 1e-6 : tolerance_);
+
+        // intensities of the ion types as in TheoreticalSpectrumGenerator::getSpectrum() (other types are not indexed)
+        vector<float> ion_intensity(256, -1.0f);
+        const char ion_letters[] = {'a', 'b', 'c', 'x', 'y', 'z'};
+        for (Size t = 0; t != sizeof(ion_letters); ++t)
+        {
+          ion_intensity[(unsigned char)ion_letters[t]] = spectrum_generator.getIonIntensity(ion_letters[t]);
+        }
+
+        // generate the theoretical spectra (in parallel) and count the number of ions per bin
+        vector<vector<Fragment_> > fragments(candidates.size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+          // per-thread buffers, re-used for all candidates
+          vector<double> mzs;
+          vector<char> ion_types;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100)
+#endif
+          for (SignedSize i = 0; i < (SignedSize)candidates.size(); ++i)
+          {
+            spectrum_generator.getFragmentMZs(mzs, ion_types, candidates[i], 1);
+            fragments[i].reserve(mzs.size());
+            for (Size j = 0; j != mzs.size(); ++j)
+            {
+              const float intensity = ion_intensity[(unsigned char)ion_types[j]];
+              if (intensity < 0.0f) continue;
+              Fragment_ f;
+              f.mz = mzs[j];
+              f.ion_type = ion_types[j];
+              f.intensity = intensity;
+              fragments[i].push_back(f);
+            }
+          }
+        }
+
+        double max_mz = 0.0;
+        for (Size i = 0; i != fragments.size(); ++i)
+        {
+          for (Size j = 0; j != fragments[i].size(); ++j)
+          {
+            max_mz = std::max(max_mz, fragments[i][j].mz);
+          }
+        }
+        bin_start_.assign(binOf_(max_mz) + 2, 0);
+        for (Size i = 0; i != fragments.size(); ++i)
+        {
+          for (Size j = 0; j != fragments[i].size(); ++j)
+          {
+            ++bin_start_[binOf_(fragments[i][j].mz) + 1];
+          }
+        }
+        for (Size b = 1; b < bin_start_.size(); ++b)
+        {
+          bin_start_[b] += bin_start_[b - 1];
+        }
+
+        // fill the bins in order of the candidates
+        const Size nr_fragments = bin_start_.back();
+        mz_.resize(nr_fragments);
+        intensity_.resize(nr_fragments);
+        candidate_.resize(nr_fragments);
+        ion_type_.resize(nr_fragments);
+        vector<Size> fill = bin_start_;
+        for (Size i = 0; i != fragments.size(); ++i)
+        {
+          for (Size j = 0; j != fragments[i].size(); ++j)
+          {
+            const Size pos = fill[binOf_(fragments[i][j].mz)]++;
+            mz_[pos] = fragments[i][j].mz;
+            intensity_[pos] = fragments[i][j].intensity;
+            candidate_[pos] = (UInt)i;
+            ion_type_[pos] = fragments[i][j].ion_type;
+          }
+          vector<Fragment_>().swap(fragments[i]);
+        }
+      }
+
+      /// number of indexed fragment ions
+      Size size() const
+      {
+        return mz_.size();
+      }
+
+      /// accumulates the HyperScore statistics of the candidates [@p first, @p last) against @p exp_spectrum
+      void accumulate(const PeakSpectrum& exp_spectrum, Size first, Size last, Accumulator_& acc) const
+      {
+        const Size nr_candidates = last - first;
+        acc.dot_product.assign(nr_candidates, 0.0);
+        acc.b_ion_count.assign(nr_candidates, 0);
+        acc.y_ion_count.assign(nr_candidates, 0);
+        if (exp_spectrum.empty() || bin_start_.size() < 2)
+        {
+          return;
+        }
+
+        acc.exp_mz.resize(exp_spectrum.size());
+        for (Size j = 0; j != exp_spectrum.size(); ++j)
+        {
+          acc.exp_mz[j] = exp_spectrum[j].getMZ();
+        }
+
+        const Size last_bin = bin_start_.size() - 2;
+        for (Size j = 0; j != exp_spectrum.size(); ++j)
+        {
+          const double exp_mz = acc.exp_mz[j];
+          // theoretical peaks within the tolerance (which is relative to the theoretical m/z for ppm)
+          const double max_dist = tolerance_unit_ppm_ ? 2.0 * exp_mz * tolerance_ * 1e-6 : tolerance_;
+          if (binOf_(std::max(0.0, exp_mz - max_dist)) > last_bin) break; // peaks are sorted by m/z
+          const Size bin_begin = binOf_(std::max(0.0, exp_mz - max_dist));
+          const Size bin_end = std::min(binOf_(exp_mz + max_dist), last_bin);
+
+          for (Size b = bin_begin; b <= bin_end; ++b)
+          {
+            // the ions of a bin are ordered by candidate
+            vector<UInt>::const_iterator begin = candidate_.begin() + bin_start_[b];
+            vector<UInt>::const_iterator end = candidate_.begin() + bin_start_[b + 1];
+            vector<UInt>::const_iterator it = lower_bound(begin, end, (UInt)first);
+            for (; it != end && *it < last; ++it)
+            {
+              const Size pos = it - candidate_.begin();
+              const double theo_mz = mz_[pos];
+              const double max_dist_dalton = tolerance_unit_ppm_ ? theo_mz * tolerance_ * 1e-6 : tolerance_;
+              if (!(std::abs(theo_mz - exp_mz) < max_dist_dalton) || findNearest_(acc.exp_mz, theo_mz) != j)
+              {
+                continue;
+              }
+
+              const Size c = *it - first;
+              acc.dot_product[c] += exp_spectrum[j].getIntensity() * intensity_[pos];
+              if (ion_type_[pos] == 'y')
+              {
+                ++acc.y_ion_count[c];
+              }
+              else if (ion_type_[pos] == 'b')
+              {
+                ++acc.b_ion_count[c];
+              }
+            }
+          }
+        }
+      }
+
+private:
+      struct Fragment_
+      {
+        double mz;
+        float intensity;
+        char ion_type;
+      };
+
+      Size binOf_(double mz) const
+      {
+        return (Size)(mz / bin_width_);
+      }
+
+      /// same semantics as MSSpectrum::findNearest
+      static Size findNearest_(const vector<double>& mz, double value)
+      {
+        vector<double>::const_iterator it = lower_bound(mz.begin(), mz.end(), value);
+        if (it == mz.begin()) return 0;
+        if (it == mz.end()) return mz.size() - 1;
+        vector<double>::const_iterator it2 = it - 1;
+        if (std::fabs(*it - value) < std::fabs(*it2 - value))
+        {
+          return it - mz.begin();
+        }
+        return it2 - mz.begin();
+      }
+
+      double tolerance_;
+      bool tolerance_unit_ppm_;
+      double bin_width_;
+      vector<Size> bin_start_;
+      vector<double> mz_;
+      vector<float> intensity_;
+      vector<UInt> candidate_;
+      vector<char> ion_type_;
+    };
+
     vector<ResidueModification> getModifications_(StringList modNames)
     {
       vector<ResidueModification> modifications;
@@ -456,8 +752,8 @@ class SimpleSearchEngine :
       preprocessSpectra_(spectra, fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm);
       progresslogger.endProgress();
 
-      // build multimap of precursor mass to scan index
-      multimap<double, Size> multimap_mass_2_scan_index;
+      // collect precursor masses of all spectra that can be searched
+      vector<pair<Size, double> > precursor_masses;
       for (PeakMap::ConstIterator s_it = spectra.begin(); s_it != spectra.end(); ++s_it)
       {
         int scan_index = s_it - spectra.begin();
@@ -475,7 +771,7 @@ class SimpleSearchEngine :
 
           double precursor_mz = precursor[0].getMZ();
           double precursor_mass = (double) precursor_charge * precursor_mz - (double) precursor_charge * Constants::PROTON_MASS_U;
-          multimap_mass_2_scan_index.insert(make_pair(precursor_mass, scan_index));
+          precursor_masses.push_back(make_pair(scan_index, precursor_mass));
         }
       }
 
@@ -483,7 +779,6 @@ class SimpleSearchEngine :
       TheoreticalSpectrumGenerator spectrum_generator;
       Param param(spectrum_generator.getParameters());
       param.setValue("add_first_prefix_ion", "true");
-      param.setValue("add_metainfo", "true");
       spectrum_generator.setParameters(param);
 
       vector<vector<PeptideHit> > peptide_hits(spectra.size(), vector<PeptideHit>());
@@ -499,7 +794,10 @@ class SimpleSearchEngine :
       digestor.setEnzyme(getStringOption_("enzyme"));
       digestor.setMissedCleavages(missed_cleavages);
 
-      progresslogger.startProgress(0, (Size)(fasta_db.end() - fasta_db.begin()), "Scoring peptide models against spectra...");
+      // create all modified residues up front, so the threads below can look them up without locking
+      ResidueDB::getInstance()->freeze();
+
+      progresslogger.startProgress(0, (Size)(fasta_db.end() - fasta_db.begin()), "Generating candidate peptides...");
 
       // lookup for processed peptides. must be defined outside of omp section and synchronized
       set<StringView> processed_petides;
@@ -508,115 +806,134 @@ class SimpleSearchEngine :
       Size min_peptide_length = getIntOption_("peptide:min_size");
       Size max_peptide_length = getIntOption_("peptide:max_size");
 
+      vector<AASequence> candidates;
+
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel
 #endif
-      for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
       {
-        IF_MASTERTHREAD
+        vector<AASequence> local_candidates;
+
+#ifdef _OPENMP
+#pragma omp for nowait
+#endif
+        for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
         {
-          progresslogger.setProgress((SignedSize)fasta_index * NUMBER_OF_THREADS);
-        }
+          IF_MASTERTHREAD
+          {
+            progresslogger.setProgress((SignedSize)fasta_index * NUMBER_OF_THREADS);
+          }
 
-        vector<StringView> current_digest;
-        digestor.digestUnmodifiedString(fasta_db[fasta_index].sequence, current_digest, min_peptide_length, max_peptide_length);
+          vector<StringView> current_digest;
+          digestor.digestUnmodifiedString(fasta_db[fasta_index].sequence, current_digest, min_peptide_length, max_peptide_length);
 
-        for (vector<StringView>::iterator cit = current_digest.begin(); cit != current_digest.end(); ++cit)
-        {
-          bool already_processed = false;
+          for (vector<StringView>::iterator cit = current_digest.begin(); cit != current_digest.end(); ++cit)
+          {
+            bool already_processed = false;
 #ifdef _OPENMP
 #pragma omp critical (processed_peptides_access)
 #endif
-          {
-            if (processed_petides.find(*cit) != processed_petides.end())
             {
               // peptide (and all modified variants) already processed so skip it
-              already_processed = true;
+              already_processed = !processed_petides.insert(*cit).second;
             }
-          }
 
-          if (already_processed)
-          {
-            continue;
+            if (already_processed)
+            {
+              continue;
+            }
+
+            // no locking needed: the frozen ResidueDB is not modified by creating modified residues
+            AASequence aas = AASequence::fromString(cit->getString());
+            ModifiedPeptideGenerator::applyFixedModifications(fixedMods.begin(), fixedMods.end(), aas);
+            ModifiedPeptideGenerator::applyVariableModifications(varMods.begin(), varMods.end(), aas, max_variable_mods_per_peptide, local_candidates);
           }
+        }
 
 #ifdef _OPENMP
-#pragma omp critical (processed_peptides_access)
+#pragma omp critical (candidates_access)
 #endif
-          {
-            processed_petides.insert(*cit);
-          }
+        {
+          candidates.insert(candidates.end(), local_candidates.begin(), local_candidates.end());
+        }
+      }
+      progresslogger.endProgress();
+
+      // sort candidates by mass (the sorted masses form the precursor index)
+      progresslogger.startProgress(0, 1, "Building fragment ion index...");
+      vector<pair<double, Size> > mass_order(candidates.size());
+      for (Size i = 0; i != candidates.size(); ++i)
+      {
+        mass_order[i] = make_pair(candidates[i].getMonoWeight(), i);
+      }
+      sort(mass_order.begin(), mass_order.end());
+
+      vector<AASequence> sorted_candidates(candidates.size());
+      vector<double> candidate_masses(candidates.size());
+      for (Size i = 0; i != mass_order.size(); ++i)
+      {
+        candidate_masses[i] = mass_order[i].first;
+        sorted_candidates[i] = candidates[mass_order[i].second];
+      }
+      candidates.swap(sorted_candidates);
+      vector<AASequence>().swap(sorted_candidates);
+      vector<pair<double, Size> >().swap(mass_order);
+
+      PrecursorMassIndex_ precursor_index(candidate_masses);
+      FragmentIndex_ fragment_index(candidates, spectrum_generator, fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm);
+      progresslogger.endProgress();
+
+      LOG_INFO << "Indexed " << candidates.size() << " candidate peptides with " << fragment_index.size() << " fragment ions." << endl;
 
-          vector<AASequence> all_modified_peptides;
+      progresslogger.startProgress(0, precursor_masses.size(), "Scoring peptide models against spectra...");
 
-          // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
 #ifdef _OPENMP
-#pragma omp critical (residuedb_access)
+#pragma omp parallel
 #endif
+      {
+        // accumulators for the candidates of the current spectrum (reused between spectra)
+        FragmentIndex_::Accumulator_ accumulator;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 10)
+#endif
+        for (SignedSize precursor_idx = 0; precursor_idx < (SignedSize)precursor_masses.size(); ++precursor_idx)
+        {
+          IF_MASTERTHREAD
           {
-            AASequence aas = AASequence::fromString(cit->getString());
-            ModifiedPeptideGenerator::applyFixedModifications(fixedMods.begin(), fixedMods.end(), aas);
-            ModifiedPeptideGenerator::applyVariableModifications(varMods.begin(), varMods.end(), aas, max_variable_mods_per_peptide, all_modified_peptides);
+            progresslogger.setProgress((SignedSize)precursor_idx * NUMBER_OF_THREADS);
           }
 
-          for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
+          const Size scan_index = precursor_masses[precursor_idx].first;
+          const double precursor_mass = precursor_masses[precursor_idx].second;
+          const MSSpectrum<Peak1D>& exp_spectrum = spectra[scan_index];
+
+          // determine candidates whose mass matches to the current MS2 precursor
+          pair<Size, Size> candidate_range = precursor_index.findCandidates(precursor_mass, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+          if (candidate_range.first == candidate_range.second)
           {
-            const AASequence& candidate = all_modified_peptides[mod_pep_idx];
-            double current_peptide_mass = candidate.getMonoWeight();
+            continue; // no matching peptide in database
+          }
 
-            // determine MS2 precursors that match to the current peptide mass
-            multimap<double, Size>::const_iterator low_it;
-            multimap<double, Size>::const_iterator up_it;
+          fragment_index.accumulate(exp_spectrum, candidate_range.first, candidate_range.second, accumulator);
 
-            if (precursor_mass_tolerance_unit_ppm) // ppm
-            {
-              low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * current_peptide_mass * precursor_mass_tolerance * 1e-6);
-              up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * current_peptide_mass * precursor_mass_tolerance * 1e-6);
-            }
-            else // Dalton
-            {
-              low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * precursor_mass_tolerance);
-              up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * precursor_mass_tolerance);
-            }
+          // each spectrum is processed by a single thread, no synchronization needed
+          vector<PeptideHit>& hits = peptide_hits[scan_index];
+          for (Size i = 0; i != accumulator.dot_product.size(); ++i)
+          {
+            double score = HyperScore::compute(accumulator.dot_product[i], accumulator.b_ion_count[i], accumulator.y_ion_count[i]);
 
-            if (low_it == up_it)
+            // no hit
+            if (score < 1e-16)
             {
-              continue;     // no matching precursor in data
+              continue;
             }
 
-            //create theoretical spectrum
-            MSSpectrum<RichPeak1D> theo_spectrum = MSSpectrum<RichPeak1D>();
-
-            //add peaks for b and y ions with charge 1
-            spectrum_generator.getSpectrum(theo_spectrum, candidate, 1);
-
-            //sort by mz
-            theo_spectrum.sortByPosition();
-
-            for (; low_it != up_it; ++low_it)
-            {
-              const Size& scan_index = low_it->second;
-              const MSSpectrum<Peak1D>& exp_spectrum = spectra[scan_index];
-
-              double score = HyperScore::compute(fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum);
-
-              // no hit
-              if (score < 1e-16)
-              {
-                continue;
-              }
-
-              PeptideHit hit;
-              hit.setSequence(candidate);
-              hit.setCharge(exp_spectrum.getPrecursors()[0].getCharge());
-              hit.setScore(score);
-#ifdef _OPENMP
-#pragma omp critical (peptide_hits_access)
-#endif
-              {
-                peptide_hits[scan_index].push_back(hit);
-              }
-            }
+            PeptideHit hit;
+            hit.setSequence(candidates[candidate_range.first + i]);
+            hit.setCharge(exp_spectrum.getPrecursors()[0].getCharge());
+            hit.setScore(score);
+            hits.push_back(hit);
           }
         }
       }
@@ -638,6 +955,8 @@ class SimpleSearchEngine :
 
 };
 
+const double SimpleSearchEngine::PrecursorMassIndex_::BUCKET_WIDTH = 1.0;
+
 int main(int argc, const char** argv)
 {
   SimpleSearchEngine tool;